@@ -310,6 +310,9 @@ UINT8 ALSA_Start(void* drvObj, UINT32 deviceID, AUDIO_OPTS* options, void* audDr
 		snd_pcm_close(drv->hPCM);	drv->hPCM = NULL;
 		return 0xC8;	// CreateThread failed
 	}
+	OSThread_SetName(drv->hThread, "vgm-alsa");
+	OSThread_SetPriority(drv->hThread, options->threadPrio);
+	OSThread_SetAffinity(drv->hThread, options->threadCPUs);
 	
 	drv->bufSize = drv->waveFmt.nBlockAlign * drv->bufSmpls;
 	drv->bufSpace = (UINT8*)malloc(drv->bufSize);
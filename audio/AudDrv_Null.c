@@ -0,0 +1,606 @@
+// Audio Stream - Null Driver
+//	- discards all data, but requests it at the speed of a simulated audio device
+//	- measures the time spent in the callback, deadline misses and wake-up jitter
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+#include "../stdtype.h"
+
+#include "AudioStream.h"
+#include "AudioStream_SpcDrvFuns.h"
+#include "../utils/OSThread.h"
+#include "../utils/OSSignal.h"
+#include "../utils/OSMutex.h"
+
+
+// histogram for timing values (in ns)
+// Values 0..15 get their own bucket, larger values use 8 buckets per power of 2. (max. error: 12.5%)
+#define HIST_BUCKETS	(16 + (32 - 4) * 8)
+typedef struct _null_histogram
+{
+	UINT32 count[HIST_BUCKETS];
+	UINT32 total;
+	UINT32 maxVal;
+	UINT64 sum;
+} NULL_HIST;
+
+typedef struct _null_driver
+{
+	void* audDrvPtr;
+	volatile UINT8 devState;	// 0 - not running, 1 - running, 2 - terminating
+	
+	UINT32 smplRate;
+	UINT32 smplSize;
+	UINT32 bufSmpls;
+	UINT32 bufSize;
+	UINT32 bufCount;
+	UINT8* bufSpace;
+	UINT32 devRate;	// see NULLDRV_RATE_* constants
+	UINT64 bufPeriod;	// time the device needs for playing one buffer (ns), 0 = unlimited speed
+	
+	OS_THREAD* hThread;
+	OS_SIGNAL* hSignal;
+	OS_MUTEX* hMutex;	// locks the callback and the statistics
+	volatile UINT8 pauseThread;
+	
+	void* userParam;
+	AUDFUNC_FILLBUF FillBuffer;
+	
+	UINT64 statStart;
+	UINT32 callbacks;
+	UINT64 bytes;
+	UINT32 deadlineMisses;
+	UINT64 starvedNS;
+	NULL_HIST histRender;
+	NULL_HIST histWakeup;
+} DRV_NULL;
+
+
+UINT8 NullDrv_IsAvailable(void);
+UINT8 NullDrv_Init(void);
+UINT8 NullDrv_Deinit(void);
+const AUDIO_DEV_LIST* NullDrv_GetDeviceList(void);
+AUDIO_OPTS* NullDrv_GetDefaultOpts(void);
+
+UINT8 NullDrv_Create(void** retDrvObj);
+UINT8 NullDrv_Destroy(void* drvObj);
+UINT8 NullDrv_SetDeviceRate(void* drvObj, UINT32 devRate);
+UINT8 NullDrv_GetStats(void* drvObj, NULLDRV_STATS* stats);
+UINT8 NullDrv_ResetStats(void* drvObj);
+
+UINT8 NullDrv_Start(void* drvObj, UINT32 deviceID, AUDIO_OPTS* options, void* audDrvParam);
+UINT8 NullDrv_Stop(void* drvObj);
+UINT8 NullDrv_Pause(void* drvObj);
+UINT8 NullDrv_Resume(void* drvObj);
+
+UINT8 NullDrv_SetCallback(void* drvObj, AUDFUNC_FILLBUF FillBufCallback, void* userParam);
+UINT32 NullDrv_GetBufferSize(void* drvObj);
+UINT8 NullDrv_IsBusy(void* drvObj);
+UINT8 NullDrv_WriteData(void* drvObj, UINT32 dataSize, void* data);
+
+UINT32 NullDrv_GetLatency(void* drvObj);
+static void NullThread(void* Arg);
+
+static UINT64 GetTimeNS(void);
+static void SleepNS(UINT64 nsec);
+static void Hist_Clear(NULL_HIST* hist);
+static void Hist_Add(NULL_HIST* hist, UINT64 value);
+static UINT32 Hist_Percentile(const NULL_HIST* hist, UINT32 perMille);
+static void Hist_GetStats(const NULL_HIST* hist, NULLDRV_TSTATS* tStats);
+
+
+AUDIO_DRV audDrv_Null =
+{
+	{ADRVTYPE_NULL, ADRVSIG_NULL, "Null"},
+	
+	NullDrv_IsAvailable,
+	NullDrv_Init, NullDrv_Deinit,
+	NullDrv_GetDeviceList, NullDrv_GetDefaultOpts,
+	
+	NullDrv_Create, NullDrv_Destroy,
+	NullDrv_Start, NullDrv_Stop,
+	NullDrv_Pause, NullDrv_Resume,
+	
+	NullDrv_SetCallback, NullDrv_GetBufferSize,
+	NullDrv_IsBusy, NullDrv_WriteData,
+	
+	NullDrv_GetLatency,
+};
+
+
+static char* nullDevNames[1] = {"Null Device"};
+static AUDIO_OPTS defOptions;
+static AUDIO_DEV_LIST deviceList;
+
+static UINT8 isInit = 0;
+static UINT32 activeDrivers;
+
+UINT8 NullDrv_IsAvailable(void)
+{
+	return 1;
+}
+
+UINT8 NullDrv_Init(void)
+{
+	if (isInit)
+		return AERR_WASDONE;
+	
+	deviceList.devCount = 1;
+	deviceList.devNames = nullDevNames;
+	
+	
+	memset(&defOptions, 0x00, sizeof(AUDIO_OPTS));
+	defOptions.sampleRate = 44100;
+	defOptions.numChannels = 2;
+	defOptions.numBitsPerSmpl = 16;
+	defOptions.usecPerBuf = 10000;	// 10 ms per buffer
+	defOptions.numBuffers = 10;	// 100 ms latency
+	
+	
+	activeDrivers = 0;
+	isInit = 1;
+	
+	return AERR_OK;
+}
+
+UINT8 NullDrv_Deinit(void)
+{
+	if (! isInit)
+		return AERR_WASDONE;
+	
+	deviceList.devCount = 0;
+	deviceList.devNames = NULL;
+	
+	isInit = 0;
+	
+	return AERR_OK;
+}
+
+const AUDIO_DEV_LIST* NullDrv_GetDeviceList(void)
+{
+	return &deviceList;
+}
+
+AUDIO_OPTS* NullDrv_GetDefaultOpts(void)
+{
+	return &defOptions;
+}
+
+
+UINT8 NullDrv_Create(void** retDrvObj)
+{
+	DRV_NULL* drv;
+	UINT8 retVal8;
+	
+	drv = (DRV_NULL*)calloc(1, sizeof(DRV_NULL));
+	drv->devState = 0;
+	drv->devRate = NULLDRV_RATE_SMPLRATE;
+	drv->hThread = NULL;
+	drv->hSignal = NULL;
+	drv->hMutex = NULL;
+	drv->userParam = NULL;
+	drv->FillBuffer = NULL;
+	
+	activeDrivers ++;
+	retVal8  = OSSignal_Init(&drv->hSignal, 0);
+	retVal8 |= OSMutex_Init(&drv->hMutex, 0);
+	if (retVal8)
+	{
+		NullDrv_Destroy(drv);
+		*retDrvObj = NULL;
+		return AERR_API_ERR;
+	}
+	*retDrvObj = drv;
+	
+	return AERR_OK;
+}
+
+UINT8 NullDrv_Destroy(void* drvObj)
+{
+	DRV_NULL* drv = (DRV_NULL*)drvObj;
+	
+	if (drv->devState != 0)
+		NullDrv_Stop(drvObj);
+	if (drv->hThread != NULL)
+	{
+		OSThread_Cancel(drv->hThread);
+		OSThread_Deinit(drv->hThread);
+	}
+	if (drv->hSignal != NULL)
+		OSSignal_Deinit(drv->hSignal);
+	if (drv->hMutex != NULL)
+		OSMutex_Deinit(drv->hMutex);
+	
+	free(drv);
+	activeDrivers --;
+	
+	return AERR_OK;
+}
+
+UINT8 NullDrv_SetDeviceRate(void* drvObj, UINT32 devRate)
+{
+	DRV_NULL* drv = (DRV_NULL*)drvObj;
+	
+	if (drv->devState != 0)
+		return AERR_BUSY;	// can only be changed while stopped
+	
+	drv->devRate = devRate;
+	return AERR_OK;
+}
+
+UINT8 NullDrv_GetStats(void* drvObj, NULLDRV_STATS* stats)
+{
+	DRV_NULL* drv = (DRV_NULL*)drvObj;
+	
+	OSMutex_Lock(drv->hMutex);
+	stats->elapsedNS = drv->statStart ? (GetTimeNS() - drv->statStart) : 0;
+	stats->callbacks = drv->callbacks;
+	stats->bytes = drv->bytes;
+	stats->deadlineMisses = drv->deadlineMisses;
+	stats->starvedNS = drv->starvedNS;
+	Hist_GetStats(&drv->histRender, &stats->render);
+	Hist_GetStats(&drv->histWakeup, &stats->wakeup);
+	OSMutex_Unlock(drv->hMutex);
+	
+	return AERR_OK;
+}
+
+UINT8 NullDrv_ResetStats(void* drvObj)
+{
+	DRV_NULL* drv = (DRV_NULL*)drvObj;
+	
+	OSMutex_Lock(drv->hMutex);
+	drv->statStart = (drv->devState == 1) ? GetTimeNS() : 0;
+	drv->callbacks = 0;
+	drv->bytes = 0;
+	drv->deadlineMisses = 0;
+	drv->starvedNS = 0;
+	Hist_Clear(&drv->histRender);
+	Hist_Clear(&drv->histWakeup);
+	OSMutex_Unlock(drv->hMutex);
+	
+	return AERR_OK;
+}
+
+UINT8 NullDrv_Start(void* drvObj, UINT32 deviceID, AUDIO_OPTS* options, void* audDrvParam)
+{
+	DRV_NULL* drv = (DRV_NULL*)drvObj;
+	UINT64 tempInt64;
+	UINT32 clockRate;
+	UINT8 retVal8;
+	
+	if (drv->devState != 0)
+		return AERR_WASDONE;	// already running
+	if (deviceID >= deviceList.devCount)
+		return AERR_INVALID_DEV;
+	
+	drv->audDrvPtr = audDrvParam;
+	if (options == NULL)
+		options = &defOptions;
+	drv->smplRate = options->sampleRate;
+	drv->smplSize = options->numChannels * options->numBitsPerSmpl / 8;
+	if (! drv->smplRate || ! drv->smplSize)
+		return AERR_BAD_MODE;
+	
+	tempInt64 = (UINT64)options->sampleRate * options->usecPerBuf;
+	drv->bufSmpls = (UINT32)((tempInt64 + 500000) / 1000000);
+	if (! drv->bufSmpls)
+		drv->bufSmpls = 1;
+	drv->bufSize = drv->smplSize * drv->bufSmpls;
+	drv->bufCount = options->numBuffers ? options->numBuffers : 10;
+	
+	clockRate = (drv->devRate == NULLDRV_RATE_SMPLRATE) ? drv->smplRate : drv->devRate;
+	if (clockRate == NULLDRV_RATE_UNLIMITED)
+		drv->bufPeriod = 0;
+	else
+		drv->bufPeriod = (UINT64)drv->bufSmpls * 1000000000 / clockRate;
+	
+	drv->bufSpace = (UINT8*)malloc(drv->bufSize);
+	if (drv->bufSpace == NULL)
+		return AERR_API_ERR;
+	NullDrv_ResetStats(drv);
+	
+	OSSignal_Reset(drv->hSignal);
+	retVal8 = OSThread_Init(&drv->hThread, &NullThread, drv);
+	if (retVal8)
+	{
+		free(drv->bufSpace);	drv->bufSpace = NULL;
+		return 0xC8;	// CreateThread failed
+	}
+	OSThread_SetName(drv->hThread, "vgm-null");
+	OSThread_SetPriority(drv->hThread, options->threadPrio);
+	OSThread_SetAffinity(drv->hThread, options->threadCPUs);
+	
+	drv->statStart = GetTimeNS();
+	drv->devState = 1;
+	drv->pauseThread = 0x00;
+	OSSignal_Signal(drv->hSignal);
+	
+	return AERR_OK;
+}
+
+UINT8 NullDrv_Stop(void* drvObj)
+{
+	DRV_NULL* drv = (DRV_NULL*)drvObj;
+	
+	if (drv->devState != 1)
+		return AERR_NOT_OPEN;
+	
+	drv->devState = 2;
+	
+	OSThread_Join(drv->hThread);
+	OSThread_Deinit(drv->hThread);	drv->hThread = NULL;
+	
+	free(drv->bufSpace);	drv->bufSpace = NULL;
+	drv->devState = 0;
+	
+	return AERR_OK;
+}
+
+UINT8 NullDrv_Pause(void* drvObj)
+{
+	DRV_NULL* drv = (DRV_NULL*)drvObj;
+	
+	if (drv->devState != 1)
+		return AERR_NOT_OPEN;
+	
+	drv->pauseThread |= 0x01;
+	return AERR_OK;
+}
+
+UINT8 NullDrv_Resume(void* drvObj)
+{
+	DRV_NULL* drv = (DRV_NULL*)drvObj;
+	
+	if (drv->devState != 1)
+		return AERR_NOT_OPEN;
+	
+	drv->pauseThread &= ~0x01;
+	return AERR_OK;
+}
+
+
+UINT8 NullDrv_SetCallback(void* drvObj, AUDFUNC_FILLBUF FillBufCallback, void* userParam)
+{
+	DRV_NULL* drv = (DRV_NULL*)drvObj;
+	
+	drv->pauseThread |= 0x02;
+	OSMutex_Lock(drv->hMutex);
+	drv->userParam = userParam;
+	drv->FillBuffer = FillBufCallback;
+	drv->pauseThread &= ~0x02;
+	OSMutex_Unlock(drv->hMutex);
+	
+	return AERR_OK;
+}
+
+UINT32 NullDrv_GetBufferSize(void* drvObj)
+{
+	DRV_NULL* drv = (DRV_NULL*)drvObj;
+	
+	return drv->bufSize;
+}
+
+UINT8 NullDrv_IsBusy(void* drvObj)
+{
+	DRV_NULL* drv = (DRV_NULL*)drvObj;
+	
+	if (drv->FillBuffer != NULL)
+		return AERR_BAD_MODE;
+	
+	return AERR_OK;
+}
+
+UINT8 NullDrv_WriteData(void* drvObj, UINT32 dataSize, void* data)
+{
+	DRV_NULL* drv = (DRV_NULL*)drvObj;
+	
+	if (drv->devState != 1)
+		return AERR_NOT_OPEN;
+	if (dataSize > drv->bufSize)
+		return AERR_TOO_MUCH_DATA;
+	
+	// data written directly is just counted
+	OSMutex_Lock(drv->hMutex);
+	drv->bytes += dataSize;
+	OSMutex_Unlock(drv->hMutex);
+	return AERR_OK;
+}
+
+
+UINT32 NullDrv_GetLatency(void* drvObj)
+{
+	DRV_NULL* drv = (DRV_NULL*)drvObj;
+	
+	if (drv->devState != 1 || ! drv->bufPeriod)
+		return 0;
+	
+	return (UINT32)(drv->bufPeriod * drv->bufCount / 1000000);
+}
+
+static void NullThread(void* Arg)
+{
+	DRV_NULL* drv = (DRV_NULL*)Arg;
+	UINT64 devStart;	// time when the virtual device started playing buffer 0
+	UINT64 bufIdx;	// index of the buffer to be rendered next
+	UINT64 pauseStart;
+	UINT64 curTime;
+	
+	OSSignal_Wait(drv->hSignal);	// wait until the initialization is done
+	
+	// The device starts playing after the first buffer period. It has bufCount buffers queued,
+	// so buffer n may be rendered as soon as buffer (n - bufCount) has started playing
+	// and has to be ready when buffer (n - 1) has finished.
+	devStart = GetTimeNS() + drv->bufPeriod;
+	bufIdx = 0;
+	pauseStart = 0;
+	while(drv->devState == 1)
+	{
+		UINT64 deadline;
+		UINT64 renderStart;
+		UINT64 renderEnd;
+		UINT32 bufBytes;
+		
+		if (drv->pauseThread || drv->FillBuffer == NULL)
+		{
+			if (! pauseStart)
+				pauseStart = GetTimeNS();
+			SleepNS(1000000);
+			continue;
+		}
+		if (pauseStart)
+		{
+			// the virtual device doesn't consume data while paused
+			devStart += GetTimeNS() - pauseStart;
+			pauseStart = 0;
+		}
+		
+		deadline = devStart + bufIdx * drv->bufPeriod;
+		if (drv->bufPeriod)
+		{
+			UINT64 readyTime = deadline - drv->bufCount * drv->bufPeriod;
+			
+			curTime = GetTimeNS();
+			if (curTime < readyTime)
+			{
+				SleepNS(readyTime - curTime);
+				curTime = GetTimeNS();
+				OSMutex_Lock(drv->hMutex);
+				Hist_Add(&drv->histWakeup, (curTime > readyTime) ? (curTime - readyTime) : 0);
+				OSMutex_Unlock(drv->hMutex);
+			}
+		}
+		
+		OSMutex_Lock(drv->hMutex);
+		if (drv->FillBuffer == NULL)
+		{
+			OSMutex_Unlock(drv->hMutex);
+			continue;
+		}
+		renderStart = GetTimeNS();
+		bufBytes = drv->FillBuffer(drv->audDrvPtr, drv->userParam, drv->bufSize, drv->bufSpace);
+		renderEnd = GetTimeNS();
+		
+		Hist_Add(&drv->histRender, renderEnd - renderStart);
+		drv->callbacks ++;
+		drv->bytes += bufBytes;
+		if (drv->bufPeriod && renderEnd > deadline)
+		{
+			// The device ran dry and waits for the data to arrive.
+			drv->deadlineMisses ++;
+			drv->starvedNS += renderEnd - deadline;
+			devStart += renderEnd - deadline;
+		}
+		OSMutex_Unlock(drv->hMutex);
+		bufIdx ++;
+	}
+	
+	return;
+}
+
+
+static UINT64 GetTimeNS(void)
+{
+#ifdef _WIN32
+	LARGE_INTEGER freq;
+	LARGE_INTEGER cntr;
+	QueryPerformanceFrequency(&freq);
+	QueryPerformanceCounter(&cntr);
+	return (UINT64)cntr.QuadPart / freq.QuadPart * 1000000000 +
+		(UINT64)cntr.QuadPart % freq.QuadPart * 1000000000 / freq.QuadPart;
+#else
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (UINT64)ts.tv_sec * 1000000000 + ts.tv_nsec;
+#endif
+}
+
+static void SleepNS(UINT64 nsec)
+{
+#ifdef _WIN32
+	Sleep((DWORD)(nsec / 1000000));
+#else
+	struct timespec ts;
+	ts.tv_sec = (time_t)(nsec / 1000000000);
+	ts.tv_nsec = (long)(nsec % 1000000000);
+	nanosleep(&ts, NULL);
+#endif
+	return;
+}
+
+static void Hist_Clear(NULL_HIST* hist)
+{
+	memset(hist, 0x00, sizeof(NULL_HIST));
+	return;
+}
+
+static void Hist_Add(NULL_HIST* hist, UINT64 value)
+{
+	UINT32 val = (value > 0xFFFFFFFF) ? 0xFFFFFFFF : (UINT32)value;
+	UINT32 idx;
+	
+	if (val < 16)
+	{
+		idx = val;
+	}
+	else
+	{
+		UINT8 msb = 4;	// position of the most significant bit
+		while(val >> (msb + 1))
+			msb ++;
+		idx = 16 + (msb - 4) * 8 + ((val >> (msb - 3)) & 7);
+	}
+	hist->count[idx] ++;
+	hist->total ++;
+	hist->sum += val;
+	if (hist->maxVal < val)
+		hist->maxVal = val;
+	
+	return;
+}
+
+static UINT32 Hist_Percentile(const NULL_HIST* hist, UINT32 perMille)
+{
+	UINT32 target;
+	UINT32 cntSum;
+	UINT32 idx;
+	
+	if (! hist->total)
+		return 0;
+	target = (UINT32)(((UINT64)hist->total * perMille + 999) / 1000);
+	cntSum = 0;
+	for (idx = 0; idx < HIST_BUCKETS; idx ++)
+	{
+		cntSum += hist->count[idx];
+		if (cntSum >= target)
+			break;
+	}
+	if (idx < 16)
+		return idx;
+	else
+	{
+		// return the upper end of the bucket
+		UINT8 msb = 4 + (idx - 16) / 8;
+		UINT64 upper = ((UINT64)(8 + (idx - 16) % 8 + 1) << (msb - 3)) - 1;
+		return (upper < hist->maxVal) ? (UINT32)upper : hist->maxVal;
+	}
+}
+
+static void Hist_GetStats(const NULL_HIST* hist, NULLDRV_TSTATS* tStats)
+{
+	tStats->count = hist->total;
+	tStats->avg = hist->total ? (UINT32)(hist->sum / hist->total) : 0;
+	tStats->p50 = Hist_Percentile(hist, 500);
+	tStats->p90 = Hist_Percentile(hist, 900);
+	tStats->p99 = Hist_Percentile(hist, 990);
+	tStats->p999 = Hist_Percentile(hist, 999);
+	tStats->max = hist->maxVal;
+	
+	return;
+}
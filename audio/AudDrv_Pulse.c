@@ -261,6 +261,9 @@ UINT8 Pulse_Start(void* drvObj, UINT32 deviceID, AUDIO_OPTS* options, void* audD
 		pa_simple_free(drv->hPulse);
 		return 0xC8;	// CreateThread failed
 	}
+	OSThread_SetName(drv->hThread, "vgm-pulse");
+	OSThread_SetPriority(drv->hThread, options->threadPrio);
+	OSThread_SetAffinity(drv->hThread, options->threadCPUs);
 	
 	drv->bufSpace = (UINT8*)malloc(drv->bufSize);
 	
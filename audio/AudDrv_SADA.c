@@ -278,6 +278,9 @@ UINT8 SADA_Start(void* drvObj, UINT32 deviceID, AUDIO_OPTS* options, void* audDr
 		drv->hFileDSP = 0;
 		return 0xC8;	// CreateThread failed
 	}
+	OSThread_SetName(drv->hThread, "vgm-sada");
+	OSThread_SetPriority(drv->hThread, options->threadPrio);
+	OSThread_SetAffinity(drv->hThread, options->threadCPUs);
 #endif
 	
 	drv->bufSpace = (UINT8*)malloc(drv->bufSize);
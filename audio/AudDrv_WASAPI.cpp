@@ -223,6 +223,9 @@ UINT8 WASAPI_Init(void)
 	defOptions.numBitsPerSmpl = 16;
 	defOptions.usecPerBuf = 10000;	// 10 ms per buffer
 	defOptions.numBuffers = 10;	// 100 ms latency
+#ifdef NDEBUG
+	defOptions.threadPrio = OSTHRD_PRIO_RT;	// too low priorities cause sound stuttering
+#endif
 	
 	retVal = devEnum->GetDefaultAudioEndpoint(eRender, eConsole, &audDev);
 	if (retVal == S_OK)
@@ -355,10 +358,6 @@ UINT8 WASAPI_Start(void* drvObj, UINT32 deviceID, AUDIO_OPTS* options, void* aud
 	UINT8 errVal;
 	HRESULT retVal;
 	UINT8 retVal8;
-#ifdef NDEBUG
-	HANDLE hWinThr;
-	BOOL retValB;
-#endif
 	
 	if (drv->devState != 0)
 		return 0xD0;	// already running
@@ -424,16 +423,9 @@ UINT8 WASAPI_Start(void* drvObj, UINT32 deviceID, AUDIO_OPTS* options, void* aud
 		errVal = 0xC8;	// CreateThread failed
 		goto StartErr_HasRendClient;
 	}
-#ifdef NDEBUG
-	hWinThr = *(HANDLE*)OSThread_GetHandle(drv->hThread);
-	retValB = SetThreadPriority(hWinThr, THREAD_PRIORITY_TIME_CRITICAL);
-	if (! retValB)
-	{
-		// Error setting priority
-		// Try a lower priority, because too low priorities cause sound stuttering.
-		retValB = SetThreadPriority(hWinThr, THREAD_PRIORITY_HIGHEST);
-	}
-#endif
+	OSThread_SetName(drv->hThread, "vgm-wasapi");
+	OSThread_SetPriority(drv->hThread, options->threadPrio);
+	OSThread_SetAffinity(drv->hThread, options->threadCPUs);
 	
 	retVal = drv->audClnt->Start();
 	
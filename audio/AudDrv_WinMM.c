@@ -163,6 +163,9 @@ UINT8 WinMM_Init(void)
 	defOptions.numBitsPerSmpl = 16;
 	defOptions.usecPerBuf = 10000;	// 10 ms per buffer
 	defOptions.numBuffers = 10;	// 100 ms latency
+#ifdef NDEBUG
+	defOptions.threadPrio = OSTHRD_PRIO_RT;	// too low priorities cause sound stuttering
+#endif
 	
 	
 	activeDrivers = 0;
@@ -259,10 +262,6 @@ UINT8 WinMM_Start(void* drvObj, UINT32 deviceID, AUDIO_OPTS* options, void* audD
 	WAVEHDR* tempWavHdr;
 	MMRESULT retValMM;
 	UINT8 retVal8;
-#ifdef NDEBUG
-	HANDLE hWinThr;
-	BOOL retValB;
-#endif
 	
 	if (drv->devState != 0)
 		return 0xD0;	// already running
@@ -298,16 +297,9 @@ UINT8 WinMM_Start(void* drvObj, UINT32 deviceID, AUDIO_OPTS* options, void* audD
 		drv->hWaveOut = NULL;
 		return 0xC8;	// CreateThread failed
 	}
-#ifdef NDEBUG
-	hWinThr = *(HANDLE*)OSThread_GetHandle(drv->hThread);
-	retValB = SetThreadPriority(hWinThr, THREAD_PRIORITY_TIME_CRITICAL);
-	if (! retValB)
-	{
-		// Error setting priority
-		// Try a lower priority, because too low priorities cause sound stuttering.
-		retValB = SetThreadPriority(hWinThr, THREAD_PRIORITY_HIGHEST);
-	}
-#endif
+	OSThread_SetName(drv->hThread, "vgm-winmm");
+	OSThread_SetPriority(drv->hThread, options->threadPrio);
+	OSThread_SetAffinity(drv->hThread, options->threadCPUs);
 	
 	drv->waveHdrs = (WAVEHDR*)malloc(drv->bufCount * sizeof(WAVEHDR));
 	drv->bufSpace = (UINT8*)malloc(drv->bufCount * drv->bufSize);
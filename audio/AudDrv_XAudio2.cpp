@@ -166,6 +166,9 @@ UINT8 XAudio2_Init(void)
 	defOptions.numBitsPerSmpl = 16;
 	defOptions.usecPerBuf = 10000;	// 10 ms per buffer
 	defOptions.numBuffers = 10;	// 100 ms latency
+#ifdef NDEBUG
+	defOptions.threadPrio = OSTHRD_PRIO_RT;	// too low priorities cause sound stuttering
+#endif
 	
 	
 	activeDrivers = 0;
@@ -265,10 +268,6 @@ UINT8 XAudio2_Start(void* drvObj, UINT32 deviceID, AUDIO_OPTS* options, void* au
 	XAUDIO2_BUFFER* tempXABuf;
 	HRESULT retVal;
 	UINT8 retVal8;
-#ifdef NDEBUG
-	HANDLE hWinThr;
-	BOOL retValB;
-#endif
 	
 	if (drv->devState != 0)
 		return 0xD0;	// already running
@@ -312,16 +311,9 @@ UINT8 XAudio2_Start(void* drvObj, UINT32 deviceID, AUDIO_OPTS* options, void* au
 	retVal8 = OSThread_Init(&drv->hThread, &XAudio2Thread, drv);
 	if (retVal8)
 		return 0xC8;	// CreateThread failed
-#ifdef NDEBUG
-	hWinThr = *(HANDLE*)OSThread_GetHandle(drv->hThread);
-	retValB = SetThreadPriority(hWinThr, THREAD_PRIORITY_TIME_CRITICAL);
-	if (! retValB)
-	{
-		// Error setting priority
-		// Try a lower priority, because too low priorities cause sound stuttering.
-		retValB = SetThreadPriority(hWinThr, THREAD_PRIORITY_HIGHEST);
-	}
-#endif
+	OSThread_SetName(drv->hThread, "vgm-xaudio2");
+	OSThread_SetPriority(drv->hThread, options->threadPrio);
+	OSThread_SetAffinity(drv->hThread, options->threadCPUs);
 	
 	drv->xaBufs = (XAUDIO2_BUFFER*)calloc(drv->bufCount, sizeof(XAUDIO2_BUFFER));
 	drv->bufSpace = (UINT8*)malloc(drv->bufCount * drv->bufSize);
@@ -257,6 +257,9 @@ UINT8 LibAO_Start(void* drvObj, UINT32 deviceID, AUDIO_OPTS* options, void* audD
 		drv->hDevAO = NULL;
 		return 0xC8;	// CreateThread failed
 	}
+	OSThread_SetName(drv->hThread, "vgm-libao");
+	OSThread_SetPriority(drv->hThread, options->threadPrio);
+	OSThread_SetAffinity(drv->hThread, options->threadCPUs);
 	
 	drv->bufSpace = (UINT8*)malloc(drv->bufSize);
 	
@@ -0,0 +1,315 @@
+// Audio Stream - Render-Ahead Buffer
+//	- lock-free single-producer/single-consumer ring buffer, filled by a dedicated render thread
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "../stdtype.h"
+#include "../_stdbool.h"
+
+#include "AudioRenderAhead.h"
+#include "../utils/OSThread.h"
+#include "../utils/OSSignal.h"
+
+// The read/write positions are free-running byte counters. They are only ever written by one thread,
+// so acquire/release semantics are all that is needed for exchanging them.
+#if defined(_MSC_VER)
+#include <windows.h>
+#define ATOMIC_LOAD(ptr)		(UINT32)InterlockedCompareExchange((volatile LONG*)(ptr), 0, 0)
+#define ATOMIC_STORE(ptr, val)	InterlockedExchange((volatile LONG*)(ptr), (LONG)(val))
+#elif defined(__GNUC__)
+#define ATOMIC_LOAD(ptr)		__atomic_load_n(ptr, __ATOMIC_ACQUIRE)
+#define ATOMIC_STORE(ptr, val)	__atomic_store_n(ptr, val, __ATOMIC_RELEASE)
+#else
+#define ATOMIC_LOAD(ptr)		(*(ptr))
+#define ATOMIC_STORE(ptr, val)	(*(ptr) = (val))
+#endif
+
+
+struct _render_ahead
+{
+	UINT8* buffer;
+	UINT32 bufSize;	// power of 2
+	UINT32 bufMask;
+	UINT32 fillLevel;
+	UINT32 blockSize;
+	UINT8* blockBuf;	// used when a block wraps around the end of the ring
+	UINT8 silence;
+	UINT8 threadPrio;
+	UINT64 threadCPUs;
+
+	AUDFUNC_FILLBUF renderFunc;
+	void* userParam;
+	OS_THREAD* hThread;
+	OS_SIGNAL* hSignal;	// wakes up the render thread
+	volatile UINT32 stopThread;
+
+	volatile UINT32 writePos;	// written by the render thread only
+	volatile UINT32 readPos;	// written by the consumer only
+	volatile UINT32 flushGen;	// incremented by RenderAhead_Flush
+	volatile UINT32 flushPos;	// written by the render thread: consumer has to skip everything before this position
+	UINT32 lastFlushPos;	// consumer-side copy of flushPos
+
+	volatile UINT32 underruns;	// statistics are written by the consumer only
+	volatile UINT32 underrunBytes;
+	volatile UINT32 minFillLevel;
+};
+
+
+static UINT32 RenderBlock(RENDER_AHEAD* ra, UINT32 writePos);
+static void RenderThread(void* arg);
+
+
+UINT8 RenderAhead_Init(RENDER_AHEAD** retRA, const RNDAHEAD_OPTS* opts, AUDFUNC_FILLBUF renderFunc, void* userParam)
+{
+	RENDER_AHEAD* ra;
+	UINT32 bufSize;
+	UINT8 retVal;
+
+	if (! opts->blockSize || renderFunc == NULL)
+		return AERR_BAD_MODE;
+	bufSize = (opts->bufSize > opts->blockSize) ? opts->bufSize : opts->blockSize;
+	if (bufSize > 0x40000000)
+		return AERR_BAD_MODE;
+
+	ra = (RENDER_AHEAD*)calloc(1, sizeof(RENDER_AHEAD));
+	if (ra == NULL)
+		return AERR_API_ERR;
+	ra->bufSize = 1;
+	while(ra->bufSize < bufSize)
+		ra->bufSize <<= 1;
+	ra->bufMask = ra->bufSize - 1;
+	ra->fillLevel = (opts->fillLevel && opts->fillLevel < ra->bufSize) ? opts->fillLevel : ra->bufSize;
+	ra->blockSize = opts->blockSize;
+	ra->silence = opts->silence;
+	ra->threadPrio = opts->threadPrio;
+	ra->threadCPUs = opts->threadCPUs;
+	ra->renderFunc = renderFunc;
+	ra->userParam = userParam;
+	ra->hThread = NULL;
+
+	ra->buffer = (UINT8*)malloc(ra->bufSize);
+	ra->blockBuf = (UINT8*)malloc(ra->blockSize);
+	retVal = OSSignal_Init(&ra->hSignal, 0);
+	if (ra->buffer == NULL || ra->blockBuf == NULL || retVal)
+	{
+		if (! retVal)
+			OSSignal_Deinit(ra->hSignal);
+		free(ra->buffer);
+		free(ra->blockBuf);
+		free(ra);
+		return AERR_API_ERR;
+	}
+
+	*retRA = ra;
+	return AERR_OK;
+}
+
+void RenderAhead_Deinit(RENDER_AHEAD* ra)
+{
+	if (ra == NULL)
+		return;
+
+	RenderAhead_Stop(ra);
+	OSSignal_Deinit(ra->hSignal);
+	free(ra->buffer);
+	free(ra->blockBuf);
+	free(ra);
+
+	return;
+}
+
+UINT8 RenderAhead_Start(RENDER_AHEAD* ra)
+{
+	UINT32 writePos;
+	UINT8 retVal;
+
+	if (ra->hThread != NULL)
+		return AERR_WASDONE;
+
+	ra->writePos = 0;
+	ra->readPos = 0;
+	ra->flushPos = 0;
+	ra->lastFlushPos = 0;
+	ra->underruns = 0;
+	ra->underrunBytes = 0;
+	ra->minFillLevel = ra->bufSize;
+
+	// pre-fill the buffer, so that the first reads don't underrun
+	writePos = 0;
+	while(writePos < ra->fillLevel && ra->bufSize - writePos >= ra->blockSize)
+	{
+		UINT32 rendered = RenderBlock(ra, writePos);
+		if (! rendered)
+			break;
+		writePos += rendered;
+	}
+	ra->writePos = writePos;
+
+	ATOMIC_STORE(&ra->stopThread, 0);
+	OSSignal_Reset(ra->hSignal);
+	retVal = OSThread_Init(&ra->hThread, &RenderThread, ra);
+	if (retVal)
+	{
+		ra->hThread = NULL;
+		return AERR_API_ERR;
+	}
+	OSThread_SetName(ra->hThread, "vgm-render");
+	OSThread_SetPriority(ra->hThread, ra->threadPrio);
+	OSThread_SetAffinity(ra->hThread, ra->threadCPUs);
+
+	return AERR_OK;
+}
+
+UINT8 RenderAhead_Stop(RENDER_AHEAD* ra)
+{
+	if (ra->hThread == NULL)
+		return AERR_WASDONE;
+
+	ATOMIC_STORE(&ra->stopThread, 1);
+	OSSignal_Signal(ra->hSignal);
+	OSThread_Join(ra->hThread);
+	OSThread_Deinit(ra->hThread);	ra->hThread = NULL;
+
+	return AERR_OK;
+}
+
+void RenderAhead_Flush(RENDER_AHEAD* ra)
+{
+	// The render thread handles the request, as it knows whether or not its current block is outdated.
+	ATOMIC_STORE(&ra->flushGen, ATOMIC_LOAD(&ra->flushGen) + 1);
+	OSSignal_Signal(ra->hSignal);
+
+	return;
+}
+
+UINT32 RenderAhead_Read(RENDER_AHEAD* ra, UINT32 bufSize, void* data)
+{
+	UINT8* dst = (UINT8*)data;
+	UINT32 flushPos = ATOMIC_LOAD(&ra->flushPos);
+	UINT32 readPos = ra->readPos;
+	UINT32 writePos = ATOMIC_LOAD(&ra->writePos);
+	UINT32 fill;
+	UINT32 copyLen;
+	UINT32 ofs;
+	bool flushed = false;
+
+	if (flushPos != ra->lastFlushPos)
+	{
+		ra->lastFlushPos = flushPos;
+		if ((INT32)(flushPos - readPos) > 0)
+			readPos = flushPos;
+		flushed = true;
+	}
+
+	fill = writePos - readPos;
+	copyLen = (bufSize < fill) ? bufSize : fill;
+	ofs = readPos & ra->bufMask;
+	if (ofs + copyLen <= ra->bufSize)
+	{
+		memcpy(dst, &ra->buffer[ofs], copyLen);
+	}
+	else
+	{
+		UINT32 part1 = ra->bufSize - ofs;
+		memcpy(dst, &ra->buffer[ofs], part1);
+		memcpy(&dst[part1], &ra->buffer[0], copyLen - part1);
+	}
+	ATOMIC_STORE(&ra->readPos, readPos + copyLen);
+	OSSignal_Signal(ra->hSignal);	// let the render thread refill the buffer
+
+	if (copyLen < bufSize)
+	{
+		memset(&dst[copyLen], ra->silence, bufSize - copyLen);
+		if (! flushed)	// a gap right after flushing is expected
+		{
+			ATOMIC_STORE(&ra->underruns, ra->underruns + 1);
+			ATOMIC_STORE(&ra->underrunBytes, ra->underrunBytes + bufSize - copyLen);
+		}
+	}
+	if (! flushed && ra->minFillLevel > fill)
+		ATOMIC_STORE(&ra->minFillLevel, fill);
+
+	return bufSize;
+}
+
+UINT32 RenderAhead_FillBuffer(void* drvStruct, void* userParam, UINT32 bufSize, void* data)
+{
+	return RenderAhead_Read((RENDER_AHEAD*)userParam, bufSize, data);
+}
+
+void RenderAhead_GetStats(const RENDER_AHEAD* ra, RNDAHEAD_STATS* stats)
+{
+	UINT32 readPos = ATOMIC_LOAD(&ra->readPos);
+	UINT32 writePos = ATOMIC_LOAD(&ra->writePos);
+
+	stats->underruns = ATOMIC_LOAD(&ra->underruns);
+	stats->underrunBytes = ATOMIC_LOAD(&ra->underrunBytes);
+	stats->fillLevel = writePos - readPos;
+	stats->minFillLevel = ATOMIC_LOAD(&ra->minFillLevel);
+
+	return;
+}
+
+// renders one block at the write position, returns the number of bytes rendered
+// The data becomes visible to the consumer only after the write position is updated.
+static UINT32 RenderBlock(RENDER_AHEAD* ra, UINT32 writePos)
+{
+	UINT32 ofs = writePos & ra->bufMask;
+	UINT32 rendered;
+
+	if (ofs + ra->blockSize <= ra->bufSize)
+	{
+		rendered = ra->renderFunc(NULL, ra->userParam, ra->blockSize, &ra->buffer[ofs]);
+	}
+	else
+	{
+		UINT32 part1 = ra->bufSize - ofs;
+		rendered = ra->renderFunc(NULL, ra->userParam, ra->blockSize, ra->blockBuf);
+		if (part1 > rendered)
+			part1 = rendered;
+		memcpy(&ra->buffer[ofs], ra->blockBuf, part1);
+		memcpy(&ra->buffer[0], &ra->blockBuf[part1], rendered - part1);
+	}
+
+	return rendered;
+}
+
+static void RenderThread(void* arg)
+{
+	RENDER_AHEAD* ra = (RENDER_AHEAD*)arg;
+	UINT32 flushGen = ATOMIC_LOAD(&ra->flushGen);
+
+	while(! ATOMIC_LOAD(&ra->stopThread))
+	{
+		UINT32 curGen = ATOMIC_LOAD(&ra->flushGen);
+		UINT32 writePos = ra->writePos;
+		UINT32 fill = writePos - ATOMIC_LOAD(&ra->readPos);
+		UINT32 rendered;
+
+		if (curGen != flushGen)
+		{
+			// make the consumer skip everything that was rendered up to now
+			flushGen = curGen;
+			ATOMIC_STORE(&ra->flushPos, writePos);
+			continue;
+		}
+		if (fill >= ra->fillLevel || ra->bufSize - fill < ra->blockSize)
+		{
+			OSSignal_Wait(ra->hSignal);	// wait for the consumer to read some data
+			continue;
+		}
+
+		rendered = RenderBlock(ra, writePos);
+		if (ATOMIC_LOAD(&ra->flushGen) != flushGen)
+			continue;	// The block may contain outdated data. Drop it.
+		if (! rendered)
+		{
+			OSSignal_Wait(ra->hSignal);	// nothing to render at the moment - retry after the next read
+			continue;
+		}
+		ATOMIC_STORE(&ra->writePos, writePos + rendered);
+	}
+
+	return;
+}
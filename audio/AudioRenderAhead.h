@@ -0,0 +1,108 @@
+#ifndef __AUDIORENDERAHEAD_H__
+#define __AUDIORENDERAHEAD_H__
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include "../stdtype.h"
+#include "AudioStructs.h"	// for AUDFUNC_FILLBUF
+
+// Render-Ahead Buffer
+// -------------------
+// Decouples the (possibly expensive) rendering of audio data from the audio driver's output thread.
+// A dedicated render thread calls the render function and keeps a lock-free single-producer/single-consumer
+// ring buffer filled. The audio driver callback then only copies data out of the ring.
+// If the ring runs empty, the missing part is filled with silence and an underrun is counted.
+
+typedef struct _render_ahead RENDER_AHEAD;
+
+typedef struct _render_ahead_options
+{
+	UINT32 bufSize;		// size of the ring buffer in bytes, rounded up to a power of 2
+	UINT32 fillLevel;	// the render thread keeps this many bytes buffered (0 = as much as possible)
+	UINT32 blockSize;	// number of bytes rendered per call of the render function
+	UINT8 silence;		// byte value used for filling gaps (0x80 for 8-bit unsigned samples, else 0x00)
+	UINT8 threadPrio;	// priority class of the render thread, see OSTHRD_PRIO_* in utils/OSThread.h
+	UINT64 threadCPUs;	// CPU affinity mask of the render thread, 0 = no restriction
+} RNDAHEAD_OPTS;
+
+typedef struct _render_ahead_stats
+{
+	UINT32 underruns;		// number of reads that couldn't be served completely
+	UINT32 underrunBytes;	// number of bytes that were filled with silence because of underruns
+	UINT32 fillLevel;		// current number of buffered bytes
+	UINT32 minFillLevel;	// lowest number of buffered bytes seen by a read
+} RNDAHEAD_STATS;
+
+/**
+ * @brief Creates a render-ahead buffer. The render thread is started using RenderAhead_Start().
+ *
+ * @param retRA buffer for returning the render-ahead instance
+ * @param opts buffer options, see RNDAHEAD_OPTS
+ * @param renderFunc render function, called with drvStruct = NULL from the render thread
+ * @param userParam user data that is passed to the render function
+ * @return error code. 0 = success, see AERR constants
+ */
+UINT8 RenderAhead_Init(RENDER_AHEAD** retRA, const RNDAHEAD_OPTS* opts, AUDFUNC_FILLBUF renderFunc, void* userParam);
+/**
+ * @brief Stops the render thread and destroys the render-ahead buffer.
+ *
+ * @param ra render-ahead instance
+ */
+void RenderAhead_Deinit(RENDER_AHEAD* ra);
+/**
+ * @brief Empties the buffer, resets the statistics and starts the render thread.
+ *
+ * @param ra render-ahead instance
+ * @return error code. 0 = success, see AERR constants
+ */
+UINT8 RenderAhead_Start(RENDER_AHEAD* ra);
+/**
+ * @brief Stops the render thread and waits for it to finish.
+ *        Data that is still buffered can be read afterwards, e.g. for playing the end of a song.
+ * @note RenderAhead_Read() must not be called while starting.
+ *
+ * @param ra render-ahead instance
+ * @return error code. 0 = success, see AERR constants
+ */
+UINT8 RenderAhead_Stop(RENDER_AHEAD* ra);
+/**
+ * @brief Discards all data that was rendered up to now, e.g. after seeking. Can be called from any thread.
+ *
+ * @param ra render-ahead instance
+ */
+void RenderAhead_Flush(RENDER_AHEAD* ra);
+/**
+ * @brief Copies buffered data. Must be called by a single consumer thread only.
+ *
+ * @param ra render-ahead instance
+ * @param bufSize number of bytes to be read
+ * @param data buffer that receives the data
+ * @return number of bytes written to data (always bufSize, gaps are filled with silence)
+ */
+UINT32 RenderAhead_Read(RENDER_AHEAD* ra, UINT32 bufSize, void* data);
+/**
+ * @brief Audio driver callback (AUDFUNC_FILLBUF) that reads from a render-ahead buffer.
+ *
+ * @param drvStruct audio driver instance (unused)
+ * @param userParam render-ahead instance
+ * @param bufSize number of bytes to be read
+ * @param data buffer that receives the data
+ * @return number of bytes written to data
+ */
+UINT32 RenderAhead_FillBuffer(void* drvStruct, void* userParam, UINT32 bufSize, void* data);
+/**
+ * @brief Retrieve fill level and underrun statistics.
+ *
+ * @param ra render-ahead instance
+ * @param stats buffer for returning the statistics
+ */
+void RenderAhead_GetStats(const RENDER_AHEAD* ra, RNDAHEAD_STATS* stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif	// __AUDIORENDERAHEAD_H__
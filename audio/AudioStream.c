@@ -14,6 +14,9 @@
 #ifdef AUDDRV_WAVEWRITE
 extern AUDIO_DRV audDrv_WaveWrt;
 #endif
+#ifdef AUDDRV_NULL
+extern AUDIO_DRV audDrv_Null;
+#endif
 
 #ifdef AUDDRV_WINMM
 extern AUDIO_DRV audDrv_WinMM;
@@ -53,6 +56,9 @@ AUDIO_DRV* audDrivers[] =
 #ifdef AUDDRV_WAVEWRITE
 	&audDrv_WaveWrt,
 #endif
+#ifdef AUDDRV_NULL
+	&audDrv_Null,
+#endif
 #ifdef AUDDRV_WINMM
 	&audDrv_WinMM,
 #endif
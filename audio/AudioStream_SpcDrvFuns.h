@@ -16,6 +16,37 @@ UINT8 WavWrt_SetFileName(void* drvObj, const char* fileName);
 const char* WavWrt_GetFileName(void* drvObj);
 #endif
 
+#ifdef AUDDRV_NULL
+#define NULLDRV_RATE_SMPLRATE	0			// the virtual device consumes data at the sample rate (default)
+#define NULLDRV_RATE_UNLIMITED	(UINT32)-1	// request new data as fast as possible
+
+typedef struct _null_driver_time_stats
+{
+	UINT32 count;	// number of measurements
+	UINT32 avg;		// all times are in nanoseconds
+	UINT32 p50;		// percentiles are rounded up to a precision of 12.5%
+	UINT32 p90;
+	UINT32 p99;
+	UINT32 p999;
+	UINT32 max;
+} NULLDRV_TSTATS;
+typedef struct _null_driver_stats
+{
+	UINT64 elapsedNS;		// time since starting the device or resetting the statistics
+	UINT32 callbacks;		// number of FillBuffer callbacks
+	UINT64 bytes;			// number of bytes received
+	UINT32 deadlineMisses;	// number of buffers that weren't ready when the virtual device needed them
+	UINT64 starvedNS;		// total time the virtual device had to wait for data
+	NULLDRV_TSTATS render;	// time spent in the FillBuffer callback
+	NULLDRV_TSTATS wakeup;	// wake-up latency (scheduling jitter) of the driver thread, n/a for unlimited rate
+} NULLDRV_STATS;
+
+// set the rate (in Hz) at which the virtual device consumes samples, can be used only while stopped
+UINT8 NullDrv_SetDeviceRate(void* drvObj, UINT32 devRate);
+UINT8 NullDrv_GetStats(void* drvObj, NULLDRV_STATS* stats);
+UINT8 NullDrv_ResetStats(void* drvObj);
+#endif
+
 #ifdef AUDDRV_DSOUND
 UINT8 DSound_SetHWnd(void* drvObj, HWND hWnd);
 #endif
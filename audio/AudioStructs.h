@@ -16,6 +16,9 @@ typedef struct _audio_options
 	
 	UINT32 usecPerBuf;
 	UINT32 numBuffers;
+	
+	UINT8 threadPrio;		// priority class of the driver's output thread, see OSTHRD_PRIO_* in utils/OSThread.h
+	UINT64 threadCPUs;		// CPU affinity mask of the driver's output thread, 0 = no restriction
 } AUDIO_OPTS;
 
 typedef struct _audio_device_list
@@ -77,6 +80,7 @@ typedef struct _audio_driver
 #define ADRVTYPE_DISK	0x02	// write to disk
 
 #define ADRVSIG_WAVEWRT	0x01	// WAV Writer
+#define ADRVSIG_NULL	0x02	// Null Driver (for benchmarking)
 #define ADRVSIG_WINMM	0x10	// [Windows] WinMM
 #define ADRVSIG_DSOUND	0x11	// [Windows] DirectSound
 #define ADRVSIG_XAUD2	0x12	// [Windows] XAudio2
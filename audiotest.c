@@ -25,6 +25,9 @@ int main(int argc, char* argv[]);
 #ifdef AUDDRV_DSOUND
 static void SetupDirectSound(void* audDrv);
 #endif
+#ifdef AUDDRV_NULL
+static void PrintNullDrvStats(void* audDrv);
+#endif
 static UINT32 FillBuffer(void* drvStruct, void* userParam, UINT32 bufSize, void* Data);
 
 
@@ -211,6 +214,11 @@ int main(int argc, char* argv[])
 			;
 	}
 	printf("Current Latency: %u ms\n", AudioDrv_GetLatency(audDrv));
+#ifdef AUDDRV_NULL
+	Audio_GetDriverInfo(idWavOut, &drvInfo);
+	if (drvInfo->drvSig == ADRVSIG_NULL)
+		PrintNullDrvStats(audDrv);
+#endif
 	
 	retVal = AudioDrv_Stop(audDrv);
 	if (audDrvLog != NULL)
@@ -312,3 +320,24 @@ static void SetupDirectSound(void* audDrv)
 	return;
 }
 #endif
+
+#ifdef AUDDRV_NULL
+static void PrintNullDrvStats(void* audDrv)
+{
+	NULLDRV_STATS stats;
+	const NULLDRV_TSTATS* ts;
+	
+	NullDrv_GetStats(AudioDrv_GetDrvData(audDrv), &stats);
+	printf("Elapsed: %.3f s, Callbacks: %u, Bytes: %llu\n", stats.elapsedNS / 1000000000.0,
+			stats.callbacks, (unsigned long long)stats.bytes);
+	printf("Deadline Misses: %u, Starved: %.3f ms\n", stats.deadlineMisses, stats.starvedNS / 1000000.0);
+	ts = &stats.render;
+	printf("Render Time [us]: avg %.1f, p50 %.1f, p90 %.1f, p99 %.1f, p99.9 %.1f, max %.1f\n",
+			ts->avg / 1000.0, ts->p50 / 1000.0, ts->p90 / 1000.0, ts->p99 / 1000.0, ts->p999 / 1000.0, ts->max / 1000.0);
+	ts = &stats.wakeup;
+	printf("Wakeup Latency [us]: avg %.1f, p50 %.1f, p90 %.1f, p99 %.1f, p99.9 %.1f, max %.1f\n",
+			ts->avg / 1000.0, ts->p50 / 1000.0, ts->p90 / 1000.0, ts->p99 / 1000.0, ts->p999 / 1000.0, ts->max / 1000.0);
+	
+	return;
+}
+#endif
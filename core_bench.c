@@ -0,0 +1,448 @@
+// Sound core throughput benchmark
+// -------------------------------
+// Starts every core of every built-in sound device and drives it with a deterministic register write
+// script (key-ons, pitch sweeps and sample playback from a synthetic ROM), then measures how many times
+// faster than real-time it renders - once at the device's native sample rate and once resampled to
+// 44.1 KHz, the way the players use it.
+// Each test is run several times (-r) and the fastest run is reported, so that warm-up effects and
+// short hiccups of the machine don't show up as regressions. Runs shorter than MIN_RUN_TIME are repeated,
+// as timing a few milliseconds of work isn't reliable.
+// The results can be written as CSV (-m) and a previous CSV run can be passed as baseline (-b).
+// Any core that got slower than the baseline by more than the threshold (-t) makes the program
+// return with exit code 1. Invalid arguments and errors return exit code 2.
+//
+// Usage: libvgm-corebench [-s seconds] [-r runs] [-d device_id] [-c core] [-m] [-b baseline.csv] [-t percent]
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "stdtype.h"
+#include "emu/EmuStructs.h"
+#include "emu/SoundEmu.h"
+#include "emu/SoundDevs.h"
+#include "emu/Resampler.h"
+#include "player/helper.h"
+#include "core_scripts.h"
+
+
+#define OUT_RATE		44100
+#define SMPL_BUF_SIZE	0x400
+#define MAX_CHAIN		4		// maximum number of devices (including linked ones) per benchmark
+#define SILENT_PEAK		0x10	// peak levels below this are reported as "silent"
+#define MIN_RUN_TIME	0.1		// fast cores are rendered repeatedly, so that a run takes at least this long (seconds)
+
+typedef struct _render_state
+{
+	UINT8 resample;
+	UINT32 devCount;
+	VGM_BASEDEV* devs[MAX_CHAIN];
+	UINT64 smplPos[MAX_CHAIN];	// native mode: samples rendered per device
+	UINT64 outPos;				// resampled mode: output samples rendered
+	INT32 peak;
+} RENDER_STATE;
+
+typedef struct _bench_result
+{
+	UINT32 smplRate;
+	double speed;	// real-time multiple
+	INT32 peak;		// peak output level (resampled mode only)
+} BENCH_RESULT;
+
+typedef struct _baseline_entry
+{
+	UINT32 devID;
+	char core[8];
+	char mode[8];
+	double speed;
+} BASELINE_ENTRY;
+
+static double GetTimeSec(void);
+static void RenderTo(void* userParam, UINT64 timeNum, UINT64 timeDen);
+static UINT8 RunBenchmark(const SCRIPT_DEF* sDef, const DEV_DEF* devDef, UINT8 resample, UINT32 seconds, BENCH_RESULT* result);
+static size_t LoadBaseline(const char* fileName, BASELINE_ENTRY** retEntries);
+static const BASELINE_ENTRY* FindBaseline(const BASELINE_ENTRY* entries, size_t count, UINT32 devID, const char* core, const char* mode);
+
+
+static DEV_SMPL smplBufL[SMPL_BUF_SIZE];
+static DEV_SMPL smplBufR[SMPL_BUF_SIZE];
+static WAVE_32BS outBuf[SMPL_BUF_SIZE];
+
+static double GetTimeSec(void)
+{
+#ifdef _WIN32
+	LARGE_INTEGER freq;
+	LARGE_INTEGER cntr;
+	QueryPerformanceFrequency(&freq);
+	QueryPerformanceCounter(&cntr);
+	return (double)cntr.QuadPart / (double)freq.QuadPart;
+#else
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1000000000.0;
+#endif
+}
+
+// render all devices up to the time timeNum/timeDen seconds
+static void RenderTo(void* userParam, UINT64 timeNum, UINT64 timeDen)
+{
+	RENDER_STATE* rState = (RENDER_STATE*)userParam;
+	DEV_SMPL* smplBufs[2];
+	UINT32 curDev;
+	UINT32 curSmpl;
+	UINT32 smplCnt;
+	UINT64 target;
+
+	if (! rState->resample)
+	{
+		smplBufs[0] = smplBufL;
+		smplBufs[1] = smplBufR;
+		for (curDev = 0; curDev < rState->devCount; curDev ++)
+		{
+			DEV_INFO* devInf = &rState->devs[curDev]->defInf;
+			target = timeNum * devInf->sampleRate / timeDen;
+			while(rState->smplPos[curDev] < target)
+			{
+				smplCnt = (target - rState->smplPos[curDev] > SMPL_BUF_SIZE) ?
+					SMPL_BUF_SIZE : (UINT32)(target - rState->smplPos[curDev]);
+				devInf->devDef->Update(devInf->dataPtr, smplCnt, smplBufs);
+				rState->smplPos[curDev] += smplCnt;
+			}
+		}
+	}
+	else
+	{
+		target = timeNum * OUT_RATE / timeDen;
+		while(rState->outPos < target)
+		{
+			smplCnt = (target - rState->outPos > SMPL_BUF_SIZE) ?
+				SMPL_BUF_SIZE : (UINT32)(target - rState->outPos);
+			memset(outBuf, 0x00, smplCnt * sizeof(WAVE_32BS));
+			for (curDev = 0; curDev < rState->devCount; curDev ++)
+				Resmpl_Execute(&rState->devs[curDev]->resmpl, smplCnt, outBuf);
+			for (curSmpl = 0; curSmpl < smplCnt; curSmpl ++)
+			{
+				INT32 smplL = (outBuf[curSmpl].L >= 0) ? outBuf[curSmpl].L : -outBuf[curSmpl].L;
+				INT32 smplR = (outBuf[curSmpl].R >= 0) ? outBuf[curSmpl].R : -outBuf[curSmpl].R;
+				if (rState->peak < smplL)
+					rState->peak = smplL;
+				if (rState->peak < smplR)
+					rState->peak = smplR;
+			}
+			rState->outPos += smplCnt;
+		}
+	}
+
+	return;
+}
+
+static UINT8 RunBenchmark(const SCRIPT_DEF* sDef, const DEV_DEF* devDef, UINT8 resample, UINT32 seconds, BENCH_RESULT* result)
+{
+	SCRIPT_DEV sDev;
+	SCRIPT_POS sPos;
+	RENDER_STATE rState;
+	VGM_BASEDEV* clDev;
+	UINT8 retVal;
+	double startTime;
+
+	retVal = CoreScript_Start(sDef, devDef, resample ? DEVRI_SRMODE_CUSTOM : DEVRI_SRMODE_NATIVE, OUT_RATE, &sDev);
+	if (retVal)
+		return retVal;
+
+	memset(&rState, 0x00, sizeof(RENDER_STATE));
+	rState.resample = resample;
+	for (clDev = &sDev.base; clDev != NULL && rState.devCount < MAX_CHAIN; clDev = clDev->linkDev)
+	{
+		rState.devs[rState.devCount ++] = clDev;
+		if (resample)
+		{
+			Resmpl_SetVals(&clDev->resmpl, RSMODE_LINEAR, 0x100, OUT_RATE);
+			Resmpl_DevConnect(&clDev->resmpl, &clDev->defInf);
+			Resmpl_Init(&clDev->resmpl);
+		}
+	}
+	sDef->init(&sDev);
+
+	memset(&sPos, 0x00, sizeof(SCRIPT_POS));
+	startTime = GetTimeSec();
+	CoreScript_Advance(sDef, &sDev, &sPos, seconds * TICK_RATE, RenderTo, &rState);
+	RenderTo(&rState, seconds, 1);
+	result->speed = seconds / (GetTimeSec() - startTime);
+	result->smplRate = resample ? OUT_RATE : sDev.base.defInf.sampleRate;
+	result->peak = rState.peak;
+
+	FreeDeviceTree(&sDev.base, 0);
+	return 0x00;
+}
+
+// reads a CSV file as written with -m
+static size_t LoadBaseline(const char* fileName, BASELINE_ENTRY** retEntries)
+{
+	FILE* hFile;
+	char line[0x100];
+	BASELINE_ENTRY* entries;
+	size_t entryCnt;
+	size_t entryAlloc;
+
+	hFile = fopen(fileName, "rt");
+	if (hFile == NULL)
+		return (size_t)-1;
+
+	entries = NULL;
+	entryCnt = 0;
+	entryAlloc = 0;
+	while(fgets(line, sizeof(line), hFile) != NULL)
+	{
+		char* fields[8];
+		size_t fieldCnt;
+		char* strPtr;
+
+		fieldCnt = 0;
+		strPtr = line;
+		while(fieldCnt < 8)
+		{
+			fields[fieldCnt ++] = strPtr;
+			strPtr = strchr(strPtr, ',');
+			if (strPtr == NULL)
+				break;
+			*strPtr++ = '\0';
+		}
+		// device_id,device,core,mode,sample_rate,seconds,speed
+		if (fieldCnt < 7 || ! strcmp(fields[0], "device_id"))
+			continue;
+
+		if (entryCnt >= entryAlloc)
+		{
+			entryAlloc += 0x100;
+			entries = (BASELINE_ENTRY*)realloc(entries, entryAlloc * sizeof(BASELINE_ENTRY));
+		}
+		entries[entryCnt].devID = (UINT32)strtoul(fields[0], NULL, 0);
+		strncpy(entries[entryCnt].core, fields[2], sizeof(entries[entryCnt].core) - 1);
+		entries[entryCnt].core[sizeof(entries[entryCnt].core) - 1] = '\0';
+		strncpy(entries[entryCnt].mode, fields[3], sizeof(entries[entryCnt].mode) - 1);
+		entries[entryCnt].mode[sizeof(entries[entryCnt].mode) - 1] = '\0';
+		entries[entryCnt].speed = strtod(fields[6], NULL);
+		entryCnt ++;
+	}
+	fclose(hFile);
+
+	*retEntries = entries;
+	return entryCnt;
+}
+
+static const BASELINE_ENTRY* FindBaseline(const BASELINE_ENTRY* entries, size_t count, UINT32 devID, const char* core, const char* mode)
+{
+	size_t curEntry;
+
+	for (curEntry = 0; curEntry < count; curEntry ++)
+	{
+		const BASELINE_ENTRY* be = &entries[curEntry];
+		if (be->devID == devID && ! strcmp(be->core, core) && ! strcmp(be->mode, mode))
+			return be;
+	}
+	return NULL;
+}
+
+int main(int argc, char* argv[])
+{
+	UINT32 seconds;
+	UINT32 runs;
+	UINT32 devFilter;
+	const char* coreFilter;
+	UINT8 csvOut;
+	const char* baseFile;
+	double threshold;
+	BASELINE_ENTRY* baseEntries;
+	size_t baseCnt;
+	UINT32 regressCnt;
+	int curArg;
+	char* endPtr;
+	const DEV_DECL* const* curDecl;
+
+	seconds = 5;
+	runs = 3;
+	devFilter = (UINT32)-1;
+	coreFilter = NULL;
+	csvOut = 0;
+	baseFile = NULL;
+	threshold = 10.0;
+	endPtr = NULL;
+	for (curArg = 1; curArg < argc; curArg ++)
+	{
+		if (! strcmp(argv[curArg], "-m"))
+			csvOut = 1;
+		else if (curArg + 1 >= argc)
+			break;
+		else if (! strcmp(argv[curArg], "-s"))
+			seconds = (UINT32)strtoul(argv[++ curArg], &endPtr, 0);
+		else if (! strcmp(argv[curArg], "-r"))
+			runs = (UINT32)strtoul(argv[++ curArg], &endPtr, 0);
+		else if (! strcmp(argv[curArg], "-d"))
+			devFilter = (UINT32)strtoul(argv[++ curArg], &endPtr, 0);
+		else if (! strcmp(argv[curArg], "-c"))
+			coreFilter = argv[++ curArg];
+		else if (! strcmp(argv[curArg], "-b"))
+			baseFile = argv[++ curArg];
+		else if (! strcmp(argv[curArg], "-t"))
+			threshold = strtod(argv[++ curArg], &endPtr);
+		else
+			break;
+		// reject numbers with trailing garbage (e.g. "-s 0.5")
+		if (endPtr != NULL && (*endPtr != '\0' || endPtr == argv[curArg]))
+			break;
+		endPtr = NULL;
+	}
+	if (curArg < argc || ! seconds || ! runs || threshold < 0.0)
+	{
+		if (curArg < argc)
+			fprintf(stderr, "Invalid argument: %s\n", argv[curArg]);
+		printf("Sound core throughput benchmark\n");
+		printf("Usage: %s [-s seconds] [-r runs] [-d device_id] [-c core] [-m] [-b baseline.csv] [-t percent]\n", argv[0]);
+		printf("    -s  seconds of audio to render per core and mode (default: 5)\n");
+		printf("    -r  number of runs per core and mode, the fastest one counts (default: 3)\n");
+		printf("    -d  only test the device with this ID (see SoundDevs.h)\n");
+		printf("    -c  only test the core with this four-character code (e.g. MAME)\n");
+		printf("    -m  machine-readable output (CSV)\n");
+		printf("    -b  compare against a CSV file from a previous run, exit code 1 on regressions\n");
+		printf("    -t  allowed slowdown against the baseline in percent (default: 10)\n");
+		return 2;
+	}
+
+	baseEntries = NULL;
+	baseCnt = 0;
+	if (baseFile != NULL)
+	{
+		baseCnt = LoadBaseline(baseFile, &baseEntries);
+		if (baseCnt == (size_t)-1)
+		{
+			fprintf(stderr, "Error opening baseline file %s!\n", baseFile);
+			return 2;
+		}
+	}
+
+	CoreScript_Init();
+
+	if (csvOut)
+	{
+		printf("device_id,device,core,mode,sample_rate,seconds,speed\n");
+	}
+	else
+	{
+		printf("Rendering %u s of audio per core, best of %u runs, results in real-time multiples.\n", seconds, runs);
+		printf("%-4s %-12s %-5s %10s %10s %10s %10s\n", "ID", "Device", "Core", "Rate", "Native", "44100 Hz", "");
+	}
+	regressCnt = 0;
+	for (curDecl = sndEmu_Devices; *curDecl != NULL; curDecl ++)
+	{
+		const DEV_DECL* devDecl = *curDecl;
+		const SCRIPT_DEF* sDef;
+		const DEV_DEF* const* curCore;
+		DEV_GEN_CFG nameCfg;
+		const char* devName;
+
+		if (devFilter != (UINT32)-1 && devDecl->deviceID != devFilter)
+			continue;
+		sDef = CoreScript_GetDef(devDecl->deviceID);
+		memset(&nameCfg, 0x00, sizeof(DEV_GEN_CFG));
+		if (sDef != NULL)
+		{
+			nameCfg.clock = sDef->clock;
+			nameCfg.flags = sDef->flags;
+		}
+		devName = devDecl->name(&nameCfg);
+		if (devName == NULL)
+			devName = "???";
+		if (devDecl->cores[0] == NULL || sDef == NULL)
+		{
+			if (! csvOut)
+				printf("0x%02X %-12s %s\n", devDecl->deviceID, devName,
+					(devDecl->cores[0] == NULL) ? "no cores" : "no benchmark script");
+			continue;
+		}
+
+		for (curCore = devDecl->cores; *curCore != NULL; curCore ++)
+		{
+			const DEV_DEF* devDef = *curCore;
+			BENCH_RESULT results[2];
+			char coreStr[8];
+			UINT8 resample;
+			UINT8 failed;
+
+			CoreScript_FCC2Str(devDef->coreID, coreStr);
+			if (coreFilter != NULL && strcmp(coreFilter, coreStr))
+				continue;
+
+			failed = 0;
+			for (resample = 0; resample < 2; resample ++)
+			{
+				static const char* const MODE_NAMES[2] = {"native", "44100"};
+				const BASELINE_ENTRY* be;
+				UINT32 curRun;
+				UINT8 retVal;
+
+				retVal = 0x00;
+				for (curRun = 0; curRun < runs; curRun ++)
+				{
+					BENCH_RESULT runRes;
+					double audioTime = 0.0;
+					double runTime = 0.0;
+					do
+					{
+						retVal = RunBenchmark(sDef, devDef, resample, seconds, &runRes);
+						if (retVal)
+							break;
+						audioTime += seconds;
+						runTime += seconds / runRes.speed;
+					} while(runTime < MIN_RUN_TIME);
+					if (retVal)
+						break;
+					runRes.speed = audioTime / runTime;
+					if (! curRun || results[resample].speed < runRes.speed)
+						results[resample] = runRes;
+				}
+				if (retVal)
+				{
+					fprintf(stderr, "%s/%s: error 0x%02X starting device\n", devName, coreStr, retVal);
+					failed = 1;
+					break;
+				}
+				if (csvOut)
+				{
+					printf("0x%02X,%s,%s,%s,%u,%u,%.2f\n", devDecl->deviceID, devName, coreStr,
+						MODE_NAMES[resample], results[resample].smplRate, seconds, results[resample].speed);
+					fflush(stdout);
+				}
+				if (resample && results[resample].peak < SILENT_PEAK)
+					fprintf(stderr, "%s/%s: output is silent (peak %d)\n", devName, coreStr, results[resample].peak);
+
+				be = FindBaseline(baseEntries, baseCnt, devDecl->deviceID, coreStr, MODE_NAMES[resample]);
+				if (be != NULL && results[resample].speed < be->speed * (1.0 - threshold / 100.0))
+				{
+					fprintf(stderr, "%s/%s (%s): %.1fx -> %.1fx (%+.1f %%)\n", devName, coreStr, MODE_NAMES[resample],
+						be->speed, results[resample].speed, (results[resample].speed / be->speed - 1.0) * 100.0);
+					regressCnt ++;
+				}
+			}
+			if (failed || csvOut)
+				continue;
+			printf("0x%02X %-12s %-5s %10u %9.1fx %9.1fx %10s\n", devDecl->deviceID, devName, coreStr,
+				results[0].smplRate, results[0].speed, results[1].speed,
+				(results[1].peak < SILENT_PEAK) ? "(silent)" : "");
+			fflush(stdout);
+		}
+	}
+
+	CoreScript_Deinit();
+	free(baseEntries);
+	if (baseFile != NULL)
+	{
+		if (regressCnt)
+			fprintf(stderr, "%u regression(s) above %.1f %%\n", regressCnt, threshold);
+		return regressCnt ? 1 : 0;
+	}
+	return 0;
+}
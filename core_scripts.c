@@ -0,0 +1,2582 @@
+// Sound core register write scripts
+// ---------------------------------
+// A deterministic register write script for every built-in sound device: key-ons, pitch sweeps and
+// sample playback from a synthetic ROM. The scripts only depend on the tick/stream position they are
+// called with, so they can be replayed after restoring a saved device state.
+#include <stdlib.h>
+#include <string.h>
+
+#include "stdtype.h"
+#include "emu/EmuStructs.h"
+#include "emu/SoundEmu.h"
+#include "emu/SoundDevs.h"
+#include "emu/cores/c140.h"
+#include "player/helper.h"
+#include "core_scripts.h"
+
+
+#define NOTE_LEN		16		// script ticks per note
+#define ROM_SIZE		0x100000
+#define SINE_LEN		32		// length of one sine period in the synthetic ROM
+
+static void GenerateSineROM(void);
+static UINT8* PrepareROM(void);
+static void LoadROM(SCRIPT_DEV* sDev, UINT16 memID, UINT32 size);
+static UINT32 NoteSemitone(UINT32 tick, UINT8 chn);
+static UINT32 NoteRatio(UINT32 tick, UINT8 chn);
+static UINT32 NoteFreq(UINT32 base, UINT32 tick, UINT8 chn);
+static UINT32 NotePeriod(UINT32 base, UINT32 tick, UINT8 chn);
+static void FnumBlock(UINT32 freq, UINT8 bits, UINT16* fnum, UINT8* block);
+static void Ratio2OctFn(UINT32 ratio, INT8* octave, UINT16* fnum);
+static void WriteWaveHeader(UINT8* hdr, UINT32 start, UINT16 length);
+static void WriteReg(SCRIPT_DEV* sDev, UINT8 ofs, UINT8 data);
+static void WritePort(SCRIPT_DEV* sDev, UINT8 port, UINT8 reg, UINT8 data);
+static void WriteReg16(SCRIPT_DEV* sDev, UINT16 ofs, UINT8 data);
+static void WriteRegD16(SCRIPT_DEV* sDev, UINT8 ofs, UINT16 data);
+static void WriteReg16D16(SCRIPT_DEV* sDev, UINT16 ofs, UINT16 data);
+
+static void SN76496_Init(SCRIPT_DEV* sDev);
+static void SN76496_Tick(SCRIPT_DEV* sDev, UINT32 tick);
+static void YM2413_Init(SCRIPT_DEV* sDev);
+static void YM2413_Tick(SCRIPT_DEV* sDev, UINT32 tick);
+static void OPN_InitChannel(SCRIPT_DEV* sDev, UINT8 port, UINT8 chn);
+static void OPN_TickChannel(SCRIPT_DEV* sDev, UINT8 port, UINT8 chn, UINT32 tick, UINT8 note);
+static void SSG_Init(SCRIPT_DEV* sDev, UINT8 port);
+static void SSG_Tick(SCRIPT_DEV* sDev, UINT8 port, UINT32 tick, UINT32 base);
+static void YM2612_Init(SCRIPT_DEV* sDev);
+static void YM2612_Tick(SCRIPT_DEV* sDev, UINT32 tick);
+static void YM2612_Stream(SCRIPT_DEV* sDev, UINT32 pos);
+static void YM2203_Init(SCRIPT_DEV* sDev);
+static void YM2203_Tick(SCRIPT_DEV* sDev, UINT32 tick);
+static void YM2608_Init(SCRIPT_DEV* sDev);
+static void YM2608_Tick(SCRIPT_DEV* sDev, UINT32 tick);
+static void YM2610_Init(SCRIPT_DEV* sDev);
+static void YM2610_Tick(SCRIPT_DEV* sDev, UINT32 tick);
+static void OPM_Init(SCRIPT_DEV* sDev, UINT8 opz);
+static void OPM_Tick(SCRIPT_DEV* sDev, UINT32 tick, UINT8 opz);
+static void YM2151_Init(SCRIPT_DEV* sDev);
+static void YM2151_Tick(SCRIPT_DEV* sDev, UINT32 tick);
+static void YM2414_Init(SCRIPT_DEV* sDev);
+static void YM2414_Tick(SCRIPT_DEV* sDev, UINT32 tick);
+static void OPL_InitChannel(SCRIPT_DEV* sDev, UINT8 port, UINT8 chn);
+static void OPL_TickChannel(SCRIPT_DEV* sDev, UINT8 port, UINT8 chn, UINT32 tick, UINT8 note);
+static void OPL2_Init(SCRIPT_DEV* sDev);
+static void OPL2_Tick(SCRIPT_DEV* sDev, UINT32 tick);
+static void Y8950_Init(SCRIPT_DEV* sDev);
+static void Y8950_Tick(SCRIPT_DEV* sDev, UINT32 tick);
+static void OPL3_Init(SCRIPT_DEV* sDev);
+static void OPL3_Tick(SCRIPT_DEV* sDev, UINT32 tick);
+static void YMF278B_Init(SCRIPT_DEV* sDev);
+static void YMF278B_Tick(SCRIPT_DEV* sDev, UINT32 tick);
+static void YMF271_Init(SCRIPT_DEV* sDev);
+static void YMF271_Tick(SCRIPT_DEV* sDev, UINT32 tick);
+static void YMZ280B_Init(SCRIPT_DEV* sDev);
+static void YMZ280B_Tick(SCRIPT_DEV* sDev, UINT32 tick);
+static void SegaPCM_Init(SCRIPT_DEV* sDev);
+static void SegaPCM_Tick(SCRIPT_DEV* sDev, UINT32 tick);
+static void RF5C68_Init(SCRIPT_DEV* sDev);
+static void RF5C68_Tick(SCRIPT_DEV* sDev, UINT32 tick);
+static void PWM_Init(SCRIPT_DEV* sDev);
+static void PWM_Tick(SCRIPT_DEV* sDev, UINT32 tick);
+static void PWM_Stream(SCRIPT_DEV* sDev, UINT32 pos);
+static void AY8910_Init(SCRIPT_DEV* sDev);
+static void AY8910_Tick(SCRIPT_DEV* sDev, UINT32 tick);
+static void GB_Init(SCRIPT_DEV* sDev);
+static void GB_Tick(SCRIPT_DEV* sDev, UINT32 tick);
+static void NES_Init(SCRIPT_DEV* sDev);
+static void NES_Tick(SCRIPT_DEV* sDev, UINT32 tick);
+static void MultiPCM_Write(SCRIPT_DEV* sDev, UINT8 slot, UINT8 reg, UINT8 data);
+static void MultiPCM_Init(SCRIPT_DEV* sDev);
+static void MultiPCM_Tick(SCRIPT_DEV* sDev, UINT32 tick);
+static void UPD7759_Init(SCRIPT_DEV* sDev);
+static void UPD7759_Tick(SCRIPT_DEV* sDev, UINT32 tick);
+static void MSM6258_Init(SCRIPT_DEV* sDev);
+static void MSM6258_Tick(SCRIPT_DEV* sDev, UINT32 tick);
+static void MSM6258_Stream(SCRIPT_DEV* sDev, UINT32 pos);
+static void OKIM6295_Init(SCRIPT_DEV* sDev);
+static void OKIM6295_Tick(SCRIPT_DEV* sDev, UINT32 tick);
+static void K051649_Init(SCRIPT_DEV* sDev);
+static void K051649_Tick(SCRIPT_DEV* sDev, UINT32 tick);
+static void K054539_Init(SCRIPT_DEV* sDev);
+static void K054539_Tick(SCRIPT_DEV* sDev, UINT32 tick);
+static void C6280_Init(SCRIPT_DEV* sDev);
+static void C6280_Tick(SCRIPT_DEV* sDev, UINT32 tick);
+static void C140_Init(SCRIPT_DEV* sDev);
+static void C140_Tick(SCRIPT_DEV* sDev, UINT32 tick);
+static void C219_Init(SCRIPT_DEV* sDev);
+static void C219_Tick(SCRIPT_DEV* sDev, UINT32 tick);
+static void K053260_Init(SCRIPT_DEV* sDev);
+static void K053260_Tick(SCRIPT_DEV* sDev, UINT32 tick);
+static void Pokey_Init(SCRIPT_DEV* sDev);
+static void Pokey_Tick(SCRIPT_DEV* sDev, UINT32 tick);
+static void QSound_Write(SCRIPT_DEV* sDev, UINT8 reg, UINT16 data);
+static void QSound_Init(SCRIPT_DEV* sDev);
+static void QSound_Tick(SCRIPT_DEV* sDev, UINT32 tick);
+static void SCSP_Init(SCRIPT_DEV* sDev);
+static void SCSP_Tick(SCRIPT_DEV* sDev, UINT32 tick);
+static void WSwan_Init(SCRIPT_DEV* sDev);
+static void WSwan_Tick(SCRIPT_DEV* sDev, UINT32 tick);
+static void VSU_Init(SCRIPT_DEV* sDev);
+static void VSU_Tick(SCRIPT_DEV* sDev, UINT32 tick);
+static void SAA1099_Write(SCRIPT_DEV* sDev, UINT8 reg, UINT8 data);
+static void SAA1099_Init(SCRIPT_DEV* sDev);
+static void SAA1099_Tick(SCRIPT_DEV* sDev, UINT32 tick);
+static void ES5503_Init(SCRIPT_DEV* sDev);
+static void ES5503_Tick(SCRIPT_DEV* sDev, UINT32 tick);
+static void X1_010_Init(SCRIPT_DEV* sDev);
+static void X1_010_Tick(SCRIPT_DEV* sDev, UINT32 tick);
+static void C352_Init(SCRIPT_DEV* sDev);
+static void C352_Tick(SCRIPT_DEV* sDev, UINT32 tick);
+static void GA20_Init(SCRIPT_DEV* sDev);
+static void GA20_Tick(SCRIPT_DEV* sDev, UINT32 tick);
+static void Mikey_Init(SCRIPT_DEV* sDev);
+static void Mikey_Tick(SCRIPT_DEV* sDev, UINT32 tick);
+static void K007232_Init(SCRIPT_DEV* sDev);
+static void K007232_Tick(SCRIPT_DEV* sDev, UINT32 tick);
+static void K005289_Init(SCRIPT_DEV* sDev);
+static void K005289_Tick(SCRIPT_DEV* sDev, UINT32 tick);
+static void MSM5205_Init(SCRIPT_DEV* sDev);
+static void MSM5205_Tick(SCRIPT_DEV* sDev, UINT32 tick);
+static void MSM5205_Stream(SCRIPT_DEV* sDev, UINT32 pos);
+static void MSM5232_Init(SCRIPT_DEV* sDev);
+static void MSM5232_Tick(SCRIPT_DEV* sDev, UINT32 tick);
+static void BSMT2000_Write(SCRIPT_DEV* sDev, UINT8 reg, UINT16 data);
+static void BSMT2000_Init(SCRIPT_DEV* sDev);
+static void BSMT2000_Tick(SCRIPT_DEV* sDev, UINT32 tick);
+static void ICS2115_Write(SCRIPT_DEV* sDev, UINT8 reg, UINT8 highByte, UINT8 data);
+static void ICS2115_Init(SCRIPT_DEV* sDev);
+static void ICS2115_Tick(SCRIPT_DEV* sDev, UINT32 tick);
+
+static void CoreScript_SetupConfig(SCRIPT_CFG* cfg, const SCRIPT_DEF* sDef);
+static void CoreScript_SampleRateChange(void* userParam, UINT32 newSRate);
+
+
+static UINT8* sineROM;	// signed 8-bit sine wave, never 0x00/0x80/0xFF (some chips use those as markers)
+static UINT8* romData;	// working copy that gets patched by the device scripts
+
+// quarter wave of the ROM sine, amplitude 100
+static const UINT8 SINE_QUARTER[SINE_LEN / 4 + 1] = {0, 20, 38, 56, 71, 83, 92, 98, 100};
+// melody (in semitones) and chord offsets for each channel
+static const UINT8 NOTE_SEQ[8] = {0, 4, 7, 12, 7, 4, 2, 5};
+static const UINT8 NOTE_CHORD[4] = {0, 4, 7, 12};
+// semitone ratios (16.16 fixed point)
+static const UINT32 SEMITONE[13] =
+{
+	65536, 69433, 73562, 77936, 82570, 87480, 92682, 98193, 104032, 110218, 116772, 123715, 131072,
+};
+// OPM key codes, starting with C#
+static const UINT8 OPM_NOTES[12] = {0x0, 0x1, 0x2, 0x4, 0x5, 0x6, 0x8, 0x9, 0xA, 0xC, 0xD, 0xE};
+// OPL operator offsets for each channel
+static const UINT8 OPL_SLOTS[9] = {0x00, 0x01, 0x02, 0x08, 0x09, 0x0A, 0x10, 0x11, 0x12};
+// OPN operator offsets (algorithm 4: slot 2 and 4 are carriers)
+static const UINT8 OPN_SLOTS[4] = {0x00, 0x04, 0x08, 0x0C};
+
+static void GenerateSineROM(void)
+{
+	UINT32 curPos;
+	UINT32 phase;
+	INT32 smpl;
+
+	for (curPos = 0; curPos < ROM_SIZE; curPos ++)
+	{
+		phase = curPos % SINE_LEN;
+		if (phase < SINE_LEN / 4)
+			smpl = SINE_QUARTER[phase];
+		else if (phase < SINE_LEN / 2)
+			smpl = SINE_QUARTER[SINE_LEN / 2 - phase];
+		else if (phase < SINE_LEN * 3 / 4)
+			smpl = -SINE_QUARTER[phase - SINE_LEN / 2];
+		else
+			smpl = -SINE_QUARTER[SINE_LEN - phase];
+		// skip 0, so that no sample becomes 0x00, 0x80 or 0xFF after sign conversion
+		smpl = (smpl >= 0) ? (smpl + 1) : (smpl - 1);
+		sineROM[curPos] = (UINT8)(INT8)smpl;
+	}
+
+	return;
+}
+
+static UINT8* PrepareROM(void)
+{
+	memcpy(romData, sineROM, ROM_SIZE);
+	return romData;
+}
+
+// Transfers the first "size" bytes of romData to the device. (ROMs get resized first, RAMs have a fixed size.)
+static void LoadROM(SCRIPT_DEV* sDev, UINT16 memID, UINT32 size)
+{
+	const DEV_DEF* devDef = sDev->base.defInf.devDef;
+	void* dataPtr = sDev->base.defInf.dataPtr;
+	DEVFUNC_WRITE_MEMSIZE romSize;
+	DEVFUNC_WRITE_BLOCK romWrite;
+	UINT8 retVal;
+
+	retVal = SndEmu_GetDeviceFunc(devDef, RWF_MEMORY | RWF_WRITE, DEVRW_MEMSIZE, memID, (void**)&romSize);
+	if (! retVal)
+		romSize(dataPtr, size);
+	retVal = SndEmu_GetDeviceFunc(devDef, RWF_MEMORY | RWF_WRITE, DEVRW_BLOCK, memID, (void**)&romWrite);
+	if (! retVal)
+		romWrite(dataPtr, 0x00, size, romData);
+
+	return;
+}
+
+void CoreScript_FCC2Str(UINT32 fcc, char* buffer)
+{
+	UINT8 curChr;
+	char* strPtr = buffer;
+
+	for (curChr = 0; curChr < 4; curChr ++)
+	{
+		char c = (char)((fcc >> ((3 - curChr) * 8)) & 0xFF);
+		if (c != '\0')
+			*strPtr++ = c;
+	}
+	*strPtr = '\0';
+
+	return;
+}
+
+static UINT32 NoteSemitone(UINT32 tick, UINT8 chn)
+{
+	return NOTE_SEQ[(tick / NOTE_LEN) % 8] + NOTE_CHORD[chn % 4];
+}
+
+// frequency ratio (16.16 fixed point) of the current note, including a slight upwards pitch sweep
+static UINT32 NoteRatio(UINT32 tick, UINT8 chn)
+{
+	UINT32 semi = NoteSemitone(tick, chn);
+	UINT32 ratio = SEMITONE[semi % 12] << (semi / 12);
+
+	return (UINT32)(((UINT64)ratio * (256 + tick % NOTE_LEN)) >> 8);
+}
+
+static UINT32 NoteFreq(UINT32 base, UINT32 tick, UINT8 chn)
+{
+	return (UINT32)(((UINT64)base * NoteRatio(tick, chn)) >> 16);
+}
+
+static UINT32 NotePeriod(UINT32 base, UINT32 tick, UINT8 chn)
+{
+	return (UINT32)(((UINT64)base << 16) / NoteRatio(tick, chn));
+}
+
+// split a frequency value (fnum << block) into F-Number and block
+static void FnumBlock(UINT32 freq, UINT8 bits, UINT16* fnum, UINT8* block)
+{
+	*block = 0;
+	while(freq >= (1U << bits))
+	{
+		freq >>= 1;
+		(*block) ++;
+	}
+	*fnum = (UINT16)freq;
+
+	return;
+}
+
+// convert a frequency ratio (16.16 fixed point) into OPL4/MultiPCM/SCSP style octave + 10-bit F-Number
+static void Ratio2OctFn(UINT32 ratio, INT8* octave, UINT16* fnum)
+{
+	*octave = 0;
+	while(ratio >= 0x20000)
+	{
+		ratio >>= 1;
+		(*octave) ++;
+	}
+	while(ratio < 0x10000)
+	{
+		ratio <<= 1;
+		(*octave) --;
+	}
+	*fnum = (UINT16)((ratio - 0x10000) >> 6);
+
+	return;
+}
+
+// OPL4/MultiPCM sample header: 8-bit sample, looping over its whole length
+static void WriteWaveHeader(UINT8* hdr, UINT32 start, UINT16 length)
+{
+	hdr[0] = (start >> 16) & 0x3F;
+	hdr[1] = (start >> 8) & 0xFF;
+	hdr[2] = (start >> 0) & 0xFF;
+	hdr[3] = 0x00;	// loop start
+	hdr[4] = 0x00;
+	hdr[5] = ((0x10000 - length) >> 8) & 0xFF;	// end address (negated)
+	hdr[6] = ((0x10000 - length) >> 0) & 0xFF;
+	hdr[7] = 0x00;	// LFO/vibrato
+	hdr[8] = 0xF0;	// AR/D1R
+	hdr[9] = 0x00;	// DL/D2R
+	hdr[10] = 0x05;	// rate correction/RR
+	hdr[11] = 0x00;	// AM
+
+	return;
+}
+
+static void WriteReg(SCRIPT_DEV* sDev, UINT8 ofs, UINT8 data)
+{
+	sDev->write8(sDev->base.defInf.dataPtr, ofs, data);
+	return;
+}
+
+// Yamaha-style address/data port pair
+static void WritePort(SCRIPT_DEV* sDev, UINT8 port, UINT8 reg, UINT8 data)
+{
+	sDev->write8(sDev->base.defInf.dataPtr, port * 2 + 0, reg);
+	sDev->write8(sDev->base.defInf.dataPtr, port * 2 + 1, data);
+	return;
+}
+
+static void WriteReg16(SCRIPT_DEV* sDev, UINT16 ofs, UINT8 data)
+{
+	sDev->write16(sDev->base.defInf.dataPtr, ofs, data);
+	return;
+}
+
+static void WriteRegD16(SCRIPT_DEV* sDev, UINT8 ofs, UINT16 data)
+{
+	sDev->write8d16(sDev->base.defInf.dataPtr, ofs, data);
+	return;
+}
+
+static void WriteReg16D16(SCRIPT_DEV* sDev, UINT16 ofs, UINT16 data)
+{
+	sDev->write16d16(sDev->base.defInf.dataPtr, ofs, data);
+	return;
+}
+
+
+// --- PSGs ---
+static void SN76496_Init(SCRIPT_DEV* sDev)
+{
+	UINT8 curChn;
+
+	for (curChn = 0; curChn < 4; curChn ++)
+		WriteReg(sDev, 0x00, 0x9F | (curChn << 5));
+
+	return;
+}
+
+static void SN76496_Tick(SCRIPT_DEV* sDev, UINT32 tick)
+{
+	UINT8 curChn;
+	UINT8 atten = (UINT8)((tick % NOTE_LEN) / 2);
+
+	for (curChn = 0; curChn < 3; curChn ++)
+	{
+		UINT32 period = NotePeriod(0x1FC, tick, curChn);
+		WriteReg(sDev, 0x00, 0x80 | (curChn << 5) | (period & 0x0F));
+		WriteReg(sDev, 0x00, (period >> 4) & 0x3F);
+		WriteReg(sDev, 0x00, 0x90 | (curChn << 5) | atten);
+	}
+	if (! (tick % NOTE_LEN))
+		WriteReg(sDev, 0x00, 0xE4 | ((tick / NOTE_LEN) % 3));	// white noise
+	WriteReg(sDev, 0x00, 0xF4 | (atten >> 1));
+
+	return;
+}
+
+static void SSG_Init(SCRIPT_DEV* sDev, UINT8 port)
+{
+	UINT8 curChn;
+
+	WritePort(sDev, port, 0x07, 0x18);	// tone on all channels, noise on channel C
+	for (curChn = 0; curChn < 3; curChn ++)
+		WritePort(sDev, port, 0x08 + curChn, 0x0F);
+
+	return;
+}
+
+static void SSG_Tick(SCRIPT_DEV* sDev, UINT8 port, UINT32 tick, UINT32 base)
+{
+	UINT8 curChn;
+
+	for (curChn = 0; curChn < 3; curChn ++)
+	{
+		UINT32 period = NotePeriod(base, tick, curChn);
+		WritePort(sDev, port, curChn * 2 + 0, period & 0xFF);
+		WritePort(sDev, port, curChn * 2 + 1, (period >> 8) & 0x0F);
+		WritePort(sDev, port, 0x08 + curChn, 0x0F - (tick % NOTE_LEN) / 2);
+	}
+	if (! (tick % NOTE_LEN))
+		WritePort(sDev, port, 0x06, (tick / NOTE_LEN) & 0x1F);
+
+	return;
+}
+
+static void AY8910_Init(SCRIPT_DEV* sDev)
+{
+	SSG_Init(sDev, 0);
+	return;
+}
+
+static void AY8910_Tick(SCRIPT_DEV* sDev, UINT32 tick)
+{
+	SSG_Tick(sDev, 0, tick, 0x1FC);
+	return;
+}
+
+static void GB_Init(SCRIPT_DEV* sDev)
+{
+	UINT8 curPos;
+
+	WriteReg(sDev, 0x16, 0x80);	// NR52: sound on
+	WriteReg(sDev, 0x14, 0x77);	// NR50: master volume
+	WriteReg(sDev, 0x15, 0xFF);	// NR51: all channels to both speakers
+	WriteReg(sDev, 0x00, 0x00);	// NR10: no sweep
+	WriteReg(sDev, 0x01, 0x80);	// NR11: 50% duty
+	WriteReg(sDev, 0x06, 0x40);	// NR21: 25% duty
+	for (curPos = 0; curPos < 0x10; curPos ++)
+		WriteReg(sDev, 0x20 + curPos, ((sineROM[curPos * 2 + 0] + 0x80) & 0xF0) | ((sineROM[curPos * 2 + 1] + 0x80) >> 4));
+	WriteReg(sDev, 0x0A, 0x80);	// NR30: wave channel on
+	WriteReg(sDev, 0x0B, 0x00);	// NR31: length
+	WriteReg(sDev, 0x0C, 0x20);	// NR32: full volume
+	WriteReg(sDev, 0x10, 0x00);	// NR41: length
+	WriteReg(sDev, 0x12, 0x55);	// NR43: noise frequency
+
+	return;
+}
+
+static void GB_Tick(SCRIPT_DEV* sDev, UINT32 tick)
+{
+	UINT8 trigger = (tick % NOTE_LEN) ? 0x00 : 0x80;
+	UINT32 freq;
+
+	if (trigger)
+	{
+		WriteReg(sDev, 0x02, 0xF3);	// NR12: volume 15, decay
+		WriteReg(sDev, 0x07, 0xC3);	// NR22
+		WriteReg(sDev, 0x11, 0xA2);	// NR42
+		WriteReg(sDev, 0x13, 0x80);	// NR44: trigger noise
+	}
+	freq = 2048 - NotePeriod(595, tick, 0);
+	WriteReg(sDev, 0x03, freq & 0xFF);
+	WriteReg(sDev, 0x04, trigger | ((freq >> 8) & 0x07));
+	freq = 2048 - NotePeriod(595, tick, 1);
+	WriteReg(sDev, 0x08, freq & 0xFF);
+	WriteReg(sDev, 0x09, trigger | ((freq >> 8) & 0x07));
+	freq = 2048 - NotePeriod(596, tick, 2);
+	WriteReg(sDev, 0x0D, freq & 0xFF);
+	WriteReg(sDev, 0x0E, trigger | ((freq >> 8) & 0x07));
+
+	return;
+}
+
+static void NES_Init(SCRIPT_DEV* sDev)
+{
+	DEVFUNC_WRITE_BLOCK ramWrite;
+	UINT8 curPos;
+
+	// DPCM data is read from CPU address 0xC000
+	if (! SndEmu_GetDeviceFunc(sDev->base.defInf.devDef, RWF_MEMORY | RWF_WRITE, DEVRW_BLOCK, 0, (void**)&ramWrite))
+		ramWrite(sDev->base.defInf.dataPtr, 0xC000, 0x1000, sineROM);
+
+	WriteReg(sDev, 0x15, 0x0F);
+	WriteReg(sDev, 0x00, 0xBF);	// pulse 1: 50% duty, constant volume 15
+	WriteReg(sDev, 0x01, 0x08);	// no sweep
+	WriteReg(sDev, 0x04, 0x7F);	// pulse 2: 25% duty
+	WriteReg(sDev, 0x05, 0x08);
+	WriteReg(sDev, 0x08, 0xFF);	// triangle: linear counter
+	WriteReg(sDev, 0x0C, 0x3F);	// noise: constant volume 15
+	WriteReg(sDev, 0x10, 0x4F);	// DPCM: loop, highest rate
+	WriteReg(sDev, 0x12, 0x00);	// address 0xC000
+	WriteReg(sDev, 0x13, 0xFF);	// length 0xFF1 bytes
+
+	// FDS: upload a sine wave
+	WriteReg(sDev, 0x23, 0x02);
+	WriteReg(sDev, 0x89, 0x80);
+	for (curPos = 0; curPos < 0x40; curPos ++)
+		WriteReg(sDev, 0x40 + curPos, (sineROM[curPos * SINE_LEN / 0x40] + 0x80) >> 2);
+	WriteReg(sDev, 0x89, 0x00);
+	WriteReg(sDev, 0x80, 0xA0);	// direct volume
+
+	return;
+}
+
+static void NES_Tick(SCRIPT_DEV* sDev, UINT32 tick)
+{
+	UINT32 period;
+
+	if (! (tick % NOTE_LEN))
+	{
+		WriteReg(sDev, 0x15, 0x1F);	// restart DPCM
+		WriteReg(sDev, 0x0E, (tick / NOTE_LEN) & 0x0F);
+		WriteReg(sDev, 0x0F, 0xF8);
+	}
+	period = NotePeriod(508, tick, 0) - 1;
+	WriteReg(sDev, 0x02, period & 0xFF);
+	if (! (tick % NOTE_LEN))
+		WriteReg(sDev, 0x03, 0xF8 | ((period >> 8) & 0x07));
+	period = NotePeriod(508, tick, 1) - 1;
+	WriteReg(sDev, 0x06, period & 0xFF);
+	if (! (tick % NOTE_LEN))
+		WriteReg(sDev, 0x07, 0xF8 | ((period >> 8) & 0x07));
+	period = NotePeriod(254, tick, 2) - 1;
+	WriteReg(sDev, 0x0A, period & 0xFF);
+	WriteReg(sDev, 0x0B, 0xF8 | ((period >> 8) & 0x07));
+	period = NoteFreq(515, tick, 3);
+	WriteReg(sDev, 0x82, period & 0xFF);
+	WriteReg(sDev, 0x83, (period >> 8) & 0x0F);
+
+	return;
+}
+
+static void K051649_Init(SCRIPT_DEV* sDev)
+{
+	UINT8 curChn;
+	UINT8 curPos;
+
+	for (curChn = 0; curChn < 4; curChn ++)
+	{
+		for (curPos = 0; curPos < 32; curPos ++)
+			WritePort(sDev, 0, curChn * 32 + curPos, sineROM[curPos * SINE_LEN / 32] >> (curChn & 1));
+	}
+	for (curChn = 0; curChn < 5; curChn ++)
+		WritePort(sDev, 2, curChn, 0x0F);
+	WritePort(sDev, 3, 0x00, 0x1F);
+
+	return;
+}
+
+static void K051649_Tick(SCRIPT_DEV* sDev, UINT32 tick)
+{
+	UINT8 curChn;
+
+	for (curChn = 0; curChn < 5; curChn ++)
+	{
+		UINT32 period = NotePeriod(0xFE, tick, curChn);
+		WritePort(sDev, 1, curChn * 2 + 0, period & 0xFF);
+		WritePort(sDev, 1, curChn * 2 + 1, (period >> 8) & 0x0F);
+		WritePort(sDev, 2, curChn, 0x0F - (tick % NOTE_LEN) / 2);
+	}
+
+	return;
+}
+
+static void C6280_Init(SCRIPT_DEV* sDev)
+{
+	UINT8 curChn;
+	UINT8 curPos;
+
+	WriteReg(sDev, 0x01, 0xFF);	// main balance
+	for (curChn = 0; curChn < 6; curChn ++)
+	{
+		WriteReg(sDev, 0x00, curChn);
+		WriteReg(sDev, 0x04, 0x00);	// reset wave index
+		for (curPos = 0; curPos < 32; curPos ++)
+			WriteReg(sDev, 0x06, (sineROM[curPos * SINE_LEN / 32] + 0x80) >> 3);
+		WriteReg(sDev, 0x05, 0xFF);
+		WriteReg(sDev, 0x04, 0x9F);
+	}
+	WriteReg(sDev, 0x00, 5);
+	WriteReg(sDev, 0x07, 0x90);	// noise on channel 6
+
+	return;
+}
+
+static void C6280_Tick(SCRIPT_DEV* sDev, UINT32 tick)
+{
+	UINT8 curChn;
+
+	for (curChn = 0; curChn < 5; curChn ++)
+	{
+		UINT32 period = NotePeriod(0x1FC, tick, curChn);
+		WriteReg(sDev, 0x00, curChn);
+		WriteReg(sDev, 0x02, period & 0xFF);
+		WriteReg(sDev, 0x03, (period >> 8) & 0x0F);
+		WriteReg(sDev, 0x04, 0x80 | (0x1F - (tick % NOTE_LEN)));
+	}
+
+	return;
+}
+
+static void Pokey_Init(SCRIPT_DEV* sDev)
+{
+	WriteReg(sDev, 0x0F, 0x03);	// SKCTL: leave init mode
+	WriteReg(sDev, 0x08, 0x00);	// AUDCTL: 64 KHz base clock
+
+	return;
+}
+
+static void Pokey_Tick(SCRIPT_DEV* sDev, UINT32 tick)
+{
+	UINT8 curChn;
+	UINT8 volume = 0x0F - (tick % NOTE_LEN) / 2;
+
+	for (curChn = 0; curChn < 4; curChn ++)
+	{
+		WriteReg(sDev, curChn * 2 + 0, NotePeriod(145, tick, curChn) - 1);
+		// channel 4 uses a noise distortion
+		WriteReg(sDev, curChn * 2 + 1, ((curChn < 3) ? 0xA0 : 0x80) | volume);
+	}
+
+	return;
+}
+
+static void SAA1099_Write(SCRIPT_DEV* sDev, UINT8 reg, UINT8 data)
+{
+	WriteReg(sDev, 0x01, reg);
+	WriteReg(sDev, 0x00, data);
+	return;
+}
+
+static void SAA1099_Init(SCRIPT_DEV* sDev)
+{
+	UINT8 curChn;
+
+	SAA1099_Write(sDev, 0x1C, 0x02);	// reset
+	SAA1099_Write(sDev, 0x1C, 0x01);	// sound enable
+	for (curChn = 0; curChn < 6; curChn ++)
+		SAA1099_Write(sDev, 0x00 + curChn, 0xAA);
+	SAA1099_Write(sDev, 0x14, 0x3F);	// frequency enable
+	SAA1099_Write(sDev, 0x15, 0x20);	// noise on channel 5
+	SAA1099_Write(sDev, 0x16, 0x01);
+
+	return;
+}
+
+static void SAA1099_Tick(SCRIPT_DEV* sDev, UINT32 tick)
+{
+	UINT8 curChn;
+	UINT8 octaves[6];
+
+	for (curChn = 0; curChn < 6; curChn ++)
+	{
+		UINT32 period = NotePeriod(568, tick, curChn);
+		UINT8 octave = 3;
+		while(period > 511)
+		{
+			period >>= 1;
+			octave ++;
+		}
+		while(period < 256)
+		{
+			period <<= 1;
+			octave --;
+		}
+		octaves[curChn] = octave;
+		SAA1099_Write(sDev, 0x08 + curChn, (UINT8)(511 - period));
+	}
+	for (curChn = 0; curChn < 6; curChn += 2)
+		SAA1099_Write(sDev, 0x10 + curChn / 2, octaves[curChn + 0] | (octaves[curChn + 1] << 4));
+
+	return;
+}
+
+static void Mikey_Init(SCRIPT_DEV* sDev)
+{
+	UINT8 curChn;
+
+	for (curChn = 0; curChn < 4; curChn ++)
+	{
+		UINT8 base = 0x20 + curChn * 8;
+		WriteReg(sDev, base + 0, 0x20);	// volume
+		WriteReg(sDev, base + 1, (curChn < 3) ? 0x01 : 0x35);	// feedback taps (channel 4: noise)
+		WriteReg(sDev, base + 3, 0x01);	// shift register
+		WriteReg(sDev, base + 7, 0x00);
+		WriteReg(sDev, 0x40 + curChn, 0xFF);	// attenuation
+	}
+	WriteReg(sDev, 0x44, 0x00);	// panning
+	WriteReg(sDev, 0x50, 0x00);	// stereo: all channels enabled
+
+	return;
+}
+
+static void Mikey_Tick(SCRIPT_DEV* sDev, UINT32 tick)
+{
+	UINT8 curChn;
+
+	for (curChn = 0; curChn < 4; curChn ++)
+	{
+		UINT8 base = 0x20 + curChn * 8;
+		UINT32 period = NotePeriod(0x8E, tick, curChn);
+		WriteReg(sDev, base + 4, (UINT8)period);	// timer reload value
+		if (! (tick % NOTE_LEN))
+			WriteReg(sDev, base + 5, 0x18 | 0x02);	// enable reload + count, 250 KHz clock
+	}
+
+	return;
+}
+
+static void WSwan_Init(SCRIPT_DEV* sDev)
+{
+	UINT8 curWave;
+	UINT8 curPos;
+
+	// 4 waves, 32 4-bit samples each, at RAM offset 0x40
+	for (curWave = 0; curWave < 4; curWave ++)
+	{
+		for (curPos = 0; curPos < 16; curPos ++)
+		{
+			UINT8 smplA = (UINT8)(sineROM[curPos * 2 + 0] + 0x80) >> (4 + (curWave & 1));
+			UINT8 smplB = (UINT8)(sineROM[curPos * 2 + 1] + 0x80) >> (4 + (curWave & 1));
+			sDev->memWrite(sDev->base.defInf.dataPtr, 0x40 + curWave * 0x10 + curPos, smplA | (smplB << 4));
+		}
+	}
+	WriteReg(sDev, 0x8F, 0x01);	// wave table base
+	WriteReg(sDev, 0x8E, 0x18);	// noise: enable, reset counter
+	WriteReg(sDev, 0x90, 0x8F);	// all channels on, noise on channel 4
+	WriteReg(sDev, 0x91, 0x09);
+
+	return;
+}
+
+static void WSwan_Tick(SCRIPT_DEV* sDev, UINT32 tick)
+{
+	UINT8 curChn;
+	UINT8 volume = 0x0F - (tick % NOTE_LEN) / 2;
+
+	for (curChn = 0; curChn < 4; curChn ++)
+	{
+		UINT32 freq = 2048 - NotePeriod(436, tick, curChn);
+		WriteReg(sDev, 0x80 + curChn * 2, freq & 0xFF);
+		WriteReg(sDev, 0x81 + curChn * 2, (freq >> 8) & 0x07);
+		WriteReg(sDev, 0x88 + curChn, (volume << 4) | volume);
+	}
+
+	return;
+}
+
+static void VSU_Init(SCRIPT_DEV* sDev)
+{
+	UINT8 curWave;
+	UINT8 curPos;
+	UINT8 curChn;
+
+	for (curWave = 0; curWave < 5; curWave ++)
+	{
+		for (curPos = 0; curPos < 32; curPos ++)
+			WriteReg16(sDev, curWave * 0x20 + curPos, (UINT8)(sineROM[curPos] + 0x80) >> (2 + (curWave & 1)));
+	}
+	for (curChn = 0; curChn < 6; curChn ++)
+	{
+		UINT16 base = 0x100 + curChn * 0x10;
+		WriteReg16(sDev, base + 1, 0xFF);	// levels
+		WriteReg16(sDev, base + 5, 0x00);	// envelope control
+		WriteReg16(sDev, base + 6, curChn % 5);	// wave index
+	}
+
+	return;
+}
+
+static void VSU_Tick(SCRIPT_DEV* sDev, UINT32 tick)
+{
+	UINT8 curChn;
+
+	for (curChn = 0; curChn < 6; curChn ++)
+	{
+		UINT16 base = 0x100 + curChn * 0x10;
+		UINT32 freq = 2048 - NotePeriod(710, tick, curChn);
+		WriteReg16(sDev, base + 2, freq & 0xFF);
+		WriteReg16(sDev, base + 3, (freq >> 8) & 0x07);
+		if (! (tick % NOTE_LEN))
+		{
+			WriteReg16(sDev, base + 4, 0xF0);	// initial envelope volume 15
+			WriteReg16(sDev, base + 0, 0x80);	// enable
+		}
+	}
+
+	return;
+}
+
+static void K005289_Init(SCRIPT_DEV* sDev)
+{
+	DEVFUNC_WRITE_BLOCK promWrite;
+	UINT16 curPos;
+
+	// 2 PROMs with 8 waveforms of 32 4-bit samples each
+	PrepareROM();
+	for (curPos = 0; curPos < 0x200; curPos ++)
+		romData[curPos] = (UINT8)(sineROM[curPos] + 0x80) >> (4 + ((curPos >> 5) & 1));
+	if (! SndEmu_GetDeviceFunc(sDev->base.defInf.devDef, RWF_MEMORY | RWF_WRITE, DEVRW_BLOCK, 0, (void**)&promWrite))
+		promWrite(sDev->base.defInf.dataPtr, 0x00, 0x200, romData);
+
+	return;
+}
+
+static void K005289_Tick(SCRIPT_DEV* sDev, UINT32 tick)
+{
+	UINT8 curChn;
+
+	for (curChn = 0; curChn < 2; curChn ++)
+	{
+		UINT32 period = NotePeriod(508, tick, curChn);
+		WriteRegD16(sDev, 0x00 + curChn, (UINT16)((((tick / NOTE_LEN) & 7) << 5) | (0x0F - (tick % NOTE_LEN) / 2)));
+		WriteRegD16(sDev, 0x02 + curChn, (UINT16)(0xFFF - period));
+		WriteRegD16(sDev, 0x04 + curChn, 0x00);	// trigger pitch latch
+	}
+
+	return;
+}
+
+static void MSM5232_Init(SCRIPT_DEV* sDev)
+{
+	UINT8 curReg;
+
+	WriteReg(sDev, 0x08, 0x00);	// attack times
+	WriteReg(sDev, 0x09, 0x00);
+	WriteReg(sDev, 0x0A, 0x04);	// decay times
+	WriteReg(sDev, 0x0B, 0x04);
+	WriteReg(sDev, 0x0C, 0x1F);	// all feet, envelope arm
+	WriteReg(sDev, 0x0D, 0x1F);
+	for (curReg = 0x10; curReg <= 0x1A; curReg ++)
+		WriteReg(sDev, curReg, 0x80);	// output volumes
+	WriteReg(sDev, 0x1E, 0x80);
+	WriteReg(sDev, 0x1F, 0x80);
+
+	return;
+}
+
+static void MSM5232_Tick(SCRIPT_DEV* sDev, UINT32 tick)
+{
+	UINT8 curChn;
+
+	if (tick % NOTE_LEN)
+		return;
+	for (curChn = 0; curChn < 8; curChn ++)
+		WriteReg(sDev, curChn, 0x80 | (0x20 + NoteSemitone(tick, curChn) + (curChn / 4) * 12));
+
+	return;
+}
+
+
+// --- FM ---
+static void YM2413_Init(SCRIPT_DEV* sDev)
+{
+	UINT8 curChn;
+
+	for (curChn = 0; curChn < 6; curChn ++)
+		WritePort(sDev, 0, 0x30 + curChn, ((curChn + 1) << 4) | 0x00);
+	// rhythm channel frequencies and volumes
+	WritePort(sDev, 0, 0x16, 0x20);
+	WritePort(sDev, 0, 0x26, 0x05);
+	WritePort(sDev, 0, 0x17, 0x50);
+	WritePort(sDev, 0, 0x27, 0x05);
+	WritePort(sDev, 0, 0x18, 0xC0);
+	WritePort(sDev, 0, 0x28, 0x01);
+	WritePort(sDev, 0, 0x36, 0x00);
+	WritePort(sDev, 0, 0x37, 0x00);
+	WritePort(sDev, 0, 0x38, 0x00);
+	WritePort(sDev, 0, 0x0E, 0x20);
+
+	return;
+}
+
+static void YM2413_Tick(SCRIPT_DEV* sDev, UINT32 tick)
+{
+	UINT8 curChn;
+	UINT16 fnum;
+	UINT8 block;
+	UINT8 noteStart = ! (tick % NOTE_LEN);
+
+	for (curChn = 0; curChn < 6; curChn ++)
+	{
+		FnumBlock(NoteFreq(0x122 << 3, tick, curChn), 9, &fnum, &block);
+		if (noteStart)
+			WritePort(sDev, 0, 0x20 + curChn, 0x00);	// key off
+		WritePort(sDev, 0, 0x10 + curChn, fnum & 0xFF);
+		WritePort(sDev, 0, 0x20 + curChn, 0x10 | (block << 1) | (fnum >> 8));
+	}
+	if (noteStart)
+	{
+		WritePort(sDev, 0, 0x0E, 0x20);
+		WritePort(sDev, 0, 0x0E, 0x20 | 0x11 | (1 << ((tick / NOTE_LEN) % 5)));
+	}
+
+	return;
+}
+
+static void OPN_InitChannel(SCRIPT_DEV* sDev, UINT8 port, UINT8 chn)
+{
+	UINT8 curOp;
+
+	for (curOp = 0; curOp < 4; curOp ++)
+	{
+		UINT8 ofs = OPN_SLOTS[curOp] + chn;
+		WritePort(sDev, port, 0x30 + ofs, (curOp & 1) ? 0x01 : 0x02);	// DT/MUL
+		WritePort(sDev, port, 0x40 + ofs, (curOp >= 2) ? 0x00 : 0x20);	// TL (carriers at full volume)
+		WritePort(sDev, port, 0x50 + ofs, 0x1F);	// KS/AR
+		WritePort(sDev, port, 0x60 + ofs, 0x05);	// AM/D1R
+		WritePort(sDev, port, 0x70 + ofs, 0x02);	// D2R
+		WritePort(sDev, port, 0x80 + ofs, 0x17);	// D1L/RR
+		WritePort(sDev, port, 0x90 + ofs, 0x00);	// SSG-EG
+	}
+	WritePort(sDev, port, 0xB0 + chn, 0x1C);	// feedback 3, algorithm 4
+	WritePort(sDev, port, 0xB4 + chn, 0xC1);	// L/R, slight vibrato
+
+	return;
+}
+
+static void OPN_TickChannel(SCRIPT_DEV* sDev, UINT8 port, UINT8 chn, UINT32 tick, UINT8 note)
+{
+	UINT16 fnum;
+	UINT8 block;
+	UINT8 keyChn = chn | (port << 2);
+
+	FnumBlock(NoteFreq(0x26A << 3, tick, note), 11, &fnum, &block);
+	if (! (tick % NOTE_LEN))
+		WritePort(sDev, 0, 0x28, keyChn);	// key off
+	WritePort(sDev, port, 0xA4 + chn, (block << 3) | (fnum >> 8));
+	WritePort(sDev, port, 0xA0 + chn, fnum & 0xFF);
+	if (! (tick % NOTE_LEN))
+		WritePort(sDev, 0, 0x28, 0xF0 | keyChn);	// key on
+
+	return;
+}
+
+static void YM2612_Init(SCRIPT_DEV* sDev)
+{
+	UINT8 curChn;
+
+	WritePort(sDev, 0, 0x22, 0x0B);	// LFO on
+	for (curChn = 0; curChn < 6; curChn ++)
+		OPN_InitChannel(sDev, curChn / 3, curChn % 3);
+	WritePort(sDev, 0, 0x2B, 0x80);	// DAC on (replaces channel 6)
+
+	return;
+}
+
+static void YM2612_Tick(SCRIPT_DEV* sDev, UINT32 tick)
+{
+	UINT8 curChn;
+
+	for (curChn = 0; curChn < 5; curChn ++)
+		OPN_TickChannel(sDev, curChn / 3, curChn % 3, tick, curChn);
+
+	return;
+}
+
+static void YM2612_Stream(SCRIPT_DEV* sDev, UINT32 pos)
+{
+	WritePort(sDev, 0, 0x2A, sineROM[pos % ROM_SIZE] ^ 0x80);
+	return;
+}
+
+static void YM2203_Init(SCRIPT_DEV* sDev)
+{
+	UINT8 curChn;
+
+	for (curChn = 0; curChn < 3; curChn ++)
+		OPN_InitChannel(sDev, 0, curChn);
+	SSG_Init(sDev, 0);
+
+	return;
+}
+
+static void YM2203_Tick(SCRIPT_DEV* sDev, UINT32 tick)
+{
+	UINT8 curChn;
+
+	for (curChn = 0; curChn < 3; curChn ++)
+		OPN_TickChannel(sDev, 0, curChn, tick, curChn);
+	SSG_Tick(sDev, 0, tick, 0x11C);
+
+	return;
+}
+
+static void YM2608_Init(SCRIPT_DEV* sDev)
+{
+	UINT8 curChn;
+
+	PrepareROM();
+	LoadROM(sDev, 'B', ROM_SIZE);
+
+	WritePort(sDev, 0, 0x29, 0x80);	// 6-channel mode
+	WritePort(sDev, 0, 0x22, 0x0B);
+	for (curChn = 0; curChn < 6; curChn ++)
+		OPN_InitChannel(sDev, curChn / 3, curChn % 3);
+	SSG_Init(sDev, 0);
+	// rhythm
+	WritePort(sDev, 0, 0x11, 0x3F);
+	for (curChn = 0; curChn < 6; curChn ++)
+		WritePort(sDev, 0, 0x18 + curChn, 0xDF);
+	// ADPCM (DELTA-T)
+	WritePort(sDev, 1, 0x00, 0x01);	// reset
+	WritePort(sDev, 1, 0x01, 0xC1);	// L/R, ROM
+	WritePort(sDev, 1, 0x02, 0x00);	// start address
+	WritePort(sDev, 1, 0x03, 0x00);
+	WritePort(sDev, 1, 0x04, 0xFF);	// stop address
+	WritePort(sDev, 1, 0x05, 0x1F);
+	WritePort(sDev, 1, 0x0B, 0xC0);	// level
+	WritePort(sDev, 1, 0x0C, 0xFF);	// limit
+	WritePort(sDev, 1, 0x0D, 0xFF);
+
+	return;
+}
+
+static void YM2608_Tick(SCRIPT_DEV* sDev, UINT32 tick)
+{
+	UINT8 curChn;
+	UINT32 deltaN;
+
+	for (curChn = 0; curChn < 6; curChn ++)
+		OPN_TickChannel(sDev, curChn / 3, curChn % 3, tick, curChn);
+	SSG_Tick(sDev, 0, tick, 0x11C);
+
+	deltaN = NoteFreq(0x2000, tick, 0);
+	WritePort(sDev, 1, 0x09, deltaN & 0xFF);
+	WritePort(sDev, 1, 0x0A, (deltaN >> 8) & 0xFF);
+	if (! (tick % NOTE_LEN))
+	{
+		WritePort(sDev, 0, 0x10, 1 << ((tick / NOTE_LEN) % 6));	// rhythm key on
+		WritePort(sDev, 1, 0x00, 0x01);
+		WritePort(sDev, 1, 0x00, 0xB0);	// start, external memory, repeat
+	}
+
+	return;
+}
+
+static void YM2610_Init(SCRIPT_DEV* sDev)
+{
+	UINT8 curChn;
+
+	PrepareROM();
+	LoadROM(sDev, 'A', ROM_SIZE);
+	LoadROM(sDev, 'B', ROM_SIZE);
+
+	WritePort(sDev, 0, 0x22, 0x0B);
+	for (curChn = 0; curChn < 4; curChn ++)
+		OPN_InitChannel(sDev, curChn / 2, 1 + (curChn % 2));
+	SSG_Init(sDev, 0);
+	// ADPCM-A: channel n plays 4 KB from n * 0x1000
+	WritePort(sDev, 1, 0x01, 0x3F);	// total level
+	for (curChn = 0; curChn < 6; curChn ++)
+	{
+		WritePort(sDev, 1, 0x08 + curChn, 0xDF);	// L/R, level
+		WritePort(sDev, 1, 0x10 + curChn, (curChn * 0x10) & 0xFF);
+		WritePort(sDev, 1, 0x18 + curChn, 0x00);
+		WritePort(sDev, 1, 0x20 + curChn, (curChn * 0x10 + 0x0F) & 0xFF);
+		WritePort(sDev, 1, 0x28 + curChn, 0x00);
+	}
+	// ADPCM-B (DELTA-T)
+	WritePort(sDev, 0, 0x10, 0x01);
+	WritePort(sDev, 0, 0x11, 0xC0);	// L/R
+	WritePort(sDev, 0, 0x12, 0x00);	// start address
+	WritePort(sDev, 0, 0x13, 0x00);
+	WritePort(sDev, 0, 0x14, 0xFF);	// stop address
+	WritePort(sDev, 0, 0x15, 0x0F);
+	WritePort(sDev, 0, 0x1B, 0xC0);	// level
+
+	return;
+}
+
+static void YM2610_Tick(SCRIPT_DEV* sDev, UINT32 tick)
+{
+	UINT8 curChn;
+	UINT32 deltaN;
+
+	for (curChn = 0; curChn < 4; curChn ++)
+		OPN_TickChannel(sDev, curChn / 2, 1 + (curChn % 2), tick, curChn);
+	SSG_Tick(sDev, 0, tick, 0x11C);
+
+	deltaN = NoteFreq(0x2000, tick, 0);
+	WritePort(sDev, 0, 0x19, deltaN & 0xFF);
+	WritePort(sDev, 0, 0x1A, (deltaN >> 8) & 0xFF);
+	if (! (tick % NOTE_LEN))
+	{
+		WritePort(sDev, 1, 0x00, 0x3F);	// ADPCM-A key on
+		WritePort(sDev, 0, 0x10, 0x01);
+		WritePort(sDev, 0, 0x10, 0x90);	// start, repeat
+	}
+
+	return;
+}
+
+static void OPM_Init(SCRIPT_DEV* sDev, UINT8 opz)
+{
+	UINT8 curChn;
+	UINT8 curOp;
+
+	WritePort(sDev, 0, 0x18, 0xC0);	// LFO frequency
+	WritePort(sDev, 0, 0x19, 0x84);	// PM depth
+	WritePort(sDev, 0, 0x1B, 0x02);	// LFO waveform
+	for (curChn = 0; curChn < 8; curChn ++)
+	{
+		if (! opz)
+			WritePort(sDev, 0, 0x20 + curChn, 0xC0 | (3 << 3) | 4);	// L/R, feedback 3, algorithm 4
+		else
+			WritePort(sDev, 0, 0x00 + curChn, 0x00);	// channel volume
+		WritePort(sDev, 0, 0x38 + curChn, 0x10);	// PMS
+		for (curOp = 0; curOp < 4; curOp ++)
+		{
+			UINT8 ofs = curOp * 8 + curChn;
+			WritePort(sDev, 0, 0x40 + ofs, (curOp & 2) ? 0x01 : 0x02);	// DT1/MUL
+			WritePort(sDev, 0, 0x60 + ofs, (curOp & 1) ? 0x00 : 0x20);	// TL (operators 2 and 4 are carriers)
+			WritePort(sDev, 0, 0x80 + ofs, 0x1F);	// KS/AR
+			WritePort(sDev, 0, 0xA0 + ofs, 0x05);	// AM/D1R
+			WritePort(sDev, 0, 0xC0 + ofs, 0x02);	// DT2/D2R
+			WritePort(sDev, 0, 0xE0 + ofs, 0x17);	// D1L/RR
+		}
+	}
+
+	return;
+}
+
+static void OPM_Tick(SCRIPT_DEV* sDev, UINT32 tick, UINT8 opz)
+{
+	UINT8 curChn;
+	UINT8 curOp;
+	UINT8 noteStart = ! (tick % NOTE_LEN);
+	UINT8 keyFrac = (UINT8)((tick % NOTE_LEN) * 4);
+
+	for (curChn = 0; curChn < 8; curChn ++)
+	{
+		UINT32 note = 12 * 3 + NoteSemitone(tick, curChn);
+		UINT8 keyCode = (UINT8)(((note / 12) << 4) | OPM_NOTES[note % 12]);
+
+		if (noteStart && ! opz)
+			WritePort(sDev, 0, 0x08, curChn);	// key off
+		WritePort(sDev, 0, 0x28 + curChn, keyCode);
+		WritePort(sDev, 0, 0x30 + curChn, (keyFrac << 2) | opz);	// OPZ: bit 0 = left output
+		if (noteStart)
+		{
+			if (! opz)
+			{
+				WritePort(sDev, 0, 0x08, 0x78 | curChn);	// key on
+			}
+			else
+			{
+				// Writing register 08 on the OPZ reloads the D1L/RR registers from the preset memory.
+				WritePort(sDev, 0, 0x08, curChn);
+				for (curOp = 0; curOp < 4; curOp ++)
+					WritePort(sDev, 0, 0xE0 + curOp * 8 + curChn, 0x17);
+				WritePort(sDev, 0, 0x20 + curChn, 0x80 | (3 << 3) | 4);	// key off
+				WritePort(sDev, 0, 0x20 + curChn, 0x80 | 0x40 | (3 << 3) | 4);	// key on
+			}
+		}
+	}
+
+	return;
+}
+
+static void YM2151_Init(SCRIPT_DEV* sDev)
+{
+	OPM_Init(sDev, 0);
+	return;
+}
+
+static void YM2151_Tick(SCRIPT_DEV* sDev, UINT32 tick)
+{
+	OPM_Tick(sDev, tick, 0);
+	return;
+}
+
+static void YM2414_Init(SCRIPT_DEV* sDev)
+{
+	OPM_Init(sDev, 1);
+	return;
+}
+
+static void YM2414_Tick(SCRIPT_DEV* sDev, UINT32 tick)
+{
+	OPM_Tick(sDev, tick, 1);
+	return;
+}
+
+static void OPL_InitChannel(SCRIPT_DEV* sDev, UINT8 port, UINT8 chn)
+{
+	UINT8 slot = OPL_SLOTS[chn];
+
+	WritePort(sDev, port, 0x20 + slot, 0x21);	// modulator: sustain, MUL 1
+	WritePort(sDev, port, 0x23 + slot, 0x21);	// carrier
+	WritePort(sDev, port, 0x40 + slot, 0x18);
+	WritePort(sDev, port, 0x43 + slot, 0x00);
+	WritePort(sDev, port, 0x60 + slot, 0xF4);	// AR/DR
+	WritePort(sDev, port, 0x63 + slot, 0xF4);
+	WritePort(sDev, port, 0x80 + slot, 0x57);	// SL/RR
+	WritePort(sDev, port, 0x83 + slot, 0x57);
+	WritePort(sDev, port, 0xE0 + slot, chn & 0x03);	// waveform
+	WritePort(sDev, port, 0xE3 + slot, 0x00);
+	WritePort(sDev, port, 0xC0 + chn, 0x30 | (3 << 1));	// L/R (OPL3), feedback 3
+
+	return;
+}
+
+static void OPL_TickChannel(SCRIPT_DEV* sDev, UINT8 port, UINT8 chn, UINT32 tick, UINT8 note)
+{
+	UINT16 fnum;
+	UINT8 block;
+
+	FnumBlock(NoteFreq(0x244 << 3, tick, note), 10, &fnum, &block);
+	if (! (tick % NOTE_LEN))
+		WritePort(sDev, port, 0xB0 + chn, 0x00);	// key off
+	WritePort(sDev, port, 0xA0 + chn, fnum & 0xFF);
+	WritePort(sDev, port, 0xB0 + chn, 0x20 | (block << 2) | (fnum >> 8));
+
+	return;
+}
+
+static void OPL2_Init(SCRIPT_DEV* sDev)
+{
+	UINT8 curChn;
+
+	WritePort(sDev, 0, 0x01, 0x20);	// waveform select enable
+	for (curChn = 0; curChn < 9; curChn ++)
+		OPL_InitChannel(sDev, 0, curChn);
+
+	return;
+}
+
+static void OPL2_Tick(SCRIPT_DEV* sDev, UINT32 tick)
+{
+	UINT8 curChn;
+
+	for (curChn = 0; curChn < 9; curChn ++)
+		OPL_TickChannel(sDev, 0, curChn, tick, curChn);
+
+	return;
+}
+
+static void Y8950_Init(SCRIPT_DEV* sDev)
+{
+	PrepareROM();
+	LoadROM(sDev, 0, ROM_SIZE);
+
+	OPL2_Init(sDev);
+	// ADPCM (DELTA-T)
+	WritePort(sDev, 0, 0x07, 0x01);	// reset
+	WritePort(sDev, 0, 0x08, 0x01);	// ROM
+	WritePort(sDev, 0, 0x09, 0x00);	// start address
+	WritePort(sDev, 0, 0x0A, 0x00);
+	WritePort(sDev, 0, 0x0B, 0xFF);	// stop address
+	WritePort(sDev, 0, 0x0C, 0x1F);
+	WritePort(sDev, 0, 0x12, 0xC0);	// level
+
+	return;
+}
+
+static void Y8950_Tick(SCRIPT_DEV* sDev, UINT32 tick)
+{
+	UINT32 deltaN;
+
+	OPL2_Tick(sDev, tick);
+	deltaN = NoteFreq(0x2000, tick, 0);
+	WritePort(sDev, 0, 0x10, deltaN & 0xFF);
+	WritePort(sDev, 0, 0x11, (deltaN >> 8) & 0xFF);
+	if (! (tick % NOTE_LEN))
+	{
+		WritePort(sDev, 0, 0x07, 0x01);
+		WritePort(sDev, 0, 0x07, 0xB0);	// start, memory, repeat
+	}
+
+	return;
+}
+
+static void OPL3_Init(SCRIPT_DEV* sDev)
+{
+	UINT8 curChn;
+
+	WritePort(sDev, 1, 0x05, 0x01);	// OPL3 mode
+	for (curChn = 0; curChn < 18; curChn ++)
+		OPL_InitChannel(sDev, curChn / 9, curChn % 9);
+
+	return;
+}
+
+static void OPL3_Tick(SCRIPT_DEV* sDev, UINT32 tick)
+{
+	UINT8 curChn;
+
+	for (curChn = 0; curChn < 18; curChn ++)
+		OPL_TickChannel(sDev, curChn / 9, curChn % 9, tick, curChn);
+
+	return;
+}
+
+static void YMF278B_Init(SCRIPT_DEV* sDev)
+{
+	UINT8 curSlot;
+
+	// 24 waves with 4 KB of sample data each
+	PrepareROM();
+	for (curSlot = 0; curSlot < 24; curSlot ++)
+		WriteWaveHeader(&romData[curSlot * 12], 0x10000 + curSlot * 0x1000, 0x1000);
+	LoadROM(sDev, 0x524F, ROM_SIZE);	// 'RO' = ROM
+
+	WritePort(sDev, 1, 0x05, 0x03);	// OPL4 mode
+	for (curSlot = 0; curSlot < 18; curSlot ++)
+		OPL_InitChannel(sDev, curSlot / 9, curSlot % 9);
+	for (curSlot = 0; curSlot < 24; curSlot ++)
+		WritePort(sDev, 2, 0x50 + curSlot, 0x20 | 0x01);	// TL, no interpolation
+
+	return;
+}
+
+static void YMF278B_Tick(SCRIPT_DEV* sDev, UINT32 tick)
+{
+	UINT8 curSlot;
+	INT8 octave;
+	UINT16 fnum;
+
+	for (curSlot = 0; curSlot < 18; curSlot ++)
+		OPL_TickChannel(sDev, curSlot / 9, curSlot % 9, tick, curSlot);
+	for (curSlot = 0; curSlot < 24; curSlot ++)
+	{
+		Ratio2OctFn(NoteRatio(tick, curSlot) >> 2, &octave, &fnum);
+		WritePort(sDev, 2, 0x38 + curSlot, ((octave & 0x0F) << 4) | (fnum >> 7));
+		WritePort(sDev, 2, 0x20 + curSlot, (fnum & 0x7F) << 1);
+		if (! (tick % NOTE_LEN))
+		{
+			WritePort(sDev, 2, 0x68 + curSlot, 0x00);	// key off
+			WritePort(sDev, 2, 0x08 + curSlot, curSlot);	// wave number (loads the header)
+			WritePort(sDev, 2, 0x68 + curSlot, 0x80);	// key on, centre
+		}
+	}
+
+	return;
+}
+
+static void YMF271_Init(SCRIPT_DEV* sDev)
+{
+	static const UINT8 FM_GROUPS[8] = {0, 1, 2, 4, 5, 6, 8, 9};	// address nibbles for groups 0..7
+	UINT8 curGrp;
+	UINT8 curBank;
+
+	PrepareROM();
+	LoadROM(sDev, 0, ROM_SIZE);
+
+	// groups 0..7: 4-operator FM, group 8: PCM
+	for (curGrp = 0; curGrp < 8; curGrp ++)
+	{
+		UINT8 nibble = FM_GROUPS[curGrp];
+		WritePort(sDev, 6, nibble, 0x00);	// sync mode: 4 operators
+		for (curBank = 0; curBank < 4; curBank ++)
+		{
+			WritePort(sDev, curBank, 0x30 | nibble, 0x01);	// DT/MUL
+			WritePort(sDev, curBank, 0x40 | nibble, (curBank == 3) ? 0x00 : 0x20);	// TL
+			WritePort(sDev, curBank, 0x50 | nibble, 0x1F);	// AR
+			WritePort(sDev, curBank, 0x60 | nibble, 0x05);	// D1R
+			WritePort(sDev, curBank, 0x70 | nibble, 0x02);	// D2R
+			WritePort(sDev, curBank, 0x80 | nibble, 0x17);	// D1L/RR
+			WritePort(sDev, curBank, 0xB0 | nibble, (curBank == 0) ? 0x30 : 0x00);	// waveform, feedback
+		}
+		WritePort(sDev, 0, 0xC0 | nibble, 0x00);	// algorithm (synced to all 4 slots)
+		WritePort(sDev, 0, 0xD0 | nibble, 0x00);	// ch0/ch1 level
+		WritePort(sDev, 0, 0xE0 | nibble, 0xFF);	// ch2/ch3 level (muted)
+	}
+	WritePort(sDev, 6, 0x0A, 0x03);	// group 8: PCM
+	for (curBank = 0; curBank < 4; curBank ++)
+	{
+		UINT8 pcmSlot = 0x02 + curBank * 4;	// slot 12 * bank + 8
+		UINT32 start = curBank * 0x1000;
+		UINT32 end = start + 0x0FFF;
+		WritePort(sDev, 4, 0x00 | pcmSlot, (start >> 0) & 0xFF);
+		WritePort(sDev, 4, 0x10 | pcmSlot, (start >> 8) & 0xFF);
+		WritePort(sDev, 4, 0x20 | pcmSlot, (start >> 16) & 0x7F);
+		WritePort(sDev, 4, 0x30 | pcmSlot, (end >> 0) & 0xFF);
+		WritePort(sDev, 4, 0x40 | pcmSlot, (end >> 8) & 0xFF);
+		WritePort(sDev, 4, 0x50 | pcmSlot, (end >> 16) & 0x7F);
+		WritePort(sDev, 4, 0x60 | pcmSlot, (start >> 0) & 0xFF);
+		WritePort(sDev, 4, 0x70 | pcmSlot, (start >> 8) & 0xFF);
+		WritePort(sDev, 4, 0x80 | pcmSlot, (start >> 16) & 0x7F);
+		WritePort(sDev, 4, 0x90 | pcmSlot, 0x00);	// 8-bit
+		WritePort(sDev, curBank, 0x3A, 0x01);
+		WritePort(sDev, curBank, 0x4A, 0x00);
+		WritePort(sDev, curBank, 0x5A, 0x1F);
+		WritePort(sDev, curBank, 0x6A, 0x00);
+		WritePort(sDev, curBank, 0x7A, 0x00);
+		WritePort(sDev, curBank, 0x8A, 0x0F);
+		WritePort(sDev, curBank, 0xBA, 0x07);	// waveform 7 = PCM
+		WritePort(sDev, curBank, 0xDA, 0x00);
+		WritePort(sDev, curBank, 0xEA, 0xFF);
+	}
+
+	return;
+}
+
+static void YMF271_Tick(SCRIPT_DEV* sDev, UINT32 tick)
+{
+	static const UINT8 FM_GROUPS[8] = {0, 1, 2, 4, 5, 6, 8, 9};
+	UINT8 curGrp;
+	UINT8 curBank;
+	UINT16 fnum;
+	UINT8 block;
+	UINT8 noteStart = ! (tick % NOTE_LEN);
+
+	for (curGrp = 0; curGrp < 8; curGrp ++)
+	{
+		UINT8 nibble = FM_GROUPS[curGrp];
+		FnumBlock(NoteFreq(0x400 << 3, tick, curGrp), 12, &fnum, &block);
+		WritePort(sDev, 0, 0xA0 | nibble, (block << 4) | (fnum >> 8));
+		WritePort(sDev, 0, 0x90 | nibble, fnum & 0xFF);
+		if (noteStart)
+		{
+			WritePort(sDev, 0, 0x00 | nibble, 0x00);	// key off
+			WritePort(sDev, 0, 0x00 | nibble, 0x01);	// key on
+		}
+	}
+	for (curBank = 0; curBank < 4; curBank ++)
+	{
+		FnumBlock(NoteFreq(0x400 << 1, tick, curBank), 12, &fnum, &block);
+		WritePort(sDev, curBank, 0xAA, (block << 4) | (fnum >> 8));
+		WritePort(sDev, curBank, 0x9A, fnum & 0xFF);
+		if (noteStart)
+		{
+			WritePort(sDev, curBank, 0x0A, 0x00);
+			WritePort(sDev, curBank, 0x0A, 0x01);
+		}
+	}
+
+	return;
+}
+
+
+// --- PCM ---
+static void YMZ280B_Init(SCRIPT_DEV* sDev)
+{
+	UINT8 curChn;
+
+	PrepareROM();
+	LoadROM(sDev, 0, ROM_SIZE);
+
+	for (curChn = 0; curChn < 8; curChn ++)
+	{
+		UINT32 start = curChn * 0x1000;
+		UINT32 end = start + 0x0FFF;
+		WritePort(sDev, 0, curChn * 4 + 2, 0xC0);	// total level
+		WritePort(sDev, 0, curChn * 4 + 3, 0x08);	// centre
+		WritePort(sDev, 0, 0x20 + curChn * 4 + 0, (start >> 16) & 0xFF);
+		WritePort(sDev, 0, 0x40 + curChn * 4 + 0, (start >> 8) & 0xFF);
+		WritePort(sDev, 0, 0x60 + curChn * 4 + 0, (start >> 0) & 0xFF);
+		WritePort(sDev, 0, 0x20 + curChn * 4 + 1, (start >> 16) & 0xFF);	// loop start
+		WritePort(sDev, 0, 0x40 + curChn * 4 + 1, (start >> 8) & 0xFF);
+		WritePort(sDev, 0, 0x60 + curChn * 4 + 1, (start >> 0) & 0xFF);
+		WritePort(sDev, 0, 0x20 + curChn * 4 + 2, (end >> 16) & 0xFF);	// loop end
+		WritePort(sDev, 0, 0x40 + curChn * 4 + 2, (end >> 8) & 0xFF);
+		WritePort(sDev, 0, 0x60 + curChn * 4 + 2, (end >> 0) & 0xFF);
+		WritePort(sDev, 0, 0x20 + curChn * 4 + 3, (end >> 16) & 0xFF);	// end
+		WritePort(sDev, 0, 0x40 + curChn * 4 + 3, (end >> 8) & 0xFF);
+		WritePort(sDev, 0, 0x60 + curChn * 4 + 3, (end >> 0) & 0xFF);
+	}
+	WritePort(sDev, 0, 0xFF, 0x80);	// key on enable
+
+	return;
+}
+
+static void YMZ280B_Tick(SCRIPT_DEV* sDev, UINT32 tick)
+{
+	UINT8 curChn;
+
+	for (curChn = 0; curChn < 8; curChn ++)
+	{
+		// mode: 0x40 = 8-bit PCM (even channels), 0x20 = ADPCM (odd channels)
+		UINT8 mode = ((curChn & 1) ? 0x20 : 0x40) | 0x10;	// + loop
+		UINT32 fnum = NoteFreq(0x40, tick, curChn);
+		if (! (tick % NOTE_LEN))
+			WritePort(sDev, 0, curChn * 4 + 1, mode);	// key off
+		WritePort(sDev, 0, curChn * 4 + 0, fnum & 0xFF);
+		WritePort(sDev, 0, curChn * 4 + 1, 0x80 | mode | ((fnum >> 8) & 0x01));
+	}
+
+	return;
+}
+
+static void SegaPCM_Init(SCRIPT_DEV* sDev)
+{
+	UINT32 curPos;
+	UINT8 curChn;
+
+	// unsigned 8-bit samples
+	PrepareROM();
+	for (curPos = 0; curPos < ROM_SIZE; curPos ++)
+		romData[curPos] ^= 0x80;
+	LoadROM(sDev, 0, ROM_SIZE);
+
+	for (curChn = 0; curChn < 16; curChn ++)
+	{
+		UINT16 base = curChn * 8;
+		UINT16 start = curChn * 0x1000;
+		WriteReg16(sDev, base + 0x86, 0x01);	// disable
+		WriteReg16(sDev, base + 0x02, 0x40);	// volume L
+		WriteReg16(sDev, base + 0x03, 0x40);	// volume R
+		WriteReg16(sDev, base + 0x04, (start >> 0) & 0xFF);	// loop address
+		WriteReg16(sDev, base + 0x05, (start >> 8) & 0xFF);
+		WriteReg16(sDev, base + 0x06, ((start + 0x0FFF) >> 8) & 0xFF);	// end address
+	}
+
+	return;
+}
+
+static void SegaPCM_Tick(SCRIPT_DEV* sDev, UINT32 tick)
+{
+	UINT8 curChn;
+
+	for (curChn = 0; curChn < 16; curChn ++)
+	{
+		UINT16 base = curChn * 8;
+		UINT16 start = curChn * 0x1000;
+		WriteReg16(sDev, base + 0x07, (UINT8)NoteFreq(0x40, tick, curChn));
+		if (! (tick % NOTE_LEN))
+		{
+			WriteReg16(sDev, base + 0x84, (start >> 0) & 0xFF);
+			WriteReg16(sDev, base + 0x85, (start >> 8) & 0xFF);
+			WriteReg16(sDev, base + 0x86, 0x00);	// enable, loop
+		}
+	}
+
+	return;
+}
+
+static void RF5C68_Init(SCRIPT_DEV* sDev)
+{
+	DEVFUNC_WRITE_BLOCK ramWrite;
+	UINT32 curPos;
+	UINT8 curChn;
+
+	// sign/magnitude samples, with loop markers at the end of every 4 KB block
+	PrepareROM();
+	for (curPos = 0; curPos < 0x10000; curPos ++)
+	{
+		INT8 smpl = (INT8)romData[curPos];
+		romData[curPos] = (smpl >= 0) ? (0x80 | smpl) : (UINT8)(-smpl);
+		if ((curPos & 0x0FFF) >= 0x0FF0)
+			romData[curPos] = 0xFF;
+	}
+	if (! SndEmu_GetDeviceFunc(sDev->base.defInf.devDef, RWF_MEMORY | RWF_WRITE, DEVRW_BLOCK, 0, (void**)&ramWrite))
+		ramWrite(sDev->base.defInf.dataPtr, 0x00, 0x10000, romData);
+
+	WriteReg(sDev, 0x08, 0xFF);	// all channels off
+	for (curChn = 0; curChn < 8; curChn ++)
+	{
+		WriteReg(sDev, 0x07, 0xC0 | curChn);
+		WriteReg(sDev, 0x00, 0xFF);	// envelope
+		WriteReg(sDev, 0x01, 0xFF);	// pan
+		WriteReg(sDev, 0x04, 0x00);	// loop address
+		WriteReg(sDev, 0x05, curChn * 0x10);
+		WriteReg(sDev, 0x06, curChn * 0x10);	// start address
+	}
+
+	return;
+}
+
+static void RF5C68_Tick(SCRIPT_DEV* sDev, UINT32 tick)
+{
+	UINT8 curChn;
+
+	for (curChn = 0; curChn < 8; curChn ++)
+	{
+		UINT32 step = NoteFreq(0x0400, tick, curChn);
+		WriteReg(sDev, 0x07, 0xC0 | curChn);
+		WriteReg(sDev, 0x02, step & 0xFF);
+		WriteReg(sDev, 0x03, (step >> 8) & 0xFF);
+	}
+	if (! (tick % NOTE_LEN))
+	{
+		WriteReg(sDev, 0x08, 0xFF);	// key off (restarts from the start address)
+		WriteReg(sDev, 0x08, 0x00);
+	}
+
+	return;
+}
+
+static void PWM_Init(SCRIPT_DEV* sDev)
+{
+	WriteRegD16(sDev, 0x00, 0x0105);	// control: L/R channels on
+	WriteRegD16(sDev, 0x01, 1045);	// cycle: ~22 KHz
+	WriteRegD16(sDev, 0x04, 0x208);	// centre level
+
+	return;
+}
+
+static void PWM_Tick(SCRIPT_DEV* sDev, UINT32 tick)
+{
+	return;
+}
+
+static void PWM_Stream(SCRIPT_DEV* sDev, UINT32 pos)
+{
+	WriteRegD16(sDev, 0x04, (UINT16)(0x208 + (INT8)sineROM[(pos / 2) % ROM_SIZE] * 2));
+	return;
+}
+
+static void MultiPCM_Write(SCRIPT_DEV* sDev, UINT8 slot, UINT8 reg, UINT8 data)
+{
+	WriteReg(sDev, 0x01, slot + slot / 7);	// slot 7, 15, ... are skipped
+	WriteReg(sDev, 0x02, reg);
+	WriteReg(sDev, 0x00, data);
+	return;
+}
+
+static void MultiPCM_Init(SCRIPT_DEV* sDev)
+{
+	UINT8 curSlot;
+
+	PrepareROM();
+	for (curSlot = 0; curSlot < 28; curSlot ++)
+		WriteWaveHeader(&romData[curSlot * 12], 0x10000 + curSlot * 0x1000, 0x1000);
+	LoadROM(sDev, 0, ROM_SIZE);
+
+	for (curSlot = 0; curSlot < 28; curSlot ++)
+	{
+		MultiPCM_Write(sDev, curSlot, 0x00, 0x00);	// centre
+		MultiPCM_Write(sDev, curSlot, 0x05, 0x20 | 0x01);	// TL, no interpolation
+	}
+
+	return;
+}
+
+static void MultiPCM_Tick(SCRIPT_DEV* sDev, UINT32 tick)
+{
+	UINT8 curSlot;
+	INT8 octave;
+	UINT16 fnum;
+
+	for (curSlot = 0; curSlot < 28; curSlot ++)
+	{
+		Ratio2OctFn(NoteRatio(tick, curSlot) >> 2, &octave, &fnum);
+		if (! (tick % NOTE_LEN))
+		{
+			MultiPCM_Write(sDev, curSlot, 0x04, 0x00);	// key off
+			MultiPCM_Write(sDev, curSlot, 0x01, curSlot);	// sample number
+		}
+		MultiPCM_Write(sDev, curSlot, 0x03, ((octave & 0x0F) << 4) | (fnum >> 6));
+		MultiPCM_Write(sDev, curSlot, 0x02, (fnum & 0x3F) << 2);
+		if (! (tick % NOTE_LEN))
+			MultiPCM_Write(sDev, curSlot, 0x04, 0x80);	// key on
+	}
+
+	return;
+}
+
+static void UPD7759_Init(SCRIPT_DEV* sDev)
+{
+	UINT8 curSmpl;
+	UINT8 curBlk;
+
+	// header + 4 samples with 16 blocks of 256 nibbles each
+	PrepareROM();
+	romData[0] = 4 - 1;	// last sample number
+	romData[1] = 0x5A;
+	romData[2] = 0xA5;
+	romData[3] = 0x69;
+	romData[4] = 0x55;
+	for (curSmpl = 0; curSmpl < 4; curSmpl ++)
+	{
+		UINT32 ofs = 0x1000 * (curSmpl + 1);
+		romData[5 + curSmpl * 2 + 0] = (UINT8)((ofs >> 1) >> 8);
+		romData[5 + curSmpl * 2 + 1] = (UINT8)((ofs >> 1) >> 0);
+		ofs ++;	// dummy byte
+		for (curBlk = 0; curBlk < 16; curBlk ++)
+		{
+			romData[ofs] = 0x40 | (curSmpl + 1);	// 256 nibbles, rate divider
+			ofs += 1 + 128;
+		}
+		romData[ofs + 0] = 0x00;	// end
+		romData[ofs + 1] = 0x00;
+	}
+	LoadROM(sDev, 0, 0x10000);
+
+	WriteReg(sDev, 0x00, 0x01);	// reset line high
+
+	return;
+}
+
+static void UPD7759_Tick(SCRIPT_DEV* sDev, UINT32 tick)
+{
+	if (tick % NOTE_LEN)
+		return;
+
+	WriteReg(sDev, 0x00, 0x00);	// reset (stops the current sample)
+	WriteReg(sDev, 0x00, 0x01);
+	WriteReg(sDev, 0x02, (tick / NOTE_LEN) & 0x03);	// sample number
+	WriteReg(sDev, 0x01, 0x00);
+	WriteReg(sDev, 0x01, 0x01);	// start
+
+	return;
+}
+
+static void MSM6258_Init(SCRIPT_DEV* sDev)
+{
+	WriteReg(sDev, 0x02, 0x00);	// pan: both
+	WriteReg(sDev, 0x00, 0x02);	// play
+
+	return;
+}
+
+static void MSM6258_Tick(SCRIPT_DEV* sDev, UINT32 tick)
+{
+	return;
+}
+
+static void MSM6258_Stream(SCRIPT_DEV* sDev, UINT32 pos)
+{
+	WriteReg(sDev, 0x01, sineROM[pos % ROM_SIZE]);
+	return;
+}
+
+static void OKIM6295_Init(SCRIPT_DEV* sDev)
+{
+	UINT8 curPhr;
+
+	// phrase table: phrases 1..4 with 4 KB each
+	PrepareROM();
+	memset(romData, 0x00, 0x400);
+	for (curPhr = 1; curPhr <= 4; curPhr ++)
+	{
+		UINT32 start = curPhr * 0x1000;
+		UINT32 end = start + 0x0FFF;
+		romData[curPhr * 8 + 0] = (start >> 16) & 0x03;
+		romData[curPhr * 8 + 1] = (start >> 8) & 0xFF;
+		romData[curPhr * 8 + 2] = (start >> 0) & 0xFF;
+		romData[curPhr * 8 + 3] = (end >> 16) & 0x03;
+		romData[curPhr * 8 + 4] = (end >> 8) & 0xFF;
+		romData[curPhr * 8 + 5] = (end >> 0) & 0xFF;
+	}
+	LoadROM(sDev, 0, 0x40000);
+
+	return;
+}
+
+static void OKIM6295_Tick(SCRIPT_DEV* sDev, UINT32 tick)
+{
+	UINT8 curVoice;
+
+	if (tick % NOTE_LEN)
+		return;
+	for (curVoice = 0; curVoice < 4; curVoice ++)
+	{
+		WriteReg(sDev, 0x00, 0x08 << curVoice);	// stop voice
+		WriteReg(sDev, 0x00, 0x80 | (1 + ((tick / NOTE_LEN + curVoice) & 0x03)));	// phrase
+		WriteReg(sDev, 0x00, (0x10 << curVoice) | 0x00);	// voice, attenuation
+	}
+
+	return;
+}
+
+static void K054539_Init(SCRIPT_DEV* sDev)
+{
+	UINT8 curChn;
+
+	// channel n plays the 4 KB from n * 0x1000, terminated by an end marker
+	PrepareROM();
+	for (curChn = 0; curChn < 8; curChn ++)
+		romData[curChn * 0x1000 + 0x0FFF] = 0x80;
+	LoadROM(sDev, 0, ROM_SIZE);
+
+	WriteReg16(sDev, 0x22F, 0x01);	// enable output
+	for (curChn = 0; curChn < 8; curChn ++)
+	{
+		UINT16 base = curChn * 0x20;
+		UINT32 start = curChn * 0x1000;
+		WriteReg16(sDev, base + 0x03, 0x10);	// volume
+		WriteReg16(sDev, base + 0x04, 0x00);	// reverb
+		WriteReg16(sDev, base + 0x05, 0x18);	// centre
+		WriteReg16(sDev, base + 0x08, (start >> 0) & 0xFF);	// loop address
+		WriteReg16(sDev, base + 0x09, (start >> 8) & 0xFF);
+		WriteReg16(sDev, base + 0x0A, (start >> 16) & 0xFF);
+		WriteReg16(sDev, base + 0x0C, (start >> 0) & 0xFF);	// start address
+		WriteReg16(sDev, base + 0x0D, (start >> 8) & 0xFF);
+		WriteReg16(sDev, base + 0x0E, (start >> 16) & 0xFF);
+		WriteReg16(sDev, 0x200 + curChn * 2, 0x00);	// 8-bit PCM
+		WriteReg16(sDev, 0x201 + curChn * 2, 0x01);	// loop
+	}
+
+	return;
+}
+
+static void K054539_Tick(SCRIPT_DEV* sDev, UINT32 tick)
+{
+	UINT8 curChn;
+
+	for (curChn = 0; curChn < 8; curChn ++)
+	{
+		UINT16 base = curChn * 0x20;
+		UINT32 delta = NoteFreq(0x4000, tick, curChn);
+		WriteReg16(sDev, base + 0x00, (delta >> 0) & 0xFF);
+		WriteReg16(sDev, base + 0x01, (delta >> 8) & 0xFF);
+		WriteReg16(sDev, base + 0x02, (delta >> 16) & 0xFF);
+	}
+	if (! (tick % NOTE_LEN))
+	{
+		WriteReg16(sDev, 0x215, 0xFF);	// key off
+		WriteReg16(sDev, 0x214, 0xFF);	// key on
+	}
+
+	return;
+}
+
+static void C140_Init(SCRIPT_DEV* sDev)
+{
+	UINT8 curChn;
+
+	PrepareROM();
+	LoadROM(sDev, 0, ROM_SIZE);
+
+	for (curChn = 0; curChn < 24; curChn ++)
+	{
+		UINT16 base = curChn * 0x10;
+		UINT16 start = (curChn & 0x0F) * 0x1000;
+		WriteReg16(sDev, base + 0x00, 0x40);	// volume R
+		WriteReg16(sDev, base + 0x01, 0x40);	// volume L
+		WriteReg16(sDev, base + 0x04, curChn >> 4);	// bank
+		WriteReg16(sDev, base + 0x06, start >> 8);	// start address
+		WriteReg16(sDev, base + 0x07, start & 0xFF);
+		WriteReg16(sDev, base + 0x08, (start + 0x0FFF) >> 8);	// end address
+		WriteReg16(sDev, base + 0x09, (start + 0x0FFF) & 0xFF);
+		WriteReg16(sDev, base + 0x0A, start >> 8);	// loop address
+		WriteReg16(sDev, base + 0x0B, start & 0xFF);
+	}
+
+	return;
+}
+
+static void C140_Tick(SCRIPT_DEV* sDev, UINT32 tick)
+{
+	UINT8 curChn;
+
+	for (curChn = 0; curChn < 24; curChn ++)
+	{
+		UINT16 base = curChn * 0x10;
+		UINT32 freq = NoteFreq(0x4000, tick, curChn);
+		WriteReg16(sDev, base + 0x02, (freq >> 8) & 0xFF);
+		WriteReg16(sDev, base + 0x03, freq & 0xFF);
+		if (! (tick % NOTE_LEN))
+		{
+			WriteReg16(sDev, base + 0x05, 0x00);	// key off
+			WriteReg16(sDev, base + 0x05, 0x80 | 0x10);	// key on, loop
+		}
+	}
+
+	return;
+}
+
+static void C219_Init(SCRIPT_DEV* sDev)
+{
+	UINT8 curChn;
+
+	PrepareROM();
+	LoadROM(sDev, 0, ROM_SIZE);
+
+	WriteReg16(sDev, 0x1F7, 0x00);	// banks for voices 0..3, 4..7, 8..11, 12..15
+	WriteReg16(sDev, 0x1F1, 0x00);
+	WriteReg16(sDev, 0x1F3, 0x00);
+	WriteReg16(sDev, 0x1F5, 0x00);
+	for (curChn = 0; curChn < 16; curChn ++)
+	{
+		UINT16 base = curChn * 0x10;
+		UINT16 start = curChn * 0x800;	// in words
+		WriteReg16(sDev, base + 0x00, 0x40);
+		WriteReg16(sDev, base + 0x01, 0x40);
+		WriteReg16(sDev, base + 0x06, start >> 8);
+		WriteReg16(sDev, base + 0x07, start & 0xFF);
+		WriteReg16(sDev, base + 0x08, (start + 0x07FF) >> 8);
+		WriteReg16(sDev, base + 0x09, (start + 0x07FF) & 0xFF);
+		WriteReg16(sDev, base + 0x0A, start >> 8);
+		WriteReg16(sDev, base + 0x0B, start & 0xFF);
+	}
+
+	return;
+}
+
+static void C219_Tick(SCRIPT_DEV* sDev, UINT32 tick)
+{
+	UINT8 curChn;
+
+	for (curChn = 0; curChn < 16; curChn ++)
+	{
+		UINT16 base = curChn * 0x10;
+		UINT32 freq = NoteFreq(0x4000, tick, curChn);
+		WriteReg16(sDev, base + 0x02, (freq >> 8) & 0xFF);
+		WriteReg16(sDev, base + 0x03, freq & 0xFF);
+		if (! (tick % NOTE_LEN))
+		{
+			// voice 15 uses the noise generator
+			UINT8 mode = (curChn == 15) ? 0x04 : 0x00;
+			WriteReg16(sDev, base + 0x05, mode);
+			WriteReg16(sDev, base + 0x05, 0x80 | 0x10 | mode);
+		}
+	}
+
+	return;
+}
+
+static void K053260_Init(SCRIPT_DEV* sDev)
+{
+	UINT8 curChn;
+
+	PrepareROM();
+	LoadROM(sDev, 0, ROM_SIZE);
+
+	WriteReg(sDev, 0x2F, 0x02);	// sound output enable
+	WriteReg(sDev, 0x2A, 0x0F);	// loop on all voices, PCM
+	WriteReg(sDev, 0x2C, 0x24);	// pan: centre
+	WriteReg(sDev, 0x2D, 0x24);
+	for (curChn = 0; curChn < 4; curChn ++)
+	{
+		UINT8 base = 0x08 + curChn * 8;
+		UINT32 start = curChn * 0x1000;
+		WriteReg(sDev, base + 2, 0xFF);	// length
+		WriteReg(sDev, base + 3, 0x0F);
+		WriteReg(sDev, base + 4, (start >> 0) & 0xFF);
+		WriteReg(sDev, base + 5, (start >> 8) & 0xFF);
+		WriteReg(sDev, base + 6, (start >> 16) & 0x1F);
+		WriteReg(sDev, base + 7, 0x7F);	// volume
+	}
+
+	return;
+}
+
+static void K053260_Tick(SCRIPT_DEV* sDev, UINT32 tick)
+{
+	UINT8 curChn;
+
+	for (curChn = 0; curChn < 4; curChn ++)
+	{
+		UINT8 base = 0x08 + curChn * 8;
+		UINT32 pitch = 0x1000 - NotePeriod(8, tick, curChn);
+		WriteReg(sDev, base + 0, pitch & 0xFF);
+		WriteReg(sDev, base + 1, (pitch >> 8) & 0x0F);
+	}
+	if (! (tick % NOTE_LEN))
+	{
+		WriteReg(sDev, 0x28, 0x00);
+		WriteReg(sDev, 0x28, 0x0F);	// key on
+	}
+
+	return;
+}
+
+static void K007232_Init(SCRIPT_DEV* sDev)
+{
+	UINT8 curChn;
+	UINT32 curPos;
+
+	// 7-bit samples, terminated by an end marker
+	PrepareROM();
+	for (curChn = 0; curChn < 2; curChn ++)
+	{
+		UINT32 start = 0x10000 + curChn * 0x2000;
+		for (curPos = 0; curPos < 0x1000; curPos ++)
+			romData[start + curPos] = (UINT8)((INT8)sineROM[curPos] / 2 + 0x40) & 0x7F;
+		romData[start + 0x1000] = 0x80;
+	}
+	LoadROM(sDev, 0, 0x20000);
+
+	WriteReg(sDev, 0x0D, 0x03);	// loop both channels
+	WriteReg(sDev, 0x10, 0xFF);	// channel volumes
+	WriteReg(sDev, 0x11, 0xFF);
+	WriteReg(sDev, 0x12, 0xFF);
+	WriteReg(sDev, 0x13, 0xFF);
+	for (curChn = 0; curChn < 2; curChn ++)
+	{
+		UINT32 start = 0x10000 + curChn * 0x2000;
+		WriteReg(sDev, curChn * 6 + 2, (start >> 0) & 0xFF);
+		WriteReg(sDev, curChn * 6 + 3, (start >> 8) & 0xFF);
+		WriteReg(sDev, curChn * 6 + 4, (start >> 16) & 0x01);
+	}
+
+	return;
+}
+
+static void K007232_Tick(SCRIPT_DEV* sDev, UINT32 tick)
+{
+	UINT8 curChn;
+
+	for (curChn = 0; curChn < 2; curChn ++)
+	{
+		UINT32 step = 0x1000 - NotePeriod(0x80, tick, curChn);
+		WriteReg(sDev, curChn * 6 + 0, step & 0xFF);
+		WriteReg(sDev, curChn * 6 + 1, (step >> 8) & 0x0F);
+		if (! (tick % NOTE_LEN))
+			WriteReg(sDev, curChn * 6 + 5, 0x00);	// key on
+	}
+
+	return;
+}
+
+static void QSound_Write(SCRIPT_DEV* sDev, UINT8 reg, UINT16 data)
+{
+	WriteReg(sDev, 0x00, data >> 8);
+	WriteReg(sDev, 0x01, data & 0xFF);
+	WriteReg(sDev, 0x02, reg);
+	return;
+}
+
+static void QSound_Init(SCRIPT_DEV* sDev)
+{
+	UINT8 curChn;
+
+	PrepareROM();
+	LoadROM(sDev, 0, ROM_SIZE);
+
+	for (curChn = 0; curChn < 16; curChn ++)
+		QSound_Write(sDev, 0x80 + curChn, 0x120);	// centre
+
+	return;
+}
+
+static void QSound_Tick(SCRIPT_DEV* sDev, UINT32 tick)
+{
+	UINT8 curChn;
+
+	for (curChn = 0; curChn < 16; curChn ++)
+	{
+		UINT8 base = curChn * 8;
+		UINT16 start = curChn * 0x800;
+		if (! (tick % NOTE_LEN))
+		{
+			QSound_Write(sDev, ((curChn - 1) & 0x0F) * 8 + 0, 0x8000);	// bank (register is used by the next voice)
+			QSound_Write(sDev, base + 1, start);	// start address
+			QSound_Write(sDev, base + 3, 0x8000);	// phase (key on)
+			QSound_Write(sDev, base + 4, 0x0800);	// loop length
+			QSound_Write(sDev, base + 5, start + 0x07FF);	// end address
+			QSound_Write(sDev, base + 6, 0x2000);	// volume
+		}
+		QSound_Write(sDev, base + 2, (UINT16)NoteFreq(0x0400, tick, curChn));	// rate
+	}
+
+	return;
+}
+
+static void SCSP_Init(SCRIPT_DEV* sDev)
+{
+	DEVFUNC_WRITE_BLOCK ramWrite;
+	UINT8 curSlot;
+
+	PrepareROM();
+	if (! SndEmu_GetDeviceFunc(sDev->base.defInf.devDef, RWF_MEMORY | RWF_WRITE, DEVRW_BLOCK, 0, (void**)&ramWrite))
+		ramWrite(sDev->base.defInf.dataPtr, 0x00, 0x80000, romData);
+
+	WriteReg16D16(sDev, 0x400, 0x000F);	// master volume
+	for (curSlot = 0; curSlot < 32; curSlot ++)
+	{
+		UINT16 base = curSlot * 0x20;
+		UINT32 start = curSlot * 0x1000;
+		WriteReg16D16(sDev, base + 0x00, 0x0020 | 0x0010 | (start >> 16));	// loop, 8-bit, start address
+		WriteReg16D16(sDev, base + 0x02, start & 0xFFFF);
+		WriteReg16D16(sDev, base + 0x04, 0x0000);	// loop start
+		WriteReg16D16(sDev, base + 0x06, 0x0FFF);	// loop end
+		WriteReg16D16(sDev, base + 0x08, (0x02 << 11) | (0x05 << 6) | 0x1F);	// D2R/D1R/AR
+		WriteReg16D16(sDev, base + 0x0A, (0x02 << 5) | 0x0C);	// DL/RR
+		WriteReg16D16(sDev, base + 0x0C, 0x0020);	// TL
+		WriteReg16D16(sDev, base + 0x16, (0x05 << 13) | (0x00 << 8));	// direct send level/pan
+	}
+
+	return;
+}
+
+static void SCSP_Tick(SCRIPT_DEV* sDev, UINT32 tick)
+{
+	UINT8 curSlot;
+	INT8 octave;
+	UINT16 fnum;
+
+	for (curSlot = 0; curSlot < 32; curSlot ++)
+	{
+		UINT16 base = curSlot * 0x20;
+		UINT32 start = curSlot * 0x1000;
+		Ratio2OctFn(NoteRatio(tick, curSlot) >> 2, &octave, &fnum);
+		WriteReg16D16(sDev, base + 0x10, ((octave & 0x0F) << 11) | fnum);
+		if (! (tick % NOTE_LEN))
+		{
+			WriteReg16D16(sDev, base + 0x00, 0x1000 | 0x0020 | 0x0010 | (start >> 16));	// key off
+			WriteReg16D16(sDev, base + 0x00, 0x1000 | 0x0800 | 0x0020 | 0x0010 | (start >> 16));	// key on
+		}
+	}
+
+	return;
+}
+
+static void ES5503_Init(SCRIPT_DEV* sDev)
+{
+	DEVFUNC_WRITE_BLOCK ramWrite;
+	UINT32 curPos;
+	UINT8 curOsc;
+
+	// unsigned samples, 0x00 would halt the oscillator
+	PrepareROM();
+	for (curPos = 0; curPos < 0x20000; curPos ++)
+		romData[curPos] ^= 0x80;
+	if (! SndEmu_GetDeviceFunc(sDev->base.defInf.devDef, RWF_MEMORY | RWF_WRITE, DEVRW_BLOCK, 0, (void**)&ramWrite))
+		ramWrite(sDev->base.defInf.dataPtr, 0x00, 0x20000, romData);
+
+	WriteReg(sDev, 0xE1, 31 << 1);	// 32 oscillators (changes the sample rate)
+	for (curOsc = 0; curOsc < 32; curOsc ++)
+	{
+		WriteReg(sDev, 0xA0 + curOsc, 0x01);	// halt
+		WriteReg(sDev, 0x40 + curOsc, 0x80);	// volume
+		WriteReg(sDev, 0x80 + curOsc, curOsc);	// wave table pointer (256-byte pages)
+		WriteReg(sDev, 0xC0 + curOsc, 0x00);	// table size 256, resolution 0
+	}
+
+	return;
+}
+
+static void ES5503_Tick(SCRIPT_DEV* sDev, UINT32 tick)
+{
+	UINT8 curOsc;
+
+	for (curOsc = 0; curOsc < 32; curOsc ++)
+	{
+		UINT32 freq = NoteFreq(0x100, tick, curOsc);
+		WriteReg(sDev, 0x00 + curOsc, freq & 0xFF);
+		WriteReg(sDev, 0x20 + curOsc, (freq >> 8) & 0xFF);
+		if (! (tick % NOTE_LEN))
+		{
+			WriteReg(sDev, 0xA0 + curOsc, 0x01);
+			WriteReg(sDev, 0xA0 + curOsc, (curOsc & 0x01) << 4);	// free-running, output channel
+		}
+	}
+
+	return;
+}
+
+static void X1_010_Init(SCRIPT_DEV* sDev)
+{
+	UINT8 curChn;
+	UINT8 curPos;
+
+	PrepareROM();
+	LoadROM(sDev, 0, ROM_SIZE);
+
+	// channels 0..7: PCM, channels 8..15: wave tables with a looping envelope
+	for (curPos = 0; curPos < 0x80; curPos ++)
+	{
+		WriteReg16(sDev, 0x1000 + curPos, sineROM[curPos]);	// wave 0
+		WriteReg16(sDev, 0x1080 + curPos, sineROM[curPos] >> 1);	// wave 1
+		WriteReg16(sDev, 0x0080 + curPos, (curPos < 0x40) ? 0xFF : 0x88);	// envelope 1
+	}
+	for (curChn = 0; curChn < 16; curChn ++)
+	{
+		UINT16 base = curChn * 8;
+		if (curChn < 8)
+		{
+			WriteReg16(sDev, base + 1, 0x88);	// volume
+			WriteReg16(sDev, base + 4, curChn);	// start address (4 KB units)
+			WriteReg16(sDev, base + 5, 0x100 - (curChn + 1));	// end address
+		}
+		else
+		{
+			WriteReg16(sDev, base + 1, curChn & 0x01);	// wave number
+			WriteReg16(sDev, base + 4, 0x04);	// envelope speed
+			WriteReg16(sDev, base + 5, 0x01);	// envelope number
+		}
+	}
+
+	return;
+}
+
+static void X1_010_Tick(SCRIPT_DEV* sDev, UINT32 tick)
+{
+	UINT8 curChn;
+
+	for (curChn = 0; curChn < 16; curChn ++)
+	{
+		UINT16 base = curChn * 8;
+		if (curChn < 8)
+		{
+			WriteReg16(sDev, base + 2, (UINT8)NoteFreq(0x08, tick, curChn));
+			if (! (tick % NOTE_LEN))
+			{
+				WriteReg16(sDev, base + 0, 0x00);
+				WriteReg16(sDev, base + 0, 0x01);	// key on
+			}
+		}
+		else
+		{
+			UINT32 freq = NoteFreq(0x39A, tick, curChn);
+			WriteReg16(sDev, base + 2, freq & 0xFF);
+			WriteReg16(sDev, base + 3, (freq >> 8) & 0xFF);
+			if (! (tick % NOTE_LEN))
+			{
+				WriteReg16(sDev, base + 0, 0x00);
+				WriteReg16(sDev, base + 0, 0x03);	// key on, wave table
+			}
+		}
+	}
+
+	return;
+}
+
+static void C352_Init(SCRIPT_DEV* sDev)
+{
+	UINT8 curChn;
+
+	PrepareROM();
+	LoadROM(sDev, 0, ROM_SIZE);
+
+	for (curChn = 0; curChn < 32; curChn ++)
+	{
+		UINT16 base = curChn * 8;
+		UINT16 start = curChn * 0x800;
+		WriteReg16D16(sDev, base + 0, 0x8080);	// front volume L/R
+		WriteReg16D16(sDev, base + 1, 0x0000);	// rear volume
+		WriteReg16D16(sDev, base + 4, 0x0000);	// bank
+		WriteReg16D16(sDev, base + 5, start);
+		WriteReg16D16(sDev, base + 6, start + 0x07FF);
+		WriteReg16D16(sDev, base + 7, start);
+	}
+
+	return;
+}
+
+static void C352_Tick(SCRIPT_DEV* sDev, UINT32 tick)
+{
+	UINT8 curChn;
+
+	for (curChn = 0; curChn < 32; curChn ++)
+	{
+		UINT16 base = curChn * 8;
+		WriteReg16D16(sDev, base + 2, (UINT16)NoteFreq(0x2000, tick, curChn));
+		if (! (tick % NOTE_LEN))
+			WriteReg16D16(sDev, base + 3, 0x4000 | 0x0002);	// key on, loop
+	}
+	if (! (tick % NOTE_LEN))
+		WriteReg16D16(sDev, 0x202, 0x0020);	// execute key on/off
+
+	return;
+}
+
+static void GA20_Init(SCRIPT_DEV* sDev)
+{
+	UINT8 curChn;
+
+	PrepareROM();
+	for (curChn = 0; curChn < 4; curChn ++)
+		romData[curChn * 0x1000 + 0x0FF0] = 0x00;	// end marker
+	LoadROM(sDev, 0, ROM_SIZE);
+
+	for (curChn = 0; curChn < 4; curChn ++)
+	{
+		UINT8 base = curChn * 8;
+		UINT32 start = curChn * 0x1000;
+		UINT32 end = start + 0x0FF0;
+		WriteReg(sDev, base + 0, (start >> 4) & 0xFF);
+		WriteReg(sDev, base + 1, (start >> 12) & 0xFF);
+		WriteReg(sDev, base + 2, (end >> 4) & 0xFF);
+		WriteReg(sDev, base + 3, (end >> 12) & 0xFF);
+		WriteReg(sDev, base + 5, 0xFF);	// volume
+	}
+
+	return;
+}
+
+static void GA20_Tick(SCRIPT_DEV* sDev, UINT32 tick)
+{
+	UINT8 curChn;
+
+	for (curChn = 0; curChn < 4; curChn ++)
+	{
+		UINT8 base = curChn * 8;
+		WriteReg(sDev, base + 4, (UINT8)(0x100 - NotePeriod(0x20, tick, curChn)));	// rate
+		if (! (tick % NOTE_LEN))
+			WriteReg(sDev, base + 6, 0x02);	// play
+	}
+
+	return;
+}
+
+static void MSM5205_Init(SCRIPT_DEV* sDev)
+{
+	WriteReg(sDev, 0x00, 0x00);	// release reset
+	return;
+}
+
+static void MSM5205_Tick(SCRIPT_DEV* sDev, UINT32 tick)
+{
+	return;
+}
+
+static void MSM5205_Stream(SCRIPT_DEV* sDev, UINT32 pos)
+{
+	WriteReg(sDev, 0x01, (sineROM[(pos / 2) % ROM_SIZE] >> ((pos & 1) * 4)) & 0x0F);
+	return;
+}
+
+static void BSMT2000_Write(SCRIPT_DEV* sDev, UINT8 reg, UINT16 data)
+{
+	WriteReg(sDev, 0x00, data >> 8);
+	WriteReg(sDev, 0x01, data & 0xFF);
+	WriteReg(sDev, 0x02, reg);
+	return;
+}
+
+static void BSMT2000_Init(SCRIPT_DEV* sDev)
+{
+	UINT8 curChn;
+
+	PrepareROM();
+	LoadROM(sDev, 0, ROM_SIZE);
+
+	for (curChn = 0; curChn < 12; curChn ++)
+	{
+		UINT16 start = curChn * 0x1000;
+		BSMT2000_Write(sDev, 0x3C + curChn, 0x0000);	// bank
+		BSMT2000_Write(sDev, 0x30 + curChn, start);	// loop start
+		BSMT2000_Write(sDev, 0x24 + curChn, start + 0x0FFF);	// loop end
+		BSMT2000_Write(sDev, 0x48 + curChn, 0x4000);	// volume
+	}
+
+	return;
+}
+
+static void BSMT2000_Tick(SCRIPT_DEV* sDev, UINT32 tick)
+{
+	UINT8 curChn;
+
+	for (curChn = 0; curChn < 12; curChn ++)
+	{
+		BSMT2000_Write(sDev, 0x18 + curChn, (UINT16)NoteFreq(0x0200, tick, curChn));	// rate
+		if (! (tick % NOTE_LEN))
+			BSMT2000_Write(sDev, 0x00 + curChn, curChn * 0x1000);	// current position
+	}
+
+	return;
+}
+
+static void ICS2115_Write(SCRIPT_DEV* sDev, UINT8 reg, UINT8 highByte, UINT8 data)
+{
+	WriteReg(sDev, 0x01, reg);
+	WriteReg(sDev, highByte ? 0x03 : 0x02, data);
+	return;
+}
+
+static void ICS2115_Init(SCRIPT_DEV* sDev)
+{
+	UINT8 curOsc;
+
+	PrepareROM();
+	LoadROM(sDev, 0, ROM_SIZE);
+
+	ICS2115_Write(sDev, 0x0E, 1, 31);	// 32 active voices (changes the sample rate)
+	for (curOsc = 0; curOsc < 32; curOsc ++)
+	{
+		UINT32 start = (curOsc * 0x1000) << 12;
+		UINT32 end = ((curOsc * 0x1000) + 0x0FFF) << 12;
+		ICS2115_Write(sDev, 0x4F, 0, curOsc);
+		ICS2115_Write(sDev, 0x10, 1, 0x0F);	// stop
+		ICS2115_Write(sDev, 0x02, 0, (start >> 16) & 0xFF);	// start address
+		ICS2115_Write(sDev, 0x02, 1, (start >> 24) & 0xFF);
+		ICS2115_Write(sDev, 0x03, 1, (start >> 8) & 0xFF);
+		ICS2115_Write(sDev, 0x04, 0, (end >> 16) & 0xFF);	// end address
+		ICS2115_Write(sDev, 0x04, 1, (end >> 24) & 0xFF);
+		ICS2115_Write(sDev, 0x05, 1, (end >> 8) & 0xFF);
+		ICS2115_Write(sDev, 0x09, 0, 0xF0);	// volume
+		ICS2115_Write(sDev, 0x09, 1, 0xFF);
+		ICS2115_Write(sDev, 0x0C, 1, 0x7F);	// centre
+		ICS2115_Write(sDev, 0x0D, 1, 0x01);	// volume envelope done
+		ICS2115_Write(sDev, 0x11, 1, 0x00);
+	}
+
+	return;
+}
+
+static void ICS2115_Tick(SCRIPT_DEV* sDev, UINT32 tick)
+{
+	UINT8 curOsc;
+
+	for (curOsc = 0; curOsc < 32; curOsc ++)
+	{
+		UINT32 start = (curOsc * 0x1000) << 12;
+		UINT32 freq = NoteFreq(0x0100, tick, curOsc);
+		ICS2115_Write(sDev, 0x4F, 0, curOsc);
+		ICS2115_Write(sDev, 0x01, 0, freq & 0xFF);
+		ICS2115_Write(sDev, 0x01, 1, (freq >> 8) & 0xFF);
+		if (! (tick % NOTE_LEN))
+		{
+			ICS2115_Write(sDev, 0x10, 1, 0x0F);	// stop
+			ICS2115_Write(sDev, 0x0A, 0, (start >> 16) & 0xFF);	// current address
+			ICS2115_Write(sDev, 0x0A, 1, (start >> 24) & 0xFF);
+			ICS2115_Write(sDev, 0x0B, 1, (start >> 8) & 0xFF);
+			ICS2115_Write(sDev, 0x00, 1, 0x0C);	// 8-bit, loop
+			ICS2115_Write(sDev, 0x10, 1, 0x00);	// key on
+		}
+	}
+
+	return;
+}
+
+
+static const SCRIPT_DEF SCRIPT_DEFS[] =
+{
+	{DEVID_SN76496,  3579545, 0x00, SN76496_Init, SN76496_Tick, 0, NULL},
+	{DEVID_YM2413,   3579545, 0x00, YM2413_Init, YM2413_Tick, 0, NULL},
+	{DEVID_YM2612,   7670453, 0x00, YM2612_Init, YM2612_Tick, 8000, YM2612_Stream},
+	{DEVID_YM2151,   3579545, 0x00, YM2151_Init, YM2151_Tick, 0, NULL},
+	{DEVID_SEGAPCM,  4000000, 0x00, SegaPCM_Init, SegaPCM_Tick, 0, NULL},
+	{DEVID_RF5C68,  12500000, 0x00, RF5C68_Init, RF5C68_Tick, 0, NULL},
+	{DEVID_YM2203,   3993600, 0x00, YM2203_Init, YM2203_Tick, 0, NULL},
+	{DEVID_YM2608,   7987200, 0x00, YM2608_Init, YM2608_Tick, 0, NULL},
+	{DEVID_YM2610,   8000000, 0x00, YM2610_Init, YM2610_Tick, 0, NULL},
+	{DEVID_YM3812,   3579545, 0x00, OPL2_Init, OPL2_Tick, 0, NULL},
+	{DEVID_YM3526,   3579545, 0x00, OPL2_Init, OPL2_Tick, 0, NULL},
+	{DEVID_Y8950,    3579545, 0x00, Y8950_Init, Y8950_Tick, 0, NULL},
+	{DEVID_YMF262,  14318180, 0x00, OPL3_Init, OPL3_Tick, 0, NULL},
+	{DEVID_YMF278B, 33868800, 0x00, YMF278B_Init, YMF278B_Tick, 0, NULL},
+	{DEVID_YMF271,  16934400, 0x00, YMF271_Init, YMF271_Tick, 0, NULL},
+	{DEVID_YMZ280B, 16934400, 0x00, YMZ280B_Init, YMZ280B_Tick, 0, NULL},
+	{DEVID_32X_PWM, 23011361, 0x00, PWM_Init, PWM_Tick, 22020, PWM_Stream},
+	{DEVID_AY8910,   1789772, 0x00, AY8910_Init, AY8910_Tick, 0, NULL},
+	{DEVID_GB_DMG,   4194304, 0x00, GB_Init, GB_Tick, 0, NULL},
+	{DEVID_NES_APU,  1789772, 0x01, NES_Init, NES_Tick, 0, NULL},	// with FDS
+	{DEVID_YMW258,   8053975, 0x00, MultiPCM_Init, MultiPCM_Tick, 0, NULL},
+	{DEVID_uPD7759,   640000, 0x00, UPD7759_Init, UPD7759_Tick, 0, NULL},
+	{DEVID_MSM6258,  4000000, 0x00, MSM6258_Init, MSM6258_Tick, 1953, MSM6258_Stream},
+	{DEVID_MSM6295,  1056000, 0x01, OKIM6295_Init, OKIM6295_Tick, 0, NULL},
+	{DEVID_K051649,  1789772, 0x00, K051649_Init, K051649_Tick, 0, NULL},
+	{DEVID_K054539, 18432000, 0x00, K054539_Init, K054539_Tick, 0, NULL},
+	{DEVID_C6280,    3579545, 0x00, C6280_Init, C6280_Tick, 0, NULL},
+	{DEVID_C140,     8192000, C140_TYPE_LINEAR, C140_Init, C140_Tick, 0, NULL},
+	{DEVID_C219,     8192000, 0x00, C219_Init, C219_Tick, 0, NULL},
+	{DEVID_K053260,  3579545, 0x00, K053260_Init, K053260_Tick, 0, NULL},
+	{DEVID_POKEY,    1789772, 0x00, Pokey_Init, Pokey_Tick, 0, NULL},
+	{DEVID_QSOUND,  60000000, 0x00, QSound_Init, QSound_Tick, 0, NULL},
+	{DEVID_SCSP,    22579200, 0x00, SCSP_Init, SCSP_Tick, 0, NULL},
+	{DEVID_WSWAN,    3072000, 0x00, WSwan_Init, WSwan_Tick, 0, NULL},
+	{DEVID_VBOY_VSU, 5000000, 0x00, VSU_Init, VSU_Tick, 0, NULL},
+	{DEVID_SAA1099,  8000000, 0x00, SAA1099_Init, SAA1099_Tick, 0, NULL},
+	{DEVID_ES5503,   7159090, 0x02, ES5503_Init, ES5503_Tick, 0, NULL},	// 2 output channels
+	{DEVID_X1_010,  16000000, 0x00, X1_010_Init, X1_010_Tick, 0, NULL},
+	{DEVID_C352,    24192000, 0x00, C352_Init, C352_Tick, 0, NULL},
+	{DEVID_GA20,     3579545, 0x00, GA20_Init, GA20_Tick, 0, NULL},
+	{DEVID_MIKEY,   16000000, 0x00, Mikey_Init, Mikey_Tick, 0, NULL},
+	{DEVID_K007232,  3579545, 0x00, K007232_Init, K007232_Tick, 0, NULL},
+	{DEVID_K005289,  3579545, 0x00, K005289_Init, K005289_Tick, 0, NULL},
+	{DEVID_MSM5205,   384000, 0x00, MSM5205_Init, MSM5205_Tick, 4000, MSM5205_Stream},
+	{DEVID_MSM5232,  2000000, 0x00, MSM5232_Init, MSM5232_Tick, 0, NULL},
+	{DEVID_BSMT2000, 24000000, 0x00, BSMT2000_Init, BSMT2000_Tick, 0, NULL},
+	{DEVID_ICS2115, 33868800, 0x00, ICS2115_Init, ICS2115_Tick, 0, NULL},
+	{DEVID_YM2414,   3579545, 0x00, YM2414_Init, YM2414_Tick, 0, NULL},
+};
+#define SCRIPT_DEF_COUNT	(sizeof(SCRIPT_DEFS) / sizeof(SCRIPT_DEFS[0]))
+
+const SCRIPT_DEF* CoreScript_GetDef(DEV_ID devID)
+{
+	size_t curDef;
+
+	for (curDef = 0; curDef < SCRIPT_DEF_COUNT; curDef ++)
+	{
+		if (SCRIPT_DEFS[curDef].devID == devID)
+			return &SCRIPT_DEFS[curDef];
+	}
+	return NULL;
+}
+
+static void CoreScript_SetupConfig(SCRIPT_CFG* cfg, const SCRIPT_DEF* sDef)
+{
+	UINT8 curCap;
+
+	memset(cfg, 0x00, sizeof(SCRIPT_CFG));
+	cfg->gen.clock = sDef->clock;
+	cfg->gen.flags = sDef->flags;
+	switch(sDef->devID)
+	{
+	case DEVID_SN76496:	// Sega PSG
+		cfg->sn76496.noiseTaps = 0x09;
+		cfg->sn76496.shiftRegWidth = 16;
+		cfg->sn76496.negate = 1;
+		cfg->sn76496.clkDiv = 8;
+		cfg->sn76496.segaPSG = 1;
+		break;
+	case DEVID_AY8910:
+		cfg->ay8910.chipType = AYTYPE_AY8910;
+		break;
+	case DEVID_SEGAPCM:
+		cfg->segapcm.bnkshift = SEGAPCM_BANK_512;
+		cfg->segapcm.bnkmask = SEGAPCM_BANK_MASK7;
+		break;
+	case DEVID_MSM6258:
+		cfg->msm6258.divider = MSM6258_DIV_1024;
+		break;
+	case DEVID_MSM5205:
+		cfg->msm5205.prescaler = 0x00;	// clock / 96
+		break;
+	case DEVID_MSM5232:
+		for (curCap = 0; curCap < 8; curCap ++)
+			cfg->msm5232.capacitors[curCap] = 1.0e-6;
+		break;
+	}
+
+	return;
+}
+
+
+static void CoreScript_SampleRateChange(void* userParam, UINT32 newSRate)
+{
+	DEV_INFO* devInf = (DEV_INFO*)userParam;
+	devInf->sampleRate = newSRate;
+	return;
+}
+
+void CoreScript_Init(void)
+{
+	sineROM = (UINT8*)malloc(ROM_SIZE);
+	romData = (UINT8*)malloc(ROM_SIZE);
+	GenerateSineROM();
+
+	return;
+}
+
+void CoreScript_Deinit(void)
+{
+	free(sineROM);	sineROM = NULL;
+	free(romData);	romData = NULL;
+
+	return;
+}
+
+UINT8 CoreScript_Start(const SCRIPT_DEF* sDef, const DEV_DEF* devDef, UINT8 srMode, UINT32 smplRate, SCRIPT_DEV* sDev)
+{
+	SCRIPT_CFG cfg;
+	VGM_BASEDEV* clDev;
+	UINT8 retVal;
+
+	CoreScript_SetupConfig(&cfg, sDef);
+	cfg.gen.emuCore = devDef->coreID;
+	cfg.gen.srMode = srMode;
+	cfg.gen.smplRate = smplRate;
+
+	memset(sDev, 0x00, sizeof(SCRIPT_DEV));
+	retVal = SndEmu_Start(sDef->devID, &cfg.gen, &sDev->base.defInf);
+	if (retVal)
+		return retVal;
+	SetupLinkedDevices(&sDev->base, NULL, NULL);
+	sDev->base.defInf.devDef->Reset(sDev->base.defInf.dataPtr);
+
+	devDef = sDev->base.defInf.devDef;
+	SndEmu_GetDeviceFunc(devDef, RWF_REGISTER | RWF_WRITE, DEVRW_A8D8, 0, (void**)&sDev->write8);
+	SndEmu_GetDeviceFunc(devDef, RWF_REGISTER | RWF_WRITE, DEVRW_A8D16, 0, (void**)&sDev->write8d16);
+	SndEmu_GetDeviceFunc(devDef, RWF_REGISTER | RWF_WRITE, DEVRW_A16D8, 0, (void**)&sDev->write16);
+	SndEmu_GetDeviceFunc(devDef, RWF_REGISTER | RWF_WRITE, DEVRW_A16D16, 0, (void**)&sDev->write16d16);
+	SndEmu_GetDeviceFunc(devDef, RWF_MEMORY | RWF_WRITE, DEVRW_A16D8, 0, (void**)&sDev->memWrite);
+
+	// Connecting a resampler replaces this callback. (The resampler follows rate changes by itself.)
+	for (clDev = &sDev->base; clDev != NULL; clDev = clDev->linkDev)
+	{
+		if (clDev->defInf.devDef->SetSRateChgCB != NULL)
+			clDev->defInf.devDef->SetSRateChgCB(clDev->defInf.dataPtr, CoreScript_SampleRateChange, &clDev->defInf);
+	}
+
+	return 0x00;
+}
+
+void CoreScript_Advance(const SCRIPT_DEF* sDef, SCRIPT_DEV* sDev, SCRIPT_POS* sPos, UINT32 endTick,
+	SCRIPT_RENDER renderFunc, void* userParam)
+{
+	UINT8 doTick;
+	UINT8 doStrm;
+
+	// Script ticks and stream writes are interleaved by their exact timestamps,
+	// so that the amount of rendering between two writes doesn't depend on rounding.
+	while(1)
+	{
+		doTick = (sPos->tick < endTick);
+		doStrm = (sDef->stream != NULL && (UINT64)sPos->strm * TICK_RATE < (UINT64)endTick * sDef->streamRate);
+		if (! doTick && ! doStrm)
+			break;
+		if (doStrm && (! doTick || (UINT64)sPos->strm * TICK_RATE < (UINT64)sPos->tick * sDef->streamRate))
+		{
+			renderFunc(userParam, sPos->strm, sDef->streamRate);
+			sDef->stream(sDev, sPos->strm);
+			sPos->strm ++;
+		}
+		else
+		{
+			renderFunc(userParam, sPos->tick, TICK_RATE);
+			sDef->tick(sDev, sPos->tick);
+			sPos->tick ++;
+		}
+	}
+
+	return;
+}
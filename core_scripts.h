@@ -0,0 +1,83 @@
+#ifndef __CORE_SCRIPTS_H__
+#define __CORE_SCRIPTS_H__
+
+// Deterministic register write scripts for all sound devices, used by libvgm-corebench and statetest.
+
+#include "stdtype.h"
+#include "emu/EmuStructs.h"
+#include "emu/cores/sn764intf.h"
+#include "emu/cores/ayintf.h"
+#include "emu/cores/segapcm.h"
+#include "emu/cores/okim6258.h"
+#include "emu/cores/msm5205.h"
+#include "emu/cores/msm5232.h"
+#include "player/helper.h"
+
+#define TICK_RATE		60		// rate of the register write script (Hz)
+
+typedef struct _script_device
+{
+	VGM_BASEDEV base;
+	DEVFUNC_WRITE_A8D8 write8;			// 8-bit offset, 8-bit data
+	DEVFUNC_WRITE_A8D16 write8d16;		// 8-bit offset, 16-bit data
+	DEVFUNC_WRITE_A16D8 write16;		// 16-bit offset, 8-bit data
+	DEVFUNC_WRITE_A16D16 write16d16;	// 16-bit offset, 16-bit data
+	DEVFUNC_WRITE_A16D8 memWrite;		// single byte RAM write
+} SCRIPT_DEV;
+
+// init: sets up the device, called once after the device was started
+// tick: called with TICK_RATE, does key-ons and pitch sweeps
+// stream: called with streamRate, feeds sample data (DAC/ADPCM streams)
+typedef void (*SCRIPT_INIT)(SCRIPT_DEV* sDev);
+typedef void (*SCRIPT_TICK)(SCRIPT_DEV* sDev, UINT32 pos);
+
+typedef struct _script_definition
+{
+	DEV_ID devID;
+	UINT32 clock;
+	UINT8 flags;
+	SCRIPT_INIT init;
+	SCRIPT_TICK tick;
+	UINT32 streamRate;
+	SCRIPT_TICK stream;
+} SCRIPT_DEF;
+
+typedef union _script_config
+{
+	DEV_GEN_CFG gen;
+	SN76496_CFG sn76496;
+	AY8910_CFG ay8910;
+	SEGAPCM_CFG segapcm;
+	MSM6258_CFG msm6258;
+	MSM5205_CFG msm5205;
+	MSM5232_CFG msm5232;
+} SCRIPT_CFG;
+
+// The scripts only depend on their position, so saving and restoring it is enough to replay them.
+typedef struct _script_position
+{
+	UINT32 tick;	// next script tick
+	UINT32 strm;	// next stream write
+} SCRIPT_POS;
+
+// renders the devices up to the time timeNum/timeDen seconds
+typedef void (*SCRIPT_RENDER)(void* userParam, UINT64 timeNum, UINT64 timeDen);
+
+
+// allocate and generate the synthetic sample ROM, must be called before running any script
+void CoreScript_Init(void);
+void CoreScript_Deinit(void);
+// return the script for a device, NULL if there is none
+const SCRIPT_DEF* CoreScript_GetDef(DEV_ID devID);
+// Start the device (including linked devices) with the script's configuration and reset it.
+// The device's sample rate is kept up-to-date in defInf.sampleRate.
+// The script's init function is not called, so that the caller can connect resamplers first.
+UINT8 CoreScript_Start(const SCRIPT_DEF* sDef, const DEV_DEF* devDef, UINT8 srMode, UINT32 smplRate, SCRIPT_DEV* sDev);
+// Run all script ticks and stream writes before script tick endTick.
+// The devices are rendered up to each write's timestamp first.
+void CoreScript_Advance(const SCRIPT_DEF* sDef, SCRIPT_DEV* sDev, SCRIPT_POS* sPos, UINT32 endTick,
+	SCRIPT_RENDER renderFunc, void* userParam);
+// convert a core's four-character code into a string (buffer must hold 5 characters)
+void CoreScript_FCC2Str(UINT32 fcc, char* buffer);
+
+#endif	// __CORE_SCRIPTS_H__
@@ -54,10 +54,17 @@ typedef void (*DEVFUNC_WRITE_A16D8)(void* info, UINT16 addr, UINT8 data);
 typedef void (*DEVFUNC_WRITE_A16D16)(void* info, UINT16 addr, UINT16 data);
 typedef void (*DEVFUNC_WRITE_MEMSIZE)(void* info, UINT32 memsize);
 typedef void (*DEVFUNC_WRITE_BLOCK)(void* info, UINT32 offset, UINT32 length, const UINT8* data);
+typedef void (*DEVFUNC_ALIAS_BLOCK)(void* info, UINT32 memsize, const UINT8* data);
 typedef void (*DEVFUNC_WRITE_CLOCK)(void* info, UINT32 clock);
 typedef void (*DEVFUNC_WRITE_VOLUME)(void* info, INT32 volume);	// 16.16 fixed point
 typedef void (*DEVFUNC_WRITE_VOL_LR)(void* info, INT32 volL, INT32 volR);
 
+typedef UINT32 (*DEVFUNC_STATE_SIZE)(void* info);
+typedef UINT8 (*DEVFUNC_STATE_SAVE)(void* info, UINT32 bufSize, void* buffer);
+typedef UINT8 (*DEVFUNC_STATE_LOAD)(void* info, UINT32 dataSize, const void* data);
+typedef void (*DEVFUNC_SKIP)(void* info, UINT32 samples);
+typedef void (*DEVFUNC_UPDATE_MIX)(void* info, UINT32 samples, DEV_SMPL* mixBuf, INT32 volL, INT32 volR);
+
 #define RWF_WRITE		0x00
 #define RWF_READ		0x01
 #define RWF_QUICKWRITE	(0x02 | RWF_WRITE)
@@ -71,6 +78,16 @@ typedef void (*DEVFUNC_WRITE_VOL_LR)(void* info, INT32 volL, INT32 volR);
 #define RWF_VOLUME_LR	0x86	// volume (left/right separately)
 #define RWF_CHN_MUTE	0x90	// set channel muting (DEVRW_VALUE = single channel, DEVRW_ALL = mask)
 #define RWF_CHN_PAN		0x92	// set channel panning (DEVRW_VALUE = single channel, DEVRW_ALL = array)
+#define RWF_STATE		0xA0	// device state, read = save, write = load (DEVRW_BLOCK = state data, DEVRW_MEMSIZE = state size)
+// Note: State data is a raw copy of the core's internal structures and is only valid
+//       for the device instance it was saved from.
+//       ROM contents and user settings (muting, panning, volume, options) are not part of the state.
+#define RWF_SKIP		0xA2	// advance the device by a number of samples without generating output (write, DEVRW_VALUE)
+// Note: Skipping has to leave the device in the same state as an Update() call with the same number of samples.
+#define RWF_UPDATE_MIX	0xA4	// render and add the output to an interleaved stereo buffer (write, DEVRW_VALUE)
+// Note: The result has to be the same as calling Update() and then doing
+//       mixBuf[i * 2 + 0] += outputs[0][i] * volL; mixBuf[i * 2 + 1] += outputs[1][i] * volR;
+//       This saves the intermediate buffers when the output doesn't need to be resampled.
 
 // register/memory DEVRW constants
 #define DEVRW_A8D8		0x11	//  8-bit address,  8-bit data
@@ -79,6 +96,10 @@ typedef void (*DEVFUNC_WRITE_VOL_LR)(void* info, INT32 volL, INT32 volR);
 #define DEVRW_A16D16	0x22	// 16-bit address, 16-bit data
 #define DEVRW_BLOCK		0x80	// write sample ROM/RAM
 #define DEVRW_MEMSIZE	0x81	// set ROM/RAM size
+#define DEVRW_BLOCK_ALIAS	0x82	// use external memory as ROM without copying it (read-only, see below)
+// Note: With DEVRW_BLOCK_ALIAS, the device reads the ROM directly from the caller's memory, so it must stay
+//       valid until the device is stopped or gets another ROM. DEVRW_BLOCK/DEVRW_MEMSIZE calls that follow
+//       make the device copy the data first.
 // chip setting DEVRW constants
 #define DEVRW_VALUE		0x00
 #define DEVRW_ALL		0x01
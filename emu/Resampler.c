@@ -1,17 +1,82 @@
 #include <stddef.h>
 #include <stdlib.h>	// for malloc/free
+#include <string.h>	// for memmove
+#include <math.h>
 #ifdef _DEBUG
 #include <stdio.h>
 #endif
 
+// SIMD kernels: SSE2 and NEON are used when the compiler targets them,
+// AVX2 is compiled in separately and used only when the CPU supports it.
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define RESMPL_SIMD_SSE2
+#endif
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__clang__) || \
+	(defined(__GNUC__) && (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9))))
+#include <immintrin.h>
+#define RESMPL_SIMD_AVX2
+#define RESMPL_TARGET_AVX2	__attribute__((target("avx2")))
+#elif (defined(_M_X64) || defined(_M_IX86)) && defined(_MSC_VER) && _MSC_VER >= 1800
+#include <intrin.h>
+#include <immintrin.h>
+#define RESMPL_SIMD_AVX2
+#define RESMPL_TARGET_AVX2
+#endif
+#if defined(__ARM_NEON) || defined(__ARM_NEON__) || defined(_M_ARM64)
+#include <arm_neon.h>
+#define RESMPL_SIMD_NEON
+#endif
+
+// The selected kernel table is published with a single pointer, so all resamplers see a consistent set.
+#if defined(_MSC_VER)
+#include <windows.h>
+#define ATOMIC_LOAD_PTR(ptr)			InterlockedCompareExchangePointer((PVOID volatile*)(ptr), NULL, NULL)
+#define ATOMIC_STORE_PTR(ptr, val)		InterlockedExchangePointer((PVOID volatile*)(ptr), (PVOID)(val))
+#define ATOMIC_CAS_PTR(ptr, cmp, val)	(InterlockedCompareExchangePointer((PVOID volatile*)(ptr), (PVOID)(val), (PVOID)(cmp)) == (cmp))
+#elif defined(__GNUC__)
+#define ATOMIC_LOAD_PTR(ptr)			__atomic_load_n(ptr, __ATOMIC_ACQUIRE)
+#define ATOMIC_STORE_PTR(ptr, val)		__atomic_store_n(ptr, val, __ATOMIC_RELEASE)
+#define ATOMIC_CAS_PTR(ptr, cmp, val)	__sync_bool_compare_and_swap(ptr, cmp, val)
+#else
+#define ATOMIC_LOAD_PTR(ptr)			(*(ptr))
+#define ATOMIC_STORE_PTR(ptr, val)		(*(ptr) = (val))
+#define ATOMIC_CAS_PTR(ptr, cmp, val)	((*(ptr) == (cmp)) ? (*(ptr) = (val), 1) : 0)
+#endif
+
 #include "../stdtype.h"
 #include "EmuStructs.h"
+#include "SoundEmu.h"	// for SndEmu_GetDeviceFunc
 #include "Resampler.h"
 
+#ifndef M_PI
+#define M_PI	3.14159265358979323846
+#endif
+
 static void Resmpl_Exec_Old(RESMPL_STATE* CAA, UINT32 length, WAVE_32BS* retSample);
 static void Resmpl_Exec_LinearUp(RESMPL_STATE* CAA, UINT32 length, WAVE_32BS* retSample);
 static void Resmpl_Exec_Copy(RESMPL_STATE* CAA, UINT32 length, WAVE_32BS* retSample);
 static void Resmpl_Exec_LinearDown(RESMPL_STATE* CAA, UINT32 length, WAVE_32BS* retSample);
+static void Resmpl_Exec_Sinc(RESMPL_STATE* CAA, UINT32 length, WAVE_32BS* retSample);
+static UINT8 Resmpl_Sinc_Setup(RESMPL_STATE* CAA);
+static void Resmpl_Sinc_Free(RESMPL_STATE* CAA);
+static void Resmpl_Decim_Setup(RESMPL_STATE* CAA);
+static void Resmpl_Decim_Free(RESMPL_STATE* CAA);
+static void Resmpl_Decim_Update(RESMPL_STATE* CAA, UINT32 samples, float** outputs);
+
+// SIMD kernels
+typedef void (*MIXPLANAR_FUNC)(WAVE_32BS* retSample, const DEV_SMPL* bufL, const DEV_SMPL* bufR, UINT32 length, INT32 volL, INT32 volR);
+typedef void (*SUMSTEREO_FUNC)(const DEV_SMPL* bufL, const DEV_SMPL* bufR, UINT32 length, INT64* sumL, INT64* sumR);
+typedef void (*DOTPROD_FUNC)(UINT32 len, const float* coeffs, const float* inL, const float* inR, float* retL, float* retR);
+typedef struct _resampler_kernels
+{
+	MIXPLANAR_FUNC MixPlanar;	// retSample[n] += buf[n] * volume
+	SUMSTEREO_FUNC SumStereo;	// sum += buf[0] + ... + buf[length - 1]
+	DOTPROD_FUNC DotProd;
+} RESMPL_KERNELS;
+static const RESMPL_KERNELS* Resmpl_FindKernels(UINT8 mask);
+static const RESMPL_KERNELS* Resmpl_GetKernels(void);
+static const RESMPL_KERNELS* selKernels = NULL;	// NULL = not selected yet, see Resmpl_GetKernels
 
 // Ensures `CAA->smplBufs[0]` and `CAA->smplBufs[1]` can each contain at least `length` samples.
 static void Resmpl_EnsureBuffers(RESMPL_STATE* CAA, UINT32 length)
@@ -34,6 +99,8 @@ void Resmpl_DevConnect(RESMPL_STATE* CAA, const DEV_INFO* devInf)
 {
 	CAA->smpRateSrc = devInf->sampleRate;
 	CAA->StreamUpdate = devInf->devDef->Update;
+	if (SndEmu_GetDeviceFunc(devInf->devDef, RWF_UPDATE_MIX | RWF_WRITE, DEVRW_VALUE, 0, (void**)&CAA->StreamUpdateMix))
+		CAA->StreamUpdateMix = NULL;
 	CAA->su_DataPtr = devInf->dataPtr;
 	if (devInf->devDef->SetSRateChgCB != NULL)
 		devInf->devDef->SetSRateChgCB(CAA->su_DataPtr, Resmpl_ChangeRate, CAA);
@@ -46,12 +113,22 @@ void Resmpl_SetVals(RESMPL_STATE* CAA, UINT8 resampleMode, UINT16 volume, UINT32
 	CAA->resampleMode = resampleMode;
 	CAA->smpRateDst = destSampleRate;
 	CAA->volumeL = volume;	CAA->volumeR = volume;
+	CAA->smplBufLimit = 0;
+	CAA->StreamUpdateMix = NULL;
+	
+	return;
+}
+
+void Resmpl_SetBufferLimit(RESMPL_STATE* CAA, UINT32 maxSamples)
+{
+	CAA->smplBufLimit = maxSamples;
 	
 	return;
 }
 
 static void Resmpl_ChooseResampler(RESMPL_STATE* CAA)
 {
+	Resmpl_Decim_Setup(CAA);	// must be done first, as it changes smpRateDstEff
 	switch(CAA->resampleMode)
 	{
 	case RSMODE_LINEAR:	// linear interpolation (good quality)
@@ -78,6 +155,15 @@ static void Resmpl_ChooseResampler(RESMPL_STATE* CAA)
 		else if (CAA->smpRateSrc > CAA->smpRateDst)
 			CAA->resampler = Resmpl_Exec_Old;
 		break;
+	case RSMODE_SINC:	// windowed-sinc filter
+	case RSMODE_SINC_HQ:
+		if (CAA->smpRateSrc == CAA->smpRateDstEff)
+			CAA->resampler = Resmpl_Exec_Copy;
+		else if (! Resmpl_Sinc_Setup(CAA))
+			CAA->resampler = Resmpl_Exec_Sinc;
+		else
+			CAA->resampler = Resmpl_Exec_LinearDown;	// fallback when out of memory
+		break;
 	default:
 #ifdef _DEBUG
 		printf("Invalid resampler mode 0x%02X used!\n", CAA->resampleMode);
@@ -89,6 +175,12 @@ static void Resmpl_ChooseResampler(RESMPL_STATE* CAA)
 
 void Resmpl_Init(RESMPL_STATE* CAA)
 {
+	UINT32 initSize;
+	
+	Resmpl_GetKernels();	// make sure the kernels are selected before the first Execute
+	CAA->sinc = NULL;
+	CAA->decim = NULL;
+	CAA->smpRateDstEff = CAA->smpRateDst;
 	if (! CAA->smpRateSrc)
 	{
 		CAA->resampler = NULL;
@@ -100,7 +192,18 @@ void Resmpl_Init(RESMPL_STATE* CAA)
 	CAA->smplBufSize = 0;
 	CAA->smplBufs[0] = NULL;
 	CAA->smplBufs[1] = NULL;
-	Resmpl_EnsureBuffers(CAA, CAA->smpRateSrc / 1); // reserve initial buffer for 1 second of samples
+	// reserve initial buffer for 1 second of samples (after decimation)
+	// Devices that mix into the output directly don't need the buffers, unless the sample rate changes later.
+	if (CAA->resampler != Resmpl_Exec_Copy || CAA->StreamUpdateMix == NULL)
+	{
+		initSize = CAA->smpRateSrc;
+		if (CAA->smpRateDstEff > CAA->smpRateDst)
+			initSize = (UINT32)((UINT64)initSize * CAA->smpRateDst / CAA->smpRateDstEff);
+		if (CAA->smplBufLimit && CAA->smplBufLimit < initSize)
+			Resmpl_EnsureBuffers(CAA, CAA->smplBufLimit);
+		else
+			Resmpl_EnsureBuffers(CAA, initSize);
+	}
 	
 	CAA->smpP = 0x00;
 	CAA->smpLast = 0x00;
@@ -125,6 +228,8 @@ void Resmpl_Init(RESMPL_STATE* CAA)
 
 void Resmpl_Deinit(RESMPL_STATE* CAA)
 {
+	Resmpl_Sinc_Free(CAA);
+	Resmpl_Decim_Free(CAA);
 	CAA->smplBufSize = 0;
 	free(CAA->smplBufs[0]);
 	CAA->smplBufs[0] = NULL;
@@ -170,6 +275,186 @@ void Resmpl_ChangeRate(void* DataPtr, UINT32 newSmplRate)
 #define fp2i_floor(x)	((x) / FIXPNT_FACT)
 #define fp2i_ceil(x)	((x + FIXPNT_MASK) / FIXPNT_FACT)
 
+// --- mixing kernels ---
+// All variants give exactly the same results as the C versions.
+static void Resmpl_MixPlanar_C(WAVE_32BS* retSample, const DEV_SMPL* bufL, const DEV_SMPL* bufR, UINT32 length, INT32 volL, INT32 volR)
+{
+	UINT32 CurSmpl;
+	
+	for (CurSmpl = 0; CurSmpl < length; CurSmpl ++)
+	{
+		retSample[CurSmpl].L += bufL[CurSmpl] * volL;
+		retSample[CurSmpl].R += bufR[CurSmpl] * volR;
+	}
+	
+	return;
+}
+
+static void Resmpl_SumStereo_C(const DEV_SMPL* bufL, const DEV_SMPL* bufR, UINT32 length, INT64* sumL, INT64* sumR)
+{
+	INT64 resL = 0;
+	INT64 resR = 0;
+	UINT32 CurSmpl;
+	
+	for (CurSmpl = 0; CurSmpl < length; CurSmpl ++)
+	{
+		resL += bufL[CurSmpl];
+		resR += bufR[CurSmpl];
+	}
+	*sumL += resL;
+	*sumR += resR;
+	
+	return;
+}
+
+#ifdef RESMPL_SIMD_SSE2
+// 32-bit multiplication, low 32 bits of the result (SSE2 has only _mm_mul_epu32)
+static __m128i SSE2_MulLo32(__m128i a, __m128i b)
+{
+	__m128i prodEven = _mm_mul_epu32(a, b);
+	__m128i prodOdd = _mm_mul_epu32(_mm_srli_epi64(a, 32), _mm_srli_epi64(b, 32));
+	return _mm_unpacklo_epi32(_mm_shuffle_epi32(prodEven, _MM_SHUFFLE(0, 0, 2, 0)),
+							_mm_shuffle_epi32(prodOdd, _MM_SHUFFLE(0, 0, 2, 0)));
+}
+
+static void Resmpl_MixPlanar_SSE2(WAVE_32BS* retSample, const DEV_SMPL* bufL, const DEV_SMPL* bufR, UINT32 length, INT32 volL, INT32 volR)
+{
+	const __m128i mVolL = _mm_set1_epi32(volL);
+	const __m128i mVolR = _mm_set1_epi32(volR);
+	UINT32 CurSmpl;
+	
+	for (CurSmpl = 0; CurSmpl + 4 <= length; CurSmpl += 4)
+	{
+		__m128i smplL = SSE2_MulLo32(_mm_loadu_si128((const __m128i*)&bufL[CurSmpl]), mVolL);
+		__m128i smplR = SSE2_MulLo32(_mm_loadu_si128((const __m128i*)&bufR[CurSmpl]), mVolR);
+		__m128i* outPtr = (__m128i*)&retSample[CurSmpl];
+		
+		_mm_storeu_si128(&outPtr[0], _mm_add_epi32(_mm_loadu_si128(&outPtr[0]), _mm_unpacklo_epi32(smplL, smplR)));
+		_mm_storeu_si128(&outPtr[1], _mm_add_epi32(_mm_loadu_si128(&outPtr[1]), _mm_unpackhi_epi32(smplL, smplR)));
+	}
+	Resmpl_MixPlanar_C(&retSample[CurSmpl], &bufL[CurSmpl], &bufR[CurSmpl], length - CurSmpl, volL, volR);
+	
+	return;
+}
+
+static void Resmpl_SumStereo_SSE2(const DEV_SMPL* bufL, const DEV_SMPL* bufR, UINT32 length, INT64* sumL, INT64* sumR)
+{
+	__m128i accL = _mm_setzero_si128();
+	__m128i accR = _mm_setzero_si128();
+	INT64 res[2];
+	UINT32 CurSmpl;
+	
+	for (CurSmpl = 0; CurSmpl + 4 <= length; CurSmpl += 4)
+	{
+		__m128i smplL = _mm_loadu_si128((const __m128i*)&bufL[CurSmpl]);
+		__m128i smplR = _mm_loadu_si128((const __m128i*)&bufR[CurSmpl]);
+		__m128i signL = _mm_srai_epi32(smplL, 31);
+		__m128i signR = _mm_srai_epi32(smplR, 31);
+		
+		// sign-extend to 64 bits
+		accL = _mm_add_epi64(accL, _mm_unpacklo_epi32(smplL, signL));
+		accL = _mm_add_epi64(accL, _mm_unpackhi_epi32(smplL, signL));
+		accR = _mm_add_epi64(accR, _mm_unpacklo_epi32(smplR, signR));
+		accR = _mm_add_epi64(accR, _mm_unpackhi_epi32(smplR, signR));
+	}
+	_mm_storeu_si128((__m128i*)res, accL);
+	*sumL += res[0] + res[1];
+	_mm_storeu_si128((__m128i*)res, accR);
+	*sumR += res[0] + res[1];
+	Resmpl_SumStereo_C(&bufL[CurSmpl], &bufR[CurSmpl], length - CurSmpl, sumL, sumR);
+	
+	return;
+}
+#endif	// RESMPL_SIMD_SSE2
+
+#ifdef RESMPL_SIMD_AVX2
+RESMPL_TARGET_AVX2
+static void Resmpl_MixPlanar_AVX2(WAVE_32BS* retSample, const DEV_SMPL* bufL, const DEV_SMPL* bufR, UINT32 length, INT32 volL, INT32 volR)
+{
+	const __m256i mVolL = _mm256_set1_epi32(volL);
+	const __m256i mVolR = _mm256_set1_epi32(volR);
+	UINT32 CurSmpl;
+	
+	for (CurSmpl = 0; CurSmpl + 8 <= length; CurSmpl += 8)
+	{
+		__m256i smplL = _mm256_mullo_epi32(_mm256_loadu_si256((const __m256i*)&bufL[CurSmpl]), mVolL);
+		__m256i smplR = _mm256_mullo_epi32(_mm256_loadu_si256((const __m256i*)&bufR[CurSmpl]), mVolR);
+		// unpack works within 128-bit lanes: lo = samples 0, 1, 4, 5, hi = samples 2, 3, 6, 7
+		__m256i smplLo = _mm256_unpacklo_epi32(smplL, smplR);
+		__m256i smplHi = _mm256_unpackhi_epi32(smplL, smplR);
+		__m256i* outPtr = (__m256i*)&retSample[CurSmpl];
+		
+		_mm256_storeu_si256(&outPtr[0], _mm256_add_epi32(_mm256_loadu_si256(&outPtr[0]),
+			_mm256_permute2x128_si256(smplLo, smplHi, 0x20)));
+		_mm256_storeu_si256(&outPtr[1], _mm256_add_epi32(_mm256_loadu_si256(&outPtr[1]),
+			_mm256_permute2x128_si256(smplLo, smplHi, 0x31)));
+	}
+	Resmpl_MixPlanar_C(&retSample[CurSmpl], &bufL[CurSmpl], &bufR[CurSmpl], length - CurSmpl, volL, volR);
+	
+	return;
+}
+
+RESMPL_TARGET_AVX2
+static void Resmpl_SumStereo_AVX2(const DEV_SMPL* bufL, const DEV_SMPL* bufR, UINT32 length, INT64* sumL, INT64* sumR)
+{
+	__m256i accL = _mm256_setzero_si256();
+	__m256i accR = _mm256_setzero_si256();
+	INT64 res[4];
+	UINT32 CurSmpl;
+	
+	for (CurSmpl = 0; CurSmpl + 4 <= length; CurSmpl += 4)
+	{
+		accL = _mm256_add_epi64(accL, _mm256_cvtepi32_epi64(_mm_loadu_si128((const __m128i*)&bufL[CurSmpl])));
+		accR = _mm256_add_epi64(accR, _mm256_cvtepi32_epi64(_mm_loadu_si128((const __m128i*)&bufR[CurSmpl])));
+	}
+	_mm256_storeu_si256((__m256i*)res, accL);
+	*sumL += (res[0] + res[1]) + (res[2] + res[3]);
+	_mm256_storeu_si256((__m256i*)res, accR);
+	*sumR += (res[0] + res[1]) + (res[2] + res[3]);
+	Resmpl_SumStereo_C(&bufL[CurSmpl], &bufR[CurSmpl], length - CurSmpl, sumL, sumR);
+	
+	return;
+}
+#endif	// RESMPL_SIMD_AVX2
+
+#ifdef RESMPL_SIMD_NEON
+static void Resmpl_MixPlanar_NEON(WAVE_32BS* retSample, const DEV_SMPL* bufL, const DEV_SMPL* bufR, UINT32 length, INT32 volL, INT32 volR)
+{
+	UINT32 CurSmpl;
+	
+	for (CurSmpl = 0; CurSmpl + 4 <= length; CurSmpl += 4)
+	{
+		INT32* outPtr = (INT32*)&retSample[CurSmpl];
+		int32x4x2_t out = vld2q_s32(outPtr);	// deinterleaves L/R
+		
+		out.val[0] = vmlaq_n_s32(out.val[0], vld1q_s32(&bufL[CurSmpl]), volL);
+		out.val[1] = vmlaq_n_s32(out.val[1], vld1q_s32(&bufR[CurSmpl]), volR);
+		vst2q_s32(outPtr, out);
+	}
+	Resmpl_MixPlanar_C(&retSample[CurSmpl], &bufL[CurSmpl], &bufR[CurSmpl], length - CurSmpl, volL, volR);
+	
+	return;
+}
+
+static void Resmpl_SumStereo_NEON(const DEV_SMPL* bufL, const DEV_SMPL* bufR, UINT32 length, INT64* sumL, INT64* sumR)
+{
+	int64x2_t accL = vdupq_n_s64(0);
+	int64x2_t accR = vdupq_n_s64(0);
+	UINT32 CurSmpl;
+	
+	for (CurSmpl = 0; CurSmpl + 4 <= length; CurSmpl += 4)
+	{
+		accL = vpadalq_s32(accL, vld1q_s32(&bufL[CurSmpl]));	// adds pairs of samples as 64-bit values
+		accR = vpadalq_s32(accR, vld1q_s32(&bufR[CurSmpl]));
+	}
+	*sumL += vgetq_lane_s64(accL, 0) + vgetq_lane_s64(accL, 1);
+	*sumR += vgetq_lane_s64(accR, 0) + vgetq_lane_s64(accR, 1);
+	Resmpl_SumStereo_C(&bufL[CurSmpl], &bufR[CurSmpl], length - CurSmpl, sumL, sumR);
+	
+	return;
+}
+#endif	// RESMPL_SIMD_NEON
+
 static void Resmpl_Exec_Old(RESMPL_STATE* CAA, UINT32 length, WAVE_32BS* retSample)
 {
 	// RESALGO_OLD: old, but very fast resampler
@@ -180,7 +465,7 @@ static void Resmpl_Exec_Old(RESMPL_STATE* CAA, UINT32 length, WAVE_32BS* retSamp
 	INT32 TempS32L;
 	INT32 TempS32R;
 	INT32 SmpCnt;	// must be signed, else I'm getting calculation errors
-	INT32 CurSmpl;
+	const RESMPL_KERNELS* krn = ATOMIC_LOAD_PTR(&selKernels);
 	
 	for (OutPos = 0; OutPos < length; OutPos ++)
 	{
@@ -222,13 +507,11 @@ static void Resmpl_Exec_Old(RESMPL_STATE* CAA, UINT32 length, WAVE_32BS* retSamp
 			}
 			else
 			{
-				TempS32L = CurBufL[0];
-				TempS32R = CurBufR[0];
-				for (CurSmpl = 1; CurSmpl < SmpCnt; CurSmpl ++)
-				{
-					TempS32L += CurBufL[CurSmpl];
-					TempS32R += CurBufR[CurSmpl];
-				}
+				INT64 sumL = 0;
+				INT64 sumR = 0;
+				krn->SumStereo(CurBufL, CurBufR, SmpCnt, &sumL, &sumR);
+				TempS32L = (INT32)sumL;
+				TempS32R = (INT32)sumR;
 				retSample[OutPos].L += TempS32L * CAA->volumeL / SmpCnt;
 				retSample[OutPos].R += TempS32R * CAA->volumeR / SmpCnt;
 				CAA->lSmpl.L = CurBufL[SmpCnt - 1];
@@ -329,16 +612,17 @@ static void Resmpl_Exec_LinearUp(RESMPL_STATE* CAA, UINT32 length, WAVE_32BS* re
 static void Resmpl_Exec_Copy(RESMPL_STATE* CAA, UINT32 length, WAVE_32BS* retSample)
 {
 	// RESALGO_COPY: Copying
-	UINT32 OutPos;
-	
 	CAA->smpNext = CAA->smpP * CAA->smpRateSrc / CAA->smpRateDst;
-	Resmpl_EnsureBuffers(CAA, length);
-	CAA->StreamUpdate(CAA->su_DataPtr, length, CAA->smplBufs);
-	
-	for (OutPos = 0; OutPos < length; OutPos ++)
+	if (CAA->StreamUpdateMix != NULL)
+	{
+		// let the device mix into the output directly
+		CAA->StreamUpdateMix(CAA->su_DataPtr, length, &retSample[0].L, CAA->volumeL, CAA->volumeR);
+	}
+	else
 	{
-		retSample[OutPos].L += CAA->smplBufs[0][OutPos] * CAA->volumeL;
-		retSample[OutPos].R += CAA->smplBufs[1][OutPos] * CAA->volumeR;
+		Resmpl_EnsureBuffers(CAA, length);
+		CAA->StreamUpdate(CAA->su_DataPtr, length, CAA->smplBufs);
+		ATOMIC_LOAD_PTR(&selKernels)->MixPlanar(retSample, CAA->smplBufs[0], CAA->smplBufs[1], length, CAA->volumeL, CAA->volumeR);
 	}
 	CAA->smpP += length;
 	CAA->smpLast = CAA->smpNext;
@@ -353,16 +637,16 @@ static void Resmpl_Exec_Copy(RESMPL_STATE* CAA, UINT32 length, WAVE_32BS* retSam
 	return;
 }
 
-// TODO: The resample is not completely stable.
-//	Resampling tiny blocks (1 resulting sample) sometimes causes values to be off-by-one,
-//	compared to resampling large blocks.
+// Note: The input range of each output sample only depends on its absolute position.
+//	(It is [floor(P * ratio), floor(P * ratio) + floor(ratio)], which is what resampling 1-sample blocks results in.)
+//	This makes the output independent of how the caller splits the rendering into blocks.
 static void Resmpl_Exec_LinearDown(RESMPL_STATE* CAA, UINT32 length, WAVE_32BS* retSample)
 {
 	// RESALGO_LINEAR_DOWN: Linear Downsampling
 	DEV_SMPL* CurBufL;
 	DEV_SMPL* CurBufR;
 	DEV_SMPL* StreamPnt[0x02];
-	UINT32 InBase;
+	UINT32 InStep;
 	UINT32 InPos;
 	UINT32 InPosNext;
 	UINT32 OutPos;
@@ -374,8 +658,10 @@ static void Resmpl_Exec_LinearDown(RESMPL_STATE* CAA, UINT32 length, WAVE_32BS*
 	INT64 TempSmpR;
 	INT32 SmpCnt;	// must be signed, else I'm getting calculation errors
 	UINT64 ChipSmpRateFP;
+	const RESMPL_KERNELS* krn = ATOMIC_LOAD_PTR(&selKernels);
 	
 	ChipSmpRateFP = FIXPNT_FACT * (UINT64)CAA->smpRateSrc;
+	InStep = (UINT32)(ChipSmpRateFP / CAA->smpRateDst);
 	InPosL = (SLINT)((CAA->smpP + length) * ChipSmpRateFP / CAA->smpRateDst);
 	CAA->smpNext = (UINT32)fp2i_ceil(InPosL);
 #if FIXPNT_OFLW_BIT < 32
@@ -397,22 +683,18 @@ static void Resmpl_Exec_LinearDown(RESMPL_STATE* CAA, UINT32 length, WAVE_32BS*
 	StreamPnt[1] = &CurBufR[1];
 	CAA->StreamUpdate(CAA->su_DataPtr, CAA->smpNext - CAA->smpLast, StreamPnt);
 	
-	InPosL = (SLINT)(CAA->smpP * ChipSmpRateFP / CAA->smpRateDst);
-	// I'm adding 1.0 to avoid negative indexes
-	InBase = FIXPNT_FACT + (UINT32)(InPosL - (SLINT)CAA->smpLast * FIXPNT_FACT);
-	InPosNext = InBase;
-	InPre = fp2i_floor(InPosNext);
+	InPre = 0;	// the first partial sample is always the last sample of the previous output sample
 	for (OutPos = 0; OutPos < length; OutPos ++)
 	{
-		//InPos = InBase + (UINT32)(OutPos * ChipSmpRateFP / CAA->smpRateDst);
-		InPos = InPosNext;
-		InPosNext = InBase + (UINT32)((OutPos+1) * ChipSmpRateFP / CAA->smpRateDst);
+		InPosL = (SLINT)((CAA->smpP + OutPos) * ChipSmpRateFP / CAA->smpRateDst);
+		// I'm adding 1.0 to avoid negative indexes
+		InPos = FIXPNT_FACT + (UINT32)(InPosL - (SLINT)CAA->smpLast * FIXPNT_FACT);
+		InPosNext = InPos + InStep;
 		
 		// first fractional Sample
 		SmpFrc = getnfraction(InPos);
 		if (SmpFrc)
 		{
-			InPre = fp2i_floor(InPos);
 			TempSmpL = (INT64)CurBufL[InPre] * SmpFrc;
 			TempSmpR = (INT64)CurBufR[InPre] * SmpFrc;
 		}
@@ -436,12 +718,24 @@ static void Resmpl_Exec_LinearDown(RESMPL_STATE* CAA, UINT32 length, WAVE_32BS*
 		//InPre = fp2i_floor(InPosNext);
 		InNow = fp2i_ceil(InPos);
 		SmpCnt += (InPre - InNow) * FIXPNT_FACT;	// this is faster
-		while(InNow < InPre)
+		if (InPre >= InNow + 8)
+		{
+			INT64 sumL = 0;
+			INT64 sumR = 0;
+			krn->SumStereo(&CurBufL[InNow], &CurBufR[InNow], InPre - InNow, &sumL, &sumR);
+			TempSmpL += sumL * FIXPNT_FACT;
+			TempSmpR += sumR * FIXPNT_FACT;
+		}
+		else
 		{
-			TempSmpL += (INT64)CurBufL[InNow] * FIXPNT_FACT;
-			TempSmpR += (INT64)CurBufR[InNow] * FIXPNT_FACT;
-			//SmpCnt ++;
-			InNow ++;
+			// short spans: avoid the function call
+			while(InNow < InPre)
+			{
+				TempSmpL += (INT64)CurBufL[InNow] * FIXPNT_FACT;
+				TempSmpR += (INT64)CurBufR[InNow] * FIXPNT_FACT;
+				//SmpCnt ++;
+				InNow ++;
+			}
 		}
 		
 		retSample[OutPos].L += (INT32)(TempSmpL * CAA->volumeL / SmpCnt);
@@ -463,14 +757,814 @@ static void Resmpl_Exec_LinearDown(RESMPL_STATE* CAA, UINT32 length, WAVE_32BS*
 	return;
 }
 
+// --- Polyphase windowed-sinc resampler ---
+// The filter kernel (sinc function with Kaiser window) is precalculated for a number of fractional
+// positions ("phases") between two input samples. Each output sample takes the phase that is closest
+// to its exact position and is calculated as the dot product of the kernel and the input samples around it.
+// The input is kept as float, so that the dot product can be done with SIMD instructions.
+#define SINC_TBL_MAX	0x40000	// maximum size of the coefficient table (in floats)
+
+struct _resampler_sinc
+{
+	UINT32 taps;		// kernel length in input samples (multiple of 8)
+	UINT32 phases;		// number of precalculated phases per input sample
+	float* coeffs;		// kernel coefficients [phases + 1][taps]
+	UINT32 stepInt;		// input samples per output sample, integer part
+	UINT32 stepFrac;	// input samples per output sample, fractional part (denominator: smpRateDst)
+	UINT32 posFrac;		// fractional input position of the next output sample (denominator: smpRateDst)
+	UINT32 histLen;		// number of input samples in the history buffers
+	UINT32 histSize;	// size of the history buffers
+	float* hist[2];		// input samples, hist[x][0] is the first sample used by the next output sample
+};
+
+static double Sinc_BesselI0(double x)
+{
+	double sum = 1.0;
+	double term = 1.0;
+	UINT32 k;
+	
+	// power series: sum((x/2)^2k / (k!)^2)
+	for (k = 1; k < 50; k ++)
+	{
+		term *= (x / (2.0 * k)) * (x / (2.0 * k));
+		sum += term;
+		if (term < sum * 1E-12)
+			break;
+	}
+	return sum;
+}
+
+static void Resmpl_Sinc_Free(RESMPL_STATE* CAA)
+{
+	RESMPL_SINC* rs = CAA->sinc;
+	if (rs == NULL)
+		return;
+	
+	free(rs->coeffs);
+	free(rs->hist[0]);
+	free(rs);
+	CAA->sinc = NULL;
+	
+	return;
+}
+
+static UINT32 Resmpl_Sinc_GetMemory(const RESMPL_SINC* rs)
+{
+	return (rs->phases + 1) * rs->taps * sizeof(float) + rs->histSize * 2 * sizeof(float);
+}
+
+// (re)calculates the filter for the current sample rates and resets the filter state
+static UINT8 Resmpl_Sinc_Setup(RESMPL_STATE* CAA)
+{
+	RESMPL_SINC* rs;
+	UINT32 zeroCross;	// number of zero crossings on each side of the kernel
+	double beta;		// Kaiser window parameter
+	double cutoff;		// cutoff frequency, relative to the input sample rate
+	double halfWidth;	// half of the kernel length (in input samples)
+	double betaDiv;
+	UINT32 maxPhases;
+	UINT32 curPhase;
+	UINT32 curTap;
+	
+	if (CAA->resampleMode == RSMODE_SINC_HQ)
+	{
+		zeroCross = 32;	beta = 10.0;	cutoff = 0.475;	maxPhases = 1024;	// about -100 db stopband
+	}
+	else
+	{
+		zeroCross = 12;	beta = 7.0;	cutoff = 0.45;	maxPhases = 256;	// about -70 db stopband
+	}
+	if (CAA->smpRateSrc > CAA->smpRateDstEff)
+		cutoff = cutoff * CAA->smpRateDstEff / CAA->smpRateSrc;	// downsampling: filter above the output Nyquist frequency
+	// The decimation chain lowers the input rate, so more phases are needed for the same timing precision.
+	// (The kernel gets shorter by the same factor.)
+	if (CAA->smpRateDstEff > CAA->smpRateDst)
+		maxPhases *= CAA->smpRateDstEff / CAA->smpRateDst;
+	halfWidth = zeroCross / (2.0 * cutoff);
+	
+	Resmpl_Sinc_Free(CAA);
+	rs = (RESMPL_SINC*)calloc(1, sizeof(RESMPL_SINC));
+	if (rs == NULL)
+		return 0xFF;
+	CAA->sinc = rs;
+	rs->taps = ((UINT32)ceil(halfWidth) * 2 + 7) & ~7;
+	rs->phases = maxPhases;
+	while(rs->phases > 16 && (rs->phases + 1) * rs->taps > SINC_TBL_MAX)
+		rs->phases /= 2;
+	rs->coeffs = (float*)malloc((rs->phases + 1) * rs->taps * sizeof(float));
+	if (rs->coeffs == NULL)
+	{
+		Resmpl_Sinc_Free(CAA);
+		return 0xFF;
+	}
+	
+	betaDiv = Sinc_BesselI0(beta);
+	for (curPhase = 0; curPhase <= rs->phases; curPhase ++)
+	{
+		float* phaseCoeffs = &rs->coeffs[curPhase * rs->taps];
+		double sum = 0.0;
+		
+		// tap (taps/2 - 1) is the input sample right before the output sample's position
+		for (curTap = 0; curTap < rs->taps; curTap ++)
+		{
+			double t = (double)curPhase / rs->phases + (rs->taps / 2 - 1) - curTap;
+			double val;
+			if (fabs(t) >= halfWidth)
+			{
+				val = 0.0;
+			}
+			else
+			{
+				double winPos = t / halfWidth;
+				double x = 2.0 * cutoff * t;
+				val = (x == 0.0) ? 1.0 : sin(M_PI * x) / (M_PI * x);
+				val *= Sinc_BesselI0(beta * sqrt(1.0 - winPos * winPos)) / betaDiv;
+			}
+			phaseCoeffs[curTap] = (float)val;
+			sum += val;
+		}
+		// normalize each phase for unity gain
+		for (curTap = 0; curTap < rs->taps; curTap ++)
+			phaseCoeffs[curTap] = (float)(phaseCoeffs[curTap] / sum);
+	}
+	
+	rs->stepInt = CAA->smpRateSrc / CAA->smpRateDstEff;
+	rs->stepFrac = CAA->smpRateSrc % CAA->smpRateDstEff;
+	rs->posFrac = 0;
+	
+	// The history starts with silence, so that the first input sample is centered on the first output sample.
+	rs->histSize = rs->taps * 2;
+	rs->hist[0] = (float*)calloc(rs->histSize * 2, sizeof(float));
+	if (rs->hist[0] == NULL)
+	{
+		Resmpl_Sinc_Free(CAA);
+		return 0xFF;
+	}
+	rs->hist[1] = &rs->hist[0][rs->histSize];
+	rs->histLen = rs->taps / 2 - 1;
+	
+	return 0x00;
+}
+
+static void Resmpl_Sinc_EnsureHistory(RESMPL_SINC* rs, UINT32 length)
+{
+	float* newBuf;
+	
+	if (rs->histSize >= length)
+		return;
+	
+	newBuf = (float*)malloc(length * 2 * sizeof(float));
+	if (newBuf == NULL)
+		abort();
+	memcpy(&newBuf[0], rs->hist[0], rs->histLen * sizeof(float));
+	memcpy(&newBuf[length], rs->hist[1], rs->histLen * sizeof(float));
+	free(rs->hist[0]);
+	rs->histSize = length;
+	rs->hist[0] = newBuf;
+	rs->hist[1] = &newBuf[length];
+	
+	return;
+}
+
+// calculates the dot product of the kernel with the left and right channel
+static void Sinc_DotProd_C(UINT32 len, const float* coeffs, const float* inL, const float* inR, float* retL, float* retR)
+{
+	// 4 separate sums, so that the compiler can vectorize/pipeline it
+	float sumL[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+	float sumR[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+	UINT32 curPos;
+	
+	for (curPos = 0; curPos < len; curPos += 4)
+	{
+		sumL[0] += coeffs[curPos + 0] * inL[curPos + 0];	sumR[0] += coeffs[curPos + 0] * inR[curPos + 0];
+		sumL[1] += coeffs[curPos + 1] * inL[curPos + 1];	sumR[1] += coeffs[curPos + 1] * inR[curPos + 1];
+		sumL[2] += coeffs[curPos + 2] * inL[curPos + 2];	sumR[2] += coeffs[curPos + 2] * inR[curPos + 2];
+		sumL[3] += coeffs[curPos + 3] * inL[curPos + 3];	sumR[3] += coeffs[curPos + 3] * inR[curPos + 3];
+	}
+	*retL = (sumL[0] + sumL[2]) + (sumL[1] + sumL[3]);
+	*retR = (sumR[0] + sumR[2]) + (sumR[1] + sumR[3]);
+	return;
+}
+
+#ifdef RESMPL_SIMD_SSE2
+static void Sinc_DotProd_SSE2(UINT32 len, const float* coeffs, const float* inL, const float* inR, float* retL, float* retR)
+{
+	__m128 sumL = _mm_setzero_ps();
+	__m128 sumR = _mm_setzero_ps();
+	UINT32 curPos;
+	
+	for (curPos = 0; curPos < len; curPos += 4)
+	{
+		__m128 c = _mm_loadu_ps(&coeffs[curPos]);
+		sumL = _mm_add_ps(sumL, _mm_mul_ps(c, _mm_loadu_ps(&inL[curPos])));
+		sumR = _mm_add_ps(sumR, _mm_mul_ps(c, _mm_loadu_ps(&inR[curPos])));
+	}
+	// horizontal sums
+	sumL = _mm_add_ps(sumL, _mm_movehl_ps(sumL, sumL));
+	sumR = _mm_add_ps(sumR, _mm_movehl_ps(sumR, sumR));
+	sumL = _mm_add_ss(sumL, _mm_shuffle_ps(sumL, sumL, 0x55));
+	sumR = _mm_add_ss(sumR, _mm_shuffle_ps(sumR, sumR, 0x55));
+	*retL = _mm_cvtss_f32(sumL);
+	*retR = _mm_cvtss_f32(sumR);
+	return;
+}
+#endif
+
+#ifdef RESMPL_SIMD_AVX2
+RESMPL_TARGET_AVX2
+static void Sinc_DotProd_AVX2(UINT32 len, const float* coeffs, const float* inL, const float* inR, float* retL, float* retR)
+{
+	__m256 sumL = _mm256_setzero_ps();
+	__m256 sumR = _mm256_setzero_ps();
+	__m128 resL;
+	__m128 resR;
+	UINT32 curPos;
+	
+	for (curPos = 0; curPos < len; curPos += 8)
+	{
+		__m256 c = _mm256_loadu_ps(&coeffs[curPos]);
+		sumL = _mm256_add_ps(sumL, _mm256_mul_ps(c, _mm256_loadu_ps(&inL[curPos])));
+		sumR = _mm256_add_ps(sumR, _mm256_mul_ps(c, _mm256_loadu_ps(&inR[curPos])));
+	}
+	// horizontal sums
+	resL = _mm_add_ps(_mm256_castps256_ps128(sumL), _mm256_extractf128_ps(sumL, 1));
+	resR = _mm_add_ps(_mm256_castps256_ps128(sumR), _mm256_extractf128_ps(sumR, 1));
+	resL = _mm_add_ps(resL, _mm_movehl_ps(resL, resL));
+	resR = _mm_add_ps(resR, _mm_movehl_ps(resR, resR));
+	resL = _mm_add_ss(resL, _mm_shuffle_ps(resL, resL, 0x55));
+	resR = _mm_add_ss(resR, _mm_shuffle_ps(resR, resR, 0x55));
+	*retL = _mm_cvtss_f32(resL);
+	*retR = _mm_cvtss_f32(resR);
+	return;
+}
+#endif
+
+#ifdef RESMPL_SIMD_NEON
+static void Sinc_DotProd_NEON(UINT32 len, const float* coeffs, const float* inL, const float* inR, float* retL, float* retR)
+{
+	float32x4_t sumL = vdupq_n_f32(0.0f);
+	float32x4_t sumR = vdupq_n_f32(0.0f);
+	float32x2_t resL;
+	float32x2_t resR;
+	UINT32 curPos;
+	
+	for (curPos = 0; curPos < len; curPos += 4)
+	{
+		float32x4_t c = vld1q_f32(&coeffs[curPos]);
+		sumL = vmlaq_f32(sumL, c, vld1q_f32(&inL[curPos]));
+		sumR = vmlaq_f32(sumR, c, vld1q_f32(&inR[curPos]));
+	}
+	// horizontal sums
+	resL = vadd_f32(vget_low_f32(sumL), vget_high_f32(sumL));
+	resR = vadd_f32(vget_low_f32(sumR), vget_high_f32(sumR));
+	*retL = vget_lane_f32(vpadd_f32(resL, resL), 0);
+	*retR = vget_lane_f32(vpadd_f32(resR, resR), 0);
+	return;
+}
+#endif
+
+static void Resmpl_Exec_Sinc(RESMPL_STATE* CAA, UINT32 length, WAVE_32BS* retSample)
+{
+	// RESALGO_SINC: polyphase windowed-sinc filter
+	RESMPL_SINC* rs = CAA->sinc;
+	DEV_SMPL* StreamPnt[0x02];
+	UINT32 histNeed;
+	UINT32 inPos;
+	UINT32 posFrac;
+	UINT32 OutPos;
+	UINT32 CurSmpl;
+	float smplL;
+	float smplR;
+	const RESMPL_KERNELS* krn = ATOMIC_LOAD_PTR(&selKernels);
+	
+	// number of input samples required for all output samples
+	histNeed = (UINT32)(((UINT64)rs->posFrac + (UINT64)(length - 1) * CAA->smpRateSrc) / CAA->smpRateDstEff) + rs->taps;
+	if (histNeed > rs->histLen)
+	{
+		UINT32 smplCnt = histNeed - rs->histLen;
+		
+		Resmpl_Sinc_EnsureHistory(rs, histNeed);
+		if (CAA->decim != NULL)
+		{
+			float* histPnt[0x02];
+			
+			histPnt[0] = &rs->hist[0][rs->histLen];
+			histPnt[1] = &rs->hist[1][rs->histLen];
+			Resmpl_Decim_Update(CAA, smplCnt, histPnt);
+		}
+		else
+		{
+			Resmpl_EnsureBuffers(CAA, smplCnt);
+			StreamPnt[0] = CAA->smplBufs[0];
+			StreamPnt[1] = CAA->smplBufs[1];
+			CAA->StreamUpdate(CAA->su_DataPtr, smplCnt, StreamPnt);
+			for (CurSmpl = 0; CurSmpl < smplCnt; CurSmpl ++)
+			{
+				rs->hist[0][rs->histLen + CurSmpl] = (float)StreamPnt[0][CurSmpl];
+				rs->hist[1][rs->histLen + CurSmpl] = (float)StreamPnt[1][CurSmpl];
+			}
+		}
+		rs->histLen = histNeed;
+	}
+	
+	inPos = 0;
+	posFrac = rs->posFrac;
+	for (OutPos = 0; OutPos < length; OutPos ++)
+	{
+		UINT32 phase = (UINT32)(((UINT64)posFrac * rs->phases + CAA->smpRateDstEff / 2) / CAA->smpRateDstEff);
+		krn->DotProd(rs->taps, &rs->coeffs[phase * rs->taps], &rs->hist[0][inPos], &rs->hist[1][inPos], &smplL, &smplR);
+		retSample[OutPos].L += (INT32)(smplL * CAA->volumeL);
+		retSample[OutPos].R += (INT32)(smplR * CAA->volumeR);
+		
+		inPos += rs->stepInt;
+		posFrac += rs->stepFrac;
+		if (posFrac >= CAA->smpRateDstEff)
+		{
+			posFrac -= CAA->smpRateDstEff;
+			inPos ++;
+		}
+	}
+	rs->posFrac = posFrac;
+	
+	// remove input samples that aren't needed anymore
+	rs->histLen -= inPos;
+	memmove(&rs->hist[0][0], &rs->hist[0][inPos], rs->histLen * sizeof(float));
+	memmove(&rs->hist[1][0], &rs->hist[1][inPos], rs->histLen * sizeof(float));
+	
+	return;
+}
+
+// --- Half-band decimation chain ---
+// For large downsampling ratios, the input is first decimated by 2 a number of times using half-band FIR filters.
+// The number of stages is chosen so that the sinc filter still gets at least twice the output sample rate.
+// Thus each half-band filter only needs to keep the range 0..1/8 of its input rate intact and may alias into
+// the range 3/8..1/2, which allows for short filters. Every second coefficient of a half-band filter is zero,
+// which halves the work again.
+// This makes the sinc resampler's cost per output sample independent of the input rate, as its kernel length
+// grows with the downsampling ratio. (LinearDown gains nothing from it, as it already does a simple
+// box filter over all input samples, which needs less work than the half-band filters.)
+#define DECIM_MAX_STAGES	8		// decimation by up to 256
+#define DECIM_BLOCK			0x800	// number of device samples rendered at once
+#define HB_MAX_PAIRS		8
+
+struct _resampler_decim
+{
+	UINT32 stages;		// number of decimation stages
+	UINT32 pairs;		// number of non-zero coefficient pairs
+	float coeffs[HB_MAX_PAIRS];	// coefficients of the odd taps, from the centre outwards (the centre tap is 0.5)
+	UINT32 histLen;		// number of history samples per stage (filter length - 1)
+	UINT32 blockLen;	// maximum number of output samples per block
+	DEV_SMPL* devBuf[2];	// device output: [blockLen << stages]
+	float* work[2];		// ping-pong work buffers, shared by both channels: [histLen + (blockLen << stages)]
+	float* hist[2];		// filter history [channel]: [stages][histLen]
+};
+
+static void Resmpl_Decim_Free(RESMPL_STATE* CAA)
+{
+	RESMPL_DECIM* rd = CAA->decim;
+	if (rd == NULL)
+		return;
+	
+	free(rd->devBuf[0]);
+	free(rd->work[0]);
+	free(rd);
+	CAA->decim = NULL;
+	
+	return;
+}
+
+static UINT32 Resmpl_Decim_GetMemory(const RESMPL_DECIM* rd)
+{
+	UINT32 inLen = rd->blockLen << rd->stages;
+	return inLen * 2 * sizeof(DEV_SMPL) +
+		(rd->histLen + inLen + rd->stages * rd->histLen) * 2 * sizeof(float);
+}
+
+// sets up the decimation chain for the current sample rates
+// The filter state is kept when the configuration doesn't change.
+static void Resmpl_Decim_Setup(RESMPL_STATE* CAA)
+{
+	RESMPL_DECIM* rd;
+	UINT32 pairs;
+	double beta;
+	UINT32 stages;
+	UINT32 inLen;
+	UINT32 workSize;
+	UINT32 curPair;
+	double betaDiv;
+	double sum;
+	
+	stages = 0;
+	if (CAA->resampleMode == RSMODE_SINC || CAA->resampleMode == RSMODE_SINC_HQ)
+	{
+		// keep the rate at >= 2x the output rate after decimation
+		while(stages < DECIM_MAX_STAGES && ((UINT64)CAA->smpRateDst << (stages + 2)) <= CAA->smpRateSrc)
+			stages ++;
+	}
+	if (CAA->resampleMode == RSMODE_SINC_HQ)
+	{
+		pairs = 8;	beta = 11.0;	// 31 taps, about -105 db stopband
+	}
+	else
+	{
+		pairs = 5;	beta = 7.0;	// 19 taps, about -68 db stopband
+	}
+	
+	rd = CAA->decim;
+	if (rd != NULL && rd->stages == stages && rd->pairs == pairs)
+		return;
+	Resmpl_Decim_Free(CAA);
+	CAA->smpRateDstEff = CAA->smpRateDst;
+	if (! stages || ! CAA->smpRateDst)
+		return;
+	
+	rd = (RESMPL_DECIM*)calloc(1, sizeof(RESMPL_DECIM));
+	if (rd == NULL)
+		return;	// fall back to resampling without decimation
+	rd->stages = stages;
+	rd->pairs = pairs;
+	rd->histLen = pairs * 4 - 2;
+	rd->blockLen = DECIM_BLOCK >> stages;
+	inLen = rd->blockLen << stages;
+	workSize = rd->histLen + inLen;
+	rd->devBuf[0] = (DEV_SMPL*)malloc(inLen * 2 * sizeof(DEV_SMPL));
+	rd->work[0] = (float*)calloc(workSize * 2 + stages * rd->histLen * 2, sizeof(float));
+	if (rd->devBuf[0] == NULL || rd->work[0] == NULL)
+	{
+		CAA->decim = rd;
+		Resmpl_Decim_Free(CAA);
+		return;
+	}
+	rd->devBuf[1] = &rd->devBuf[0][inLen];
+	rd->work[1] = &rd->work[0][workSize];
+	rd->hist[0] = &rd->work[1][workSize];
+	rd->hist[1] = &rd->hist[0][stages * rd->histLen];
+	
+	// Kaiser-windowed sinc with the cutoff at 1/4 of the input rate, the history starts with silence
+	betaDiv = Sinc_BesselI0(beta);
+	sum = 0.0;
+	for (curPair = 0; curPair < pairs; curPair ++)
+	{
+		double t = curPair * 2 + 1;	// distance from the centre
+		double winPos = t / (pairs * 2 - 1);
+		double val = ((curPair & 1) ? -1.0 : 1.0) / (M_PI * t);
+		val *= Sinc_BesselI0(beta * sqrt(1.0 - winPos * winPos)) / betaDiv;
+		rd->coeffs[curPair] = (float)val;
+		sum += val;
+	}
+	// normalize for unity gain: the centre tap is 0.5, so all pairs must add up to 0.5
+	for (curPair = 0; curPair < pairs; curPair ++)
+		rd->coeffs[curPair] = (float)(rd->coeffs[curPair] * 0.25 / sum);
+	
+	CAA->decim = rd;
+	CAA->smpRateDstEff = CAA->smpRateDst << stages;
+	
+	return;
+}
+
+// Applies the half-band filter to in[0 .. outLen*2 + histLen - 1] and writes the decimated samples to out[0 .. outLen - 1].
+#ifdef RESMPL_SIMD_SSE2
+// loads in[0], in[2], in[4], in[6]
+#define LOAD_EVEN4(in)	_mm_shuffle_ps(_mm_loadu_ps(in), _mm_loadu_ps((in) + 4), _MM_SHUFFLE(2, 0, 2, 0))
+static void Decim_HalfBand(const RESMPL_DECIM* rd, float* out, const float* in, UINT32 outLen)
+{
+	const float* centre = &in[rd->pairs * 2 - 1];
+	const __m128 half = _mm_set1_ps(0.5f);
+	UINT32 OutPos;
+	UINT32 CurPair;
+	
+	for (OutPos = 0; OutPos + 4 <= outLen; OutPos += 4)
+	{
+		const float* inPtr = &centre[OutPos * 2];
+		__m128 sum = _mm_mul_ps(LOAD_EVEN4(inPtr), half);
+		
+		for (CurPair = 0; CurPair < rd->pairs; CurPair ++)
+		{
+			__m128 smpls = _mm_add_ps(LOAD_EVEN4(inPtr - 1 - CurPair * 2), LOAD_EVEN4(inPtr + 1 + CurPair * 2));
+			sum = _mm_add_ps(sum, _mm_mul_ps(_mm_set1_ps(rd->coeffs[CurPair]), smpls));
+		}
+		_mm_storeu_ps(&out[OutPos], sum);
+	}
+	for (; OutPos < outLen; OutPos ++)
+	{
+		const float* inPtr = &centre[OutPos * 2];
+		float sum = inPtr[0] * 0.5f;
+		
+		for (CurPair = 0; CurPair < rd->pairs; CurPair ++)
+			sum += rd->coeffs[CurPair] * (inPtr[-1 - (INT32)CurPair * 2] + inPtr[1 + CurPair * 2]);
+		out[OutPos] = sum;
+	}
+	
+	return;
+}
+#else
+static void Decim_HalfBand(const RESMPL_DECIM* rd, float* out, const float* in, UINT32 outLen)
+{
+	const float* centre = &in[rd->pairs * 2 - 1];
+	UINT32 OutPos;
+	UINT32 CurPair;
+	
+	// one pass per coefficient pair, so that the compiler can vectorize the loops
+	for (OutPos = 0; OutPos < outLen; OutPos ++)
+		out[OutPos] = centre[OutPos * 2] * 0.5f;
+	for (CurPair = 0; CurPair < rd->pairs; CurPair ++)
+	{
+		const float* inA = centre - 1 - CurPair * 2;
+		const float* inB = centre + 1 + CurPair * 2;
+		float coeff = rd->coeffs[CurPair];
+		
+		for (OutPos = 0; OutPos < outLen; OutPos ++)
+			out[OutPos] += coeff * (inA[OutPos * 2] + inB[OutPos * 2]);
+	}
+	
+	return;
+}
+#endif
+
+// renders `samples` decimated samples
+static void Resmpl_Decim_Update(RESMPL_STATE* CAA, UINT32 samples, float** outputs)
+{
+	RESMPL_DECIM* rd = CAA->decim;
+	UINT32 OutPos;
+	UINT32 blkLen;
+	UINT32 inLen;
+	UINT32 CurSmpl;
+	UINT32 curStage;
+	UINT8 curChn;
+	
+	for (OutPos = 0; OutPos < samples; OutPos += blkLen)
+	{
+		blkLen = samples - OutPos;
+		if (blkLen > rd->blockLen)
+			blkLen = rd->blockLen;
+		CAA->StreamUpdate(CAA->su_DataPtr, blkLen << rd->stages, rd->devBuf);
+		
+		for (curChn = 0; curChn < 2; curChn ++)
+		{
+			const DEV_SMPL* devBuf = rd->devBuf[curChn];
+			float* inBuf = rd->work[0];
+			float* outBuf = rd->work[1];
+			
+			inLen = blkLen << rd->stages;
+			for (CurSmpl = 0; CurSmpl < inLen; CurSmpl ++)
+				inBuf[rd->histLen + CurSmpl] = (float)devBuf[CurSmpl];
+			for (curStage = 0; curStage < rd->stages; curStage ++, inLen /= 2)
+			{
+				float* hist = &rd->hist[curChn][curStage * rd->histLen];
+				float* tmpBuf;
+				
+				// prepend the history and keep the last samples for the next block
+				memcpy(&inBuf[0], hist, rd->histLen * sizeof(float));
+				memcpy(hist, &inBuf[inLen], rd->histLen * sizeof(float));
+				if (curStage + 1 < rd->stages)
+				{
+					// the output becomes the input of the next stage
+					Decim_HalfBand(rd, &outBuf[rd->histLen], inBuf, inLen / 2);
+					tmpBuf = inBuf;	inBuf = outBuf;	outBuf = tmpBuf;
+				}
+				else
+				{
+					Decim_HalfBand(rd, &outputs[curChn][OutPos], inBuf, inLen / 2);
+				}
+			}
+		}
+	}
+	
+	return;
+}
+
 void Resmpl_Execute(RESMPL_STATE* CAA, UINT32 smplCount, WAVE_32BS* smplBuffer)
 {
 	if (! smplCount)
 		return;
 	
-	if (CAA->resampler != NULL)
+	if (CAA->resampler == NULL)
+	{
+		CAA->smpP += CAA->smpRateDst;	// just skip the samples and do nothing else
+	}
+	else if (! CAA->smplBufLimit)
+	{
 		CAA->resampler(CAA, smplCount, smplBuffer);
+	}
 	else
-		CAA->smpP += CAA->smpRateDst;	// just skip the samples and do nothing else
+	{
+		// Render in chunks whose input fits into the buffer limit.
+		// This doesn't change the result, as long as all resamplers give the same output for any block split.
+		// (Resmpl_Exec_LinearDown needs to use absolute positions for that.)
+		UINT32 chunkLen;
+		
+		// The buffer needs to hold the input samples plus 3 for interpolation and rounding.
+		if (CAA->smplBufLimit <= 3)
+			chunkLen = 1;
+		else
+			chunkLen = (UINT32)((UINT64)(CAA->smplBufLimit - 3) * CAA->smpRateDstEff / CAA->smpRateSrc);
+		if (chunkLen < 1)
+			chunkLen = 1;	// the input of a single output sample doesn't fit - the buffer will grow beyond the limit
+		while(smplCount > chunkLen)
+		{
+			CAA->resampler(CAA, chunkLen, smplBuffer);
+			smplBuffer += chunkLen;
+			smplCount -= chunkLen;
+		}
+		CAA->resampler(CAA, smplCount, smplBuffer);
+	}
+	return;
+}
+
+UINT32 Resmpl_GetBufferMemory(const RESMPL_STATE* CAA)
+{
+	UINT32 memSize = CAA->smplBufSize * 2 * sizeof(DEV_SMPL);
+	if (CAA->sinc != NULL)
+		memSize += Resmpl_Sinc_GetMemory(CAA->sinc);
+	if (CAA->decim != NULL)
+		memSize += Resmpl_Decim_GetMemory(CAA->decim);
+	return memSize;
+}
+
+// header of the saved state, followed by the sinc history [2][histLen] and the decimation history [2][stages][histLen]
+typedef struct _resampler_savestate
+{
+	UINT32 smpRateSrc;
+	UINT32 smpRateDst;
+	UINT8 resampleMode;
+	UINT8 decimStages;
+	UINT32 smpP;
+	UINT32 smpLast;
+	UINT32 smpNext;
+	WAVE_32BS lSmpl;
+	WAVE_32BS nSmpl;
+	UINT32 sincPosFrac;
+	UINT32 sincHistLen;
+} RESMPL_SAVESTATE;
+
+static UINT32 Resmpl_Decim_GetHistSize(const RESMPL_DECIM* rd)
+{
+	return (rd == NULL) ? 0 : rd->stages * rd->histLen * 2 * sizeof(float);
+}
+
+UINT32 Resmpl_GetStateSize(const RESMPL_STATE* CAA)
+{
+	UINT32 size = sizeof(RESMPL_SAVESTATE);
+	if (CAA->sinc != NULL)
+		size += CAA->sinc->histLen * 2 * sizeof(float);
+	size += Resmpl_Decim_GetHistSize(CAA->decim);
+	return size;
+}
+
+void Resmpl_SaveState(const RESMPL_STATE* CAA, void* buffer)
+{
+	RESMPL_SAVESTATE* rss = (RESMPL_SAVESTATE*)buffer;
+	UINT8* data = (UINT8*)&rss[1];
+	
+	memset(rss, 0x00, sizeof(RESMPL_SAVESTATE));
+	rss->smpRateSrc = CAA->smpRateSrc;
+	rss->smpRateDst = CAA->smpRateDst;
+	rss->resampleMode = CAA->resampleMode;
+	rss->decimStages = (CAA->decim != NULL) ? (UINT8)CAA->decim->stages : 0;
+	rss->smpP = CAA->smpP;
+	rss->smpLast = CAA->smpLast;
+	rss->smpNext = CAA->smpNext;
+	rss->lSmpl = CAA->lSmpl;
+	rss->nSmpl = CAA->nSmpl;
+	if (CAA->sinc != NULL)
+	{
+		const RESMPL_SINC* rs = CAA->sinc;
+		rss->sincPosFrac = rs->posFrac;
+		rss->sincHistLen = rs->histLen;
+		memcpy(data, rs->hist[0], rs->histLen * sizeof(float));	data += rs->histLen * sizeof(float);
+		memcpy(data, rs->hist[1], rs->histLen * sizeof(float));	data += rs->histLen * sizeof(float);
+	}
+	if (CAA->decim != NULL)
+		memcpy(data, CAA->decim->hist[0], Resmpl_Decim_GetHistSize(CAA->decim));	// hist[1] follows hist[0]
+	
+	return;
+}
+
+UINT8 Resmpl_LoadState(RESMPL_STATE* CAA, UINT32 dataSize, const void* data)
+{
+	const RESMPL_SAVESTATE* rss = (const RESMPL_SAVESTATE*)data;
+	const UINT8* histData = (const UINT8*)&rss[1];
+	UINT32 histSize;
+	
+	if (dataSize < sizeof(RESMPL_SAVESTATE))
+		return 0xFF;
+	// The state can only be restored into a resampler with the same configuration.
+	if (rss->smpRateSrc != CAA->smpRateSrc || rss->smpRateDst != CAA->smpRateDst ||
+		rss->resampleMode != CAA->resampleMode || (rss->sincHistLen > 0 && CAA->sinc == NULL) ||
+		rss->decimStages != ((CAA->decim != NULL) ? CAA->decim->stages : 0))
+		return 0xFF;
+	histSize = rss->sincHistLen * 2 * sizeof(float);
+	if (dataSize != sizeof(RESMPL_SAVESTATE) + histSize + Resmpl_Decim_GetHistSize(CAA->decim))
+		return 0xFF;
+	
+	CAA->smpP = rss->smpP;
+	CAA->smpLast = rss->smpLast;
+	CAA->smpNext = rss->smpNext;
+	CAA->lSmpl = rss->lSmpl;
+	CAA->nSmpl = rss->nSmpl;
+	if (CAA->sinc != NULL)
+	{
+		RESMPL_SINC* rs = CAA->sinc;
+		Resmpl_Sinc_EnsureHistory(rs, rss->sincHistLen);
+		rs->posFrac = rss->sincPosFrac;
+		rs->histLen = rss->sincHistLen;
+		memcpy(rs->hist[0], histData, rs->histLen * sizeof(float));	histData += rs->histLen * sizeof(float);
+		memcpy(rs->hist[1], histData, rs->histLen * sizeof(float));	histData += rs->histLen * sizeof(float);
+	}
+	if (CAA->decim != NULL)
+		memcpy(CAA->decim->hist[0], histData, Resmpl_Decim_GetHistSize(CAA->decim));
+	
+	return 0x00;
+}
+
+UINT8 Resmpl_GetSIMDSupport(void)
+{
+	// not cached, as it is only called when selecting kernels
+	UINT8 result;
+	
+	result = 0x00;
+#ifdef RESMPL_SIMD_SSE2
+	result |= RSSIMD_SSE2;
+#endif
+#ifdef RESMPL_SIMD_AVX2
+#ifdef _MSC_VER
+	{
+		int cpuInfo[4];
+		
+		__cpuid(cpuInfo, 0);
+		if (cpuInfo[0] >= 7)
+		{
+			__cpuid(cpuInfo, 1);
+			// The CPU must support AVX and the OS must save the AVX registers. (OSXSAVE + XGETBV)
+			if ((cpuInfo[2] & 0x18000000) == 0x18000000 && (_xgetbv(0) & 0x06) == 0x06)
+			{
+				__cpuidex(cpuInfo, 7, 0);
+				if (cpuInfo[1] & 0x20)
+					result |= RSSIMD_AVX2;
+			}
+		}
+	}
+#else
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("avx2"))
+		result |= RSSIMD_AVX2;
+#endif
+#endif	// RESMPL_SIMD_AVX2
+#ifdef RESMPL_SIMD_NEON
+	result |= RSSIMD_NEON;	// always present when the compiler targets it
+#endif
+	
+	return result;
+}
+
+static const RESMPL_KERNELS krnC = {Resmpl_MixPlanar_C, Resmpl_SumStereo_C, Sinc_DotProd_C};
+#ifdef RESMPL_SIMD_SSE2
+static const RESMPL_KERNELS krnSSE2 = {Resmpl_MixPlanar_SSE2, Resmpl_SumStereo_SSE2, Sinc_DotProd_SSE2};
+#endif
+#ifdef RESMPL_SIMD_AVX2
+static const RESMPL_KERNELS krnAVX2 = {Resmpl_MixPlanar_AVX2, Resmpl_SumStereo_AVX2, Sinc_DotProd_AVX2};
+#endif
+#ifdef RESMPL_SIMD_NEON
+static const RESMPL_KERNELS krnNEON = {Resmpl_MixPlanar_NEON, Resmpl_SumStereo_NEON, Sinc_DotProd_NEON};
+#endif
+
+static const RESMPL_KERNELS* Resmpl_FindKernels(UINT8 mask)
+{
+	UINT8 features = Resmpl_GetSIMDSupport() & mask;
+	
+#ifdef RESMPL_SIMD_AVX2
+	if (features & RSSIMD_AVX2)
+		return &krnAVX2;
+#endif
+#ifdef RESMPL_SIMD_SSE2
+	if (features & RSSIMD_SSE2)
+		return &krnSSE2;
+#endif
+#ifdef RESMPL_SIMD_NEON
+	if (features & RSSIMD_NEON)
+		return &krnNEON;
+#endif
+	(void)features;
+	return &krnC;
+}
+
+static const RESMPL_KERNELS* Resmpl_GetKernels(void)
+{
+	const RESMPL_KERNELS* krn = ATOMIC_LOAD_PTR(&selKernels);
+	
+	if (krn == NULL)
+	{
+		// All threads select the same default table, so losing the race is harmless.
+		// The CAS only prevents overwriting a table that was set by Resmpl_SetSIMDMask in the meantime.
+		ATOMIC_CAS_PTR(&selKernels, NULL, Resmpl_FindKernels(0xFF));
+		krn = ATOMIC_LOAD_PTR(&selKernels);
+	}
+	return krn;
+}
+
+void Resmpl_SetSIMDMask(UINT8 mask)
+{
+	ATOMIC_STORE_PTR(&selKernels, Resmpl_FindKernels(mask));
+	
 	return;
 }
@@ -12,6 +12,8 @@ extern "C"
 
 typedef struct _waveform_32bit_stereo WAVE_32BS;
 typedef struct _resampling_state RESMPL_STATE;
+typedef struct _resampler_sinc RESMPL_SINC;
+typedef struct _resampler_decim RESMPL_DECIM;
 
 typedef void (*RESAMPLER_FUNC)(RESMPL_STATE* CAA, UINT32 length, WAVE_32BS* retSample);
 
@@ -24,6 +26,10 @@ struct _waveform_32bit_stereo
 #define RSMODE_LINEAR	0x00	// linear interpolation (good quality)
 #define RSMODE_NEAREST	0x01	// nearest-neighbour (low quality)
 #define RSMODE_LUP_NDWN	0x02	// nearest-neighbour downsampling, interpolation upsampling
+#define RSMODE_SINC		0x03	// polyphase windowed-sinc filter (very good quality, adds a delay of about 0.3 ms)
+#define RSMODE_SINC_HQ	0x04	// polyphase windowed-sinc filter with longer kernel (best quality, slow)
+// Note: For downsampling by a factor of 4 or more, the SINC modes first reduce the sample rate
+//       with a chain of half-band filters, so that the sinc filter only has to resample by a factor of 2..4.
 struct _resampling_state
 {
 	UINT32 smpRateSrc;
@@ -33,6 +39,7 @@ struct _resampling_state
 	UINT8 resampleMode;	// see RSMODE_ constants
 	RESAMPLER_FUNC resampler;
 	DEVFUNC_UPDATE StreamUpdate;
+	DEVFUNC_UPDATE_MIX StreamUpdateMix;	// optional, used instead of StreamUpdate when no resampling is needed
 	void* su_DataPtr;
 	UINT32 smpP;		// Current Sample (Playback Rate)
 	UINT32 smpLast;		// Sample Number Last
@@ -41,6 +48,10 @@ struct _resampling_state
 	WAVE_32BS nSmpl;	// Next Sample
 	UINT32 smplBufSize;
 	DEV_SMPL* smplBufs[2];
+	UINT32 smplBufLimit;	// maximum buffer size in samples, 0 = grow as needed
+	RESMPL_SINC* sinc;	// filter state for RSMODE_SINC/RSMODE_SINC_HQ
+	RESMPL_DECIM* decim;	// half-band decimation filter state, NULL = not used
+	UINT32 smpRateDstEff;	// output rate relative to the decimated input rate (smpRateDst << decimation stages)
 };
 
 // ---- resampler helper functions (for quick/comfortable initialization) ----
@@ -60,6 +71,15 @@ void Resmpl_DevConnect(RESMPL_STATE* CAA, const DEV_INFO* devInf);
  * @param destSampleRate sample rate of the output stream
  */
 void Resmpl_SetVals(RESMPL_STATE* CAA, UINT8 resampleMode, UINT16 volume, UINT32 destSampleRate);
+/**
+ * @brief Limits the size of the resampler's sample buffers. Must be called after Resmpl_SetVals.
+ *        Larger requests are split into multiple smaller ones, so the memory usage stays constant.
+ *
+ * @param CAA resampler to be configured
+ * @param maxSamples maximum buffer size in samples, 0 = no limit (default, buffers grow as needed)
+ *                   Note: Very low limits are raised to the minimum required by the resampling ratio.
+ */
+void Resmpl_SetBufferLimit(RESMPL_STATE* CAA, UINT32 maxSamples);
 
 // ---- resampler main functions ----
 /**
@@ -88,6 +108,58 @@ void Resmpl_ChangeRate(void* DataPtr, UINT32 newSmplRate);
  * @param smplBuffer buffer for output data
  */
 void Resmpl_Execute(RESMPL_STATE* CAA, UINT32 samples, WAVE_32BS* smplBuffer);
+/**
+ * @brief Returns the amount of memory used by the resampler's sample buffers.
+ *
+ * @param CAA resampler to be queried
+ * @return size of the sample buffers in bytes
+ */
+UINT32 Resmpl_GetBufferMemory(const RESMPL_STATE* CAA);
+/**
+ * @brief Returns the size of the resampler's current state (position and filter history).
+ *        The size may change while resampling.
+ *
+ * @param CAA resampler to be queried
+ * @return size of the state data in bytes
+ */
+UINT32 Resmpl_GetStateSize(const RESMPL_STATE* CAA);
+/**
+ * @brief Saves the current state of the resampler, so that it can continue from the same position later.
+ *
+ * @param CAA resampler to be saved
+ * @param buffer buffer that receives the state data, must be at least Resmpl_GetStateSize() bytes
+ */
+void Resmpl_SaveState(const RESMPL_STATE* CAA, void* buffer);
+/**
+ * @brief Restores a state that was saved using Resmpl_SaveState().
+ *        The resampler must have the same configuration (sample rates and mode) as when saving.
+ *
+ * @param CAA resampler to be restored
+ * @param dataSize size of the state data
+ * @param data state data
+ * @return error code. 0 = success, 0xFF = state doesn't match the resampler's configuration
+ */
+UINT8 Resmpl_LoadState(RESMPL_STATE* CAA, UINT32 dataSize, const void* data);
+
+// ---- SIMD support ----
+// The resampler picks the fastest SIMD kernels the CPU supports. All of them give the same results as the
+// plain C code, except for tiny floating point rounding differences in the SINC modes.
+#define RSSIMD_SSE2		0x01
+#define RSSIMD_AVX2		0x02
+#define RSSIMD_NEON		0x04
+/**
+ * @brief Returns the SIMD instruction sets that are compiled in and supported by the CPU.
+ *
+ * @return combination of RSSIMD_ flags
+ */
+UINT8 Resmpl_GetSIMDSupport(void);
+/**
+ * @brief Restricts the SIMD instruction sets used by all resamplers, mainly for testing and benchmarking.
+ *        Thread-safe. Resamplers that are in use switch to the new kernels with their next Resmpl_Execute call.
+ *
+ * @param mask combination of RSSIMD_ flags, 0x00 = use plain C code only, 0xFF = use all (default)
+ */
+void Resmpl_SetSIMDMask(UINT8 mask);
 
 #ifdef __cplusplus
 }
@@ -483,6 +483,68 @@ UINT8 SndEmu_GetDeviceFunc(const DEV_DEF* devDef, UINT8 funcType, UINT8 rwType,
 		return EERR_MORE_FOUND;	// found multiple matching functions
 }
 
+UINT32 SndEmu_GetStateSize(const DEV_INFO* devInf)
+{
+	DEVFUNC_STATE_SIZE stateSize;
+	UINT8 retVal;
+	
+	retVal = SndEmu_GetDeviceFunc(devInf->devDef, RWF_STATE | RWF_READ, DEVRW_MEMSIZE, 0, (void**)&stateSize);
+	if (retVal == EERR_NOT_FOUND)
+		return 0;
+	return stateSize(devInf->dataPtr);
+}
+
+UINT8 SndEmu_SaveState(const DEV_INFO* devInf, UINT32 bufSize, void* buffer)
+{
+	DEVFUNC_STATE_SAVE saveState;
+	UINT8 retVal;
+	
+	retVal = SndEmu_GetDeviceFunc(devInf->devDef, RWF_STATE | RWF_READ, DEVRW_BLOCK, 0, (void**)&saveState);
+	if (retVal == EERR_NOT_FOUND)
+		return EERR_NOT_FOUND;
+	retVal = saveState(devInf->dataPtr, bufSize, buffer);
+	return retVal ? EERR_BAD_STATE : EERR_OK;
+}
+
+UINT8 SndEmu_LoadState(const DEV_INFO* devInf, UINT32 dataSize, const void* data)
+{
+	DEVFUNC_STATE_LOAD loadState;
+	UINT8 retVal;
+	
+	retVal = SndEmu_GetDeviceFunc(devInf->devDef, RWF_STATE | RWF_WRITE, DEVRW_BLOCK, 0, (void**)&loadState);
+	if (retVal == EERR_NOT_FOUND)
+		return EERR_NOT_FOUND;
+	retVal = loadState(devInf->dataPtr, dataSize, data);
+	return retVal ? EERR_BAD_STATE : EERR_OK;
+}
+
+void SndEmu_Skip(const DEV_INFO* devInf, UINT32 samples)
+{
+	DEVFUNC_SKIP skipFunc;
+	DEV_SMPL smplBuf[2][0x100];
+	DEV_SMPL* outputs[2];
+	UINT8 retVal;
+	
+	retVal = SndEmu_GetDeviceFunc(devInf->devDef, RWF_SKIP | RWF_WRITE, DEVRW_VALUE, 0, (void**)&skipFunc);
+	if (retVal != EERR_NOT_FOUND)
+	{
+		skipFunc(devInf->dataPtr, samples);
+		return;
+	}
+	
+	// fallback: render in small blocks and throw the output away
+	outputs[0] = smplBuf[0];
+	outputs[1] = smplBuf[1];
+	while(samples > 0)
+	{
+		UINT32 smplCnt = (samples < 0x100) ? samples : 0x100;
+		devInf->devDef->Update(devInf->dataPtr, smplCnt, outputs);
+		samples -= smplCnt;
+	}
+	
+	return;
+}
+
 // opts:
 //	0x01: long names (1) / short names (0)
 const char* SndEmu_GetDevName(DEV_ID deviceID, UINT8 opts, const DEV_GEN_CFG* devCfg)
@@ -75,6 +75,40 @@ void SndEmu_FreeDevLinkData(DEV_INFO* devInf);
  * @return error code. 0 = success, 1 - success, but more possible candidates found, see EERR constants
  */
 UINT8 SndEmu_GetDeviceFunc(const DEV_DEF* devInf, UINT8 funcType, UINT8 rwType, UINT16 user, void** retFuncPtr);
+/**
+ * @brief Return the size of the state data of a sound core.
+ *
+ * @param devInf DEV_INFO structure of the device
+ * @return size of the state data in bytes, 0 if the sound core doesn't support saving its state
+ */
+UINT32 SndEmu_GetStateSize(const DEV_INFO* devInf);
+/**
+ * @brief Save the current state of a sound core.
+ *
+ * @param devInf DEV_INFO structure of the device
+ * @param bufSize size of the buffer, must be at least SndEmu_GetStateSize() bytes
+ * @param buffer buffer that receives the state data
+ * @return error code. 0 = success, see EERR constants
+ */
+UINT8 SndEmu_SaveState(const DEV_INFO* devInf, UINT32 bufSize, void* buffer);
+/**
+ * @brief Restore a state of a sound core that was previously saved using SndEmu_SaveState().
+ *        The state can only be restored into the same device instance it was saved from.
+ *
+ * @param devInf DEV_INFO structure of the device
+ * @param dataSize size of the state data
+ * @param data state data
+ * @return error code. 0 = success, see EERR constants
+ */
+UINT8 SndEmu_LoadState(const DEV_INFO* devInf, UINT32 dataSize, const void* data);
+/**
+ * @brief Advance a sound core by a number of samples without using its output.
+ *        Uses the core's skip function when available and falls back to rendering into a scratch buffer.
+ *
+ * @param devInf DEV_INFO structure of the device
+ * @param samples number of samples to advance, in the device's native sample rate
+ */
+void SndEmu_Skip(const DEV_INFO* devInf, UINT32 samples);
 /**
  * @brief Retrieve the name of a sound device.
  *        Device configuration parameters may be use to identify exact sound chip models.
@@ -98,6 +132,7 @@ extern const DEV_DECL* sndEmu_Devices[];	// list of built-in sound devices, term
 #define EERR_OK			0x00
 #define EERR_MORE_FOUND	0x01	// success, but more items were found
 #define EERR_UNK_DEVICE	0xF0	// unknown/invalid device ID
+#define EERR_BAD_STATE	0xF4	// invalid state data or state buffer too small
 #define EERR_NOT_FOUND	0xF8	// sound core or function not found
 #define EERR_INIT_ERR	0xFF	// sound core initialization error (usually malloc error)
 
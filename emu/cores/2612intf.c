@@ -33,6 +33,10 @@ static DEVDEF_RWFUNC devFunc_MAME[] =
 	{RWF_REGISTER | RWF_WRITE, DEVRW_A8D8, 0, ym2612_write},
 	{RWF_REGISTER | RWF_READ, DEVRW_A8D8, 0, ym2612_read},
 	{RWF_CHN_MUTE | RWF_WRITE, DEVRW_ALL, 0, ym2612_set_mute_mask},
+	{RWF_STATE | RWF_READ, DEVRW_MEMSIZE, 0, ym2612_get_state_size},
+	{RWF_STATE | RWF_READ, DEVRW_BLOCK, 0, ym2612_save_state},
+	{RWF_STATE | RWF_WRITE, DEVRW_BLOCK, 0, ym2612_load_state},
+	{RWF_UPDATE_MIX | RWF_WRITE, DEVRW_VALUE, 0, ym2612_update_mix},
 	{0x00, 0x00, 0, NULL}
 };
 static DEV_DEF devDef_MAME =
@@ -62,6 +62,9 @@ static DEVDEF_RWFUNC devFunc262_Emu[] =
 	{RWF_VOLUME | RWF_WRITE, DEVRW_VALUE, 0, adlib_OPL3_set_volume},
 	{RWF_VOLUME_LR | RWF_WRITE, DEVRW_VALUE, 0, adlib_OPL3_set_volume_lr},
 	{RWF_CHN_MUTE | RWF_WRITE, DEVRW_ALL, 0, adlib_OPL3_set_mute_mask},
+	{RWF_STATE | RWF_READ, DEVRW_MEMSIZE, 0, adlib_OPL3_get_state_size},
+	{RWF_STATE | RWF_READ, DEVRW_BLOCK, 0, adlib_OPL3_save_state},
+	{RWF_STATE | RWF_WRITE, DEVRW_BLOCK, 0, adlib_OPL3_load_state},
 	{0x00, 0x00, 0, NULL}
 };
 static DEV_DEF devDef262_AdLibEmu =
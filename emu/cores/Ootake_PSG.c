@@ -66,6 +66,9 @@ static DEVDEF_RWFUNC devFunc[] =
 	{RWF_REGISTER | RWF_WRITE, DEVRW_A8D8, 0, OPSG_Write},
 	{RWF_REGISTER | RWF_READ, DEVRW_A8D8, 0, OPSG_Read},
 	{RWF_CHN_MUTE | RWF_WRITE, DEVRW_ALL, 0, OPSG_SetMuteMask},
+	{RWF_STATE | RWF_READ, DEVRW_MEMSIZE, 0, OPSG_GetStateSize},
+	{RWF_STATE | RWF_READ, DEVRW_BLOCK, 0, OPSG_SaveState},
+	{RWF_STATE | RWF_WRITE, DEVRW_BLOCK, 0, OPSG_LoadState},
 	{0x00, 0x00, 0, NULL}
 };
 DEV_DEF devDef_C6280_Ootake =
@@ -964,3 +967,41 @@ OPSG_SetHoneyInTheSky(
 	
 	info->bHoneyInTheSky = bHoneyInTheSky;
 }
+
+
+static UINT32
+OPSG_GetStateSize(void* chip)
+{
+	return sizeof(huc6280_state);
+}
+
+static UINT8
+OPSG_SaveState(
+	void*		chip,
+	UINT32		bufSize,
+	void*		buffer)
+{
+	if (bufSize < sizeof(huc6280_state))
+		return 0xFF;
+	memcpy(buffer, chip, sizeof(huc6280_state));
+	return 0x00;
+}
+
+static UINT8
+OPSG_LoadState(
+	void*		chip,
+	UINT32		dataSize,
+	const void*	data)
+{
+	huc6280_state* info = (huc6280_state*)chip;
+	huc6280_state old;
+
+	if (dataSize != sizeof(huc6280_state))
+		return 0xFF;
+	old = *info;
+	memcpy(info, data, sizeof(huc6280_state));
+	// keep user settings
+	memcpy(info->bPsgMute, old.bPsgMute, sizeof(info->bPsgMute));
+	info->bHoneyInTheSky = old.bHoneyInTheSky;
+	return 0x00;
+}
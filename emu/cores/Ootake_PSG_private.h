@@ -77,4 +77,19 @@ OPSG_SetHoneyInTheSky(
 	void*	chip,
 	UINT8	bHoneyInTheSky);
 
+static UINT32
+OPSG_GetStateSize(void* chip);
+
+static UINT8
+OPSG_SaveState(
+	void*		chip,
+	UINT32		bufSize,
+	void*		buffer);
+
+static UINT8
+OPSG_LoadState(
+	void*		chip,
+	UINT32		dataSize,
+	const void*	data);
+
 #endif	// __OOTAKE_PSG_PRIVATE_H__
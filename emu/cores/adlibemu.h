@@ -27,4 +27,8 @@ void ADLIBEMU(set_mute_mask)(void *chip, UINT32 MuteMask);
 void ADLIBEMU(set_volume)(void *chip, INT32 volume);
 void ADLIBEMU(set_volume_lr)(void *chip, INT32 volL, INT32 volR);
 
+UINT32 ADLIBEMU(get_state_size)(void *chip);
+UINT8 ADLIBEMU(save_state)(void *chip, UINT32 bufSize, void* buffer);
+UINT8 ADLIBEMU(load_state)(void *chip, UINT32 dataSize, const void* data);
+
 #endif	// __ADLIBEMU_H__
@@ -32,7 +32,7 @@
 #endif
 
 #include <math.h>
-#include <stdlib.h> // rand
+#include <stdlib.h> // for calloc/free
 #include <string.h> // for memset
 
 #include "../../stdtype.h"
@@ -51,8 +51,6 @@ static Bit32s vibval_const[BLOCKBUF_SIZE];
 static Bit32s tremval_const[BLOCKBUF_SIZE];
 
 // vibrato value tables (used per-operator)
-static Bit32s vibval_var1[BLOCKBUF_SIZE];
-static Bit32s vibval_var2[BLOCKBUF_SIZE];
 //static Bit32s vibval_var3[BLOCKBUF_SIZE];
 //static Bit32s vibval_var4[BLOCKBUF_SIZE];
 
@@ -171,10 +169,15 @@ INLINE void operator_advance_drums(OPL_DATA* chip, op_type* op_pt1, Bit32s vib1,
 	Bit32u c3 = op_pt3->tcount/FIXEDPT;
 	Bit32u phasebit = (((c1 & 0x88) ^ ((c1<<5) & 0x80)) | ((c3 ^ (c3<<2)) & 0x20)) ? 0x02 : 0x00;
 
-	Bit32u noisebit = rand()&1;
+	Bit32u noisebit = chip->noise_rng & 1;
 
 	Bit32u snare_phase_bit = (((Bitu)((op_pt1->tcount/FIXEDPT) / 0x100))&1);
 
+	// advance the 23-bit noise generator (per chip, so that the output doesn't depend on other chips)
+	if (chip->noise_rng & 1)
+		chip->noise_rng ^= 0x800302;
+	chip->noise_rng >>= 1;
+
 	//Hihat
 	Bit32u inttm = (phasebit<<8) | (0x34<<(phasebit ^ (noisebit<<1)));
 	op_pt1->wfpos = inttm*FIXEDPT;				// waveform position
@@ -753,6 +756,7 @@ void ADLIBEMU(reset)(void *chip)
 	OPL->status = 0;
 	OPL->opl_addr = 0;
 	OPL->isDisabled = 0x01;	// OPL4 speed hack
+	OPL->noise_rng = 1;
 	
 	return;
 }
@@ -1195,6 +1199,9 @@ void ADLIBEMU(getsample)(void *chip, UINT32 numsamples, DEV_SMPL** sndptr)
 	// vibrato/tremolo lookup tables (global, to possibly be used by all operators)
 	Bit32s vib_lut[BLOCKBUF_SIZE];
 	Bit32s trem_lut[BLOCKBUF_SIZE];
+	// vibrato values of the current block (local, so that multiple instances can be rendered in parallel)
+	Bit32s vibval_var1[BLOCKBUF_SIZE];
+	Bit32s vibval_var2[BLOCKBUF_SIZE];
 
 	Bit32u cursmp;
 	Bit32s vib_tshift;
@@ -1969,3 +1976,43 @@ void ADLIBEMU(set_volume_lr)(void *chip, INT32 volLeft, INT32 volRight)
 
 	return;
 }
+
+UINT32 ADLIBEMU(get_state_size)(void *chip)
+{
+	return sizeof(OPL_DATA);
+}
+
+UINT8 ADLIBEMU(save_state)(void *chip, UINT32 bufSize, void* buffer)
+{
+	if (bufSize < sizeof(OPL_DATA))
+		return 0xFF;
+	memcpy(buffer, chip, sizeof(OPL_DATA));
+	return 0x00;
+}
+
+UINT8 ADLIBEMU(load_state)(void *chip, UINT32 dataSize, const void* data)
+{
+	OPL_DATA* OPL = (OPL_DATA*)chip;
+	Bit8u MuteChn[NUM_CHANNELS + 5];
+	ADL_UPDATEHANDLER UpdateHandler;
+	void* UpdateParam;
+	Bit32s master_vol_l;
+	Bit32s master_vol_r;
+	
+	if (dataSize != sizeof(OPL_DATA))
+		return 0xFF;
+	memcpy(MuteChn, OPL->MuteChn, sizeof(MuteChn));
+	UpdateHandler = OPL->UpdateHandler;
+	UpdateParam = OPL->UpdateParam;
+	master_vol_l = OPL->master_vol_l;
+	master_vol_r = OPL->master_vol_r;
+	
+	memcpy(OPL, data, sizeof(OPL_DATA));
+	
+	memcpy(OPL->MuteChn, MuteChn, sizeof(MuteChn));
+	OPL->UpdateHandler = UpdateHandler;
+	OPL->UpdateParam = UpdateParam;
+	OPL->master_vol_l = master_vol_l;
+	OPL->master_vol_r = master_vol_r;
+	return 0x00;
+}
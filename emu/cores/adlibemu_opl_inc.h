@@ -185,6 +185,8 @@ typedef struct opl_chip
 	
 	Bit32u generator_add;	// should be a chip parameter
 	
+	Bit32u noise_rng;	// noise generator for rhythm mode
+	
 	fltype recipsamp;	// inverse of sampling rate
 	fltype frqmul[16];
 	
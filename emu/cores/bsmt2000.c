@@ -136,6 +136,9 @@ static void bsmt2000_set_mute_mask(void *info, UINT32 MuteMask);
 static UINT32 bsmt2000_get_mute_mask(void *info);
 static void bsmt2000_set_log_cb(void* info, DEVCB_LOG func, void* param);
 static void bsmt2000_set_srchg_cb(void *info, DEVCB_SRATE_CHG CallbackFunc, void* DataPtr);
+static UINT32 bsmt2000_get_state_size(void *info);
+static UINT8 bsmt2000_save_state(void *info, UINT32 bufSize, void* buffer);
+static UINT8 bsmt2000_load_state(void *info, UINT32 dataSize, const void* data);
 
 /* ==== Device Function Table ==== */
 static DEVDEF_RWFUNC devFunc[] =
@@ -146,6 +149,9 @@ static DEVDEF_RWFUNC devFunc[] =
     {RWF_MEMORY | RWF_WRITE, DEVRW_BLOCK, 0, bsmt2000_write_rom},
     {RWF_MEMORY | RWF_WRITE, DEVRW_MEMSIZE, 0, bsmt2000_alloc_rom},
     {RWF_CHN_MUTE | RWF_WRITE, DEVRW_ALL, 0, bsmt2000_set_mute_mask},
+    {RWF_STATE | RWF_READ, DEVRW_MEMSIZE, 0, bsmt2000_get_state_size},
+    {RWF_STATE | RWF_READ, DEVRW_BLOCK, 0, bsmt2000_save_state},
+    {RWF_STATE | RWF_WRITE, DEVRW_BLOCK, 0, bsmt2000_load_state},
     {0x00, 0x00, 0, NULL}
 };
 
@@ -615,3 +621,40 @@ static void bsmt2000_set_srchg_cb(void *info, DEVCB_SRATE_CHG CallbackFunc, void
 	
 	return;
 }
+
+/* ==== Save States ==== */
+static UINT32 bsmt2000_get_state_size(void *info)
+{
+    return sizeof(bsmt2000_state);
+}
+
+static UINT8 bsmt2000_save_state(void *info, UINT32 bufSize, void* buffer)
+{
+    if (bufSize < sizeof(bsmt2000_state))
+        return 0xFF;
+    memcpy(buffer, info, sizeof(bsmt2000_state));
+    return 0x00;
+}
+
+static UINT8 bsmt2000_load_state(void *info, UINT32 dataSize, const void* data)
+{
+    bsmt2000_state* chip = (bsmt2000_state *)info;
+    bsmt2000_state old;
+
+    if (dataSize != sizeof(bsmt2000_state))
+        return 0xFF;
+    old = *chip;
+    memcpy(chip, data, sizeof(bsmt2000_state));
+    // keep memory buffers, callbacks and user settings
+    chip->logger = old.logger;
+    chip->sample_rom = old.sample_rom;
+    chip->sample_rom_length = old.sample_rom_length;
+    chip->sample_rom_mask = old.sample_rom_mask;
+    chip->total_banks = old.total_banks;
+    memcpy(chip->Muted, old.Muted, sizeof(chip->Muted));
+    chip->SmpRateFunc = old.SmpRateFunc;
+    chip->SmpRateData = old.SmpRateData;
+    if (chip->SmpRateFunc != NULL && chip->sample_rate != old.sample_rate)
+        chip->SmpRateFunc(chip->SmpRateData, (UINT32)chip->sample_rate);
+    return 0x00;
+}
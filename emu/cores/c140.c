@@ -44,6 +44,9 @@ static void c140_alloc_rom(void* chip, UINT32 memsize);
 static void c140_write_rom(void *chip, UINT32 offset, UINT32 length, const UINT8* data);
 
 static void c140_set_mute_mask(void *chip, UINT32 MuteMask);
+static UINT32 c140_get_state_size(void *chip);
+static UINT8 c140_save_state(void *chip, UINT32 bufSize, void* buffer);
+static UINT8 c140_load_state(void *chip, UINT32 dataSize, const void* data);
 
 
 static DEVDEF_RWFUNC devFunc[] =
@@ -53,6 +56,9 @@ static DEVDEF_RWFUNC devFunc[] =
 	{RWF_MEMORY | RWF_WRITE, DEVRW_BLOCK, 0, c140_write_rom},
 	{RWF_MEMORY | RWF_WRITE, DEVRW_MEMSIZE, 0, c140_alloc_rom},
 	{RWF_CHN_MUTE | RWF_WRITE, DEVRW_ALL, 0, c140_set_mute_mask},
+	{RWF_STATE | RWF_READ, DEVRW_MEMSIZE, 0, c140_get_state_size},
+	{RWF_STATE | RWF_READ, DEVRW_BLOCK, 0, c140_save_state},
+	{RWF_STATE | RWF_WRITE, DEVRW_BLOCK, 0, c140_load_state},
 	{0x00, 0x00, 0, NULL}
 };
 static DEV_DEF devDef =
@@ -480,3 +486,35 @@ static void c140_set_mute_mask(void *chip, UINT32 MuteMask)
 	
 	return;
 }
+
+static UINT32 c140_get_state_size(void *chip)
+{
+	return sizeof(c140_state);
+}
+
+static UINT8 c140_save_state(void *chip, UINT32 bufSize, void* buffer)
+{
+	if (bufSize < sizeof(c140_state))
+		return 0xFF;
+	memcpy(buffer, chip, sizeof(c140_state));
+	return 0x00;
+}
+
+static UINT8 c140_load_state(void *chip, UINT32 dataSize, const void* data)
+{
+	c140_state *info = (c140_state *)chip;
+	c140_state old;
+	UINT8 CurChn;
+	
+	if (dataSize != sizeof(c140_state))
+		return 0xFF;
+	old = *info;
+	memcpy(info, data, sizeof(c140_state));
+	// keep memory buffers and user settings
+	info->romSize = old.romSize;
+	info->romMask = old.romMask;
+	info->pRom = old.pRom;
+	for (CurChn = 0; CurChn < MAX_VOICE; CurChn ++)
+		info->voi[CurChn].Muted = old.voi[CurChn].Muted;
+	return 0x00;
+}
@@ -39,10 +39,14 @@ static void c352_w(void *chip, UINT16 offset, UINT16 data);
 
 static void c352_alloc_rom(void* chip, UINT32 memsize);
 static void c352_write_rom(void *chip, UINT32 offset, UINT32 length, const UINT8* data);
+static void c352_alias_rom(void *chip, UINT32 memsize, const UINT8* data);
 
 static void c352_set_mute_mask(void *chip, UINT32 MuteMask);
 static UINT32 c352_get_mute_mask(void *chip);
 static void c352_set_options(void *chip, UINT32 Flags);
+static UINT32 c352_get_state_size(void *chip);
+static UINT8 c352_save_state(void *chip, UINT32 bufSize, void* buffer);
+static UINT8 c352_load_state(void *chip, UINT32 dataSize, const void* data);
 
 
 static DEVDEF_RWFUNC devFunc[] =
@@ -51,7 +55,11 @@ static DEVDEF_RWFUNC devFunc[] =
 	{RWF_REGISTER | RWF_READ, DEVRW_A16D16, 0, c352_r},
 	{RWF_MEMORY | RWF_WRITE, DEVRW_BLOCK, 0, c352_write_rom},
 	{RWF_MEMORY | RWF_WRITE, DEVRW_MEMSIZE, 0, c352_alloc_rom},
+	{RWF_MEMORY | RWF_WRITE, DEVRW_BLOCK_ALIAS, 0, c352_alias_rom},
 	{RWF_CHN_MUTE | RWF_WRITE, DEVRW_ALL, 0, c352_set_mute_mask},
+	{RWF_STATE | RWF_READ, DEVRW_MEMSIZE, 0, c352_get_state_size},
+	{RWF_STATE | RWF_READ, DEVRW_BLOCK, 0, c352_save_state},
+	{RWF_STATE | RWF_WRITE, DEVRW_BLOCK, 0, c352_load_state},
 	{0x00, 0x00, 0, NULL}
 };
 static DEV_DEF devDef =
@@ -162,7 +170,8 @@ typedef struct {
 	UINT16 random;
 	UINT16 control; // control flags, purpose unknown.
 
-	UINT8* wave;
+	const UINT8* wave;	// points to waveBuf or to external memory (see c352_alias_rom)
+	UINT8* waveBuf;
 	UINT32 wavesize;
 	UINT32 wave_mask;
 
@@ -325,6 +334,7 @@ static UINT8 device_start_c352(const DEV_GEN_CFG* cfg, DEV_INFO* retDevInf)
 		return 0xFF;
 
 	c->wave = NULL;
+	c->waveBuf = NULL;
 	c->wavesize = 0x00;
 
 	//c->sample_rate_base = cfg->clock / 576;	// sample rate according to superctr
@@ -362,7 +372,7 @@ static void device_stop_c352(void *chip)
 {
 	C352 *c = (C352 *)chip;
 	
-	free(c->wave);
+	free(c->waveBuf);
 	free(c);
 	
 	return;
@@ -453,16 +463,33 @@ static void c352_w(void *chip, UINT16 address, UINT16 val)
 }
 
 
+// make a private copy of an aliased ROM before modifying it
+static void c352_own_rom(C352 *c)
+{
+	if (c->wave == c->waveBuf)
+		return;
+	
+	c->waveBuf = (UINT8*)malloc(c->wavesize);
+	memcpy(c->waveBuf, c->wave, c->wavesize);
+	c->wave = c->waveBuf;
+	
+	return;
+}
+
 static void c352_alloc_rom(void* chip, UINT32 memsize)
 {
 	C352 *c = (C352 *)chip;
 	
 	if (c->wavesize == memsize)
+	{
+		c352_own_rom(c);
 		return;
+	}
 	
-	c->wave = (UINT8*)realloc(c->wave, memsize);
+	c->waveBuf = (UINT8*)realloc(c->waveBuf, memsize);
+	c->wave = c->waveBuf;
 	c->wavesize = memsize;
-	memset(c->wave, 0xFF, memsize);
+	memset(c->waveBuf, 0xFF, memsize);
 	c->wave_mask = pow2_mask(memsize);
 	
 	return;
@@ -477,7 +504,20 @@ static void c352_write_rom(void *chip, UINT32 offset, UINT32 length, const UINT8
 	if (offset + length > c->wavesize)
 		length = c->wavesize - offset;
 	
-	memcpy(c->wave + offset, data, length);
+	c352_own_rom(c);
+	memcpy(c->waveBuf + offset, data, length);
+	
+	return;
+}
+
+static void c352_alias_rom(void *chip, UINT32 memsize, const UINT8* data)
+{
+	C352 *c = (C352 *)chip;
+	
+	free(c->waveBuf);	c->waveBuf = NULL;
+	c->wave = data;
+	c->wavesize = memsize;
+	c->wave_mask = pow2_mask(memsize);
 	
 	return;
 }
@@ -514,3 +554,37 @@ static void c352_set_options(void *chip, UINT32 Flags)
 	
 	return;
 }
+
+static UINT32 c352_get_state_size(void *chip)
+{
+	return sizeof(C352);
+}
+
+static UINT8 c352_save_state(void *chip, UINT32 bufSize, void* buffer)
+{
+	if (bufSize < sizeof(C352))
+		return 0xFF;
+	memcpy(buffer, chip, sizeof(C352));
+	return 0x00;
+}
+
+static UINT8 c352_load_state(void *chip, UINT32 dataSize, const void* data)
+{
+	C352 *c = (C352 *)chip;
+	C352 old;
+	UINT8 CurChn;
+	
+	if (dataSize != sizeof(C352))
+		return 0xFF;
+	old = *c;
+	memcpy(c, data, sizeof(C352));
+	// keep memory buffers and user settings
+	c->wave = old.wave;
+	c->waveBuf = old.waveBuf;
+	c->wavesize = old.wavesize;
+	c->wave_mask = old.wave_mask;
+	c->optMuteRear = old.optMuteRear;
+	for (CurChn = 0; CurChn < C352_VOICES; CurChn ++)
+		c->v[CurChn].mute = old.v[CurChn].mute;
+	return 0x00;
+}
@@ -53,6 +53,9 @@ static DEVDEF_RWFUNC devFunc[] =
 	{RWF_SRATE | RWF_WRITE, DEVRW_VALUE, 0, EPSG_set_rate},
 	{RWF_CHN_MUTE | RWF_WRITE, DEVRW_ALL, 0, EPSG_setMuteMask},
 	{RWF_CHN_PAN | RWF_WRITE, DEVRW_ALL, 0, ay8910_emu_pan},
+	{RWF_STATE | RWF_READ, DEVRW_MEMSIZE, 0, EPSG_getStateSize},
+	{RWF_STATE | RWF_READ, DEVRW_BLOCK, 0, EPSG_saveState},
+	{RWF_STATE | RWF_WRITE, DEVRW_BLOCK, 0, EPSG_loadState},
 	{0x00, 0x00, 0, NULL}
 };
 DEV_DEF devDef_YM2149_Emu =
@@ -624,6 +627,38 @@ void EPSG_set_pan (EPSG * psg, uint8_t ch, int16_t pan)
   Panning_Calculate( psg->pan[ch], pan );
 }
 
+UINT32
+EPSG_getStateSize (EPSG * psg)
+{
+  return sizeof(EPSG);
+}
+
+UINT8
+EPSG_saveState (EPSG * psg, UINT32 bufSize, void *buffer)
+{
+  if (bufSize < sizeof(EPSG))
+    return 0xFF;
+  memcpy(buffer, psg, sizeof(EPSG));
+  return 0x00;
+}
+
+UINT8
+EPSG_loadState (EPSG * psg, UINT32 dataSize, const void *data)
+{
+  EPSG old;
+
+  if (dataSize != sizeof(EPSG))
+    return 0xFF;
+  old = *psg;
+  memcpy(psg, data, sizeof(EPSG));
+  /* keep user settings */
+  psg->mask = old.mask;
+  memcpy(psg->stereo_mask, old.stereo_mask, sizeof(psg->stereo_mask));
+  memcpy(psg->pan, old.pan, sizeof(psg->pan));
+  psg->pcm3ch_detect = old.pcm3ch_detect;
+  return 0x00;
+}
+
 static void ay8910_emu_set_options(void *chip, UINT32 Flags)
 {
   EPSG* psg = (EPSG*)chip;
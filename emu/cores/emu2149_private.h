@@ -98,6 +98,9 @@ extern "C"
   void EPSG_setMuteMask (EPSG *, UINT32 mask);
   void EPSG_setStereoMask (EPSG *psg, UINT32 mask);
   void EPSG_set_pan (EPSG * psg, uint8_t ch, int16_t pan);
+  UINT32 EPSG_getStateSize (EPSG * psg);
+  UINT8 EPSG_saveState (EPSG * psg, UINT32 bufSize, void *buffer);
+  UINT8 EPSG_loadState (EPSG * psg, UINT32 dataSize, const void *data);
   static void ay8910_emu_set_options(void *chip, UINT32 Flags);
   static void ay8910_emu_pan(void* chip, const INT16* PanVals);
     
@@ -30,6 +30,9 @@ static UINT8 device_start_ym2413_emu(const DEV_GEN_CFG* cfg, DEV_INFO* retDevInf
 static void ym2413_update_emu(void *chip, UINT32 samples, DEV_SMPL **out);
 static void ym2413_set_mute_mask_emu(void *chip, UINT32 MuteMask);
 static void ym2413_pan_emu(void* chip, const INT16* PanVals);
+static UINT32 ym2413_get_state_size_emu(void *chip);
+static UINT8 ym2413_save_state_emu(void *chip, UINT32 bufSize, void* buffer);
+static UINT8 ym2413_load_state_emu(void *chip, UINT32 dataSize, const void* data);
 
 
 static DEVDEF_RWFUNC devFunc[] =
@@ -38,6 +41,9 @@ static DEVDEF_RWFUNC devFunc[] =
 	{RWF_REGISTER | RWF_QUICKWRITE, DEVRW_A8D8, 0, EOPLL_writeReg},
 	{RWF_CHN_MUTE | RWF_WRITE, DEVRW_ALL, 0, ym2413_set_mute_mask_emu},
 	{RWF_CHN_PAN | RWF_WRITE, DEVRW_ALL, 0, ym2413_pan_emu},
+	{RWF_STATE | RWF_READ, DEVRW_MEMSIZE, 0, ym2413_get_state_size_emu},
+	{RWF_STATE | RWF_READ, DEVRW_BLOCK, 0, ym2413_save_state_emu},
+	{RWF_STATE | RWF_WRITE, DEVRW_BLOCK, 0, ym2413_load_state_emu},
 	{0x00, 0x00, 0, NULL}
 };
 DEV_DEF devDef_YM2413_Emu =
@@ -1627,3 +1633,63 @@ static void ym2413_pan_emu(void* chip, const INT16* PanVals)
 	
 	return;
 }
+
+static UINT32 ym2413_get_state_size_emu(void *chip)
+{
+	EOPLL *opll = (EOPLL *)chip;
+	UINT32 size;
+	
+	size = sizeof(EOPLL);
+	if (opll->conv != NULL)
+		size += sizeof(double) + opll->conv->ch * LW * sizeof(int32_t);
+	return size;
+}
+
+static UINT8 ym2413_save_state_emu(void *chip, UINT32 bufSize, void* buffer)
+{
+	EOPLL *opll = (EOPLL *)chip;
+	UINT8* dst = (UINT8*)buffer;
+	int curChn;
+	
+	if (bufSize < ym2413_get_state_size_emu(chip))
+		return 0xFF;
+	memcpy(dst, opll, sizeof(EOPLL));	dst += sizeof(EOPLL);
+	if (opll->conv != NULL)
+	{
+		memcpy(dst, &opll->conv->timer, sizeof(double));	dst += sizeof(double);
+		for (curChn = 0; curChn < opll->conv->ch; curChn ++)
+		{
+			memcpy(dst, opll->conv->buf[curChn], LW * sizeof(int32_t));
+			dst += LW * sizeof(int32_t);
+		}
+	}
+	return 0x00;
+}
+
+static UINT8 ym2413_load_state_emu(void *chip, UINT32 dataSize, const void* data)
+{
+	EOPLL *opll = (EOPLL *)chip;
+	const UINT8* src = (const UINT8*)data;
+	EOPLL old;
+	int curChn;
+	
+	if (dataSize != ym2413_get_state_size_emu(chip))
+		return 0xFF;
+	old = *opll;
+	memcpy(opll, src, sizeof(EOPLL));	src += sizeof(EOPLL);
+	// keep rate converter and user settings
+	opll->conv = old.conv;
+	memcpy(opll->pan, old.pan, sizeof(opll->pan));
+	memcpy(opll->pan_fine, old.pan_fine, sizeof(opll->pan_fine));
+	opll->mask = old.mask;
+	if (opll->conv != NULL)
+	{
+		memcpy(&opll->conv->timer, src, sizeof(double));	src += sizeof(double);
+		for (curChn = 0; curChn < opll->conv->ch; curChn ++)
+		{
+			memcpy(opll->conv->buf[curChn], src, LW * sizeof(int32_t));
+			src += LW * sizeof(int32_t);
+		}
+	}
+	return 0x00;
+}
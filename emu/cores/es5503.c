@@ -63,6 +63,9 @@ static void es5503_write_ram(void *info, UINT32 offset, UINT32 length, const UIN
 
 static void es5503_set_mute_mask(void *info, UINT32 MuteMask);
 static void es5503_set_srchg_cb(void *info, DEVCB_SRATE_CHG CallbackFunc, void* DataPtr);
+static UINT32 es5503_get_state_size(void *info);
+static UINT8 es5503_save_state(void *info, UINT32 bufSize, void* buffer);
+static UINT8 es5503_load_state(void *info, UINT32 dataSize, const void* data);
 
 
 static DEVDEF_RWFUNC devFunc[] =
@@ -71,6 +74,9 @@ static DEVDEF_RWFUNC devFunc[] =
 	{RWF_REGISTER | RWF_READ, DEVRW_A8D8, 0, es5503_r},
 	{RWF_MEMORY | RWF_WRITE, DEVRW_BLOCK, 0, es5503_write_ram},
 	{RWF_CHN_MUTE | RWF_WRITE, DEVRW_ALL, 0, es5503_set_mute_mask},
+	{RWF_STATE | RWF_READ, DEVRW_MEMSIZE, 0, es5503_get_state_size},
+	{RWF_STATE | RWF_READ, DEVRW_BLOCK, 0, es5503_save_state},
+	{RWF_STATE | RWF_WRITE, DEVRW_BLOCK, 0, es5503_load_state},
 	{0x00, 0x00, 0, NULL}
 };
 static DEV_DEF devDef =
@@ -645,3 +651,49 @@ static void es5503_set_srchg_cb(void *info, DEVCB_SRATE_CHG CallbackFunc, void*
 	
 	return;
 }
+
+static UINT32 es5503_get_state_size(void *info)
+{
+	ES5503Chip *chip = (ES5503Chip *)info;
+	return sizeof(ES5503Chip) + chip->dramsize;
+}
+
+static UINT8 es5503_save_state(void *info, UINT32 bufSize, void* buffer)
+{
+	ES5503Chip *chip = (ES5503Chip *)info;
+	UINT8* dst = (UINT8*)buffer;
+	
+	if (bufSize < sizeof(ES5503Chip) + chip->dramsize)
+		return 0xFF;
+	memcpy(dst, chip, sizeof(ES5503Chip));
+	memcpy(dst + sizeof(ES5503Chip), chip->docram, chip->dramsize);
+	return 0x00;
+}
+
+static UINT8 es5503_load_state(void *info, UINT32 dataSize, const void* data)
+{
+	ES5503Chip *chip = (ES5503Chip *)info;
+	const UINT8* src = (const UINT8*)data;
+	ES5503Chip old;
+	UINT8 CurChn;
+	
+	if (dataSize != sizeof(ES5503Chip) + chip->dramsize)
+		return 0xFF;
+	old = *chip;
+	memcpy(chip, src, sizeof(ES5503Chip));
+	// keep memory buffers, callbacks and user settings
+	chip->docram = old.docram;
+	chip->dramsize = old.dramsize;
+	chip->irq_func = old.irq_func;
+	chip->irq_param = old.irq_param;
+	chip->adc_func = old.adc_func;
+	chip->adc_param = old.adc_param;
+	chip->SmpRateFunc = old.SmpRateFunc;
+	chip->SmpRateData = old.SmpRateData;
+	for (CurChn = 0; CurChn < 32; CurChn ++)
+		chip->oscillators[CurChn].Muted = old.oscillators[CurChn].Muted;
+	memcpy(chip->docram, src + sizeof(ES5503Chip), chip->dramsize);
+	if (chip->SmpRateFunc != NULL && chip->output_rate != old.output_rate)
+		chip->SmpRateFunc(chip->SmpRateData, chip->output_rate);
+	return 0x00;
+}
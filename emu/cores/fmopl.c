@@ -2445,9 +2445,104 @@ void opl_set_mute_mask(void *chip, UINT32 MuteMask)
 	return;
 }
 
+/* same as ym3812_update_one/ym3526_update_one, but only advances LFO, envelopes and phases
+   (the operator feedback isn't updated, like for muted channels) */
+void opl_skip(void *chip, UINT32 length)
+{
+	FM_OPL *OPL = (FM_OPL *)chip;
+	UINT32 i;
+
+	for( i=0; i < length ; i++ )
+	{
+		advance_lfo(OPL);
+		advance(OPL);
+	}
+}
+
 void opl_set_log_cb(void* chip, DEVCB_LOG func, void* param)
 {
 	FM_OPL *opl = (FM_OPL *)chip;
 	dev_logger_set(&opl->logger, opl, func, param);
 	return;
 }
+
+UINT32 opl_get_state_size(void *chip)
+{
+	FM_OPL *opl = (FM_OPL *)chip;
+	UINT32 size = sizeof(FM_OPL);
+	
+#if BUILD_Y8950
+	if (opl->type & OPL_TYPE_ADPCM)
+		size += sizeof(YM_DELTAT) + opl->deltat->memory_size;
+#endif
+	return size;
+}
+
+UINT8 opl_save_state(void *chip, UINT32 bufSize, void* buffer)
+{
+	FM_OPL *opl = (FM_OPL *)chip;
+	UINT8 *dst = (UINT8 *)buffer;
+	
+	if (bufSize < opl_get_state_size(chip))
+		return 0xFF;
+	memcpy(dst, opl, sizeof(FM_OPL));
+#if BUILD_Y8950
+	if (opl->type & OPL_TYPE_ADPCM)
+	{
+		dst += sizeof(FM_OPL);
+		memcpy(dst, opl->deltat, sizeof(YM_DELTAT));
+		dst += sizeof(YM_DELTAT);
+		memcpy(dst, opl->deltat->memory, opl->deltat->memory_size);
+	}
+#endif
+	return 0x00;
+}
+
+UINT8 opl_load_state(void *chip, UINT32 dataSize, const void* data)
+{
+	FM_OPL *opl = (FM_OPL *)chip;
+	const UINT8 *src = (const UINT8 *)data;
+	FM_OPL old;
+	UINT8 CurChn;
+	
+	if (dataSize != opl_get_state_size(chip))
+		return 0xFF;
+	old = *opl;
+	memcpy(opl, src, sizeof(FM_OPL));
+	
+	// keep callbacks and user settings
+	opl->logger = old.logger;
+	for (CurChn = 0; CurChn < 9; CurChn ++)
+		opl->P_CH[CurChn].Muted = old.P_CH[CurChn].Muted;
+	memcpy(opl->MuteSpc, old.MuteSpc, sizeof(opl->MuteSpc));
+	opl->timer_handler = old.timer_handler;
+	opl->TimerParam = old.TimerParam;
+	opl->IRQHandler = old.IRQHandler;
+	opl->IRQParam = old.IRQParam;
+	opl->UpdateHandler = old.UpdateHandler;
+	opl->UpdateParam = old.UpdateParam;
+#if BUILD_Y8950
+	opl->deltat = old.deltat;
+	opl->porthandler_r = old.porthandler_r;
+	opl->porthandler_w = old.porthandler_w;
+	opl->port_param = old.port_param;
+	opl->keyboardhandler_r = old.keyboardhandler_r;
+	opl->keyboardhandler_w = old.keyboardhandler_w;
+	opl->keyboard_param = old.keyboard_param;
+	if (opl->type & OPL_TYPE_ADPCM)
+	{
+		YM_DELTAT *DELTAT = opl->deltat;
+		YM_DELTAT oldDT = *DELTAT;
+		
+		src += sizeof(FM_OPL);
+		memcpy(DELTAT, src, sizeof(YM_DELTAT));
+		src += sizeof(YM_DELTAT);
+		DELTAT->logger = oldDT.logger;
+		DELTAT->memory = oldDT.memory;
+		DELTAT->memory_size = oldDT.memory_size;
+		DELTAT->memory_mask = oldDT.memory_mask;
+		memcpy(DELTAT->memory, src, DELTAT->memory_size);
+	}
+#endif
+	return 0x00;
+}
@@ -2337,6 +2337,63 @@ static void OPNSetSmplRateChgCallback(FM_OPN *OPN, DEVCB_SRATE_CHG cbFunc, void*
 	return;
 }
 
+/* everything that has to survive loading a state: callbacks, links and user settings */
+typedef struct
+{
+	void *      param;
+	FM_TIMERHANDLER timer_handler;
+	FM_IRQHANDLER   IRQ_Handler;
+	ssg_callbacks SSG_funcs;
+	void *      SSG_param;
+	UINT32      rate;
+	UINT8       LegacyMode;
+	DEVCB_SRATE_CHG smpRateFunc;
+	void*       smpRateData;
+	DEV_LOGGER  logger;
+	UINT8       Muted[6];
+} OPN_KEEP;
+
+static void OPNKeepSettings(const FM_OPN *OPN, const FM_CH *CH, int chCnt, OPN_KEEP *keep)
+{
+	int c;
+	
+	keep->param = OPN->ST.param;
+	keep->timer_handler = OPN->ST.timer_handler;
+	keep->IRQ_Handler = OPN->ST.IRQ_Handler;
+	keep->SSG_funcs = OPN->ST.SSG_funcs;
+	keep->SSG_param = OPN->ST.SSG_param;
+	keep->rate = OPN->ST.rate;
+	keep->LegacyMode = OPN->LegacyMode;
+	keep->smpRateFunc = OPN->smpRateFunc;
+	keep->smpRateData = OPN->smpRateData;
+	keep->logger = OPN->logger;
+	for (c = 0; c < chCnt; c ++)
+		keep->Muted[c] = CH[c].Muted;
+	return;
+}
+
+static void OPNRestoreSettings(FM_OPN *OPN, FM_CH *CH, int chCnt, const OPN_KEEP *keep)
+{
+	int c;
+	
+	OPN->ST.param = keep->param;
+	OPN->ST.timer_handler = keep->timer_handler;
+	OPN->ST.IRQ_Handler = keep->IRQ_Handler;
+	OPN->ST.SSG_funcs = keep->SSG_funcs;
+	OPN->ST.SSG_param = keep->SSG_param;
+	OPN->LegacyMode = keep->LegacyMode;
+	OPN->smpRateFunc = keep->smpRateFunc;
+	OPN->smpRateData = keep->smpRateData;
+	OPN->logger = keep->logger;
+	for (c = 0; c < chCnt; c ++)
+		CH[c].Muted = keep->Muted[c];
+	
+	/* the state may use a different prescaler */
+	if (OPN->ST.rate != keep->rate && OPN->smpRateFunc != NULL)
+		OPN->smpRateFunc(OPN->smpRateData, OPN->ST.rate);
+	return;
+}
+
 
 #if BUILD_YM2203
 /*****************************************************************************/
@@ -2670,6 +2727,32 @@ void ym2203_set_log_cb(void* chip, DEVCB_LOG func, void* param)
 	dev_logger_set(&F2203->OPN.logger, F2203, func, param);
 	return;
 }
+
+UINT32 ym2203_get_state_size(void *chip)
+{
+	return sizeof(YM2203);
+}
+
+UINT8 ym2203_save_state(void *chip, UINT32 bufSize, void* buffer)
+{
+	if (bufSize < sizeof(YM2203))
+		return 0xFF;
+	memcpy(buffer, chip, sizeof(YM2203));
+	return 0x00;
+}
+
+UINT8 ym2203_load_state(void *chip, UINT32 dataSize, const void* data)
+{
+	YM2203 *F2203 = (YM2203 *)chip;
+	OPN_KEEP keep;
+	
+	if (dataSize != sizeof(YM2203))
+		return 0xFF;
+	OPNKeepSettings(&F2203->OPN, F2203->CH, 3, &keep);
+	memcpy(F2203, data, sizeof(YM2203));
+	OPNRestoreSettings(&F2203->OPN, F2203->CH, 3, &keep);
+	return 0x00;
+}
 #endif /* BUILD_YM2203 */
 
 
@@ -3588,6 +3671,60 @@ void ym2608_set_log_cb(void* chip, DEVCB_LOG func, void* param)
 	dev_logger_set(&F2608->OPN.logger, F2608, func, param);
 	return;
 }
+
+/* The DELTA-T memory of the YM2608 is RAM and thus part of the state. */
+UINT32 ym2608_get_state_size(void *chip)
+{
+	YM2608 *F2608 = (YM2608 *)chip;
+	return sizeof(YM2608) + F2608->deltaT.memory_size;
+}
+
+UINT8 ym2608_save_state(void *chip, UINT32 bufSize, void* buffer)
+{
+	YM2608 *F2608 = (YM2608 *)chip;
+	UINT8 *dst = (UINT8 *)buffer;
+	
+	if (bufSize < ym2608_get_state_size(chip))
+		return 0xFF;
+	memcpy(dst, F2608, sizeof(YM2608));
+	memcpy(dst + sizeof(YM2608), F2608->deltaT.memory, F2608->deltaT.memory_size);
+	return 0x00;
+}
+
+UINT8 ym2608_load_state(void *chip, UINT32 dataSize, const void* data)
+{
+	YM2608 *F2608 = (YM2608 *)chip;
+	const UINT8 *src = (const UINT8 *)data;
+	OPN_KEEP keep;
+	UINT8 adpcmMuted[6];
+	UINT8 muteDeltaT;
+	UINT8 *memory;
+	UINT32 memory_size;
+	UINT32 memory_mask;
+	int c;
+	
+	if (dataSize != ym2608_get_state_size(chip))
+		return 0xFF;
+	OPNKeepSettings(&F2608->OPN, F2608->CH, 6, &keep);
+	for (c = 0; c < 6; c ++)
+		adpcmMuted[c] = F2608->adpcm[c].Muted;
+	muteDeltaT = F2608->MuteDeltaT;
+	memory = F2608->deltaT.memory;
+	memory_size = F2608->deltaT.memory_size;
+	memory_mask = F2608->deltaT.memory_mask;
+	
+	memcpy(F2608, src, sizeof(YM2608));
+	memcpy(memory, src + sizeof(YM2608), memory_size);
+	
+	OPNRestoreSettings(&F2608->OPN, F2608->CH, 6, &keep);
+	for (c = 0; c < 6; c ++)
+		F2608->adpcm[c].Muted = adpcmMuted[c];
+	F2608->MuteDeltaT = muteDeltaT;
+	F2608->deltaT.memory = memory;
+	F2608->deltaT.memory_size = memory_size;
+	F2608->deltaT.memory_mask = memory_mask;
+	return 0x00;
+}
 #endif /* BUILD_YM2608 */
 
 
@@ -4331,6 +4468,58 @@ void ym2610_set_log_cb(void* chip, DEVCB_LOG func, void* param)
 	dev_logger_set(&F2610->OPN.logger, F2610, func, param);
 	return;
 }
+
+UINT32 ym2610_get_state_size(void *chip)
+{
+	return sizeof(YM2610);
+}
+
+UINT8 ym2610_save_state(void *chip, UINT32 bufSize, void* buffer)
+{
+	if (bufSize < sizeof(YM2610))
+		return 0xFF;
+	memcpy(buffer, chip, sizeof(YM2610));
+	return 0x00;
+}
+
+UINT8 ym2610_load_state(void *chip, UINT32 dataSize, const void* data)
+{
+	YM2610 *F2610 = (YM2610 *)chip;
+	OPN_KEEP keep;
+	UINT8 adpcmMuted[6];
+	UINT8 muteDeltaT;
+	UINT8 *pcmbuf;
+	UINT32 pcm_size;
+	UINT8 *memory;
+	UINT32 memory_size;
+	UINT32 memory_mask;
+	int c;
+	
+	if (dataSize != sizeof(YM2610))
+		return 0xFF;
+	OPNKeepSettings(&F2610->OPN, F2610->CH, 6, &keep);
+	for (c = 0; c < 6; c ++)
+		adpcmMuted[c] = F2610->adpcm[c].Muted;
+	muteDeltaT = F2610->MuteDeltaT;
+	pcmbuf = F2610->pcmbuf;
+	pcm_size = F2610->pcm_size;
+	memory = F2610->deltaT.memory;
+	memory_size = F2610->deltaT.memory_size;
+	memory_mask = F2610->deltaT.memory_mask;
+	
+	memcpy(F2610, data, sizeof(YM2610));
+	
+	OPNRestoreSettings(&F2610->OPN, F2610->CH, 6, &keep);
+	for (c = 0; c < 6; c ++)
+		F2610->adpcm[c].Muted = adpcmMuted[c];
+	F2610->MuteDeltaT = muteDeltaT;
+	F2610->pcmbuf = pcmbuf;
+	F2610->pcm_size = pcm_size;
+	F2610->deltaT.memory = memory;
+	F2610->deltaT.memory_size = memory_size;
+	F2610->deltaT.memory_mask = memory_mask;
+	return 0x00;
+}
 #endif /* (BUILD_YM2610||BUILD_YM2610B) */
 
 
@@ -4361,29 +4550,16 @@ typedef struct
 } YM2612;
 
 /* Generate samples for one of the YM2612s */
-void ym2612_update_one(void *chip, UINT32 length, DEV_SMPL **buffer)
+/* When buffer is NULL, the samples are multiplied by volL/volR and added to the interleaved mixBuf. */
+static void ym2612_render(YM2612 *F2612, UINT32 length, DEV_SMPL **buffer, DEV_SMPL *mixBuf, INT32 volL, INT32 volR)
 {
-	YM2612 *F2612 = (YM2612 *)chip;
 	FM_OPN *OPN  = &F2612->OPN;
 	INT32 *out_fm = OPN->out_fm;
 	UINT32 i;
-	DEV_SMPL  *bufL,*bufR;
 	INT32 dacout;
 	FM_CH   *cch[6];
 	INT32 lt,rt;
 
-	/* set buffer */
-	if (buffer != NULL)
-	{
-		bufL = buffer[0];
-		bufR = buffer[1];
-	}
-	else
-	{
-		// for internal 0-sample update
-		bufL = bufR = NULL;
-	}
-
 	cch[0]   = &F2612->CH[0];
 	cch[1]   = &F2612->CH[1];
 	cch[2]   = &F2612->CH[2];
@@ -4534,8 +4710,16 @@ void ym2612_update_one(void *chip, UINT32 length, DEV_SMPL **buffer)
 			F2612->WaveL = lt;
 			F2612->WaveR = rt;
 		}
-		bufL[i] = F2612->WaveL;
-		bufR[i] = F2612->WaveR;
+		if (buffer != NULL)
+		{
+			buffer[0][i] = F2612->WaveL;
+			buffer[1][i] = F2612->WaveR;
+		}
+		else
+		{
+			mixBuf[i * 2 + 0] += F2612->WaveL * volL;
+			mixBuf[i * 2 + 1] += F2612->WaveR * volR;
+		}
 
 		/* CSM mode: if CSM Key ON has occured, CSM Key OFF need to be sent       */
 		/* only if Timer A does not overflow again (i.e CSM Key ON not set again) */
@@ -4560,6 +4744,16 @@ void ym2612_update_one(void *chip, UINT32 length, DEV_SMPL **buffer)
 	INTERNAL_TIMER_B(&OPN->ST,length)
 }
 
+void ym2612_update_one(void *chip, UINT32 length, DEV_SMPL **buffer)
+{
+	ym2612_render((YM2612 *)chip, length, buffer, NULL, 0, 0);
+}
+
+void ym2612_update_mix(void *chip, UINT32 length, DEV_SMPL *mixBuf, INT32 volL, INT32 volR)
+{
+	ym2612_render((YM2612 *)chip, length, NULL, mixBuf, volL, volR);
+}
+
 static void ym2612_update_req(void *param)
 {
 	ym2612_update_one(param, 0, NULL);
@@ -4810,4 +5004,38 @@ void ym2612_set_log_cb(void* chip, DEVCB_LOG func, void* param)
 	dev_logger_set(&F2612->OPN.logger, F2612, func, param);
 	return;
 }
+
+UINT32 ym2612_get_state_size(void *chip)
+{
+	return sizeof(YM2612);
+}
+
+UINT8 ym2612_save_state(void *chip, UINT32 bufSize, void* buffer)
+{
+	if (bufSize < sizeof(YM2612))
+		return 0xFF;
+	memcpy(buffer, chip, sizeof(YM2612));
+	return 0x00;
+}
+
+UINT8 ym2612_load_state(void *chip, UINT32 dataSize, const void* data)
+{
+	YM2612 *F2612 = (YM2612 *)chip;
+	OPN_KEEP keep;
+	UINT8 muteDAC;
+	UINT8 waveOutMode;
+	
+	if (dataSize != sizeof(YM2612))
+		return 0xFF;
+	OPNKeepSettings(&F2612->OPN, F2612->CH, 6, &keep);
+	muteDAC = F2612->MuteDAC;
+	waveOutMode = F2612->WaveOutMode;
+	
+	memcpy(F2612, data, sizeof(YM2612));
+	
+	OPNRestoreSettings(&F2612->OPN, F2612->CH, 6, &keep);
+	F2612->MuteDAC = muteDAC;
+	F2612->WaveOutMode = waveOutMode;
+	return 0x00;
+}
 #endif /* (BUILD_YM2612) */
@@ -144,6 +144,13 @@ void ym2203_set_mute_mask(void *chip, UINT32 MuteMask);
 **  logging function
 */
 void ym2203_set_log_cb(void* chip, DEVCB_LOG func, void* param);
+
+/*
+**  state save/load
+*/
+UINT32 ym2203_get_state_size(void *chip);
+UINT8 ym2203_save_state(void *chip, UINT32 bufSize, void* buffer);
+UINT8 ym2203_load_state(void *chip, UINT32 dataSize, const void* data);
 #endif /* BUILD_YM2203 */
 
 #if BUILD_YM2608
@@ -164,6 +171,9 @@ void ym2608_write_pcmromb(void* chip, UINT32 offset, UINT32 length, const UINT8*
 
 void ym2608_set_mute_mask(void *chip, UINT32 MuteMask);
 void ym2608_set_log_cb(void* chip, DEVCB_LOG func, void* param);
+UINT32 ym2608_get_state_size(void *chip);
+UINT8 ym2608_save_state(void *chip, UINT32 bufSize, void* buffer);
+UINT8 ym2608_load_state(void *chip, UINT32 dataSize, const void* data);
 #endif /* BUILD_YM2608 */
 
 #if (BUILD_YM2610||BUILD_YM2610B)
@@ -189,6 +199,9 @@ void ym2610_write_pcmromb(void* chip, UINT32 offset, UINT32 length, const UINT8*
 
 void ym2610_set_mute_mask(void *chip, UINT32 MuteMask);
 void ym2610_set_log_cb(void* chip, DEVCB_LOG func, void* param);
+UINT32 ym2610_get_state_size(void *chip);
+UINT8 ym2610_save_state(void *chip, UINT32 bufSize, void* buffer);
+UINT8 ym2610_load_state(void *chip, UINT32 dataSize, const void* data);
 #endif /* (BUILD_YM2610||BUILD_YM2610B) */
 
 #if (BUILD_YM2612||BUILD_YM3438)
@@ -197,6 +210,7 @@ void * ym2612_init(void *param, UINT32 baseclock, UINT32 rate,
 void ym2612_shutdown(void *chip);
 void ym2612_reset_chip(void *chip);
 void ym2612_update_one(void *chip, UINT32 length, DEV_SMPL **buffer);
+void ym2612_update_mix(void *chip, UINT32 length, DEV_SMPL *mixBuf, INT32 volL, INT32 volR);
 
 void ym2612_write(void *chip, UINT8 a, UINT8 v);
 UINT8 ym2612_read(void *chip, UINT8 a);
@@ -205,6 +219,9 @@ UINT8 ym2612_timer_over(void *chip, UINT8 c );
 void ym2612_set_mute_mask(void *chip, UINT32 MuteMask);
 void ym2612_set_options(void *chip, UINT32 Flags);
 void ym2612_set_log_cb(void* chip, DEVCB_LOG func, void* param);
+UINT32 ym2612_get_state_size(void *chip);
+UINT8 ym2612_save_state(void *chip, UINT32 bufSize, void* buffer);
+UINT8 ym2612_load_state(void *chip, UINT32 dataSize, const void* data);
 #endif /* (BUILD_YM2612||BUILD_YM3438) */
 
 #endif	// __FMOPN_H__
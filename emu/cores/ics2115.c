@@ -56,6 +56,9 @@ static void ics2115_write_rom(void *info, UINT32 offset, UINT32 length, const UI
 static void ics2115_set_mute_mask(void *info, UINT32 MuteMask);
 static UINT32 ics2115_get_mute_mask(void *info);
 static void ics2115_set_srchg_cb(void *info, DEVCB_SRATE_CHG CallbackFunc, void* DataPtr);
+static UINT32 ics2115_get_state_size(void *info);
+static UINT8 ics2115_save_state(void *info, UINT32 bufSize, void* buffer);
+static UINT8 ics2115_load_state(void *info, UINT32 dataSize, const void* data);
 
 static DEVDEF_RWFUNC devFunc[] =
 {
@@ -64,6 +67,9 @@ static DEVDEF_RWFUNC devFunc[] =
 	{RWF_MEMORY | RWF_WRITE, DEVRW_MEMSIZE, 0, ics2115_alloc_rom},
 	{RWF_MEMORY | RWF_WRITE, DEVRW_BLOCK, 0, ics2115_write_rom},
 	{RWF_CHN_MUTE | RWF_WRITE, DEVRW_ALL, 0, ics2115_set_mute_mask},
+	{RWF_STATE | RWF_READ, DEVRW_MEMSIZE, 0, ics2115_get_state_size},
+	{RWF_STATE | RWF_READ, DEVRW_BLOCK, 0, ics2115_save_state},
+	{RWF_STATE | RWF_WRITE, DEVRW_BLOCK, 0, ics2115_load_state},
 	{0x00, 0x00, 0, NULL}
 };
 static DEV_DEF devDef =
@@ -1345,3 +1351,41 @@ static void ics2115_set_srchg_cb(void *info, DEVCB_SRATE_CHG CallbackFunc, void*
 	
 	return;
 }
+
+static UINT32 ics2115_get_state_size(void *info)
+{
+	return sizeof(ics2115_state);
+}
+
+static UINT8 ics2115_save_state(void *info, UINT32 bufSize, void* buffer)
+{
+	if (bufSize < sizeof(ics2115_state))
+		return 0xFF;
+	memcpy(buffer, info, sizeof(ics2115_state));
+	return 0x00;
+}
+
+static UINT8 ics2115_load_state(void *info, UINT32 dataSize, const void* data)
+{
+	ics2115_state *chip = (ics2115_state *)info;
+	ics2115_state old;
+	UINT8 CurChn;
+	
+	if (dataSize != sizeof(ics2115_state))
+		return 0xFF;
+	old = *chip;
+	memcpy(chip, data, sizeof(ics2115_state));
+	// keep memory buffers, callbacks and user settings
+	chip->irq_func = old.irq_func;
+	chip->irq_param = old.irq_param;
+	chip->SmpRateFunc = old.SmpRateFunc;
+	chip->SmpRateData = old.SmpRateData;
+	chip->rom = old.rom;
+	chip->rom_size = old.rom_size;
+	chip->rom_mask = old.rom_mask;
+	for (CurChn = 0; CurChn < 32; CurChn ++)
+		chip->voice[CurChn].Muted = old.voice[CurChn].Muted;
+	if (chip->SmpRateFunc != NULL && chip->output_rate != old.output_rate)
+		chip->SmpRateFunc(chip->SmpRateData, chip->output_rate);
+	return 0x00;
+}
@@ -68,6 +68,9 @@ static void iremga20_write_rom(void *info, UINT32 offset, UINT32 length, const U
 static void iremga20_set_mute_mask(void *info, UINT32 MuteMask);
 static void iremga20_set_options(void *chip, UINT32 Flags);
 static void iremga20_set_log_cb(void* info, DEVCB_LOG func, void* param);
+static UINT32 iremga20_get_state_size(void *info);
+static UINT8 iremga20_save_state(void *info, UINT32 bufSize, void* buffer);
+static UINT8 iremga20_load_state(void *info, UINT32 dataSize, const void* data);
 
 
 static DEVDEF_RWFUNC devFunc[] =
@@ -77,6 +80,9 @@ static DEVDEF_RWFUNC devFunc[] =
 	{RWF_MEMORY | RWF_WRITE, DEVRW_BLOCK, 0, iremga20_write_rom},
 	{RWF_MEMORY | RWF_WRITE, DEVRW_MEMSIZE, 0, iremga20_alloc_rom},
 	{RWF_CHN_MUTE | RWF_WRITE, DEVRW_ALL, 0, iremga20_set_mute_mask},
+	{RWF_STATE | RWF_READ, DEVRW_MEMSIZE, 0, iremga20_get_state_size},
+	{RWF_STATE | RWF_READ, DEVRW_BLOCK, 0, iremga20_save_state},
+	{RWF_STATE | RWF_WRITE, DEVRW_BLOCK, 0, iremga20_load_state},
 	{0x00, 0x00, 0, NULL}
 };
 static DEV_DEF devDef =
@@ -434,3 +440,36 @@ static void iremga20_set_log_cb(void* info, DEVCB_LOG func, void* param)
 	dev_logger_set(&chip->logger, chip, func, param);
 	return;
 }
+
+static UINT32 iremga20_get_state_size(void *info)
+{
+	return sizeof(ga20_state);
+}
+
+static UINT8 iremga20_save_state(void *info, UINT32 bufSize, void* buffer)
+{
+	if (bufSize < sizeof(ga20_state))
+		return 0xFF;
+	memcpy(buffer, info, sizeof(ga20_state));
+	return 0x00;
+}
+
+static UINT8 iremga20_load_state(void *info, UINT32 dataSize, const void* data)
+{
+	ga20_state *chip = (ga20_state *)info;
+	ga20_state old;
+	UINT8 CurChn;
+	
+	if (dataSize != sizeof(ga20_state))
+		return 0xFF;
+	old = *chip;
+	memcpy(chip, data, sizeof(ga20_state));
+	// keep memory buffers, callbacks and user settings
+	chip->logger = old.logger;
+	chip->rom = old.rom;
+	chip->rom_size = old.rom_size;
+	chip->interpolate = old.interpolate;
+	for (CurChn = 0; CurChn < 4; CurChn ++)
+		chip->channel[CurChn].Muted = old.channel[CurChn].Muted;
+	return 0x00;
+}
@@ -83,12 +83,18 @@ static void device_reset_k005289(void* chip);
 static void k005289_set_mute_mask(void* chip, UINT32 mute_mask);
 static void k005289_write(void* chip, UINT8 address, UINT16 data);
 static void k005289_write_prom(void *info, UINT32 offset, UINT32 length, const UINT8* data);
+static UINT32 k005289_get_state_size(void* chip);
+static UINT8 k005289_save_state(void* chip, UINT32 bufSize, void* buffer);
+static UINT8 k005289_load_state(void* chip, UINT32 dataSize, const void* data);
 
 // Add PROM write handler
 static DEVDEF_RWFUNC devFunc[] = {
     {RWF_REGISTER | RWF_WRITE, DEVRW_A8D16, 0, k005289_write},
     {RWF_CHN_MUTE | RWF_WRITE, DEVRW_ALL, 0, k005289_set_mute_mask},
     {RWF_MEMORY | RWF_WRITE, DEVRW_BLOCK, 0, k005289_write_prom},
+    {RWF_STATE | RWF_READ, DEVRW_MEMSIZE, 0, k005289_get_state_size},
+    {RWF_STATE | RWF_READ, DEVRW_BLOCK, 0, k005289_save_state},
+    {RWF_STATE | RWF_WRITE, DEVRW_BLOCK, 0, k005289_load_state},
     {0x00, 0x00, 0, NULL}
 };
 
@@ -249,3 +255,31 @@ static void k005289_write_prom(void *info, UINT32 offset, UINT32 length, const U
     
     memcpy(chip->prom + offset, data, length);
 }
+
+// Save states (the PROM is not part of the state)
+static UINT32 k005289_get_state_size(void* chip)
+{
+    return sizeof(k005289_state);
+}
+
+static UINT8 k005289_save_state(void* chip, UINT32 bufSize, void* buffer)
+{
+    if (bufSize < sizeof(k005289_state))
+        return 0xFF;
+    memcpy(buffer, chip, sizeof(k005289_state));
+    return 0x00;
+}
+
+static UINT8 k005289_load_state(void* chip, UINT32 dataSize, const void* data)
+{
+    k005289_state* info = (k005289_state*)chip;
+    k005289_state old;
+    
+    if (dataSize != sizeof(k005289_state))
+        return 0xFF;
+    old = *info;
+    memcpy(info, data, sizeof(k005289_state));
+    memcpy(info->prom, old.prom, PROM_SIZE);
+    info->mute_mask = old.mute_mask;
+    return 0x00;
+}
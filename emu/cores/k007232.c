@@ -85,6 +85,9 @@ static UINT8 k007232_read(void* chip, UINT8 offset);
 static void k007232_write_rom(void* chip, UINT32 offset, UINT32 length, const UINT8* data);
 static void k007232_alloc_rom(void* chip, UINT32 memsize);
 static void k007232_set_mute_mask(void* chip, UINT32 MuteMask);
+static UINT32 k007232_get_state_size(void* chip);
+static UINT8 k007232_save_state(void* chip, UINT32 bufSize, void* buffer);
+static UINT8 k007232_load_state(void* chip, UINT32 dataSize, const void* data);
 void k007232_set_port_write_cb(void* chip, void (*cb)(UINT8 data));	// TODO: integrate into DEVDEF_RWFUNC list
 
 // --- Device definition ---
@@ -95,6 +98,9 @@ static DEVDEF_RWFUNC devFunc[] =
 	{RWF_MEMORY | RWF_WRITE, DEVRW_BLOCK, 0, k007232_write_rom},
 	{RWF_MEMORY | RWF_WRITE, DEVRW_MEMSIZE, 0, k007232_alloc_rom},
 	{RWF_CHN_MUTE | RWF_WRITE, DEVRW_ALL, 0, k007232_set_mute_mask},
+	{RWF_STATE | RWF_READ, DEVRW_MEMSIZE, 0, k007232_get_state_size},
+	{RWF_STATE | RWF_READ, DEVRW_BLOCK, 0, k007232_save_state},
+	{RWF_STATE | RWF_WRITE, DEVRW_BLOCK, 0, k007232_load_state},
 	{0, 0, 0, NULL}
 };
 static DEV_DEF devDef =
@@ -370,6 +376,39 @@ static void k007232_set_mute_mask(void* chip, UINT32 MuteMask)
 		c->channel[i].mute = (MuteMask & (1 << i)) ? 1 : 0;
 }
 
+static UINT32 k007232_get_state_size(void* chip)
+{
+	return sizeof(k007232_state);
+}
+
+static UINT8 k007232_save_state(void* chip, UINT32 bufSize, void* buffer)
+{
+	if (bufSize < sizeof(k007232_state))
+		return 0xFF;
+	memcpy(buffer, chip, sizeof(k007232_state));
+	return 0x00;
+}
+
+static UINT8 k007232_load_state(void* chip, UINT32 dataSize, const void* data)
+{
+	k007232_state* c = (k007232_state*)chip;
+	k007232_state old;
+	int i;
+	
+	if (dataSize != sizeof(k007232_state))
+		return 0xFF;
+	old = *c;
+	memcpy(c, data, sizeof(k007232_state));
+	// keep memory buffers, callbacks and user settings
+	c->rom = old.rom;
+	c->rom_size = old.rom_size;
+	c->rom_mask = old.rom_mask;
+	c->port_write_cb = old.port_write_cb;
+	for (i = 0; i < K007232_PCM_MAX; i++)
+		c->channel[i].mute = old.channel[i].mute;
+	return 0x00;
+}
+
 // --- Optional: attach external volume/pan callback (for host integration like Ajax and Chequered Flag) ---
 void k007232_set_port_write_cb(void* chip, void (*cb)(UINT8 data))
 {
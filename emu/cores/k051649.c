@@ -65,6 +65,9 @@ static void k051649_w(void *chip, UINT8 offset, UINT8 data);
 static UINT8 k051649_r(void *chip, UINT8 offset, UINT8 data);
 
 static void k051649_set_mute_mask(void *chip, UINT32 MuteMask);
+static UINT32 k051649_get_state_size(void *chip);
+static UINT8 k051649_save_state(void *chip, UINT32 bufSize, void* buffer);
+static UINT8 k051649_load_state(void *chip, UINT32 dataSize, const void* data);
 
 
 static DEVDEF_RWFUNC devFunc[] =
@@ -72,6 +75,9 @@ static DEVDEF_RWFUNC devFunc[] =
 	{RWF_REGISTER | RWF_WRITE, DEVRW_A8D8, 0, k051649_w},
 	{RWF_REGISTER | RWF_READ, DEVRW_A8D8, 0, k051649_r},
 	{RWF_CHN_MUTE | RWF_WRITE, DEVRW_ALL, 0, k051649_set_mute_mask},
+	{RWF_STATE | RWF_READ, DEVRW_MEMSIZE, 0, k051649_get_state_size},
+	{RWF_STATE | RWF_READ, DEVRW_BLOCK, 0, k051649_save_state},
+	{RWF_STATE | RWF_WRITE, DEVRW_BLOCK, 0, k051649_load_state},
 	{0x00, 0x00, 0, NULL}
 };
 static DEV_DEF devDef =
@@ -447,3 +453,32 @@ static void k051649_set_mute_mask(void *chip, UINT32 MuteMask)
 	
 	return;
 }
+
+static UINT32 k051649_get_state_size(void *chip)
+{
+	return sizeof(k051649_state);
+}
+
+static UINT8 k051649_save_state(void *chip, UINT32 bufSize, void* buffer)
+{
+	if (bufSize < sizeof(k051649_state))
+		return 0xFF;
+	memcpy(buffer, chip, sizeof(k051649_state));
+	return 0x00;
+}
+
+static UINT8 k051649_load_state(void *chip, UINT32 dataSize, const void* data)
+{
+	k051649_state *info = (k051649_state *)chip;
+	k051649_state old;
+	UINT8 CurChn;
+	
+	if (dataSize != sizeof(k051649_state))
+		return 0xFF;
+	old = *info;
+	memcpy(info, data, sizeof(k051649_state));
+	// keep user settings
+	for (CurChn = 0; CurChn < 5; CurChn ++)
+		info->channel_list[CurChn].Muted = old.channel_list[CurChn].Muted;
+	return 0x00;
+}
@@ -80,6 +80,9 @@ static void k053260_alloc_rom(void* chip, UINT32 memsize);
 static void k053260_write_rom(void *chip, UINT32 offset, UINT32 length, const UINT8* data);
 static void k053260_set_mute_mask(void* chip, UINT32 MuteMask);
 static void k053260_set_log_cb(void* chip, DEVCB_LOG func, void* param);
+static UINT32 k053260_get_state_size(void *chip);
+static UINT8 k053260_save_state(void *chip, UINT32 bufSize, void* buffer);
+static UINT8 k053260_load_state(void *chip, UINT32 dataSize, const void* data);
 
 
 static DEVDEF_RWFUNC devFunc[] =
@@ -89,6 +92,9 @@ static DEVDEF_RWFUNC devFunc[] =
 	{RWF_MEMORY | RWF_WRITE, DEVRW_BLOCK, 0, k053260_write_rom},
 	{RWF_MEMORY | RWF_WRITE, DEVRW_MEMSIZE, 0, k053260_alloc_rom},
 	{RWF_CHN_MUTE | RWF_WRITE, DEVRW_ALL, 0, k053260_set_mute_mask},
+	{RWF_STATE | RWF_READ, DEVRW_MEMSIZE, 0, k053260_get_state_size},
+	{RWF_STATE | RWF_READ, DEVRW_BLOCK, 0, k053260_save_state},
+	{RWF_STATE | RWF_WRITE, DEVRW_BLOCK, 0, k053260_load_state},
 	{0x00, 0x00, 0, NULL}
 };
 static DEV_DEF devDef =
@@ -696,3 +702,36 @@ static void k053260_set_log_cb(void* chip, DEVCB_LOG func, void* param)
 	dev_logger_set(&info->logger, info, func, param);
 	return;
 }
+
+static UINT32 k053260_get_state_size(void *chip)
+{
+	return sizeof(k053260_state);
+}
+
+static UINT8 k053260_save_state(void *chip, UINT32 bufSize, void* buffer)
+{
+	if (bufSize < sizeof(k053260_state))
+		return 0xFF;
+	memcpy(buffer, chip, sizeof(k053260_state));
+	return 0x00;
+}
+
+static UINT8 k053260_load_state(void *chip, UINT32 dataSize, const void* data)
+{
+	k053260_state *info = (k053260_state *)chip;
+	k053260_state old;
+	UINT8 CurChn;
+	
+	if (dataSize != sizeof(k053260_state))
+		return 0xFF;
+	old = *info;
+	memcpy(info, data, sizeof(k053260_state));
+	// keep memory buffers and user settings
+	info->logger = old.logger;
+	info->rom = old.rom;
+	info->rom_size = old.rom_size;
+	info->rom_mask = old.rom_mask;
+	for (CurChn = 0; CurChn < 4; CurChn ++)
+		info->voice[CurChn].Muted = old.voice[CurChn].Muted;
+	return 0x00;
+}
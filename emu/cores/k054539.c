@@ -36,9 +36,13 @@ static void k054539_set_gain(void *chip, UINT8 channel, double _gain);
 
 static void k054539_alloc_rom(void* chip, UINT32 memsize);
 static void k054539_write_rom(void *chip, UINT32 offset, UINT32 length, const UINT8* data);
+static void k054539_alias_rom(void *chip, UINT32 memsize, const UINT8* data);
 
 static void k054539_set_mute_mask(void *chip, UINT32 MuteMask);
 static void k054539_set_log_cb(void* chip, DEVCB_LOG func, void* param);
+static UINT32 k054539_get_state_size(void *chip);
+static UINT8 k054539_save_state(void *chip, UINT32 bufSize, void* buffer);
+static UINT8 k054539_load_state(void *chip, UINT32 dataSize, const void* data);
 
 
 static DEVDEF_RWFUNC devFunc[] =
@@ -47,7 +51,11 @@ static DEVDEF_RWFUNC devFunc[] =
 	{RWF_REGISTER | RWF_READ, DEVRW_A16D8, 0, k054539_r},
 	{RWF_MEMORY | RWF_WRITE, DEVRW_BLOCK, 0, k054539_write_rom},
 	{RWF_MEMORY | RWF_WRITE, DEVRW_MEMSIZE, 0, k054539_alloc_rom},
+	{RWF_MEMORY | RWF_WRITE, DEVRW_BLOCK_ALIAS, 0, k054539_alias_rom},
 	{RWF_CHN_MUTE | RWF_WRITE, DEVRW_ALL, 0, k054539_set_mute_mask},
+	{RWF_STATE | RWF_READ, DEVRW_MEMSIZE, 0, k054539_get_state_size},
+	{RWF_STATE | RWF_READ, DEVRW_BLOCK, 0, k054539_save_state},
+	{RWF_STATE | RWF_WRITE, DEVRW_BLOCK, 0, k054539_load_state},
 	{0x00, 0x00, 0, NULL}
 };
 static DEV_DEF devDef =
@@ -168,7 +176,8 @@ struct _k054539_state {
 
 	UINT32 cur_ptr;
 	UINT32 rom_addr;
-	UINT8 *rom;
+	const UINT8 *rom;	// points to rom_buf or to external memory (see k054539_alias_rom)
+	UINT8 *rom_buf;
 	UINT32 rom_size;
 	UINT32 rom_mask;
 
@@ -637,6 +646,7 @@ static UINT8 device_start_k054539(const DEV_GEN_CFG* cfg, DEV_INFO* retDevInf)
 
 	info->ram = (UINT8*)malloc(0x8000);
 	info->rom = NULL;
+	info->rom_buf = NULL;
 	info->rom_size = 0x00;
 	info->rom_mask = 0x00;
 
@@ -654,7 +664,8 @@ static void device_stop_k054539(void *chip)
 {
 	k054539_state *info = (k054539_state *)chip;
 	
-	free(info->rom);	info->rom = NULL;
+	free(info->rom_buf);	info->rom_buf = NULL;
+	info->rom = NULL;
 	free(info->ram);	info->ram = NULL;
 	free(info);
 	
@@ -676,16 +687,33 @@ static void device_reset_k054539(void *chip)
 	return;
 }
 
+// make a private copy of an aliased ROM before modifying it
+static void k054539_own_rom(k054539_state *info)
+{
+	if (info->rom == info->rom_buf)
+		return;
+	
+	info->rom_buf = (UINT8*)malloc(info->rom_size);
+	memcpy(info->rom_buf, info->rom, info->rom_size);
+	info->rom = info->rom_buf;
+	
+	return;
+}
+
 static void k054539_alloc_rom(void* chip, UINT32 memsize)
 {
 	k054539_state *info = (k054539_state *)chip;
 	
 	if (info->rom_size == memsize)
+	{
+		k054539_own_rom(info);
 		return;
+	}
 	
-	info->rom = (UINT8*)realloc(info->rom, memsize);
+	info->rom_buf = (UINT8*)realloc(info->rom_buf, memsize);
+	info->rom = info->rom_buf;
 	info->rom_size = memsize;
-	memset(info->rom, 0xFF, memsize);
+	memset(info->rom_buf, 0xFF, memsize);
 	
 	info->rom_mask = pow2_mask(memsize);
 	
@@ -701,7 +729,20 @@ static void k054539_write_rom(void *chip, UINT32 offset, UINT32 length, const UI
 	if (offset + length > info->rom_size)
 		length = info->rom_size - offset;
 	
-	memcpy(info->rom + offset, data, length);
+	k054539_own_rom(info);
+	memcpy(info->rom_buf + offset, data, length);
+	
+	return;
+}
+
+static void k054539_alias_rom(void *chip, UINT32 memsize, const UINT8* data)
+{
+	k054539_state *info = (k054539_state *)chip;
+	
+	free(info->rom_buf);	info->rom_buf = NULL;
+	info->rom = data;
+	info->rom_size = memsize;
+	info->rom_mask = pow2_mask(memsize);
 	
 	return;
 }
@@ -724,3 +765,44 @@ static void k054539_set_log_cb(void* chip, DEVCB_LOG func, void* param)
 	dev_logger_set(&info->logger, info, func, param);
 	return;
 }
+
+static UINT32 k054539_get_state_size(void *chip)
+{
+	return sizeof(k054539_state) + 0x8000;
+}
+
+static UINT8 k054539_save_state(void *chip, UINT32 bufSize, void* buffer)
+{
+	k054539_state *info = (k054539_state *)chip;
+	UINT8* dst = (UINT8*)buffer;
+	
+	if (bufSize < sizeof(k054539_state) + 0x8000)
+		return 0xFF;
+	memcpy(dst, info, sizeof(k054539_state));
+	memcpy(dst + sizeof(k054539_state), info->ram, 0x8000);
+	return 0x00;
+}
+
+static UINT8 k054539_load_state(void *chip, UINT32 dataSize, const void* data)
+{
+	k054539_state *info = (k054539_state *)chip;
+	const UINT8* src = (const UINT8*)data;
+	k054539_state old;
+	
+	if (dataSize != sizeof(k054539_state) + 0x8000)
+		return 0xFF;
+	old = *info;
+	memcpy(info, src, sizeof(k054539_state));
+	// keep memory buffers and user settings
+	info->logger = old.logger;
+	memcpy(info->gain, old.gain, sizeof(info->gain));
+	info->flags = old.flags;
+	info->ram = old.ram;
+	info->rom = old.rom;
+	info->rom_buf = old.rom_buf;
+	info->rom_size = old.rom_size;
+	info->rom_mask = old.rom_mask;
+	memcpy(info->Muted, old.Muted, sizeof(info->Muted));
+	memcpy(info->ram, src + sizeof(k054539_state), 0x8000);
+	return 0x00;
+}
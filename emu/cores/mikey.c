@@ -2,6 +2,7 @@
 // copyright-holders:laoo
 // C++17 -> C90 backport by Valley Bell
 #include <stdlib.h>
+#include <string.h>	// for memcpy
 
 #include "../../stdtype.h"
 #include "../../_stdbool.h"
@@ -20,12 +21,18 @@ static UINT8 mikey_start( const DEV_GEN_CFG*, DEV_INFO* );
 static void mikey_stop( void* );
 static void mikey_reset( void* );
 static void mikey_update( void*, UINT32 samples, DEV_SMPL** outputs );
+static UINT32 mikey_get_state_size( void* );
+static UINT8 mikey_save_state( void*, UINT32 bufSize, void* buffer );
+static UINT8 mikey_load_state( void*, UINT32 dataSize, const void* data );
 
 static DEVDEF_RWFUNC devFunc[] =
 {
   {RWF_REGISTER | RWF_WRITE, DEVRW_A8D8, 0, (void*)mikey_write},
   {RWF_REGISTER | RWF_READ, DEVRW_A8D8, 0, (void*)mikey_read},
   {RWF_CHN_MUTE | RWF_WRITE, DEVRW_ALL, 0, (void*)mikey_set_mute_mask},
+  {RWF_STATE | RWF_READ, DEVRW_MEMSIZE, 0, (void*)mikey_get_state_size},
+  {RWF_STATE | RWF_READ, DEVRW_BLOCK, 0, (void*)mikey_save_state},
+  {RWF_STATE | RWF_WRITE, DEVRW_BLOCK, 0, (void*)mikey_load_state},
   {0x00, 0x00, 0, NULL}
 };
 
@@ -1060,3 +1067,30 @@ static void mikey_set_mute_mask( void* info, UINT32 mutes )
     mikey_pimpl_mute( &mikey->mMikey, i, ( mutes & ( 1 << i ) ) != 0 );
   }
 }
+
+static UINT32 mikey_get_state_size( void* info )
+{
+  return sizeof( mikey_t );
+}
+
+static UINT8 mikey_save_state( void* info, UINT32 bufSize, void* buffer )
+{
+  if ( bufSize < sizeof( mikey_t ) )
+    return 0xFF;
+  memcpy( buffer, info, sizeof( mikey_t ) );
+  return 0x00;
+}
+
+static UINT8 mikey_load_state( void* info, UINT32 dataSize, const void* data )
+{
+  mikey_t* mikey = (mikey_t*)info;
+  bool mutes[4];
+
+  if ( dataSize != sizeof( mikey_t ) )
+    return 0xFF;
+  // keep user settings
+  memcpy( mutes, mikey->mMikey.mMute, sizeof( mutes ) );
+  memcpy( mikey, data, sizeof( mikey_t ) );
+  memcpy( mikey->mMikey.mMute, mutes, sizeof( mutes ) );
+  return 0x00;
+}
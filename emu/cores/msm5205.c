@@ -93,6 +93,9 @@ static void msm5205_write(void *chip, UINT8 offset, UINT8 data);
 static void msm5205_set_mute_mask(void *chip, UINT32 MuteMask);
 static void msm5205_set_srchg_cb(void *chip, DEVCB_SRATE_CHG CallbackFunc, void *DataPtr);
 static void msm5205_set_log_cb(void *chip, DEVCB_LOG func, void *param);
+static UINT32 msm5205_get_state_size(void *chip);
+static UINT8 msm5205_save_state(void *chip, UINT32 bufSize, void *buffer);
+static UINT8 msm5205_load_state(void *chip, UINT32 dataSize, const void *data);
 
 // ========== Core Structure ==========
 typedef struct _msm5205_state {
@@ -134,6 +137,9 @@ static DEVDEF_RWFUNC devFunc[] = {
     {RWF_CLOCK | RWF_WRITE, DEVRW_VALUE, 0, msm5205_set_clock},
     {RWF_SRATE | RWF_READ, DEVRW_VALUE, 0, msm5205_get_rate},
     {RWF_CHN_MUTE | RWF_WRITE, DEVRW_ALL, 0, msm5205_set_mute_mask},
+    {RWF_STATE | RWF_READ, DEVRW_MEMSIZE, 0, msm5205_get_state_size},
+    {RWF_STATE | RWF_READ, DEVRW_BLOCK, 0, msm5205_save_state},
+    {RWF_STATE | RWF_WRITE, DEVRW_BLOCK, 0, msm5205_load_state},
     {0x00, 0x00, 0, NULL}
 };
 
@@ -429,3 +435,32 @@ static void msm5205_set_log_cb(void *chip, DEVCB_LOG func, void *param) {
     msm5205_state *info = (msm5205_state*)chip;
     dev_logger_set(&info->logger, info, func, param);
 }
+
+static UINT32 msm5205_get_state_size(void *chip) {
+    return sizeof(msm5205_state);
+}
+
+static UINT8 msm5205_save_state(void *chip, UINT32 bufSize, void *buffer) {
+    if (bufSize < sizeof(msm5205_state))
+        return 0xFF;
+    memcpy(buffer, chip, sizeof(msm5205_state));
+    return 0x00;
+}
+
+static UINT8 msm5205_load_state(void *chip, UINT32 dataSize, const void *data) {
+    msm5205_state *info = (msm5205_state*)chip;
+    msm5205_state old;
+
+    if (dataSize != sizeof(msm5205_state))
+        return 0xFF;
+    old = *info;
+    memcpy(info, data, sizeof(msm5205_state));
+    // keep callbacks and user settings
+    info->logger = old.logger;
+    info->Muted = old.Muted;
+    info->SmpRateFunc = old.SmpRateFunc;
+    info->SmpRateData = old.SmpRateData;
+    if (info->SmpRateFunc && msm5205_get_rate(info) != msm5205_get_rate(&old))
+        info->SmpRateFunc(info->SmpRateData, msm5205_get_rate(info));
+    return 0x00;
+}
@@ -108,10 +108,16 @@ static void device_update_msm5232(void* info, UINT32 samples, DEV_SMPL** outputs
 static void msm5232_write(void* info, UINT8 reg, UINT8 value);
 static void msm5232_set_mute_mask(void* info, UINT32 muteMask);
 static void msm5232_set_srchg_cb(void *info, DEVCB_SRATE_CHG CallbackFunc, void *DataPtr);
+static UINT32 msm5232_get_state_size(void* info);
+static UINT8 msm5232_save_state(void* info, UINT32 bufSize, void* buffer);
+static UINT8 msm5232_load_state(void* info, UINT32 dataSize, const void* data);
 
 static DEVDEF_RWFUNC devFunc[] = {
     {RWF_REGISTER | RWF_WRITE, DEVRW_A8D8, 0, msm5232_write},
     {RWF_CHN_MUTE | RWF_WRITE, DEVRW_ALL, 0, msm5232_set_mute_mask},
+    {RWF_STATE | RWF_READ, DEVRW_MEMSIZE, 0, msm5232_get_state_size},
+    {RWF_STATE | RWF_READ, DEVRW_BLOCK, 0, msm5232_save_state},
+    {RWF_STATE | RWF_WRITE, DEVRW_BLOCK, 0, msm5232_load_state},
     {0x00, 0x00, 0, NULL}
 };
 
@@ -697,3 +703,34 @@ static void msm5232_set_srchg_cb(void *info, DEVCB_SRATE_CHG CallbackFunc, void
 	chip->SmpRateFunc = CallbackFunc;
 	chip->SmpRateData = DataPtr;
 }
+
+static UINT32 msm5232_get_state_size(void* info)
+{
+	return sizeof(MSM5232_STATE);
+}
+
+static UINT8 msm5232_save_state(void* info, UINT32 bufSize, void* buffer)
+{
+	if (bufSize < sizeof(MSM5232_STATE))
+		return 0xFF;
+	memcpy(buffer, info, sizeof(MSM5232_STATE));
+	return 0x00;
+}
+
+static UINT8 msm5232_load_state(void* info, UINT32 dataSize, const void* data)
+{
+	MSM5232_STATE* chip = (MSM5232_STATE*)info;
+	MSM5232_STATE old;
+
+	if (dataSize != sizeof(MSM5232_STATE))
+		return 0xFF;
+	old = *chip;
+	memcpy(chip, data, sizeof(MSM5232_STATE));
+	// keep callbacks and user settings
+	chip->SmpRateFunc = old.SmpRateFunc;
+	chip->SmpRateData = old.SmpRateData;
+	memcpy(chip->Muted, old.Muted, sizeof(chip->Muted));
+	if (chip->SmpRateFunc != NULL && chip->sample_rate != old.sample_rate)
+		chip->SmpRateFunc(chip->SmpRateData, chip->sample_rate);
+	return 0x00;
+}
@@ -59,8 +59,12 @@ static UINT8 multipcm_r(void *info, UINT8 offset);
 
 static void multipcm_alloc_rom(void* info, UINT32 memsize);
 static void multipcm_write_rom(void *info, UINT32 offset, UINT32 length, const UINT8* data);
+static void multipcm_alias_rom(void *info, UINT32 memsize, const UINT8* data);
 
 static void multipcm_set_mute_mask(void *info, UINT32 MuteMask);
+static UINT32 multipcm_get_state_size(void *info);
+static UINT8 multipcm_save_state(void *info, UINT32 bufSize, void* buffer);
+static UINT8 multipcm_load_state(void *info, UINT32 dataSize, const void* data);
 
 
 static DEVDEF_RWFUNC devFunc[] =
@@ -70,7 +74,11 @@ static DEVDEF_RWFUNC devFunc[] =
 	{RWF_REGISTER | RWF_READ, DEVRW_A8D8, 0, multipcm_r},
 	{RWF_MEMORY | RWF_WRITE, DEVRW_BLOCK, 0, multipcm_write_rom},
 	{RWF_MEMORY | RWF_WRITE, DEVRW_MEMSIZE, 0, multipcm_alloc_rom},
+	{RWF_MEMORY | RWF_WRITE, DEVRW_BLOCK_ALIAS, 0, multipcm_alias_rom},
 	{RWF_CHN_MUTE | RWF_WRITE, DEVRW_ALL, 0, multipcm_set_mute_mask},
+	{RWF_STATE | RWF_READ, DEVRW_MEMSIZE, 0, multipcm_get_state_size},
+	{RWF_STATE | RWF_READ, DEVRW_BLOCK, 0, multipcm_save_state},
+	{RWF_STATE | RWF_WRITE, DEVRW_BLOCK, 0, multipcm_load_state},
 	{0x00, 0x00, 0, NULL}
 };
 static DEV_DEF devDef =
@@ -230,7 +238,8 @@ struct _MultiPCM
 	
 	UINT32 ROMMask;
 	UINT32 ROMSize;
-	UINT8 *ROM;
+	const UINT8 *ROM;	// points to ROMBuf or to external memory (see multipcm_alias_rom)
+	UINT8 *ROMBuf;
 };
 
 
@@ -593,6 +602,7 @@ static UINT8 device_start_multipcm(const DEV_GEN_CFG* cfg, DEV_INFO* retDevInf)
 		return 0xFF;
 	
 	ptChip->ROM = NULL;
+	ptChip->ROMBuf = NULL;
 	ptChip->ROMSize = 0x00;
 	ptChip->ROMMask = 0x00;
 	ptChip->rate = (float)cfg->clock / MULTIPCM_CLOCKDIV;
@@ -692,7 +702,7 @@ static void device_stop_multipcm(void *info)
 {
 	MultiPCM *ptChip = (MultiPCM *)info;
 	
-	free(ptChip->ROM);
+	free(ptChip->ROMBuf);
 	free(ptChip);
 	
 	return;
@@ -966,16 +976,33 @@ static void multipcm_w_quick(void *info, UINT8 offset, UINT8 data)
 
 /* MAME/M1 access functions */
 
+// make a private copy of an aliased ROM before modifying it
+static void multipcm_own_rom(MultiPCM *ptChip)
+{
+	if (ptChip->ROM == ptChip->ROMBuf)
+		return;
+	
+	ptChip->ROMBuf = (UINT8*)malloc(ptChip->ROMSize);
+	memcpy(ptChip->ROMBuf, ptChip->ROM, ptChip->ROMSize);
+	ptChip->ROM = ptChip->ROMBuf;
+	
+	return;
+}
+
 static void multipcm_alloc_rom(void* info, UINT32 memsize)
 {
 	MultiPCM *ptChip = (MultiPCM *)info;
 	
 	if (ptChip->ROMSize == memsize)
+	{
+		multipcm_own_rom(ptChip);
 		return;
+	}
 	
-	ptChip->ROM = (UINT8*)realloc(ptChip->ROM, memsize);
+	ptChip->ROMBuf = (UINT8*)realloc(ptChip->ROMBuf, memsize);
+	ptChip->ROM = ptChip->ROMBuf;
 	ptChip->ROMSize = memsize;
-	memset(ptChip->ROM, 0xFF, memsize);
+	memset(ptChip->ROMBuf, 0xFF, memsize);
 	
 	ptChip->ROMMask = pow2_mask(memsize);
 	
@@ -991,7 +1018,20 @@ static void multipcm_write_rom(void *info, UINT32 offset, UINT32 length, const U
 	if (offset + length > ptChip->ROMSize)
 		length = ptChip->ROMSize - offset;
 	
-	memcpy(ptChip->ROM + offset, data, length);
+	multipcm_own_rom(ptChip);
+	memcpy(ptChip->ROMBuf + offset, data, length);
+	
+	return;
+}
+
+static void multipcm_alias_rom(void *info, UINT32 memsize, const UINT8* data)
+{
+	MultiPCM *ptChip = (MultiPCM *)info;
+	
+	free(ptChip->ROMBuf);	ptChip->ROMBuf = NULL;
+	ptChip->ROM = data;
+	ptChip->ROMSize = memsize;
+	ptChip->ROMMask = pow2_mask(memsize);
 	
 	return;
 }
@@ -1007,3 +1047,36 @@ static void multipcm_set_mute_mask(void *info, UINT32 MuteMask)
 	
 	return;
 }
+
+static UINT32 multipcm_get_state_size(void *info)
+{
+	return sizeof(MultiPCM);
+}
+
+static UINT8 multipcm_save_state(void *info, UINT32 bufSize, void* buffer)
+{
+	if (bufSize < sizeof(MultiPCM))
+		return 0xFF;
+	memcpy(buffer, info, sizeof(MultiPCM));
+	return 0x00;
+}
+
+static UINT8 multipcm_load_state(void *info, UINT32 dataSize, const void* data)
+{
+	MultiPCM *ptChip = (MultiPCM *)info;
+	MultiPCM old;
+	UINT8 CurChn;
+	
+	if (dataSize != sizeof(MultiPCM))
+		return 0xFF;
+	old = *ptChip;
+	memcpy(ptChip, data, sizeof(MultiPCM));
+	// keep memory buffers and user settings
+	ptChip->ROMMask = old.ROMMask;
+	ptChip->ROMSize = old.ROMSize;
+	ptChip->ROM = old.ROM;
+	ptChip->ROMBuf = old.ROMBuf;
+	for (CurChn = 0; CurChn < 28; CurChn ++)
+		ptChip->slots[CurChn].muted = old.slots[CurChn].muted;
+	return 0x00;
+}
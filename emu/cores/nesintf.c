@@ -53,6 +53,9 @@ static void nes_set_mute_mask_mame(void* chip, UINT32 MuteMask);
 static void nes_set_pan_mame(void* chipptr, const INT16* PanVals);
 static void nes_set_mute_mask_nsfplay(void* chip, UINT32 MuteMask);
 static void nes_set_pan_nsfplay(void* chip, const INT16* PanVals);
+static UINT32 nes_get_state_size_nsfplay(void* chip);
+static UINT8 nes_save_state_nsfplay(void* chip, UINT32 bufSize, void* buffer);
+static UINT8 nes_load_state_nsfplay(void* chip, UINT32 dataSize, const void* data);
 
 
 #ifdef EC_NES_MAME
@@ -92,6 +95,9 @@ static DEVDEF_RWFUNC devFunc_NSFPlay[] =
 	{RWF_MEMORY | RWF_WRITE, DEVRW_BLOCK, 0, nes_write_ram},
 	{RWF_CHN_MUTE | RWF_WRITE, DEVRW_ALL, 0, nes_set_mute_mask_nsfplay},
 	{RWF_CHN_PAN | RWF_WRITE, DEVRW_ALL, 0, nes_set_pan_nsfplay},
+	{RWF_STATE | RWF_READ, DEVRW_MEMSIZE, 0, nes_get_state_size_nsfplay},
+	{RWF_STATE | RWF_READ, DEVRW_BLOCK, 0, nes_save_state_nsfplay},
+	{RWF_STATE | RWF_WRITE, DEVRW_BLOCK, 0, nes_load_state_nsfplay},
 	{0x00, 0x00, 0, NULL}
 };
 static DEV_DEF devDef_NSFPlay =
@@ -682,4 +688,62 @@ static void nes_set_pan_nsfplay(void* chip, const INT16* PanVals)
 	
 	return;
 }
+
+// state layout: APU, DMC, FDS (if present), RAM (0x8000 bytes)
+static UINT32 nes_get_state_size_nsfplay(void* chip)
+{
+	NESAPU_INF* info = (NESAPU_INF*)chip;
+	UINT32 size;
+	
+	size = NES_APU_np_GetStateSize(info->chip_apu) + NES_DMC_np_GetStateSize(info->chip_dmc);
+#ifdef EC_NES_NSFP_FDS
+	if (info->chip_fds != NULL)
+		size += NES_FDS_GetStateSize(info->chip_fds);
+#endif
+	return size + 0x8000;
+}
+
+static UINT8 nes_save_state_nsfplay(void* chip, UINT32 bufSize, void* buffer)
+{
+	NESAPU_INF* info = (NESAPU_INF*)chip;
+	UINT8* dst = (UINT8*)buffer;
+	
+	if (bufSize < nes_get_state_size_nsfplay(chip))
+		return 0xFF;
+	NES_APU_np_SaveState(info->chip_apu, dst);
+	dst += NES_APU_np_GetStateSize(info->chip_apu);
+	NES_DMC_np_SaveState(info->chip_dmc, dst);
+	dst += NES_DMC_np_GetStateSize(info->chip_dmc);
+#ifdef EC_NES_NSFP_FDS
+	if (info->chip_fds != NULL)
+	{
+		NES_FDS_SaveState(info->chip_fds, dst);
+		dst += NES_FDS_GetStateSize(info->chip_fds);
+	}
+#endif
+	memcpy(dst, info->memory, 0x8000);
+	return 0x00;
+}
+
+static UINT8 nes_load_state_nsfplay(void* chip, UINT32 dataSize, const void* data)
+{
+	NESAPU_INF* info = (NESAPU_INF*)chip;
+	const UINT8* src = (const UINT8*)data;
+	
+	if (dataSize != nes_get_state_size_nsfplay(chip))
+		return 0xFF;
+	NES_APU_np_LoadState(info->chip_apu, src);
+	src += NES_APU_np_GetStateSize(info->chip_apu);
+	NES_DMC_np_LoadState(info->chip_dmc, src);
+	src += NES_DMC_np_GetStateSize(info->chip_dmc);
+#ifdef EC_NES_NSFP_FDS
+	if (info->chip_fds != NULL)
+	{
+		NES_FDS_LoadState(info->chip_fds, src);
+		src += NES_FDS_GetStateSize(info->chip_fds);
+	}
+#endif
+	memcpy(info->memory, src, 0x8000);
+	return 0x00;
+}
 #endif
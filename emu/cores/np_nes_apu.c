@@ -7,6 +7,7 @@
 // (Note: Encoding is UTF-8)
 
 #include <stdlib.h>
+#include <string.h>	// for memcpy
 #include <stddef.h>	// for NULL
 
 #include "../../stdtype.h"
@@ -405,6 +406,30 @@ void NES_APU_np_SetStereoMix(void* chip, int trk, INT16 mixl, INT16 mixr)
 	apu->sm[1][trk] = mixr;
 }
 
+UINT32 NES_APU_np_GetStateSize(void* chip)
+{
+	return sizeof(NES_APU);
+}
+
+void NES_APU_np_SaveState(void* chip, void* buffer)
+{
+	memcpy(buffer, chip, sizeof(NES_APU));
+}
+
+void NES_APU_np_LoadState(void* chip, const void* data)
+{
+	NES_APU* apu = (NES_APU*)chip;
+	NES_APU old = *apu;
+
+	memcpy(apu, data, sizeof(NES_APU));
+	// keep options, mixing tables and user settings
+	memcpy(apu->option, old.option, sizeof(apu->option));
+	apu->mask = old.mask;
+	memcpy(apu->sm, old.sm, sizeof(apu->sm));
+	memcpy(apu->square_table, old.square_table, sizeof(apu->square_table));
+	apu->square_linear = old.square_linear;
+}
+
 bool NES_APU_np_Write(void* chip, UINT16 adr, UINT8 val)
 {
 	NES_APU* apu = (NES_APU*)chip;
@@ -13,5 +13,8 @@ void NES_APU_np_SetClock(void* chip, UINT32 clock);
 void NES_APU_np_SetOption(void* chip, int id, int b);
 void NES_APU_np_SetMask(void* chip, int m);
 void NES_APU_np_SetStereoMix(void* chip, int trk, INT16 mixl, INT16 mixr);
+UINT32 NES_APU_np_GetStateSize(void* chip);
+void NES_APU_np_SaveState(void* chip, void* buffer);
+void NES_APU_np_LoadState(void* chip, const void* data);
 
 #endif	// __NP_NES_APU_H__
@@ -5,7 +5,8 @@
 
 #include <stdlib.h>	// for rand
 #include <stdlib.h>
-#include <stddef.h>	// for NULL
+#include <string.h>	// for memcpy
+#include <stddef.h>	// for NULL, offsetof
 
 #include "../../stdtype.h"
 #include "../../_stdbool.h"
@@ -221,6 +222,43 @@ void NES_DMC_np_SetStereoMix(void* chip, int trk, INT16 mixl, INT16 mixr)
 	dmc->sm[1][trk] = mixr;
 }
 
+// The mixing table is not part of the state.
+#define DMC_STATE_OFS	offsetof(NES_DMC, option)
+
+UINT32 NES_DMC_np_GetStateSize(void* chip)
+{
+	return sizeof(NES_DMC) - DMC_STATE_OFS;
+}
+
+void NES_DMC_np_SaveState(void* chip, void* buffer)
+{
+	memcpy(buffer, (const UINT8*)chip + DMC_STATE_OFS, sizeof(NES_DMC) - DMC_STATE_OFS);
+}
+
+void NES_DMC_np_LoadState(void* chip, const void* data)
+{
+	NES_DMC* dmc = (NES_DMC*)chip;
+	int option[OPT_END];
+	int mask;
+	INT32 sm[2][3];
+	const UINT8* memory;
+	void* apu;
+
+	memcpy(option, dmc->option, sizeof(option));
+	mask = dmc->mask;
+	memcpy(sm, dmc->sm, sizeof(sm));
+	memory = dmc->memory;
+	apu = dmc->apu;
+
+	memcpy((UINT8*)dmc + DMC_STATE_OFS, data, sizeof(NES_DMC) - DMC_STATE_OFS);
+	// keep options, linked devices and user settings
+	memcpy(dmc->option, option, sizeof(dmc->option));
+	dmc->mask = mask;
+	memcpy(dmc->sm, sm, sizeof(dmc->sm));
+	dmc->memory = memory;
+	dmc->apu = apu;
+}
+
 static void FrameSequence(NES_DMC* dmc, int s)
 {
 	//DEBUG_OUT("FrameSequence: %d\n",s);
@@ -16,5 +16,8 @@ void NES_DMC_np_SetOption(void* chip, int id, int val);
 int NES_DMC_np_GetDamp(void* chip);
 void NES_DMC_np_SetMask(void* chip, int m);
 void NES_DMC_np_SetStereoMix(void* chip, int trk, INT16 mixl, INT16 mixr);
+UINT32 NES_DMC_np_GetStateSize(void* chip);
+void NES_DMC_np_SaveState(void* chip, void* buffer);
+void NES_DMC_np_LoadState(void* chip, const void* data);
 
 #endif	// __NP_NES_DMC_H__
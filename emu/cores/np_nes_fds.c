@@ -145,6 +145,30 @@ void NES_FDS_SetStereoMix(void* chip, int trk, INT16 mixl, INT16 mixr)
 	fds->sm[1] = mixr;
 }
 
+UINT32 NES_FDS_GetStateSize(void* chip)
+{
+	return sizeof(NES_FDS);
+}
+
+void NES_FDS_SaveState(void* chip, void* buffer)
+{
+	memcpy(buffer, chip, sizeof(NES_FDS));
+}
+
+void NES_FDS_LoadState(void* chip, const void* data)
+{
+	NES_FDS* fds = (NES_FDS*)chip;
+	NES_FDS old = *fds;
+
+	memcpy(fds, data, sizeof(NES_FDS));
+	// keep options, filter settings and user settings
+	fds->mask = old.mask;
+	memcpy(fds->sm, old.sm, sizeof(fds->sm));
+	memcpy(fds->option, old.option, sizeof(fds->option));
+	fds->rc_k = old.rc_k;
+	fds->rc_l = old.rc_l;
+}
+
 void NES_FDS_SetClock(void* chip, UINT32 c)
 {
 	NES_FDS* fds = (NES_FDS*)chip;
@@ -13,5 +13,8 @@ void NES_FDS_SetOption(void* chip, int id, int val);
 int NES_FDS_GetOption(void* chip, int id);
 void NES_FDS_SetMask(void* chip, int m);
 void NES_FDS_SetStereoMix(void* chip, int trk, INT16 mixl, INT16 mixr);
+UINT32 NES_FDS_GetStateSize(void* chip);
+void NES_FDS_SaveState(void* chip, void* buffer);
+void NES_FDS_LoadState(void* chip, const void* data);
 
 #endif	// __NP_NES_FDS_H__
@@ -12,6 +12,7 @@
 
 
 #include <stdlib.h>
+#include <string.h>	// for memcpy
 #include <stddef.h>	// for NULL
 #include <math.h>
 
@@ -44,6 +45,9 @@ static void okim6258_set_options(void *chip, UINT32 Options);
 static void okim6258_set_srchg_cb(void *chip, DEVCB_SRATE_CHG CallbackFunc, void* DataPtr);
 static void okim6258_set_mute_mask(void *chip, UINT32 MuteMask);
 static void okim6258_set_log_cb(void* chip, DEVCB_LOG func, void* param);
+static UINT32 okim6258_get_state_size(void *chip);
+static UINT8 okim6258_save_state(void *chip, UINT32 bufSize, void* buffer);
+static UINT8 okim6258_load_state(void *chip, UINT32 dataSize, const void* data);
 
 
 static DEVDEF_RWFUNC devFunc[] =
@@ -53,6 +57,9 @@ static DEVDEF_RWFUNC devFunc[] =
 	{RWF_CLOCK | RWF_WRITE, DEVRW_VALUE, 0, okim6258_set_clock},
 	{RWF_SRATE | RWF_READ, DEVRW_VALUE, 0, okim6258_get_vclk},
 	{RWF_CHN_MUTE | RWF_WRITE, DEVRW_ALL, 0, okim6258_set_mute_mask},
+	{RWF_STATE | RWF_READ, DEVRW_MEMSIZE, 0, okim6258_get_state_size},
+	{RWF_STATE | RWF_READ, DEVRW_BLOCK, 0, okim6258_save_state},
+	{RWF_STATE | RWF_WRITE, DEVRW_BLOCK, 0, okim6258_load_state},
 	{0x00, 0x00, 0, NULL}
 };
 static DEV_DEF devDef =
@@ -651,3 +658,37 @@ static void okim6258_set_log_cb(void* chip, DEVCB_LOG func, void* param)
 	dev_logger_set(&info->logger, info, func, param);
 	return;
 }
+
+static UINT32 okim6258_get_state_size(void *chip)
+{
+	return sizeof(okim6258_state);
+}
+
+static UINT8 okim6258_save_state(void *chip, UINT32 bufSize, void* buffer)
+{
+	if (bufSize < sizeof(okim6258_state))
+		return 0xFF;
+	memcpy(buffer, chip, sizeof(okim6258_state));
+	return 0x00;
+}
+
+static UINT8 okim6258_load_state(void *chip, UINT32 dataSize, const void* data)
+{
+	okim6258_state *info = (okim6258_state *)chip;
+	okim6258_state old;
+	
+	if (dataSize != sizeof(okim6258_state))
+		return 0xFF;
+	old = *info;
+	memcpy(info, data, sizeof(okim6258_state));
+	// keep callbacks and user settings
+	info->logger = old.logger;
+	info->output_12force = old.output_12force;
+	info->output_mask = old.output_mask;
+	info->Muted = old.Muted;
+	info->SmpRateFunc = old.SmpRateFunc;
+	info->SmpRateData = old.SmpRateData;
+	if (info->SmpRateFunc != NULL && get_vclk(info) != get_vclk(&old))
+		info->SmpRateFunc(info->SmpRateData, get_vclk(info));
+	return 0x00;
+}
@@ -72,6 +72,8 @@ static void okim6295_set_clock(void *chip, UINT32 clock);
 INLINE void okim6295_set_pin7(okim6295_state *info, UINT8 pin7);
 
 static void okim6295_update(void* info, UINT32 samples, DEV_SMPL** outputs);
+static void okim6295_update_mix(void* info, UINT32 samples, DEV_SMPL* mixBuf, INT32 volL, INT32 volR);
+static void okim6295_skip(void* info, UINT32 samples);
 static UINT8 device_start_okim6295(const DEV_GEN_CFG* cfg, DEV_INFO* retDevInf);
 static void device_stop_okim6295(void* chipptr);
 static void device_reset_okim6295(void *chip);
@@ -84,6 +86,9 @@ static void okim6295_write_rom(void* info, UINT32 offset, UINT32 length, const U
 static void okim6295_set_mute_mask(void *info, UINT32 MuteMask);
 static void okim6295_set_srchg_cb(void* chip, DEVCB_SRATE_CHG CallbackFunc, void* DataPtr);
 static void okim6295_set_log_cb(void* chip, DEVCB_LOG func, void* param);
+static UINT32 okim6295_get_state_size(void *chip);
+static UINT8 okim6295_save_state(void *chip, UINT32 bufSize, void* buffer);
+static UINT8 okim6295_load_state(void *chip, UINT32 dataSize, const void* data);
 
 
 static DEVDEF_RWFUNC devFunc[] =
@@ -95,6 +100,11 @@ static DEVDEF_RWFUNC devFunc[] =
 	{RWF_CLOCK | RWF_WRITE, DEVRW_VALUE, 0, okim6295_set_clock},
 	{RWF_SRATE | RWF_READ, DEVRW_VALUE, 0, okim6295_get_rate},
 	{RWF_CHN_MUTE | RWF_WRITE, DEVRW_ALL, 0, okim6295_set_mute_mask},
+	{RWF_STATE | RWF_READ, DEVRW_MEMSIZE, 0, okim6295_get_state_size},
+	{RWF_STATE | RWF_READ, DEVRW_BLOCK, 0, okim6295_save_state},
+	{RWF_STATE | RWF_WRITE, DEVRW_BLOCK, 0, okim6295_load_state},
+	{RWF_UPDATE_MIX | RWF_WRITE, DEVRW_VALUE, 0, okim6295_update_mix},
+	{RWF_SKIP | RWF_WRITE, DEVRW_VALUE, 0, okim6295_skip},
 	{0x00, 0x00, 0, NULL}
 };
 static DEV_DEF devDef =
@@ -279,7 +289,11 @@ static UINT8 memory_raw_read_byte(okim6295_state *chip, UINT32 offset)
 		return 0x00;
 }
 
-static void generate_adpcm(okim6295_state *chip, okim_voice *voice, DEV_SMPL *buffer, UINT32 samples)
+// mono output: adds to buffer[0], buffer[1], ...
+// stereo output (buffer == NULL): adds the sample multiplied by volL/volR to the interleaved mixBuf
+// no output (buffer == NULL, mixBuf == NULL): only decodes the ADPCM data
+static void generate_adpcm(okim6295_state *chip, okim_voice *voice, DEV_SMPL *buffer, UINT32 samples,
+							DEV_SMPL *mixBuf, INT32 volL, INT32 volR)
 {
 	UINT32 i;
 
@@ -295,7 +309,16 @@ static void generate_adpcm(okim6295_state *chip, okim_voice *voice, DEV_SMPL *bu
 
 		// output to the buffer, scaling by the volume
 		// signal in range -2048..2047, volume in range 2..32 => signal * volume / 2 in range -32768..32767
-		buffer[i] += oki_adpcm_clock(&voice->adpcm, nibble) * voice->volume / 2;
+		INT32 smpl = oki_adpcm_clock(&voice->adpcm, nibble) * voice->volume / 2;
+		if (buffer != NULL)
+		{
+			buffer[i] += smpl;
+		}
+		else if (mixBuf != NULL)
+		{
+			mixBuf[i * 2 + 0] += smpl * volL;
+			mixBuf[i * 2 + 1] += smpl * volR;
+		}
 
 		// next!
 		if (++voice->sample >= voice->count)
@@ -326,12 +349,37 @@ static void okim6295_update(void* info, UINT32 samples, DEV_SMPL** outputs)
 	{
 		// iterate over voices and accumulate sample data
 		for (i = 0; i < OKIM6295_VOICES; i++)
-			generate_adpcm(chip, &chip->voice[i], outputs[0], samples);
+			generate_adpcm(chip, &chip->voice[i], outputs[0], samples, NULL, 0, 0);
 	}
 
 	memcpy(outputs[1], outputs[0], samples * sizeof(*outputs[0]));
 }
 
+static void okim6295_update_mix(void* info, UINT32 samples, DEV_SMPL* mixBuf, INT32 volL, INT32 volR)
+{
+	okim6295_state *chip = (okim6295_state *)info;
+	int i;
+
+	if (chip->ROM == NULL)
+		return;
+
+	for (i = 0; i < OKIM6295_VOICES; i++)
+		generate_adpcm(chip, &chip->voice[i], NULL, samples, mixBuf, volL, volR);
+}
+
+static void okim6295_skip(void* info, UINT32 samples)
+{
+	okim6295_state *chip = (okim6295_state *)info;
+	int i;
+
+	if (chip->ROM == NULL)
+		return;
+
+	// the ADPCM decoder state depends on all previous nibbles, so they are still decoded
+	for (i = 0; i < OKIM6295_VOICES; i++)
+		generate_adpcm(chip, &chip->voice[i], NULL, samples, NULL, 0, 0);
+}
+
 
 
 /**********************************************************************************************
@@ -672,3 +720,39 @@ static void okim6295_set_log_cb(void* chip, DEVCB_LOG func, void* param)
 	dev_logger_set(&info->logger, info, func, param);
 	return;
 }
+
+static UINT32 okim6295_get_state_size(void *chip)
+{
+	return sizeof(okim6295_state);
+}
+
+static UINT8 okim6295_save_state(void *chip, UINT32 bufSize, void* buffer)
+{
+	if (bufSize < sizeof(okim6295_state))
+		return 0xFF;
+	memcpy(buffer, chip, sizeof(okim6295_state));
+	return 0x00;
+}
+
+static UINT8 okim6295_load_state(void *chip, UINT32 dataSize, const void* data)
+{
+	okim6295_state *info = (okim6295_state *)chip;
+	okim6295_state old;
+	UINT8 CurChn;
+	
+	if (dataSize != sizeof(okim6295_state))
+		return 0xFF;
+	old = *info;
+	memcpy(info, data, sizeof(okim6295_state));
+	// keep memory buffers, callbacks and user settings
+	info->logger = old.logger;
+	info->ROMSize = old.ROMSize;
+	info->ROM = old.ROM;
+	info->SmpRateFunc = old.SmpRateFunc;
+	info->SmpRateData = old.SmpRateData;
+	for (CurChn = 0; CurChn < OKIM6295_VOICES; CurChn ++)
+		info->voice[CurChn].Muted = old.voice[CurChn].Muted;
+	if (info->SmpRateFunc != NULL && okim6295_get_rate(info) != okim6295_get_rate(&old))
+		info->SmpRateFunc(info->SmpRateData, okim6295_get_rate(info));
+	return 0x00;
+}
@@ -40,6 +40,10 @@ static DEVDEF_RWFUNC devFunc3812_MAME[] =
 	{RWF_REGISTER | RWF_WRITE, DEVRW_A8D8, 0, ym3812_write},
 	{RWF_REGISTER | RWF_READ, DEVRW_A8D8, 0, ym3812_read},
 	{RWF_CHN_MUTE | RWF_WRITE, DEVRW_ALL, 0, opl_set_mute_mask},
+	{RWF_STATE | RWF_READ, DEVRW_MEMSIZE, 0, opl_get_state_size},
+	{RWF_STATE | RWF_READ, DEVRW_BLOCK, 0, opl_save_state},
+	{RWF_STATE | RWF_WRITE, DEVRW_BLOCK, 0, opl_load_state},
+	{RWF_SKIP | RWF_WRITE, DEVRW_VALUE, 0, opl_skip},
 	{0x00, 0x00, 0, NULL}
 };
 static DEV_DEF devDef3812_MAME =
@@ -67,6 +71,9 @@ static DEVDEF_RWFUNC devFunc3812_Emu[] =
 	{RWF_REGISTER | RWF_WRITE, DEVRW_A8D8, 0, adlib_OPL2_writeIO},
 	{RWF_REGISTER | RWF_READ, DEVRW_A8D8, 0, adlib_OPL2_reg_read},
 	{RWF_CHN_MUTE | RWF_WRITE, DEVRW_ALL, 0, adlib_OPL2_set_mute_mask},
+	{RWF_STATE | RWF_READ, DEVRW_MEMSIZE, 0, adlib_OPL2_get_state_size},
+	{RWF_STATE | RWF_READ, DEVRW_BLOCK, 0, adlib_OPL2_save_state},
+	{RWF_STATE | RWF_WRITE, DEVRW_BLOCK, 0, adlib_OPL2_load_state},
 	{0x00, 0x00, 0, NULL}
 };
 static DEV_DEF devDef3812_AdLibEmu =
@@ -174,6 +181,10 @@ static DEVDEF_RWFUNC devFunc3526_MAME[] =
 	{RWF_REGISTER | RWF_WRITE, DEVRW_A8D8, 0, ym3526_write},
 	{RWF_REGISTER | RWF_READ, DEVRW_A8D8, 0, ym3526_read},
 	{RWF_CHN_MUTE | RWF_WRITE, DEVRW_ALL, 0, opl_set_mute_mask},
+	{RWF_STATE | RWF_READ, DEVRW_MEMSIZE, 0, opl_get_state_size},
+	{RWF_STATE | RWF_READ, DEVRW_BLOCK, 0, opl_save_state},
+	{RWF_STATE | RWF_WRITE, DEVRW_BLOCK, 0, opl_load_state},
+	{RWF_SKIP | RWF_WRITE, DEVRW_VALUE, 0, opl_skip},
 	{0x00, 0x00, 0, NULL}
 };
 static DEV_DEF devDef3526_MAME =
@@ -223,6 +234,9 @@ static DEVDEF_RWFUNC devFunc8950_MAME[] =
 	{RWF_MEMORY | RWF_WRITE, DEVRW_BLOCK, 0, y8950_write_pcmrom},
 	{RWF_MEMORY | RWF_WRITE, DEVRW_MEMSIZE, 0, y8950_alloc_pcmrom},
 	{RWF_CHN_MUTE | RWF_WRITE, DEVRW_ALL, 0, opl_set_mute_mask},
+	{RWF_STATE | RWF_READ, DEVRW_MEMSIZE, 0, opl_get_state_size},
+	{RWF_STATE | RWF_READ, DEVRW_BLOCK, 0, opl_save_state},
+	{RWF_STATE | RWF_WRITE, DEVRW_BLOCK, 0, opl_load_state},
 	{0x00, 0x00, 0, NULL}
 };
 static DEV_DEF devDef8950_MAME =
@@ -86,6 +86,7 @@
 #include <stdlib.h>
 #include <math.h>
 #include <string.h>
+#include <stddef.h>	// for offsetof
 
 #include "../../stdtype.h"
 #include "emutypes.h"
@@ -106,6 +107,9 @@ static UINT8 device_start_pokey(const DEV_GEN_CFG *, DEV_INFO *);
 static void device_stop_pokey(void *);
 static void device_reset_pokey(void *);
 static void pokey_set_mute_mask(void *, UINT32 mutes);
+static UINT32 pokey_get_state_size(void *);
+static UINT8 pokey_save_state(void *, UINT32 bufSize, void* buffer);
+static UINT8 pokey_load_state(void *, UINT32 dataSize, const void* data);
 
 static void pokey_step_one_clock(pokey_device *);
 static void pokey_sid_w(pokey_device *d, UINT8 state);
@@ -121,6 +125,9 @@ static DEVDEF_RWFUNC devFunc[] =
 	{RWF_REGISTER | RWF_WRITE, DEVRW_A8D8, 0, pokey_write},
 	{RWF_REGISTER | RWF_READ, DEVRW_A8D8, 0, pokey_read},
 	{RWF_CHN_MUTE | RWF_WRITE, DEVRW_ALL, 0, pokey_set_mute_mask},
+	{RWF_STATE | RWF_READ, DEVRW_MEMSIZE, 0, pokey_get_state_size},
+	{RWF_STATE | RWF_READ, DEVRW_BLOCK, 0, pokey_save_state},
+	{RWF_STATE | RWF_WRITE, DEVRW_BLOCK, 0, pokey_load_state},
 	{0x00, 0x00, 0, NULL}
 };
 static DEV_DEF devDef =
@@ -492,6 +499,37 @@ static void pokey_set_mute_mask(void *info, UINT32 mask)
 	}
 }
 
+// The poly/volume tables and the output configuration that follow the
+// register state are constant after device_start, so they are not saved.
+#define POKEY_STATE_SIZE	offsetof(pokey_device, m_poly4)
+
+static UINT32 pokey_get_state_size(void *info)
+{
+	return POKEY_STATE_SIZE;
+}
+
+static UINT8 pokey_save_state(void *info, UINT32 bufSize, void* buffer)
+{
+	if (bufSize < POKEY_STATE_SIZE)
+		return 0xFF;
+	memcpy(buffer, info, POKEY_STATE_SIZE);
+	return 0x00;
+}
+
+static UINT8 pokey_load_state(void *info, UINT32 dataSize, const void* data)
+{
+	pokey_device *d = (pokey_device *)info;
+	UINT8 muted[POKEY_CHANNELS];
+
+	if (dataSize != POKEY_STATE_SIZE)
+		return 0xFF;
+	// keep user settings
+	memcpy(muted, d->m_muted, sizeof(muted));
+	memcpy(d, data, POKEY_STATE_SIZE);
+	memcpy(d->m_muted, muted, sizeof(muted));
+	return 0x00;
+}
+
 static void device_stop_pokey(void *info)
 {
 	pokey_device *d = (pokey_device *)info;
@@ -48,12 +48,18 @@ static void device_stop_pwm(void* info);
 static void pwm_chn_w(void* info, UINT8 Channel, UINT16 data);
 
 static void pwm_set_mute_mask(void *info, UINT32 MuteMask);
+static UINT32 pwm_get_state_size(void *info);
+static UINT8 pwm_save_state(void *info, UINT32 bufSize, void* buffer);
+static UINT8 pwm_load_state(void *info, UINT32 dataSize, const void* data);
 
 
 static DEVDEF_RWFUNC devFunc[] =
 {
 	{RWF_REGISTER | RWF_WRITE, DEVRW_A8D16, 0, pwm_chn_w},
 	{RWF_CHN_MUTE | RWF_WRITE, DEVRW_ALL, 0, pwm_set_mute_mask},
+	{RWF_STATE | RWF_READ, DEVRW_MEMSIZE, 0, pwm_get_state_size},
+	{RWF_STATE | RWF_READ, DEVRW_BLOCK, 0, pwm_save_state},
+	{RWF_STATE | RWF_WRITE, DEVRW_BLOCK, 0, pwm_load_state},
 	{0x00, 0x00, 0, NULL}
 };
 static DEV_DEF devDef =
@@ -299,3 +305,30 @@ static void pwm_set_mute_mask(void *info, UINT32 MuteMask)
 	
 	return;
 }
+
+static UINT32 pwm_get_state_size(void *info)
+{
+	return sizeof(pwm_chip);
+}
+
+static UINT8 pwm_save_state(void *info, UINT32 bufSize, void* buffer)
+{
+	if (bufSize < sizeof(pwm_chip))
+		return 0xFF;
+	memcpy(buffer, info, sizeof(pwm_chip));
+	return 0x00;
+}
+
+static UINT8 pwm_load_state(void *info, UINT32 dataSize, const void* data)
+{
+	pwm_chip* chip = (pwm_chip*)info;
+	pwm_chip old;
+	
+	if (dataSize != sizeof(pwm_chip))
+		return 0xFF;
+	old = *chip;
+	memcpy(chip, data, sizeof(pwm_chip));
+	// keep user settings
+	chip->PWM_Mute = old.PWM_Mute;
+	return 0x00;
+}
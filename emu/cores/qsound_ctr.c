@@ -149,6 +149,9 @@ static void qsoundc_alloc_rom(void* info, UINT32 memsize);
 static void qsoundc_write_rom(void* info, UINT32 offset, UINT32 length, const UINT8* data);
 static void qsoundc_set_options(void* info, UINT32 options);
 static void qsoundc_set_mute_mask(void* info, UINT32 MuteMask);
+static UINT32 qsoundc_get_state_size(void* info);
+static UINT8 qsoundc_save_state(void* info, UINT32 bufSize, void* buffer);
+static UINT8 qsoundc_load_state(void* info, UINT32 dataSize, const void* data);
 
 static DEVDEF_RWFUNC devFunc[] =
 {
@@ -158,6 +161,9 @@ static DEVDEF_RWFUNC devFunc[] =
 	{RWF_MEMORY | RWF_WRITE, DEVRW_BLOCK, 0, qsoundc_write_rom},
 	{RWF_MEMORY | RWF_WRITE, DEVRW_MEMSIZE, 0, qsoundc_alloc_rom},
 	{RWF_CHN_MUTE | RWF_WRITE, DEVRW_ALL, 0, qsoundc_set_mute_mask},
+	{RWF_STATE | RWF_READ, DEVRW_MEMSIZE, 0, qsoundc_get_state_size},
+	{RWF_STATE | RWF_READ, DEVRW_BLOCK, 0, qsoundc_save_state},
+	{RWF_STATE | RWF_WRITE, DEVRW_BLOCK, 0, qsoundc_load_state},
 	{0x00, 0x00, 0, NULL}
 };
 DEV_DEF devDef_QSound_ctr =
@@ -339,6 +345,37 @@ static void qsoundc_set_mute_mask(void* info, UINT32 MuteMask)
 	return;
 }
 
+static UINT32 qsoundc_get_state_size(void* info)
+{
+	return sizeof(struct qsound_chip);
+}
+
+static UINT8 qsoundc_save_state(void* info, UINT32 bufSize, void* buffer)
+{
+	if (bufSize < sizeof(struct qsound_chip))
+		return 0xFF;
+	memcpy(buffer, info, sizeof(struct qsound_chip));
+	return 0x00;
+}
+
+static UINT8 qsoundc_load_state(void* info, UINT32 dataSize, const void* data)
+{
+	struct qsound_chip* chip = (struct qsound_chip*)info;
+	struct qsound_chip old;
+	
+	if (dataSize != sizeof(struct qsound_chip))
+		return 0xFF;
+	old = *chip;
+	memcpy(chip, data, sizeof(struct qsound_chip));
+	// keep memory buffers and user settings
+	chip->romData = old.romData;
+	chip->romSize = old.romSize;
+	chip->romMask = old.romMask;
+	chip->muteMask = old.muteMask;
+	chip->opt_nowait = old.opt_nowait;
+	return 0x00;
+}
+
 // ============================================================================
 
 static const INT16 qsound_dry_mix_table[33] = {
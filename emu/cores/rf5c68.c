@@ -17,6 +17,7 @@
 
 
 static void rf5c68_update(void *info, UINT32 samples, DEV_SMPL **outputs);
+static void rf5c68_skip(void *info, UINT32 samples);
 
 static UINT8 device_start_rf5c68_mame(const DEV_GEN_CFG* cfg, DEV_INFO* retDevInf);
 static void* device_start_rf5c68(UINT32 clock);
@@ -32,6 +33,9 @@ static void rf5c68_mem_w(void *info, UINT16 offset, UINT8 data);
 static void rf5c68_write_ram(void *info, UINT32 offset, UINT32 length, const UINT8* data);
 
 static void rf5c68_set_mute_mask(void *info, UINT32 MuteMask);
+static UINT32 rf5c68_get_state_size(void *info);
+static UINT8 rf5c68_save_state(void *info, UINT32 bufSize, void* buffer);
+static UINT8 rf5c68_load_state(void *info, UINT32 dataSize, const void* data);
 
 
 static DEVDEF_RWFUNC devFunc[] =
@@ -42,6 +46,10 @@ static DEVDEF_RWFUNC devFunc[] =
 	{RWF_MEMORY | RWF_READ, DEVRW_A16D8, 0, rf5c68_mem_r},
 	{RWF_MEMORY | RWF_WRITE, DEVRW_BLOCK, 0, rf5c68_write_ram},
 	{RWF_CHN_MUTE | RWF_WRITE, DEVRW_ALL, 0, rf5c68_set_mute_mask},
+	{RWF_STATE | RWF_READ, DEVRW_MEMSIZE, 0, rf5c68_get_state_size},
+	{RWF_STATE | RWF_READ, DEVRW_BLOCK, 0, rf5c68_save_state},
+	{RWF_STATE | RWF_WRITE, DEVRW_BLOCK, 0, rf5c68_load_state},
+	{RWF_SKIP | RWF_WRITE, DEVRW_VALUE, 0, rf5c68_skip},
 	{0x00, 0x00, 0, NULL}
 };
 DEV_DEF devDef_RF5C68_MAME =
@@ -190,6 +198,46 @@ static void rf5c68_update(void *info, UINT32 samples, DEV_SMPL **outputs)
 #endif
 }
 
+//-------------------------------------------------
+//    RF5C68 skip (advance the sample addresses
+//    without generating output)
+//-------------------------------------------------
+
+static void rf5c68_skip(void *info, UINT32 samples)
+{
+	rf5c68_state *chip = (rf5c68_state *)info;
+	UINT8 i;
+	UINT32 j;
+
+	if (chip->data == NULL || !chip->enable)
+		return;
+
+	for (i = 0; i < NUM_CHANNELS; i++)
+	{
+		pcm_channel *chan = &chip->chan[i];
+
+		if (chan->enable && ! chan->Muted)
+		{
+			for (j = 0; j < samples; j++)
+			{
+				if(chip->sample_end_cb)
+				{
+					if(((chan->addr >> 11) & 0xfff) == 0xfff)
+						chip->sample_end_cb(chip->sample_cb_param,(chan->addr >> 11)/0x2000);
+				}
+
+				if (chip->data[(chan->addr >> 11) & 0xffff] == 0xff)
+				{
+					chan->addr = chan->loopst << 11;
+					if (chip->data[(chan->addr >> 11) & 0xffff] == 0xff)
+						break;
+				}
+				chan->addr += chan->step;
+			}
+		}
+	}
+}
+
 
 static UINT8 device_start_rf5c68_mame(const DEV_GEN_CFG* cfg, DEV_INFO* retDevInf)
 {
@@ -402,3 +450,43 @@ static void rf5c68_set_mute_mask(void *info, UINT32 MuteMask)
 	
 	return;
 }
+
+static UINT32 rf5c68_get_state_size(void *info)
+{
+	rf5c68_state *chip = (rf5c68_state *)info;
+	return sizeof(rf5c68_state) + chip->datasize;
+}
+
+static UINT8 rf5c68_save_state(void *info, UINT32 bufSize, void* buffer)
+{
+	rf5c68_state *chip = (rf5c68_state *)info;
+	UINT8* dst = (UINT8*)buffer;
+	
+	if (bufSize < sizeof(rf5c68_state) + chip->datasize)
+		return 0xFF;
+	memcpy(dst, chip, sizeof(rf5c68_state));
+	memcpy(dst + sizeof(rf5c68_state), chip->data, chip->datasize);
+	return 0x00;
+}
+
+static UINT8 rf5c68_load_state(void *info, UINT32 dataSize, const void* data)
+{
+	rf5c68_state *chip = (rf5c68_state *)info;
+	const UINT8* src = (const UINT8*)data;
+	rf5c68_state old;
+	UINT8 CurChn;
+	
+	if (dataSize != sizeof(rf5c68_state) + chip->datasize)
+		return 0xFF;
+	old = *chip;
+	memcpy(chip, src, sizeof(rf5c68_state));
+	// keep memory buffer, callbacks and user settings
+	chip->datasize = old.datasize;
+	chip->data = old.data;
+	chip->sample_end_cb = old.sample_end_cb;
+	chip->sample_cb_param = old.sample_cb_param;
+	for (CurChn = 0; CurChn < NUM_CHANNELS; CurChn ++)
+		chip->chan[CurChn].Muted = old.chan[CurChn].Muted;
+	memcpy(chip->data, src + sizeof(rf5c68_state), chip->datasize);
+	return 0x00;
+}
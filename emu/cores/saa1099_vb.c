@@ -40,6 +40,9 @@ static void* saa1099v_create(UINT32 clock, UINT32 sampleRate);
 static void saa1099v_destroy(void* info);
 static void saa1099v_reset(void* info);
 static void saa1099v_set_mute_mask(void* info, UINT32 MuteMask);
+static UINT32 saa1099v_get_state_size(void* info);
+static UINT8 saa1099v_save_state(void* info, UINT32 bufSize, void* buffer);
+static UINT8 saa1099v_load_state(void* info, UINT32 dataSize, const void* data);
 
 static void saa1099v_write(void* info, UINT8 offset, UINT8 data);
 static void saa_write_addr(void* info, UINT8 data);
@@ -57,6 +60,9 @@ static DEVDEF_RWFUNC devFunc[] =
 {
 	{RWF_REGISTER | RWF_WRITE, DEVRW_A8D8, 0, saa1099v_write},
 	{RWF_CHN_MUTE | RWF_WRITE, DEVRW_ALL, 0, saa1099v_set_mute_mask},
+	{RWF_STATE | RWF_READ, DEVRW_MEMSIZE, 0, saa1099v_get_state_size},
+	{RWF_STATE | RWF_READ, DEVRW_BLOCK, 0, saa1099v_save_state},
+	{RWF_STATE | RWF_WRITE, DEVRW_BLOCK, 0, saa1099v_load_state},
 	{0x00, 0x00, 0, NULL}
 };
 DEV_DEF devDef_SAA1099_VB =
@@ -284,6 +290,35 @@ static void saa1099v_set_mute_mask(void* info, UINT32 MuteMask)
 	return;
 }
 
+static UINT32 saa1099v_get_state_size(void* info)
+{
+	return sizeof(SAA_CHIP);
+}
+
+static UINT8 saa1099v_save_state(void* info, UINT32 bufSize, void* buffer)
+{
+	if (bufSize < sizeof(SAA_CHIP))
+		return 0xFF;
+	memcpy(buffer, info, sizeof(SAA_CHIP));
+	return 0x00;
+}
+
+static UINT8 saa1099v_load_state(void* info, UINT32 dataSize, const void* data)
+{
+	SAA_CHIP* saa = (SAA_CHIP*)info;
+	SAA_CHIP old;
+	UINT8 curChn;
+	
+	if (dataSize != sizeof(SAA_CHIP))
+		return 0xFF;
+	old = *saa;
+	memcpy(saa, data, sizeof(SAA_CHIP));
+	// keep user settings
+	for (curChn = 0; curChn < 6; curChn ++)
+		saa->channels[curChn].muted = old.channels[curChn].muted;
+	return 0x00;
+}
+
 static void saa1099v_write(void* info, UINT8 offset, UINT8 data)
 {
 	if (offset & 0x01)
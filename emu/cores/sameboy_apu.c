@@ -28,6 +28,9 @@ static void device_reset_gb_sameboy(void *chip);
 static void gb_sameboy_set_mute_mask(void *chip, UINT32 MuteMask);
 static UINT32 gb_sameboy_get_mute_mask(void *chip);
 static void gb_sameboy_set_options(void *chip, UINT32 Flags);
+static UINT32 gb_sameboy_get_state_size(void *chip);
+static UINT8 gb_sameboy_save_state(void *chip, UINT32 bufSize, void* buffer);
+static UINT8 gb_sameboy_load_state(void *chip, UINT32 dataSize, const void* data);
 
 static void gb_sameboy_w(void *chip, UINT8 offset, UINT8 data);
 static UINT8 gb_sameboy_r(void *chip, UINT8 offset);
@@ -38,6 +41,9 @@ static DEVDEF_RWFUNC devFunc[] =
 	{RWF_REGISTER | RWF_WRITE, DEVRW_A8D8, 0, gb_sameboy_w},
 	{RWF_REGISTER | RWF_READ, DEVRW_A8D8, 0, gb_sameboy_r},
 	{RWF_CHN_MUTE | RWF_WRITE, DEVRW_ALL, 0, gb_sameboy_set_mute_mask},
+	{RWF_STATE | RWF_READ, DEVRW_MEMSIZE, 0, gb_sameboy_get_state_size},
+	{RWF_STATE | RWF_READ, DEVRW_BLOCK, 0, gb_sameboy_save_state},
+	{RWF_STATE | RWF_WRITE, DEVRW_BLOCK, 0, gb_sameboy_load_state},
 	{0x00, 0x00, 0, NULL}
 };
 DEV_DEF devDef_GB_SameBoy =
@@ -198,6 +204,13 @@ static void update_sample(GB_gameboy_t *gb, GB_channel_t index, int8_t value, un
     }
 }
 
+// replacement for rand(), so that the output depends only on the state of the chip
+static unsigned GB_random(GB_gameboy_t *gb)
+{
+    gb->rng_state = gb->rng_state * 1103515245 + 12345;
+    return (gb->rng_state >> 16) & 0x7FFF;
+}
+
 static double smooth(double x)
 {
     return 3*x*x - 2*x*x*x;
@@ -241,7 +254,7 @@ static signed interference(GB_gameboy_t *gb)
         ret /= 4;
     }
     
-    ret += rand() % (MAX_CH_AMP / 12);
+    ret += GB_random(gb) % (MAX_CH_AMP / 12);
     
     return ret;
 }
@@ -800,7 +813,7 @@ restart:;
         while (cycles_left) {
             cycles_left--;
             if (--gb->apu.wave_channel.bugged_read_countdown == 0) {
-                uint16_t address_bus = rand() & 0x7FFF;
+                uint16_t address_bus = GB_random(gb) & 0x7FFF;
                 gb->apu.wave_channel.current_sample_byte =
                     gb->io_registers[GB_IO_WAV_START + (address_bus & 0xF)];
                 if (gb->apu.is_active[GB_WAVE]) {
@@ -936,7 +949,7 @@ restart:;
                 cycles_left -= gb->apu.wave_channel.sample_countdown + 1;
                 gb->apu.wave_channel.sample_countdown = gb->apu.wave_channel.sample_length ^ 0x7FF;
                 if (cycles_left) {
-                    uint16_t address_bus = rand() & 0x7FFF;
+                    uint16_t address_bus = GB_random(gb) & 0x7FFF;
                     gb->apu.wave_channel.current_sample_byte =
                     gb->io_registers[GB_IO_WAV_START + (address_bus & 0xF)];
                 }
@@ -1899,7 +1912,7 @@ static void GB_apu_write(GB_gameboy_t *gb, uint8_t reg, uint8_t value)
                 if (gb->apu.is_active[GB_WAVE] && gb->noWaveCorrupt) {
                     // Todo: I assume this happens on pre-CGB models; test this with an audible test
                     if (gb->apu.wave_channel.sample_countdown == 0 && gb->model <= GB_MODEL_CGB_E) {
-                        uint16_t pc = rand() & 0x7FFF;  // simulate PC position using random
+                        uint16_t pc = GB_random(gb) & 0x7FFF;  // simulate PC position using random
                         gb->apu.wave_channel.current_sample_byte = gb->io_registers[GB_IO_WAV_START + (pc & 0xF)];
                     }
                     else if (gb->apu.wave_channel.wave_form_just_read && gb->model <= GB_MODEL_CGB_C) {
@@ -2326,6 +2339,7 @@ static void device_reset_gb_sameboy(void *chip)
 	gb->apu_output.sample_fraction = 0;
 	GB_set_sample_rate(gb, gb->smpl_rate);
 	RC_RESET(&gb->cycleCntr);
+	gb->rng_state = 1;
 
 	gb_sameboy_set_mute_mask(gb, muteMask);
 
@@ -2367,6 +2381,35 @@ static void gb_sameboy_set_options(void *chip, UINT32 Flags)
 	return;
 }
 
+static UINT32 gb_sameboy_get_state_size(void *chip)
+{
+	return sizeof(GB_gameboy_t);
+}
+
+static UINT8 gb_sameboy_save_state(void *chip, UINT32 bufSize, void* buffer)
+{
+	if (bufSize < sizeof(GB_gameboy_t))
+		return 0xFF;
+	memcpy(buffer, chip, sizeof(GB_gameboy_t));
+	return 0x00;
+}
+
+static UINT8 gb_sameboy_load_state(void *chip, UINT32 dataSize, const void* data)
+{
+	GB_gameboy_t *gb = (GB_gameboy_t *)chip;
+	GB_gameboy_t old;
+	
+	if (dataSize != sizeof(GB_gameboy_t))
+		return 0xFF;
+	old = *gb;
+	memcpy(gb, data, sizeof(GB_gameboy_t));
+	// keep user settings
+	memcpy(gb->apu_output.channel_muted, old.apu_output.channel_muted, sizeof(gb->apu_output.channel_muted));
+	gb->noWaveCorrupt = old.noWaveCorrupt;
+	gb->legacyMode = old.legacyMode;
+	return 0x00;
+}
+
 static void gb_sameboy_w(void *chip, UINT8 offset, UINT8 data)
 {
 	GB_gameboy_t *gb = (GB_gameboy_t *)chip;
@@ -260,6 +260,7 @@ struct GB_gameboy_s {
 
 	bool noWaveCorrupt;
 	bool legacyMode;
+	uint32_t rng_state;	// for simulating random bus values
 };
 typedef struct GB_gameboy_s GB_gameboy_t;
 
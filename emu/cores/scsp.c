@@ -65,6 +65,9 @@ static void scsp_write_ram(void* info, UINT32 offset, UINT32 length, const UINT8
 static void scsp_set_mute_mask(void* info, UINT32 MuteMask);
 static void scsp_set_options(void* info, UINT32 Flags);
 static void scsp_set_log_cb(void* info, DEVCB_LOG func, void* param);
+static UINT32 scsp_get_state_size(void* info);
+static UINT8 scsp_save_state(void* info, UINT32 bufSize, void* buffer);
+static UINT8 scsp_load_state(void* info, UINT32 dataSize, const void* data);
 
 
 static DEVDEF_RWFUNC devFunc[] =
@@ -75,6 +78,9 @@ static DEVDEF_RWFUNC devFunc[] =
 	{RWF_REGISTER | RWF_READ, DEVRW_A16D16, 0, SCSP_r16},
 	{RWF_MEMORY | RWF_WRITE, DEVRW_BLOCK, 0, scsp_write_ram},
 	{RWF_CHN_MUTE | RWF_WRITE, DEVRW_ALL, 0, scsp_set_mute_mask},
+	{RWF_STATE | RWF_READ, DEVRW_MEMSIZE, 0, scsp_get_state_size},
+	{RWF_STATE | RWF_READ, DEVRW_BLOCK, 0, scsp_save_state},
+	{RWF_STATE | RWF_WRITE, DEVRW_BLOCK, 0, scsp_load_state},
 	{0x00, 0x00, 0, NULL}
 };
 static DEV_DEF devDef =
@@ -342,6 +348,7 @@ struct _scsp_state
 	SCSPDSP DSP;
 
 	INT16 *RBUFDST;   //this points to where the sample will be stored in the RingBuf
+	UINT32 noise_rng; // state of the noise generator (SSCTL 1)
 
 	//LFO
 	//int PLFO_TRI[256], PLFO_SQR[256], PLFO_SAW[256], PLFO_NOI[256];
@@ -942,6 +949,13 @@ static UINT16 SCSP_r16(void* info, UINT16 addr)
 
 #define REVSIGN(v) ((~v)+1)
 
+// replacement for rand(), so that the output depends only on the state of the chip
+INLINE UINT16 SCSP_Noise(scsp_state *scsp)
+{
+	scsp->noise_rng = scsp->noise_rng * 1103515245 + 12345;
+	return (UINT16)(scsp->noise_rng >> 16);
+}
+
 INLINE INT32 SCSP_UpdateSlot(scsp_state *scsp, SCSP_SLOT *slot)
 {
 	INT32 sample;
@@ -1011,7 +1025,7 @@ INLINE INT32 SCSP_UpdateSlot(scsp_state *scsp, SCSP_SLOT *slot)
 		}
 	}
 	else if (SSCTL(slot) == 1)  // Internally generated data (Noise)
-		sample = (INT16)(rand() & 0xffff); // Unknown algorithm
+		sample = (INT16)SCSP_Noise(scsp); // Unknown algorithm
 	else //if (SSCTL(slot) >= 2)  // Internally generated data (All 0)
 		sample = 0;
 
@@ -1265,6 +1279,7 @@ static void device_reset_scsp(void* info)
 	SCSPDSP_Init(&scsp->DSP);
 	scsp->DSP.SCSPRAM_LENGTH = scsp->SCSPRAM_LENGTH / 2;
 	scsp->DSP.SCSPRAM = (UINT16*)scsp->SCSPRAM;
+	scsp->noise_rng = 1;
 	
 	return;
 }
@@ -1365,3 +1380,53 @@ static void scsp_set_log_cb(void* info, DEVCB_LOG func, void* param)
 	dev_logger_set(&scsp->logger, scsp, func, param);
 	return;
 }
+
+static UINT32 scsp_get_state_size(void* info)
+{
+	scsp_state *scsp = (scsp_state *)info;
+	return sizeof(scsp_state) + scsp->SCSPRAM_LENGTH;
+}
+
+static UINT8 scsp_save_state(void* info, UINT32 bufSize, void* buffer)
+{
+	scsp_state *scsp = (scsp_state *)info;
+	UINT8* dst = (UINT8*)buffer;
+	
+	if (bufSize < sizeof(scsp_state) + scsp->SCSPRAM_LENGTH)
+		return 0xFF;
+	memcpy(dst, scsp, sizeof(scsp_state));
+	memcpy(dst + sizeof(scsp_state), scsp->SCSPRAM, scsp->SCSPRAM_LENGTH);
+	return 0x00;
+}
+
+static UINT8 scsp_load_state(void* info, UINT32 dataSize, const void* data)
+{
+	scsp_state *scsp = (scsp_state *)info;
+	const UINT8* src = (const UINT8*)data;
+	DEV_LOGGER logger;
+	UINT8* ram;
+	UINT32 ramLen;
+	UINT8 muted[32];
+	UINT8 CurChn;
+	
+	if (dataSize != sizeof(scsp_state) + scsp->SCSPRAM_LENGTH)
+		return 0xFF;
+	// The chip structure is too large for a copy on the stack,
+	// so only the fields that are kept are saved.
+	logger = scsp->logger;
+	ram = scsp->SCSPRAM;
+	ramLen = scsp->SCSPRAM_LENGTH;
+	for (CurChn = 0; CurChn < 32; CurChn ++)
+		muted[CurChn] = scsp->Slots[CurChn].Muted;
+	memcpy(scsp, src, sizeof(scsp_state));
+	// keep memory buffers, callbacks and user settings
+	scsp->logger = logger;
+	scsp->SCSPRAM = ram;
+	scsp->SCSPRAM_LENGTH = ramLen;
+	scsp->DSP.SCSPRAM = (UINT16*)ram;
+	scsp->DSP.SCSPRAM_LENGTH = ramLen / 2;
+	for (CurChn = 0; CurChn < 32; CurChn ++)
+		scsp->Slots[CurChn].Muted = muted[CurChn];
+	memcpy(scsp->SCSPRAM, src + sizeof(scsp_state), scsp->SCSPRAM_LENGTH);
+	return 0x00;
+}
@@ -17,6 +17,8 @@
 #include "segapcm.h"
 
 static void SEGAPCM_update(void *chip, UINT32 samples, DEV_SMPL **outputs);
+static void SEGAPCM_update_mix(void *chip, UINT32 samples, DEV_SMPL *mixBuf, INT32 volL, INT32 volR);
+static void SEGAPCM_skip(void *chip, UINT32 samples);
 
 static UINT8 device_start_segapcm(const SEGAPCM_CFG* cfg, DEV_INFO* retDevInf);
 static void device_stop_segapcm(void *chip);
@@ -26,11 +28,15 @@ static void sega_pcm_w(void *chip, UINT16 offset, UINT8 data);
 static UINT8 sega_pcm_r(void *chip, UINT16 offset);
 static void sega_pcm_alloc_rom(void *chip, UINT32 memsize);
 static void sega_pcm_write_rom(void *chip, UINT32 offset, UINT32 length, const UINT8* data);
+static void sega_pcm_alias_rom(void *chip, UINT32 memsize, const UINT8* data);
 #ifdef _DEBUG
 static void sega_pcm_fwrite_romusage(void *chip);
 #endif
 
 static void segapcm_set_mute_mask(void *chip, UINT32 MuteMask);
+static UINT32 segapcm_get_state_size(void *chip);
+static UINT8 segapcm_save_state(void *chip, UINT32 bufSize, void* buffer);
+static UINT8 segapcm_load_state(void *chip, UINT32 dataSize, const void* data);
 
 
 static DEVDEF_RWFUNC devFunc[] =
@@ -39,7 +45,13 @@ static DEVDEF_RWFUNC devFunc[] =
 	{RWF_REGISTER | RWF_READ, DEVRW_A16D8, 0, sega_pcm_r},
 	{RWF_MEMORY | RWF_WRITE, DEVRW_BLOCK, 0, sega_pcm_write_rom},
 	{RWF_MEMORY | RWF_WRITE, DEVRW_MEMSIZE, 0, sega_pcm_alloc_rom},
+	{RWF_MEMORY | RWF_WRITE, DEVRW_BLOCK_ALIAS, 0, sega_pcm_alias_rom},
 	{RWF_CHN_MUTE | RWF_WRITE, DEVRW_ALL, 0, segapcm_set_mute_mask},
+	{RWF_STATE | RWF_READ, DEVRW_MEMSIZE, 0, segapcm_get_state_size},
+	{RWF_STATE | RWF_READ, DEVRW_BLOCK, 0, segapcm_save_state},
+	{RWF_STATE | RWF_WRITE, DEVRW_BLOCK, 0, segapcm_load_state},
+	{RWF_SKIP | RWF_WRITE, DEVRW_VALUE, 0, SEGAPCM_skip},
+	{RWF_UPDATE_MIX | RWF_WRITE, DEVRW_VALUE, 0, SEGAPCM_update_mix},
 	{0x00, 0x00, 0, NULL}
 };
 static DEV_DEF devDef =
@@ -103,7 +115,8 @@ struct _segapcm_state
 	UINT8  *ram;
 	UINT8 low[16];
 	UINT32 ROMSize;
-	UINT8 *rom;
+	const UINT8 *rom;	// points to romBuf or to external memory (see sega_pcm_alias_rom)
+	UINT8 *romBuf;
 #ifdef _DEBUG
 	UINT8 *romusage;
 #endif
@@ -113,14 +126,11 @@ struct _segapcm_state
 	UINT8 Muted[16];
 };
 
-static void SEGAPCM_update(void *chip, UINT32 samples, DEV_SMPL **outputs)
+/* adds all channels to bufL[i * step] and bufR[i * step], with an additional gain of volL/volR */
+static void SEGAPCM_render(segapcm_state *spcm, UINT32 samples, DEV_SMPL *bufL, DEV_SMPL *bufR, UINT32 step, INT32 volL, INT32 volR)
 {
-	segapcm_state *spcm = (segapcm_state *)chip;
 	int ch;
 
-	/* clear the buffers */
-	memset(outputs[0], 0, samples*sizeof(DEV_SMPL));
-	memset(outputs[1], 0, samples*sizeof(DEV_SMPL));
 	if (spcm->rom == NULL)
 		return;
 
@@ -157,6 +167,9 @@ static void SEGAPCM_update(void *chip, UINT32 samples, DEV_SMPL **outputs)
 			UINT32 addr = (regs[0x85] << 16) | (regs[0x84] << 8) | spcm->low[ch];
 			UINT32 loop = (regs[0x05] << 16) | (regs[0x04] << 8);
 			UINT8 end = regs[6] + 1;
+			// fixed Bitmask for volume multiplication, thanks to ctr -Valley Bell
+			INT32 gainL = (regs[2] & 0x7F) * volL;
+			INT32 gainR = (regs[3] & 0x7F) * volR;
 			UINT32 i;
 
 			/* loop over samples on this channel */
@@ -184,9 +197,8 @@ static void SEGAPCM_update(void *chip, UINT32 samples, DEV_SMPL **outputs)
 #endif
 
 				/* apply panning and advance */
-				// fixed Bitmask for volume multiplication, thanks to ctr -Valley Bell
-				outputs[0][i] += v * (regs[2] & 0x7F);
-				outputs[1][i] += v * (regs[3] & 0x7F);
+				bufL[i * step] += v * gainL;
+				bufR[i * step] += v * gainR;
 				addr = (addr + regs[7]) & 0xffffff;
 			}
 
@@ -198,6 +210,60 @@ static void SEGAPCM_update(void *chip, UINT32 samples, DEV_SMPL **outputs)
 	}
 }
 
+static void SEGAPCM_update(void *chip, UINT32 samples, DEV_SMPL **outputs)
+{
+	/* clear the buffers */
+	memset(outputs[0], 0, samples*sizeof(DEV_SMPL));
+	memset(outputs[1], 0, samples*sizeof(DEV_SMPL));
+	SEGAPCM_render((segapcm_state *)chip, samples, outputs[0], outputs[1], 1, 1, 1);
+}
+
+static void SEGAPCM_update_mix(void *chip, UINT32 samples, DEV_SMPL *mixBuf, INT32 volL, INT32 volR)
+{
+	SEGAPCM_render((segapcm_state *)chip, samples, &mixBuf[0], &mixBuf[1], 2, volL, volR);
+}
+
+/* same as SEGAPCM_update, but only advances the sample addresses */
+static void SEGAPCM_skip(void *chip, UINT32 samples)
+{
+	segapcm_state *spcm = (segapcm_state *)chip;
+	int ch;
+
+	if (spcm->rom == NULL)
+		return;
+
+	for (ch = 0; ch < 16; ch++)
+	{
+		UINT8 *regs = spcm->ram+8*ch;
+
+		if (!(regs[0x86] & 1) && ! spcm->Muted[ch])
+		{
+			UINT32 addr = (regs[0x85] << 16) | (regs[0x84] << 8) | spcm->low[ch];
+			UINT32 loop = (regs[0x05] << 16) | (regs[0x04] << 8);
+			UINT8 end = regs[6] + 1;
+			UINT32 i;
+
+			for (i = 0; i < samples; i++)
+			{
+				if ((addr >> 16) == end)
+				{
+					if (regs[0x86] & 2)
+					{
+						regs[0x86] |= 1;
+						break;
+					}
+					else addr = loop;
+				}
+				addr = (addr + regs[7]) & 0xffffff;
+			}
+
+			regs[0x84] = addr >> 8;
+			regs[0x85] = addr >> 16;
+			spcm->low[ch] = regs[0x86] & 1 ? 0 : addr;
+		}
+	}
+}
+
 static UINT8 device_start_segapcm(const SEGAPCM_CFG* cfg, DEV_INFO* retDevInf)
 {
 	static const UINT32 STD_ROM_SIZE = 0x80000;
@@ -212,6 +278,7 @@ static UINT8 device_start_segapcm(const SEGAPCM_CFG* cfg, DEV_INFO* retDevInf)
 	
 	spcm->ROMSize = 0;
 	spcm->rom = NULL;
+	spcm->romBuf = NULL;
 #ifdef _DEBUG
 	spcm->romusage = NULL;
 #endif
@@ -230,7 +297,8 @@ static UINT8 device_start_segapcm(const SEGAPCM_CFG* cfg, DEV_INFO* retDevInf)
 void device_stop_segapcm(void *chip)
 {
 	segapcm_state *spcm = (segapcm_state *)chip;
-	free(spcm->rom);	spcm->rom = NULL;
+	free(spcm->romBuf);	spcm->romBuf = NULL;
+	spcm->rom = NULL;
 #ifdef _DEBUG
 	//sega_pcm_fwrite_romusage(spcm);
 	free(spcm->romusage);
@@ -264,24 +332,41 @@ static UINT8 sega_pcm_r(void *chip, UINT16 offset)
 	return spcm->ram[offset & 0x07ff];
 }
 
+// make a private copy of an aliased ROM before modifying it
+static void sega_pcm_own_rom(segapcm_state *spcm)
+{
+	if (spcm->rom == spcm->romBuf)
+		return;
+	
+	spcm->romBuf = (UINT8*)malloc(spcm->ROMSize);
+	memcpy(spcm->romBuf, spcm->rom, spcm->ROMSize);
+	spcm->rom = spcm->romBuf;
+	
+	return;
+}
+
 static void sega_pcm_alloc_rom(void *chip, UINT32 memsize)
 {
 	segapcm_state *spcm = (segapcm_state *)chip;
 	
 	if (spcm->ROMSize == memsize)
+	{
+		sega_pcm_own_rom(spcm);
 		return;
+	}
 	
-	spcm->rom = (UINT8*)realloc(spcm->rom, memsize);
+	spcm->romBuf = (UINT8*)realloc(spcm->romBuf, memsize);
+	spcm->rom = spcm->romBuf;
 #ifndef _DEBUG
-	//memset(spcm->rom, 0xFF, memsize);
+	//memset(spcm->romBuf, 0xFF, memsize);
 	// filling 0xFF would actually be more true to the hardware,
 	// (unused ROMs have all FFs)
 	// but 0x80 is the effective 'null' byte
-	memset(spcm->rom, 0x80, memsize);
+	memset(spcm->romBuf, 0x80, memsize);
 #else
 	spcm->romusage = (UINT8*)realloc(spcm->romusage, memsize);
 	// filling with FF makes it easier to find bugs in a .wav-log
-	memset(spcm->rom, 0xFF, memsize);
+	memset(spcm->romBuf, 0xFF, memsize);
 	memset(spcm->romusage, 0x02, memsize);
 #endif
 	spcm->ROMSize = memsize;
@@ -300,7 +385,8 @@ static void sega_pcm_write_rom(void *chip, UINT32 offset, UINT32 length, const U
 	if (offset + length > spcm->ROMSize)
 		length = spcm->ROMSize - offset;
 	
-	memcpy(&spcm->rom[offset], data, length);
+	sega_pcm_own_rom(spcm);
+	memcpy(&spcm->romBuf[offset], data, length);
 #ifdef _DEBUG
 	memset(&spcm->romusage[offset], 0x00, length);
 #endif
@@ -308,6 +394,23 @@ static void sega_pcm_write_rom(void *chip, UINT32 offset, UINT32 length, const U
 	return;
 }
 
+static void sega_pcm_alias_rom(void *chip, UINT32 memsize, const UINT8* data)
+{
+	segapcm_state *spcm = (segapcm_state *)chip;
+	
+	free(spcm->romBuf);	spcm->romBuf = NULL;
+	spcm->rom = data;
+	spcm->ROMSize = memsize;
+#ifdef _DEBUG
+	spcm->romusage = (UINT8*)realloc(spcm->romusage, memsize);
+	memset(spcm->romusage, 0x00, memsize);
+#endif
+	
+	spcm->bankmask = spcm->intf_mask & (0x1fffff >> spcm->bankshift);
+	
+	return;
+}
+
 
 #ifdef _DEBUG
 static void sega_pcm_fwrite_romusage(void *chip)
@@ -336,3 +439,44 @@ static void segapcm_set_mute_mask(void *chip, UINT32 MuteMask)
 	
 	return;
 }
+
+static UINT32 segapcm_get_state_size(void *chip)
+{
+	return sizeof(segapcm_state) + 0x800;
+}
+
+static UINT8 segapcm_save_state(void *chip, UINT32 bufSize, void* buffer)
+{
+	segapcm_state *spcm = (segapcm_state *)chip;
+	UINT8* dst = (UINT8*)buffer;
+	
+	if (bufSize < sizeof(segapcm_state) + 0x800)
+		return 0xFF;
+	memcpy(dst, spcm, sizeof(segapcm_state));
+	memcpy(dst + sizeof(segapcm_state), spcm->ram, 0x800);
+	return 0x00;
+}
+
+static UINT8 segapcm_load_state(void *chip, UINT32 dataSize, const void* data)
+{
+	segapcm_state *spcm = (segapcm_state *)chip;
+	const UINT8* src = (const UINT8*)data;
+	segapcm_state old;
+	
+	if (dataSize != sizeof(segapcm_state) + 0x800)
+		return 0xFF;
+	old = *spcm;
+	memcpy(spcm, src, sizeof(segapcm_state));
+	// keep memory buffers and user settings
+	spcm->ram = old.ram;
+	spcm->ROMSize = old.ROMSize;
+	spcm->rom = old.rom;
+	spcm->romBuf = old.romBuf;
+#ifdef _DEBUG
+	spcm->romusage = old.romusage;
+#endif
+	spcm->bankmask = old.bankmask;
+	memcpy(spcm->Muted, old.Muted, sizeof(spcm->Muted));
+	memcpy(spcm->ram, src + sizeof(segapcm_state), 0x800);
+	return 0x00;
+}
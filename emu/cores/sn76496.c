@@ -154,12 +154,16 @@ static void sn76496_write_reg(void *chip, UINT8 offset, UINT8 data);
 static void sn76496_stereo_w(void *chip, UINT8 offset, UINT8 data);
 
 static void sn76496_update(void *param, UINT32 samples, DEV_SMPL** outputs);
+static void sn76496_update_mix(void *param, UINT32 samples, DEV_SMPL* mixBuf, INT32 volL, INT32 volR);
 static void sn76496_connect_t6w28(void *noisechip, void *tonechip);
 static void sn76496_shutdown(void *chip);
 static void sn76496_reset(void *chip);
 static void sn76496_freq_limiter(void* chip, UINT32 sample_rate);
 static void sn76496_set_mute_mask(void *chip, UINT32 MuteMask);
 static void sn76496_set_log_cb(void *info, DEVCB_LOG func, void* param);
+static UINT32 sn76496_get_state_size(void *chip);
+static UINT8 sn76496_save_state(void *chip, UINT32 bufSize, void* buffer);
+static UINT8 sn76496_load_state(void *chip, UINT32 dataSize, const void* data);
 
 static UINT8 device_start_sn76496_mame(const SN76496_CFG* cfg, DEV_INFO* retDevInf);
 static void sn76496_w_mame(void *chip, UINT8 reg, UINT8 data);
@@ -169,6 +173,10 @@ static DEVDEF_RWFUNC devFunc[] =
 {
 	{RWF_REGISTER | RWF_WRITE, DEVRW_A8D8, 0, sn76496_w_mame},
 	{RWF_CHN_MUTE | RWF_WRITE, DEVRW_ALL, 0, sn76496_set_mute_mask},
+	{RWF_STATE | RWF_READ, DEVRW_MEMSIZE, 0, sn76496_get_state_size},
+	{RWF_STATE | RWF_READ, DEVRW_BLOCK, 0, sn76496_save_state},
+	{RWF_STATE | RWF_WRITE, DEVRW_BLOCK, 0, sn76496_load_state},
+	{RWF_UPDATE_MIX | RWF_WRITE, DEVRW_VALUE, 0, sn76496_update_mix},
 	{0x00, 0x00, 0, NULL}
 };
 DEV_DEF devDef_SN76496_MAME =
@@ -333,14 +341,12 @@ INLINE void countdown_cycles(sn76496_state *R)
 	}
 }
 
-static void sn76496_update(void* param, UINT32 samples, DEV_SMPL** outputs)
+// writes to outputs or, if it is NULL, adds the output multiplied by volL/volR to the interleaved mixBuf
+INLINE void sn76496_render(sn76496_state *R, UINT32 samples, DEV_SMPL** outputs, DEV_SMPL* mixBuf, INT32 volL, INT32 volR)
 {
 	UINT32 i;
 	UINT32 j;
-	sn76496_state *R = (sn76496_state *)param;
 	sn76496_state *R2;
-	DEV_SMPL* lbuffer = outputs[0];
-	DEV_SMPL* rbuffer = outputs[1];
 	DEV_SMPL out = 0;
 	DEV_SMPL out2 = 0;
 	INT32 vol[4];
@@ -363,8 +369,11 @@ static void sn76496_update(void* param, UINT32 samples, DEV_SMPL** outputs)
 			out = 1;
 		if (! out)
 		{
-			memset(lbuffer, 0x00, sizeof(DEV_SMPL) * samples);
-			memset(rbuffer, 0x00, sizeof(DEV_SMPL) * samples);
+			if (outputs != NULL)
+			{
+				memset(outputs[0], 0x00, sizeof(DEV_SMPL) * samples);
+				memset(outputs[1], 0x00, sizeof(DEV_SMPL) * samples);
+			}
 			return;
 		}
 	}
@@ -543,11 +552,31 @@ static void sn76496_update(void* param, UINT32 samples, DEV_SMPL** outputs)
 		
 		if(R->negate) { out = -out; out2 = -out2; }
 
-		lbuffer[j] = out >> 1;	// >>1 to make up for bipolar output
-		rbuffer[j] = out2 >> 1;
+		out >>= 1;	// >>1 to make up for bipolar output
+		out2 >>= 1;
+		if (outputs != NULL)
+		{
+			outputs[0][j] = out;
+			outputs[1][j] = out2;
+		}
+		else
+		{
+			mixBuf[j * 2 + 0] += out * volL;
+			mixBuf[j * 2 + 1] += out2 * volR;
+		}
 	}
 }
 
+static void sn76496_update(void* param, UINT32 samples, DEV_SMPL** outputs)
+{
+	sn76496_render((sn76496_state *)param, samples, outputs, NULL, 0, 0);
+}
+
+static void sn76496_update_mix(void* param, UINT32 samples, DEV_SMPL* mixBuf, INT32 volL, INT32 volR)
+{
+	sn76496_render((sn76496_state *)param, samples, NULL, mixBuf, volL, volR);
+}
+
 static void sn76496_connect_t6w28(void *noisechip, void *tonechip)
 {
 	sn76496_state *Rnoise = (sn76496_state *)noisechip;
@@ -632,6 +661,35 @@ static void sn76496_set_log_cb(void *chip, DEVCB_LOG func, void* param)
 	return;
 }
 
+static UINT32 sn76496_get_state_size(void *chip)
+{
+	return sizeof(sn76496_state);
+}
+
+static UINT8 sn76496_save_state(void *chip, UINT32 bufSize, void* buffer)
+{
+	if (bufSize < sizeof(sn76496_state))
+		return 0xFF;
+	memcpy(buffer, chip, sizeof(sn76496_state));
+	return 0x00;
+}
+
+static UINT8 sn76496_load_state(void *chip, UINT32 dataSize, const void* data)
+{
+	sn76496_state *R = (sn76496_state*)chip;
+	sn76496_state old;
+	
+	if (dataSize != sizeof(sn76496_state))
+		return 0xFF;
+	old = *R;
+	memcpy(R, data, sizeof(sn76496_state));
+	// keep callbacks, links and user settings
+	R->logger = old.logger;
+	R->NgpChip2 = old.NgpChip2;
+	memcpy(R->MuteMsk, old.MuteMsk, sizeof(R->MuteMsk));
+	return 0x00;
+}
+
 static UINT8 device_start_sn76496_mame(const SN76496_CFG* cfg, DEV_INFO* retDevInf)
 {
 	sn76496_state* chip;
@@ -159,6 +159,9 @@ static void upd7759_write_rom(void* info, UINT32 offset, UINT32 length, const UI
 
 static void upd7759_set_mute_mask(void *info, UINT32 MuteMask);
 static void upd7759_set_log_cb(void* info, DEVCB_LOG func, void* param);
+static UINT32 upd7759_get_state_size(void *info);
+static UINT8 upd7759_save_state(void *info, UINT32 bufSize, void* buffer);
+static UINT8 upd7759_load_state(void *info, UINT32 dataSize, const void* data);
 
 
 static DEVDEF_RWFUNC devFunc[] =
@@ -168,6 +171,9 @@ static DEVDEF_RWFUNC devFunc[] =
 	{RWF_MEMORY | RWF_WRITE, DEVRW_BLOCK, 0, upd7759_write_rom},
 	{RWF_MEMORY | RWF_WRITE, DEVRW_MEMSIZE, 0, upd7759_alloc_rom},
 	{RWF_CHN_MUTE | RWF_WRITE, DEVRW_ALL, 0, upd7759_set_mute_mask},
+	{RWF_STATE | RWF_READ, DEVRW_MEMSIZE, 0, upd7759_get_state_size},
+	{RWF_STATE | RWF_READ, DEVRW_BLOCK, 0, upd7759_save_state},
+	{RWF_STATE | RWF_WRITE, DEVRW_BLOCK, 0, upd7759_load_state},
 	{0x00, 0x00, 0, NULL}
 };
 static DEV_DEF devDef =
@@ -997,3 +1003,36 @@ static void upd7759_set_log_cb(void* info, DEVCB_LOG func, void* param)
 	dev_logger_set(&chip->logger, chip, func, param);
 	return;
 }
+
+static UINT32 upd7759_get_state_size(void *info)
+{
+	return sizeof(upd7759_state);
+}
+
+static UINT8 upd7759_save_state(void *info, UINT32 bufSize, void* buffer)
+{
+	if (bufSize < sizeof(upd7759_state))
+		return 0xFF;
+	memcpy(buffer, info, sizeof(upd7759_state));
+	return 0x00;
+}
+
+static UINT8 upd7759_load_state(void *info, UINT32 dataSize, const void* data)
+{
+	upd7759_state *chip = (upd7759_state *)info;
+	upd7759_state old;
+	
+	if (dataSize != sizeof(upd7759_state))
+		return 0xFF;
+	old = *chip;
+	memcpy(chip, data, sizeof(upd7759_state));
+	// keep memory buffers, callbacks and user settings
+	chip->logger = old.logger;
+	chip->drqcallback = old.drqcallback;
+	chip->romsize = old.romsize;
+	chip->rombase = old.rombase;
+	chip->rommask = old.rommask;
+	chip->Muted = old.Muted;
+	chip->rom = chip->rombase + chip->romoffset;
+	return 0x00;
+}
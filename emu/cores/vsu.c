@@ -37,6 +37,9 @@ static void VSU_Write(void* info, UINT16 A, UINT8 V);
 
 static void vsu_set_options(void* info, UINT32 Options);
 static void vsu_set_mute_mask(void *info, UINT32 MuteMask);
+static UINT32 vsu_get_state_size(void *info);
+static UINT8 vsu_save_state(void *info, UINT32 bufSize, void* buffer);
+static UINT8 vsu_load_state(void *info, UINT32 dataSize, const void* data);
 
 
 static DEVDEF_RWFUNC devFunc[] =
@@ -44,6 +47,9 @@ static DEVDEF_RWFUNC devFunc[] =
 	{RWF_REGISTER | RWF_WRITE, DEVRW_A16D8, 0, VSU_Write},
 	//{RWF_REGISTER | RWF_READ, DEVRW_A16D8, 0, NULL},	// read returns 0 in vbjin/Mednafen
 	{RWF_CHN_MUTE | RWF_WRITE, DEVRW_ALL, 0, vsu_set_mute_mask},
+	{RWF_STATE | RWF_READ, DEVRW_MEMSIZE, 0, vsu_get_state_size},
+	{RWF_STATE | RWF_READ, DEVRW_BLOCK, 0, vsu_save_state},
+	{RWF_STATE | RWF_WRITE, DEVRW_BLOCK, 0, vsu_load_state},
 	{0x00, 0x00, 0, NULL}
 };
 static DEV_DEF devDef =
@@ -682,3 +688,31 @@ static void vsu_set_mute_mask(void* info, UINT32 MuteMask)
 	
 	return;
 }
+
+static UINT32 vsu_get_state_size(void* info)
+{
+	return sizeof(vsu_state);
+}
+
+static UINT8 vsu_save_state(void* info, UINT32 bufSize, void* buffer)
+{
+	if (bufSize < sizeof(vsu_state))
+		return 0xFF;
+	memcpy(buffer, info, sizeof(vsu_state));
+	return 0x00;
+}
+
+static UINT8 vsu_load_state(void* info, UINT32 dataSize, const void* data)
+{
+	vsu_state* chip = (vsu_state*)info;
+	vsu_state old;
+	
+	if (dataSize != sizeof(vsu_state))
+		return 0xFF;
+	old = *chip;
+	memcpy(chip, data, sizeof(vsu_state));
+	// keep user settings
+	chip->allowWavWriteWhileOn = old.allowWavWriteWhileOn;
+	memcpy(chip->Muted, old.Muted, sizeof(chip->Muted));
+	return 0x00;
+}
@@ -26,6 +26,9 @@ static void ws_write_ram_byte(void* info, UINT16 offset, UINT8 value);
 static UINT8 ws_read_ram_byte(void* info, UINT16 offset);
 static void ws_set_mute_mask(void* info, UINT32 MuteMask);
 static UINT32 ws_get_mute_mask(void* info);
+static UINT32 ws_get_state_size(void* info);
+static UINT8 ws_save_state(void* info, UINT32 bufSize, void* buffer);
+static UINT8 ws_load_state(void* info, UINT32 dataSize, const void* data);
 
 
 static DEVDEF_RWFUNC devFunc[] =
@@ -36,6 +39,9 @@ static DEVDEF_RWFUNC devFunc[] =
 	{RWF_MEMORY | RWF_READ, DEVRW_A16D8, 0, ws_read_ram_byte},
 	//{RWF_MEMORY | RWF_WRITE, DEVRW_BLOCK, 0, ws_write_ram_block},
 	{RWF_CHN_MUTE | RWF_WRITE, DEVRW_ALL, 0, ws_set_mute_mask},
+	{RWF_STATE | RWF_READ, DEVRW_MEMSIZE, 0, ws_get_state_size},
+	{RWF_STATE | RWF_READ, DEVRW_BLOCK, 0, ws_save_state},
+	{RWF_STATE | RWF_WRITE, DEVRW_BLOCK, 0, ws_load_state},
 	{0x00, 0x00, 0, NULL}
 };
 static DEV_DEF devDef =
@@ -562,3 +568,39 @@ static UINT32 ws_get_mute_mask(void* info)
 	
 	return muteMask;
 }
+
+static UINT32 ws_get_state_size(void* info)
+{
+	return sizeof(wsa_state) + 0x4000;
+}
+
+static UINT8 ws_save_state(void* info, UINT32 bufSize, void* buffer)
+{
+	wsa_state* chip = (wsa_state*)info;
+	UINT8* dst = (UINT8*)buffer;
+	
+	if (bufSize < sizeof(wsa_state) + 0x4000)
+		return 0xFF;
+	memcpy(dst, chip, sizeof(wsa_state));
+	memcpy(dst + sizeof(wsa_state), chip->ws_internalRam, 0x4000);
+	return 0x00;
+}
+
+static UINT8 ws_load_state(void* info, UINT32 dataSize, const void* data)
+{
+	wsa_state* chip = (wsa_state*)info;
+	const UINT8* src = (const UINT8*)data;
+	wsa_state old;
+	UINT8 CurChn;
+	
+	if (dataSize != sizeof(wsa_state) + 0x4000)
+		return 0xFF;
+	old = *chip;
+	memcpy(chip, src, sizeof(wsa_state));
+	// keep memory buffers and user settings
+	chip->ws_internalRam = old.ws_internalRam;
+	for (CurChn = 0; CurChn < 4; CurChn ++)
+		chip->ws_audio[CurChn].Muted = old.ws_audio[CurChn].Muted;
+	memcpy(chip->ws_internalRam, src + sizeof(wsa_state), 0x4000);
+	return 0x00;
+}
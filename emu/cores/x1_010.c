@@ -79,6 +79,9 @@ static void x1_010_write_rom(void *chip, UINT32 offset, UINT32 length, const UIN
 
 static void x1_010_set_mute_mask(void *chip, UINT32 MuteMask);
 static void x1_010_set_log_cb(void *chip, DEVCB_LOG func, void* param);
+static UINT32 x1_010_get_state_size(void *chip);
+static UINT8 x1_010_save_state(void *chip, UINT32 bufSize, void* buffer);
+static UINT8 x1_010_load_state(void *chip, UINT32 dataSize, const void* data);
 
 
 static DEVDEF_RWFUNC devFunc[] =
@@ -88,6 +91,9 @@ static DEVDEF_RWFUNC devFunc[] =
 	{RWF_MEMORY | RWF_WRITE, DEVRW_BLOCK, 0, x1_010_write_rom},
 	{RWF_MEMORY | RWF_WRITE, DEVRW_MEMSIZE, 0, x1_010_alloc_rom},
 	{RWF_CHN_MUTE | RWF_WRITE, DEVRW_ALL, 0, x1_010_set_mute_mask},
+	{RWF_STATE | RWF_READ, DEVRW_MEMSIZE, 0, x1_010_get_state_size},
+	{RWF_STATE | RWF_READ, DEVRW_BLOCK, 0, x1_010_save_state},
+	{RWF_STATE | RWF_WRITE, DEVRW_BLOCK, 0, x1_010_load_state},
 	{0x00, 0x00, 0, NULL}
 };
 static DEV_DEF devDef =
@@ -417,3 +423,33 @@ static void x1_010_set_log_cb(void *chip, DEVCB_LOG func, void* param)
 	dev_logger_set(&info->logger, info, func, param);
 	return;
 }
+
+static UINT32 x1_010_get_state_size(void *chip)
+{
+	return sizeof(x1_010_state);
+}
+
+static UINT8 x1_010_save_state(void *chip, UINT32 bufSize, void* buffer)
+{
+	if (bufSize < sizeof(x1_010_state))
+		return 0xFF;
+	memcpy(buffer, chip, sizeof(x1_010_state));
+	return 0x00;
+}
+
+static UINT8 x1_010_load_state(void *chip, UINT32 dataSize, const void* data)
+{
+	x1_010_state *info = (x1_010_state *)chip;
+	x1_010_state old;
+	
+	if (dataSize != sizeof(x1_010_state))
+		return 0xFF;
+	old = *info;
+	memcpy(info, data, sizeof(x1_010_state));
+	// keep memory buffers and user settings
+	info->logger = old.logger;
+	info->ROMSize = old.ROMSize;
+	info->rom = old.rom;
+	memcpy(info->Muted, old.Muted, sizeof(info->Muted));
+	return 0x00;
+}
@@ -53,7 +53,12 @@ static void * ym2151_init(UINT32 clock, UINT32 rate);
 static void ym2151_shutdown(void *_chip);
 static void ym2151_reset_chip(void *_chip);
 static void ym2151_update_one(void *chip, UINT32 length, DEV_SMPL **buffers);
+static void ym2151_update_mix(void *chip, UINT32 length, DEV_SMPL *mixBuf, INT32 volL, INT32 volR);
+static void ym2151_skip(void *chip, UINT32 length);
 static void ym2151_set_mute_mask(void *chip, UINT32 MuteMask);
+static UINT32 ym2151_get_state_size(void *chip);
+static UINT8 ym2151_save_state(void *chip, UINT32 bufSize, void* buffer);
+static UINT8 ym2151_load_state(void *chip, UINT32 dataSize, const void* data);
 static UINT8 device_start_ym2151(const DEV_GEN_CFG* cfg, DEV_INFO* retDevInf);
 static UINT8 ym2151_r(void *chip, UINT8 offset);
 static void ym2151_w(void *chip, UINT8 offset, UINT8 data);
@@ -65,6 +70,11 @@ static DEVDEF_RWFUNC devFunc_MAME[] =
 	{RWF_REGISTER | RWF_READ, DEVRW_A8D8, 0, ym2151_r},
 	{RWF_REGISTER | RWF_QUICKWRITE, DEVRW_A8D8, 0, ym2151_write_reg},
 	{RWF_CHN_MUTE | RWF_WRITE, DEVRW_ALL, 0, ym2151_set_mute_mask},
+	{RWF_STATE | RWF_READ, DEVRW_MEMSIZE, 0, ym2151_get_state_size},
+	{RWF_STATE | RWF_READ, DEVRW_BLOCK, 0, ym2151_save_state},
+	{RWF_STATE | RWF_WRITE, DEVRW_BLOCK, 0, ym2151_load_state},
+	{RWF_UPDATE_MIX | RWF_WRITE, DEVRW_VALUE, 0, ym2151_update_mix},
+	{RWF_SKIP | RWF_WRITE, DEVRW_VALUE, 0, ym2151_skip},
 	{0x00, 0x00, 0, NULL}
 };
 DEV_DEF devDef_YM2151_MAME =
@@ -1951,13 +1961,16 @@ INLINE void advance(YM2151 *PSG)
 
 /*  Generate samples for one of the YM2151's
 *
-*   'chip' is a pointer to the virtual YM2151
+*   'PSG' is a pointer to the virtual YM2151
 *   '**buffers' is table of pointers to the buffers: left and right
 *   'length' is the number of samples that should be generated
+*   When 'buffers' is NULL, the samples are multiplied by volL/volR and added to
+*   the interleaved stereo buffer 'mixBuf' instead.
+*   When both are NULL, only envelopes, LFO, phases and timers are advanced.
+*   (The operator feedback isn't updated then, like for muted channels.)
 */
-static void ym2151_update_one(void *chip, UINT32 length, DEV_SMPL **buffers)
+static void ym2151_render(YM2151 *PSG, UINT32 length, DEV_SMPL **buffers, DEV_SMPL *mixBuf, INT32 volL, INT32 volR)
 {
-	YM2151 *PSG = (YM2151 *)chip;
 	UINT32 i;
 	int ch;
 	DEV_SMPL outl, outr;
@@ -1966,21 +1979,32 @@ static void ym2151_update_one(void *chip, UINT32 length, DEV_SMPL **buffers)
 	{
 		advance_eg(PSG);
 
-		for(ch=0; ch<8; ch++)
-			PSG->chanout[ch] = 0;
-
-		for(ch=0; ch<7; ch++)
-			chan_calc(PSG, ch);
-		chan7_calc(PSG);
-
-		outl = 0;
-		outr = 0;
-		for(ch=0; ch<8; ch++) {
-			outl += PSG->chanout[ch] & PSG->pan[2*ch];
-			outr += PSG->chanout[ch] & PSG->pan[2*ch+1];
+		if (buffers != NULL || mixBuf != NULL)
+		{
+			for(ch=0; ch<8; ch++)
+				PSG->chanout[ch] = 0;
+
+			for(ch=0; ch<7; ch++)
+				chan_calc(PSG, ch);
+			chan7_calc(PSG);
+
+			outl = 0;
+			outr = 0;
+			for(ch=0; ch<8; ch++) {
+				outl += PSG->chanout[ch] & PSG->pan[2*ch];
+				outr += PSG->chanout[ch] & PSG->pan[2*ch+1];
+			}
+			if (buffers != NULL)
+			{
+				buffers[0][i] = outl;
+				buffers[1][i] = outr;
+			}
+			else
+			{
+				mixBuf[i * 2 + 0] += outl * volL;
+				mixBuf[i * 2 + 1] += outr * volR;
+			}
 		}
-		buffers[0][i] = outl;
-		buffers[1][i] = outr;
 
 		advance(PSG);
 
@@ -2019,6 +2043,21 @@ static void ym2151_update_one(void *chip, UINT32 length, DEV_SMPL **buffers)
 	}
 }
 
+static void ym2151_update_one(void *chip, UINT32 length, DEV_SMPL **buffers)
+{
+	ym2151_render((YM2151 *)chip, length, buffers, NULL, 0, 0);
+}
+
+static void ym2151_update_mix(void *chip, UINT32 length, DEV_SMPL *mixBuf, INT32 volL, INT32 volR)
+{
+	ym2151_render((YM2151 *)chip, length, NULL, mixBuf, volL, volR);
+}
+
+static void ym2151_skip(void *chip, UINT32 length)
+{
+	ym2151_render((YM2151 *)chip, length, NULL, NULL, 0, 0);
+}
+
 void ym2151_set_irq_handler(void *chip, void(*handler)(void *param, UINT8 irq))
 {
 	YM2151 *PSG = (YM2151 *)chip;
@@ -2036,6 +2075,40 @@ static void ym2151_set_mute_mask(void *chip, UINT32 MuteMask)
 	return;
 }
 
+static UINT32 ym2151_get_state_size(void *chip)
+{
+	return sizeof(YM2151);
+}
+
+static UINT8 ym2151_save_state(void *chip, UINT32 bufSize, void* buffer)
+{
+	if (bufSize < sizeof(YM2151))
+		return 0xFF;
+	memcpy(buffer, chip, sizeof(YM2151));
+	return 0x00;
+}
+
+static UINT8 ym2151_load_state(void *chip, UINT32 dataSize, const void* data)
+{
+	YM2151 *PSG = (YM2151 *)chip;
+	UINT8 Muted[8];
+	void (*irqhandler)(void *param, UINT8 irq);
+	void (*portwritehandler)(void *param, UINT8 ofs, UINT8 data);
+	
+	if (dataSize != sizeof(YM2151))
+		return 0xFF;
+	memcpy(Muted, PSG->Muted, sizeof(Muted));
+	irqhandler = PSG->irqhandler;
+	portwritehandler = PSG->portwritehandler;
+	
+	memcpy(PSG, data, sizeof(YM2151));
+	
+	memcpy(PSG->Muted, Muted, sizeof(Muted));
+	PSG->irqhandler = irqhandler;
+	PSG->portwritehandler = portwritehandler;
+	return 0x00;
+}
+
 
 static UINT8 device_start_ym2151(const DEV_GEN_CFG* cfg, DEV_INFO* retDevInf)
 {
@@ -54,6 +54,9 @@ static void ymf271_write_rom(void *info, UINT32 offset, UINT32 length, const UIN
 
 static void ymf271_set_mute_mask(void *info, UINT32 MuteMask);
 static void ymf271_set_log_cb(void *info, DEVCB_LOG func, void* param);
+static UINT32 ymf271_get_state_size(void *info);
+static UINT8 ymf271_save_state(void *info, UINT32 bufSize, void* buffer);
+static UINT8 ymf271_load_state(void *info, UINT32 dataSize, const void* data);
 
 
 static DEVDEF_RWFUNC devFunc[] =
@@ -63,6 +66,9 @@ static DEVDEF_RWFUNC devFunc[] =
 	{RWF_MEMORY | RWF_WRITE, DEVRW_BLOCK, 0, ymf271_write_rom},
 	{RWF_MEMORY | RWF_WRITE, DEVRW_MEMSIZE, 0, ymf271_alloc_rom},
 	{RWF_CHN_MUTE | RWF_WRITE, DEVRW_ALL, 0, ymf271_set_mute_mask},
+	{RWF_STATE | RWF_READ, DEVRW_MEMSIZE, 0, ymf271_get_state_size},
+	{RWF_STATE | RWF_READ, DEVRW_BLOCK, 0, ymf271_save_state},
+	{RWF_STATE | RWF_WRITE, DEVRW_BLOCK, 0, ymf271_load_state},
 	{0x00, 0x00, 0, NULL}
 };
 static DEV_DEF devDef =
@@ -1979,3 +1985,42 @@ static void ymf271_set_log_cb(void *info, DEVCB_LOG func, void* param)
 	dev_logger_set(&chip->logger, chip, func, param);
 	return;
 }
+
+static UINT32 ymf271_get_state_size(void *info)
+{
+	return sizeof(YMF271Chip);
+}
+
+static UINT8 ymf271_save_state(void *info, UINT32 bufSize, void* buffer)
+{
+	if (bufSize < sizeof(YMF271Chip))
+		return 0xFF;
+	memcpy(buffer, info, sizeof(YMF271Chip));
+	return 0x00;
+}
+
+static UINT8 ymf271_load_state(void *info, UINT32 dataSize, const void* data)
+{
+	YMF271Chip *chip = (YMF271Chip *)info;
+	YMF271Chip old;
+	UINT8 CurChn;
+	
+	if (dataSize != sizeof(YMF271Chip))
+		return 0xFF;
+	old = *chip;
+	memcpy(chip, data, sizeof(YMF271Chip));
+	// keep memory buffers, callbacks and user settings
+	chip->logger = old.logger;
+	chip->mem_base = old.mem_base;
+	chip->mem_size = old.mem_size;
+	chip->mixbuf_smpls = old.mixbuf_smpls;
+	chip->mix_buffer = old.mix_buffer;
+	chip->irq_handler = old.irq_handler;
+	chip->irq_param = old.irq_param;
+	chip->ext_read_handler = old.ext_read_handler;
+	chip->ext_write_handler = old.ext_write_handler;
+	chip->ext_param = old.ext_param;
+	for (CurChn = 0; CurChn < 12; CurChn ++)
+		chip->groups[CurChn].Muted = old.groups[CurChn].Muted;
+	return 0x00;
+}
@@ -125,9 +125,13 @@ static void ymf278b_alloc_rom(void* info, UINT32 memsize);
 static void ymf278b_alloc_ram(void* info, UINT32 memsize);
 static void ymf278b_write_rom(void *info, UINT32 offset, UINT32 length, const UINT8* data);
 static void ymf278b_write_ram(void *info, UINT32 offset, UINT32 length, const UINT8* data);
+static void ymf278b_alias_rom(void* info, UINT32 memsize, const UINT8* data);
 
 static void ymf278b_set_mute_mask(void *info, UINT32 MuteMask);
 static void ymf278b_set_log_cb(void *info, DEVCB_LOG func, void* param);
+static UINT32 ymf278b_get_state_size(void *info);
+static UINT8 ymf278b_save_state(void *info, UINT32 bufSize, void* buffer);
+static UINT8 ymf278b_load_state(void *info, UINT32 dataSize, const void* data);
 
 
 static DEVDEF_RWFUNC devFunc[] =
@@ -136,9 +140,13 @@ static DEVDEF_RWFUNC devFunc[] =
 	{RWF_REGISTER | RWF_READ, DEVRW_A8D8, 0, ymf278b_r},
 	{RWF_MEMORY | RWF_WRITE, DEVRW_BLOCK, 0x524F, ymf278b_write_rom},	// 0x524F = 'RO' for ROM
 	{RWF_MEMORY | RWF_WRITE, DEVRW_MEMSIZE, 0x524F, ymf278b_alloc_rom},
+	{RWF_MEMORY | RWF_WRITE, DEVRW_BLOCK_ALIAS, 0x524F, ymf278b_alias_rom},
 	{RWF_MEMORY | RWF_WRITE, DEVRW_BLOCK, 0x5241, ymf278b_write_ram},	// 0x5241 = 'RA' for RAM
 	{RWF_MEMORY | RWF_WRITE, DEVRW_MEMSIZE, 0x5241, ymf278b_alloc_ram},
 	{RWF_CHN_MUTE | RWF_WRITE, DEVRW_ALL, 0, ymf278b_set_mute_mask},
+	{RWF_STATE | RWF_READ, DEVRW_MEMSIZE, 0, ymf278b_get_state_size},
+	{RWF_STATE | RWF_READ, DEVRW_BLOCK, 0, ymf278b_save_state},
+	{RWF_STATE | RWF_WRITE, DEVRW_BLOCK, 0, ymf278b_load_state},
 	{0x00, 0x00, 0, NULL}
 };
 static DEV_DEF devDef =
@@ -264,7 +272,8 @@ struct _YMF278BChip
 	INT32 pcm_l, pcm_r;
 
 	UINT32 ROMSize;
-	UINT8 *rom;
+	const UINT8 *rom;	// points to romBuf or to external memory (see ymf278b_alias_rom)
+	UINT8 *romBuf;
 	UINT32 RAMSize;
 	UINT8 *ram;
 	UINT32 clock;
@@ -279,7 +288,7 @@ struct _YMF278BChip
 	OPL3FM fm;
 };
 
-INLINE UINT8* ymf278b_getMemPtr(YMF278BChip* chip, UINT32 address);
+INLINE const UINT8* ymf278b_getMemPtr(YMF278BChip* chip, UINT32 address);
 INLINE UINT8 ymf278b_readMem(YMF278BChip* chip, UINT32 address);
 INLINE void ymf278b_writeMem(YMF278BChip* chip, UINT32 address, UINT8 value);
 
@@ -943,7 +952,7 @@ static void ymf278b_C_w(YMF278BChip* chip, UINT8 reg, UINT8 data)
 		YMF278BSlot* slot = &chip->slots[snum];
 		UINT8 wavetblhdr;
 		UINT32 base;
-		UINT8* buf;
+		const UINT8* buf;
 		int i;
 		
 		switch((reg - 8) / 24)
@@ -1352,7 +1361,7 @@ static UINT32 ymf278b_getRamAddress(YMF278BChip* chip, UINT32 addr)
 	return addr;
 }
 
-INLINE UINT8* ymf278b_getMemPtr(YMF278BChip* chip, UINT32 address)
+INLINE const UINT8* ymf278b_getMemPtr(YMF278BChip* chip, UINT32 address)
 {
 	address &= 0x3FFFFF;
 	if (address < chip->ROMSize)
@@ -1459,6 +1468,7 @@ static UINT8 device_start_ymf278b(const DEV_GEN_CFG* cfg, DEV_INFO* retDevInf)
 
 	chip->ROMSize = 0;
 	chip->rom = NULL;
+	chip->romBuf = NULL;
 	chip->RAMSize = 0;
 	chip->ram = NULL;
 
@@ -1499,7 +1509,7 @@ static void device_stop_ymf278b(void *info)
 	YMF278BChip* chip = (YMF278BChip *)info;
 	
 	free(chip->ram);
-	free(chip->rom);
+	free(chip->romBuf);
 	free(chip);
 	
 	return;
@@ -1576,16 +1586,35 @@ static UINT8 device_ymf278b_link_opl3(void* param, UINT8 linkID, const DEV_INFO*
 	return retVal;
 }
 
+// make a private copy of an aliased ROM before modifying it
+static void ymf278b_own_rom(YMF278BChip *chip)
+{
+	if (chip->rom == chip->romBuf)
+		return;
+	
+	chip->romBuf = (UINT8*)malloc(chip->ROMSize);
+	memcpy(chip->romBuf, chip->rom, chip->ROMSize);
+	chip->rom = chip->romBuf;
+	
+	return;
+}
+
 static void ymf278b_alloc_rom(void* info, UINT32 memsize)
 {
 	YMF278BChip *chip = (YMF278BChip *)info;
 	
 	if (chip->ROMSize == memsize)
+	{
+		ymf278b_own_rom(chip);
 		return;
+	}
 	
-	chip->rom = (UINT8*)realloc(chip->rom, memsize);
+	if (chip->rom != chip->romBuf)
+		chip->romBuf = NULL;	// don't touch aliased memory
+	chip->romBuf = (UINT8*)realloc(chip->romBuf, memsize);
+	chip->rom = chip->romBuf;
 	chip->ROMSize = memsize;
-	memset(chip->rom, 0xFF, memsize);
+	memset(chip->romBuf, 0xFF, memsize);
 	
 	return;
 }
@@ -1613,7 +1642,19 @@ static void ymf278b_write_rom(void *info, UINT32 offset, UINT32 length, const UI
 	if (offset + length > chip->ROMSize)
 		length = chip->ROMSize - offset;
 	
-	memcpy(chip->rom + offset, data, length);
+	ymf278b_own_rom(chip);
+	memcpy(chip->romBuf + offset, data, length);
+	
+	return;
+}
+
+static void ymf278b_alias_rom(void* info, UINT32 memsize, const UINT8* data)
+{
+	YMF278BChip *chip = (YMF278BChip *)info;
+	
+	free(chip->romBuf);	chip->romBuf = NULL;
+	chip->rom = data;
+	chip->ROMSize = memsize;
 	
 	return;
 }
@@ -1650,3 +1691,48 @@ static void ymf278b_set_log_cb(void *info, DEVCB_LOG func, void* param)
 	dev_logger_set(&chip->logger, chip, func, param);
 	return;
 }
+
+static UINT32 ymf278b_get_state_size(void *info)
+{
+	YMF278BChip *chip = (YMF278BChip *)info;
+	return sizeof(YMF278BChip) + chip->RAMSize;
+}
+
+static UINT8 ymf278b_save_state(void *info, UINT32 bufSize, void* buffer)
+{
+	YMF278BChip *chip = (YMF278BChip *)info;
+	UINT8* dst = (UINT8*)buffer;
+	
+	if (bufSize < sizeof(YMF278BChip) + chip->RAMSize)
+		return 0xFF;
+	memcpy(dst, chip, sizeof(YMF278BChip));
+	memcpy(dst + sizeof(YMF278BChip), chip->ram, chip->RAMSize);
+	return 0x00;
+}
+
+static UINT8 ymf278b_load_state(void *info, UINT32 dataSize, const void* data)
+{
+	YMF278BChip *chip = (YMF278BChip *)info;
+	const UINT8* src = (const UINT8*)data;
+	YMF278BChip old;
+	UINT8 CurChn;
+	
+	if (dataSize != sizeof(YMF278BChip) + chip->RAMSize)
+		return 0xFF;
+	old = *chip;
+	memcpy(chip, src, sizeof(YMF278BChip));
+	// keep memory buffers, linked OPL3 and user settings
+	// Note: The state of the OPL3 has to be saved separately.
+	chip->logger = old.logger;
+	chip->ROMSize = old.ROMSize;
+	chip->rom = old.rom;
+	chip->romBuf = old.romBuf;
+	chip->RAMSize = old.RAMSize;
+	chip->ram = old.ram;
+	chip->fm = old.fm;
+	for (CurChn = 0; CurChn < 24; CurChn ++)
+		chip->slots[CurChn].Muted = old.slots[CurChn].Muted;
+	memcpy(chip->ram, src + sizeof(YMF278BChip), chip->RAMSize);
+	refresh_opl3_volume(chip);
+	return 0x00;
+}
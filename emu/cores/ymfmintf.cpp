@@ -78,6 +78,9 @@ static void ym2414_update(void* chip, UINT32 samples, DEV_SMPL** outputs);
 static UINT8 ym2414_write(void* chip, UINT8 offset, UINT8 data);
 static UINT8 ym2414_read(void* chip, UINT8 offset);
 static void ym2414_set_mute_mask(void* chip, UINT32 muteMask);
+static UINT32 ym2414_get_state_size(void* chip);
+static UINT8 ym2414_save_state(void* chip, UINT32 bufSize, void* buffer);
+static UINT8 ym2414_load_state(void* chip, UINT32 dataSize, const void* data);
 
 
 //*********************************************************
@@ -89,6 +92,9 @@ static DEVDEF_RWFUNC devFunc[] =
 	{RWF_REGISTER | RWF_WRITE, DEVRW_A8D8, 0, (void*)ym2414_write},
 	{RWF_REGISTER | RWF_READ, DEVRW_A8D8, 0, (void*)ym2414_read},
 	{RWF_CHN_MUTE | RWF_WRITE, DEVRW_ALL, 0, (void*)ym2414_set_mute_mask},
+	{RWF_STATE | RWF_READ, DEVRW_MEMSIZE, 0, (void*)ym2414_get_state_size},
+	{RWF_STATE | RWF_READ, DEVRW_BLOCK, 0, (void*)ym2414_save_state},
+	{RWF_STATE | RWF_WRITE, DEVRW_BLOCK, 0, (void*)ym2414_load_state},
 	{0x00, 0x00, 0, NULL}
 };
 
@@ -231,6 +237,46 @@ static void ym2414_set_mute_mask(void* chip, UINT32 muteMask)
 	return;
 }
 
+// The state is serialized using ymfm's own save/restore functions.
+static UINT32 ym2414_get_state_size(void* chip)
+{
+	ymfm_ym2414_chip* info = CHP_GET_PTR(chip);
+	std::vector<uint8_t> buffer;
+	ymfm::ymfm_saved_state state(buffer, true);
+
+	info->chip->save_restore(state);
+	return (UINT32)buffer.size() + 1;
+}
+
+static UINT8 ym2414_save_state(void* chip, UINT32 bufSize, void* buffer)
+{
+	ymfm_ym2414_chip* info = CHP_GET_PTR(chip);
+	std::vector<uint8_t> data;
+	ymfm::ymfm_saved_state state(data, true);
+
+	info->chip->save_restore(state);
+	if (bufSize < data.size() + 1)
+		return 0xFF;
+	memcpy(buffer, &data[0], data.size());
+	((UINT8*)buffer)[data.size()] = info->address;
+	return 0x00;
+}
+
+static UINT8 ym2414_load_state(void* chip, UINT32 dataSize, const void* data)
+{
+	ymfm_ym2414_chip* info = CHP_GET_PTR(chip);
+	const UINT8* src = (const UINT8*)data;
+
+	if (dataSize != ym2414_get_state_size(chip))
+		return 0xFF;
+	std::vector<uint8_t> buffer(src, src + dataSize - 1);
+	ymfm::ymfm_saved_state state(buffer, false);
+
+	info->chip->save_restore(state);
+	info->address = src[dataSize - 1];
+	return 0x00;
+}
+
 
 //*********************************************************
 //  DEVICE METADATA
@@ -55,6 +55,9 @@ static void ymz280b_write_rom(void *info, UINT32 offset, UINT32 length, const UI
 
 static void ymz280b_set_mute_mask(void *info, UINT32 MuteMask);
 static void ymz280b_set_log_cb(void *info, DEVCB_LOG func, void* param);
+static UINT32 ymz280b_get_state_size(void *info);
+static UINT8 ymz280b_save_state(void *info, UINT32 bufSize, void* buffer);
+static UINT8 ymz280b_load_state(void *info, UINT32 dataSize, const void* data);
 
 
 static DEVDEF_RWFUNC devFunc[] =
@@ -64,6 +67,9 @@ static DEVDEF_RWFUNC devFunc[] =
 	{RWF_MEMORY | RWF_WRITE, DEVRW_BLOCK, 0, ymz280b_write_rom},
 	{RWF_MEMORY | RWF_WRITE, DEVRW_MEMSIZE, 0, ymz280b_alloc_rom},
 	{RWF_CHN_MUTE | RWF_WRITE, DEVRW_ALL, 0, ymz280b_set_mute_mask},
+	{RWF_STATE | RWF_READ, DEVRW_MEMSIZE, 0, ymz280b_get_state_size},
+	{RWF_STATE | RWF_READ, DEVRW_BLOCK, 0, ymz280b_save_state},
+	{RWF_STATE | RWF_WRITE, DEVRW_BLOCK, 0, ymz280b_load_state},
 	{0x00, 0x00, 0, NULL}
 };
 static DEV_DEF devDef =
@@ -1107,3 +1113,41 @@ static void ymz280b_set_log_cb(void *info, DEVCB_LOG func, void* param)
 	dev_logger_set(&chip->logger, chip, func, param);
 	return;
 }
+
+static UINT32 ymz280b_get_state_size(void *info)
+{
+	return sizeof(ymz280b_state);
+}
+
+static UINT8 ymz280b_save_state(void *info, UINT32 bufSize, void* buffer)
+{
+	if (bufSize < sizeof(ymz280b_state))
+		return 0xFF;
+	memcpy(buffer, info, sizeof(ymz280b_state));
+	return 0x00;
+}
+
+static UINT8 ymz280b_load_state(void *info, UINT32 dataSize, const void* data)
+{
+	ymz280b_state *chip = (ymz280b_state *)info;
+	ymz280b_state old;
+	UINT8 CurChn;
+	
+	if (dataSize != sizeof(ymz280b_state))
+		return 0xFF;
+	old = *chip;
+	memcpy(chip, data, sizeof(ymz280b_state));
+	// keep memory buffers, callbacks and user settings
+	chip->logger = old.logger;
+	chip->irq_handler = old.irq_handler;
+	chip->irq_param = old.irq_param;
+	chip->ext_read_handler = old.ext_read_handler;
+	chip->ext_write_handler = old.ext_write_handler;
+	chip->ext_param = old.ext_param;
+	chip->mem_base = old.mem_base;
+	chip->mem_size = old.mem_size;
+	chip->scratch = old.scratch;
+	for (CurChn = 0; CurChn < 8; CurChn ++)
+		chip->voice[CurChn].Muted = old.voice[CurChn].Muted;
+	return 0x00;
+}
@@ -26,6 +26,17 @@
 #include "RatioCntr.h"
 #include "dac_control.h"
 
+static UINT32 daccontrol_get_state_size(void* info);
+static UINT8 daccontrol_save_state(void* info, UINT32 bufSize, void* buffer);
+static UINT8 daccontrol_load_state(void* info, UINT32 dataSize, const void* data);
+
+static DEVDEF_RWFUNC devFunc[] =
+{
+	{RWF_STATE | RWF_READ, DEVRW_MEMSIZE, 0, daccontrol_get_state_size},
+	{RWF_STATE | RWF_READ, DEVRW_BLOCK, 0, daccontrol_save_state},
+	{RWF_STATE | RWF_WRITE, DEVRW_BLOCK, 0, daccontrol_load_state},
+	{0x00, 0x00, 0, NULL}
+};
 static DEV_DEF devDef_DAC =
 {
 	NULL, NULL, 0,
@@ -42,7 +53,7 @@ static DEV_DEF devDef_DAC =
 	NULL,	// SetLoggingCallback
 	NULL,	// LinkDevice
 	
-	NULL,	// rwFuncs
+	devFunc,	// rwFuncs
 };
 
 typedef struct
@@ -335,6 +346,29 @@ void daccontrol_update(void* info, UINT32 samples, DEV_SMPL** dummy)
 	return;
 }
 
+UINT32 daccontrol_get_next_write(void* info)
+{
+	dac_control* chip = (dac_control*)info;
+	RC_TYPE remain;
+	
+	if (chip->Running & 0x80)	// disabled
+		return (UINT32)-1;
+	if (! (chip->Running & 0x01))	// stopped
+		return (UINT32)-1;
+	if (! chip->RemainCmds)
+		return 1;	// the next update will stop the stream
+	
+	if (RC_GET_VAL(&chip->stepCntr) > 0)
+		return 1;	// a command is already pending
+	if (! chip->stepCntr.inc)
+		return (UINT32)-1;	// frequency 0 - the stream will never send anything
+	
+	// number of update steps until the counter reaches the next integer
+	remain = ((RC_TYPE)1 << RC_SHIFT) - chip->stepCntr.val;
+	remain = (remain + chip->stepCntr.inc - 1) / chip->stepCntr.inc;
+	return (remain > (UINT32)-1) ? (UINT32)-1 : (UINT32)remain;
+}
+
 UINT8 device_start_daccontrol(const DEV_GEN_CFG* cfg, DEV_INFO* retDevInf)
 {
 	dac_control* chip;
@@ -442,7 +476,7 @@ void daccontrol_setup_chip(void* info, DEV_INFO* devInf, UINT8 ChType, UINT16 Co
 	return;
 }
 
-void daccontrol_set_data(void* info, UINT8* Data, UINT32 DataLen, UINT8 StepSize, UINT8 StepBase)
+void daccontrol_set_data(void* info, const UINT8* Data, UINT32 DataLen, UINT8 StepSize, UINT8 StepBase)
 {
 	dac_control* chip = (dac_control*)info;
 	
@@ -466,7 +500,7 @@ void daccontrol_set_data(void* info, UINT8* Data, UINT32 DataLen, UINT8 StepSize
 	return;
 }
 
-void daccontrol_refresh_data(void* info, UINT8* Data, UINT32 DataLen)
+void daccontrol_refresh_data(void* info, const UINT8* Data, UINT32 DataLen)
 {
 	// should be called to fix the data pointer (e.g. after a realloc)
 	dac_control* chip = (dac_control*)info;
@@ -565,3 +599,30 @@ void daccontrol_stop(void* info)
 	
 	return;
 }
+
+static UINT32 daccontrol_get_state_size(void* info)
+{
+	return sizeof(dac_control);
+}
+
+static UINT8 daccontrol_save_state(void* info, UINT32 bufSize, void* buffer)
+{
+	dac_control* chip = (dac_control*)info;
+	
+	if (bufSize < sizeof(dac_control))
+		return 0xFF;
+	memcpy(buffer, chip, sizeof(dac_control));
+	return 0x00;
+}
+
+static UINT8 daccontrol_load_state(void* info, UINT32 dataSize, const void* data)
+{
+	// Note: The data pointer is restored as well.
+	//       Call daccontrol_refresh_data() afterwards if the data buffer may have been reallocated.
+	dac_control* chip = (dac_control*)info;
+	
+	if (dataSize != sizeof(dac_control))
+		return 0xFF;
+	memcpy(chip, data, sizeof(dac_control));
+	return 0x00;
+}
@@ -10,13 +10,16 @@ extern "C"
 #include "EmuStructs.h"
 
 void daccontrol_update(void* info, UINT32 samples, DEV_SMPL** dummy);
+// Returns the number of samples daccontrol_update() has to process until the stream sends its next command.
+// (i.e. the command is sent at the end of an update of that many samples, (UINT32)-1 = no pending commands)
+UINT32 daccontrol_get_next_write(void* info);
 UINT8 device_start_daccontrol(const DEV_GEN_CFG* cfg, DEV_INFO* retDevInf);
 void device_stop_daccontrol(void* info);
 void device_reset_daccontrol(void* info);
 
 void daccontrol_setup_chip(void* info, DEV_INFO* devInf, UINT8 ChType, UINT16 Command);
-void daccontrol_set_data(void* info, UINT8* Data, UINT32 DataLen, UINT8 StepSize, UINT8 StepBase);
-void daccontrol_refresh_data(void* info, UINT8* Data, UINT32 DataLen);
+void daccontrol_set_data(void* info, const UINT8* Data, UINT32 DataLen, UINT8 StepSize, UINT8 StepBase);
+void daccontrol_refresh_data(void* info, const UINT8* Data, UINT32 DataLen);
 void daccontrol_set_frequency(void* info, UINT32 Frequency);
 void daccontrol_start(void* info, UINT32 DataPos, UINT8 LenMode, UINT32 Length);
 void daccontrol_stop(void* info);
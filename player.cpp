@@ -38,6 +38,7 @@ extern "C" int __cdecl _kbhit(void);
 #include "player/playera.hpp"
 #include "audio/AudioStream.h"
 #include "audio/AudioStream_SpcDrvFuns.h"
+#include "audio/AudioRenderAhead.h"
 #include "emu/SoundDevs.h"	// for DEVID_*
 #include "emu/EmuCores.h"
 #include "utils/OSMutex.h"
@@ -59,6 +60,7 @@ static UINT8 *SlurpFile(const char *fileName, UINT32 *fileSize);
 #endif
 static const char* GetFileTitle(const char* filePath);
 static UINT32 FillBuffer(void* drvStruct, void* userParam, UINT32 bufSize, void* Data);
+static UINT32 RenderBuffer(void* drvStruct, void* userParam, UINT32 bufSize, void* data);
 static UINT8 FilePlayCallback(PlayerBase* player, void* userParam, UINT8 evtType, void* evtParam);
 static DATA_LOADER* RequestFileCallback(void* userParam, PlayerBase* player, const char* fileName);
 static const char* LogLevel2Str(UINT8 level);
@@ -82,10 +84,12 @@ static void* audDrv;
 static void* audDrvLog;
 static std::vector<UINT8> locAudBuf;	// local audio buffer (for WAV dumping)
 static OS_MUTEX* renderMtx;	// render thread mutex
+static RENDER_AHEAD* renderAhead;	// render-ahead buffer, when enabled
 
 static UINT32 sampleRate = 44100;
 static UINT32 maxLoops = 2;
 static bool manualRenderLoop = false;
+static UINT32 renderAheadMsec = 0;	// render in a separate thread, up to X ms ahead of the audio driver (0 = render in the driver callback, set using -r)
 static volatile UINT8 playState;
 
 static UINT32 idWavOut;
@@ -111,13 +115,27 @@ int main(int argc, char* argv[])
 	DATA_LOADER *dLoad;
 	int curSong;
 	bool needRefresh;
+	UINT32 lastUnderruns;
 	
-	if (argc < 2)
+	argbase = 1;
+	while(argbase < argc && argv[argbase][0] == '-')
+	{
+		if (! strcmp(argv[argbase], "-r") && argbase + 1 < argc)
+		{
+			// -r msec: render in a separate thread, up to msec ahead of the audio driver
+			renderAheadMsec = (UINT32)strtoul(argv[argbase + 1], NULL, 0);
+			argbase += 2;
+		}
+		else
+		{
+			break;
+		}
+	}
+	if (argc <= argbase)
 	{
-		printf("Usage: %s inputfile\n", argv[0]);
+		printf("Usage: %s [-r render-ahead-msec] inputfile\n", argv[0]);
 		return 0;
 	}
-	argbase = 1;
 #ifdef _WIN32
 	SetConsoleOutputCP(65001);	// set UTF-8 codepage
 #endif
@@ -169,6 +187,7 @@ int main(int argc, char* argv[])
 
 	if(dLoad == NULL) continue;
 	DataLoader_SetPreloadBytes(dLoad,0x100);
+	DataLoader_SetAsync(dLoad,1);	// decompress .vgz files while playing
 	retVal = DataLoader_Load(dLoad);
 	if (retVal)
 	{
@@ -362,6 +381,9 @@ int main(int argc, char* argv[])
 	
 	StartDiskWriter("waveOut.wav");
 	
+	lastUnderruns = 0;
+	if (renderAhead != NULL)
+		RenderAhead_Start(renderAhead);
 	if (audDrv != NULL)
 		retVal = AudioDrv_SetCallback(audDrv, FillBuffer, &mainPlr);
 	else
@@ -410,6 +432,17 @@ int main(int argc, char* argv[])
 			fflush(stdout);
 			needRefresh = false;
 		}
+		if (renderAhead != NULL)
+		{
+			RNDAHEAD_STATS raStats;
+			RenderAhead_GetStats(renderAhead, &raStats);
+			if (raStats.underruns != lastUnderruns)
+			{
+				printf("Render-ahead buffer underrun! (%u total, %u bytes of silence)\n",
+					raStats.underruns, raStats.underrunBytes);
+				lastUnderruns = raStats.underruns;
+			}
+		}
 		
 		if (manualRenderLoop && ! (playState & PLAYSTATE_PAUSE))
 		{
@@ -442,6 +475,8 @@ int main(int argc, char* argv[])
 				OSMutex_Lock(renderMtx);
 				mainPlr.Reset();
 				OSMutex_Unlock(renderMtx);
+				if (renderAhead != NULL)
+					RenderAhead_Flush(renderAhead);
 			}
 			else if (letter >= '0' && letter <= '9')
 			{
@@ -455,6 +490,8 @@ int main(int argc, char* argv[])
 				destPos = maxPos * pbPos10 / 10;
 				mainPlr.Seek(PLAYPOS_TICK, destPos);
 				OSMutex_Unlock(renderMtx);
+				if (renderAhead != NULL)
+					RenderAhead_Flush(renderAhead);
 			}
 			else if (letter == 'B')	// previous file
 			{
@@ -496,10 +533,35 @@ int main(int argc, char* argv[])
 #ifndef _WIN32
 	changemode(0);
 #endif
+	if (renderAhead != NULL && (mainPlr.GetState() & PLAYSTATE_FIN))
+	{
+		// Stop rendering and let the audio driver play the remaining buffered data.
+		// Give up only when the driver stops reading, so that a stalled driver can't hang the player.
+		RNDAHEAD_STATS raStats;
+		UINT32 lastFill;
+		UINT32 stallTime;
+		
+		RenderAhead_Stop(renderAhead);
+		RenderAhead_GetStats(renderAhead, &raStats);
+		lastFill = raStats.fillLevel;
+		stallTime = 0;
+		while(raStats.fillLevel > 0 && stallTime < 500)
+		{
+			Sleep(10);
+			RenderAhead_GetStats(renderAhead, &raStats);
+			if (raStats.fillLevel < lastFill)
+				stallTime = 0;
+			else
+				stallTime += 10;
+			lastFill = raStats.fillLevel;
+		}
+	}
 	// remove callback to prevent further rendering
 	// also waits for render thread to finish its work
 	if (audDrv != NULL)
 		AudioDrv_SetCallback(audDrv, NULL, NULL);
+	if (renderAhead != NULL)
+		RenderAhead_Stop(renderAhead);
 	
 	StopDiskWriter();
 	
@@ -639,8 +701,9 @@ static void DoChipControlMode(PlayerBase* player)
 						VGM_PLAY_OPTIONS playOpts;
 						vgmplay->GetPlayerOptions(playOpts);
 						double spd = playOpts.genOpts.pbSpeed / (double)0x10000;
-						printf("Opts: Speed %.3f, PlaybkHz %u, HardStopOld %u\n",
-							spd, playOpts.playbackHz, playOpts.hardStopOld);
+						printf("Opts: Speed %.3f, PlaybkHz %u, HardStopOld %u, SeekKfInt %.1f s, RenderThreads %u\n",
+							spd, playOpts.playbackHz, playOpts.hardStopOld, vgmplay->Tick2Sample(playOpts.seekKfInterval) / (double)sampleRate,
+							playOpts.renderThreads);
 						mode = 2;
 					}
 						break;
@@ -875,7 +938,7 @@ static void DoChipControlMode(PlayerBase* player)
 				
 				vgmplay->GetPlayerOptions(playOpts);
 				
-				printf("Command [SPD/PHZ/HSO data]: ");
+				printf("Command [SPD/PHZ/HSO/SKI/THR data]: ");
 				endPtr = fgets(line, 0x80, stdin);
 				if (endPtr == NULL)
 					return;
@@ -904,6 +967,25 @@ static void DoChipControlMode(PlayerBase* player)
 					if (endPtr > tokenStr)
 						vgmplay->SetPlayerOptions(playOpts);
 				}
+				else if (! strcmp(line, "SKI"))
+				{
+					// seek keyframe interval in seconds of output, 0 = off
+					double secs = strtod(tokenStr, &endPtr);
+					playOpts.seekKfInterval = vgmplay->Sample2Tick((UINT32)(secs * sampleRate + 0.5));
+					if (endPtr > tokenStr)
+						vgmplay->SetPlayerOptions(playOpts);
+				}
+				else if (! strcmp(line, "THR"))
+				{
+					// number of render threads, 0/1 = off
+					playOpts.renderThreads = (UINT32)strtoul(tokenStr, &endPtr, 0);
+					if (endPtr > tokenStr)
+					{
+						OSMutex_Lock(renderMtx);	// the thread pool must not be replaced while rendering
+						vgmplay->SetPlayerOptions(playOpts);
+						OSMutex_Unlock(renderMtx);
+					}
+				}
 				else if (! strcmp(line, "Q"))
 					mode = -1;
 				else
@@ -1077,6 +1159,14 @@ static const char* GetFileTitle(const char* filePath)
 }
 
 static UINT32 FillBuffer(void* drvStruct, void* userParam, UINT32 bufSize, void* data)
+{
+	// With render-ahead enabled, the audio driver thread only copies data that the render thread prepared.
+	if (renderAhead != NULL)
+		return RenderAhead_Read(renderAhead, bufSize, data);
+	return RenderBuffer(drvStruct, userParam, bufSize, data);
+}
+
+static UINT32 RenderBuffer(void* drvStruct, void* userParam, UINT32 bufSize, void* data)
 {
 	PlayerA& myPlr = *(PlayerA*)userParam;
 	if (! (myPlr.GetState() & PLAYSTATE_PLAY))
@@ -1304,6 +1394,26 @@ static UINT8 StartAudioDevice(void)
 	locAudBuf.resize(localAudBufSize);
 	mainPlr.SetOutputSettings(opts->sampleRate, opts->numChannels, opts->numBitsPerSmpl, smplAlloc);
 	
+	renderAhead = NULL;
+	if (audDrv != NULL && renderAheadMsec > 0)
+	{
+		RNDAHEAD_OPTS raOpts;
+		
+		// render in blocks of the driver's buffer size, the ring can hold one additional block
+		raOpts.blockSize = smplAlloc * smplSize;
+		raOpts.fillLevel = (UINT32)((UINT64)opts->sampleRate * renderAheadMsec / 1000) * smplSize;
+		raOpts.bufSize = raOpts.fillLevel + raOpts.blockSize;
+		raOpts.silence = (opts->numBitsPerSmpl == 8) ? 0x80 : 0x00;
+		raOpts.threadPrio = opts->threadPrio;	// the render thread feeds the output thread, so use the same settings
+		raOpts.threadCPUs = opts->threadCPUs;
+		retVal = RenderAhead_Init(&renderAhead, &raOpts, RenderBuffer, &mainPlr);
+		if (retVal)
+		{
+			fprintf(stderr, "Render-Ahead Init Error: %02X\n", retVal);
+			renderAhead = NULL;	// fall back to rendering in the driver callback
+		}
+	}
+	
 	return 0x00;
 }
 
@@ -1314,6 +1424,7 @@ static UINT8 StopAudioDevice(void)
 	retVal = 0x00;
 	if (audDrv != NULL)
 		retVal = AudioDrv_Stop(audDrv);
+	RenderAhead_Deinit(renderAhead);	renderAhead = NULL;
 	locAudBuf.clear();
 	
 	return retVal;
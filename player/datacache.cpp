@@ -0,0 +1,254 @@
+#include <stdlib.h>
+#include <string.h>
+#include <list>
+#include <vector>
+
+#include "../stdtype.h"
+#include "datacache.hpp"
+#ifdef VGMPLAYER_THREADING
+#include "../utils/OSMutex.h"
+#endif
+
+struct CACHE_ENTRY
+{
+	UINT64 hash;	// hash of the key
+	std::vector<UINT8> key;	// empty = the data is the key
+	UINT32 size;
+	UINT8* data;
+	UINT32 refCount;
+};
+
+class DataCache
+{
+public:
+	DataCache();
+	~DataCache();
+	void Lock(void);
+	void Unlock(void);
+	void Trim(void);	// free unused entries until the size limit is met
+	std::list<CACHE_ENTRY>::iterator Find(UINT64 hash, const void* key, UINT32 keySize);	// must be called with the lock held
+
+	std::list<CACHE_ENTRY> entries;	// sorted by last use, most recent first
+	UINT32 totalSize;
+	UINT32 maxSize;
+#ifdef VGMPLAYER_THREADING
+	OS_MUTEX* hMutex;
+#endif
+};
+
+static DataCache cache;
+
+
+DataCache::DataCache() :
+	totalSize(0),
+	maxSize(0x4000000)	// 64 MB
+{
+#ifdef VGMPLAYER_THREADING
+	if (OSMutex_Init(&hMutex, 0))
+		hMutex = NULL;
+#endif
+}
+
+DataCache::~DataCache()
+{
+	std::list<CACHE_ENTRY>::iterator entIt;
+
+	// Note: All players should have released their entries at this point.
+	for (entIt = entries.begin(); entIt != entries.end(); ++entIt)
+		free(entIt->data);
+	entries.clear();
+#ifdef VGMPLAYER_THREADING
+	if (hMutex != NULL)
+		OSMutex_Deinit(hMutex);
+#endif
+}
+
+void DataCache::Lock(void)
+{
+#ifdef VGMPLAYER_THREADING
+	if (hMutex != NULL)
+		OSMutex_Lock(hMutex);
+#endif
+	return;
+}
+
+void DataCache::Unlock(void)
+{
+#ifdef VGMPLAYER_THREADING
+	if (hMutex != NULL)
+		OSMutex_Unlock(hMutex);
+#endif
+	return;
+}
+
+void DataCache::Trim(void)
+{
+	std::list<CACHE_ENTRY>::iterator entIt = entries.end();
+
+	while(totalSize > maxSize && entIt != entries.begin())
+	{
+		--entIt;
+		if (entIt->refCount > 0)
+			continue;
+		totalSize -= entIt->size + (UINT32)entIt->key.size();
+		free(entIt->data);
+		entIt = entries.erase(entIt);
+	}
+
+	return;
+}
+
+
+UINT64 DataCache_Hash(const void* data, UINT32 size, UINT64 hash)
+{
+	const UINT8* dataPtr = (const UINT8*)data;
+	UINT32 curPos;
+
+	for (curPos = 0; curPos < size; curPos ++)
+	{
+		hash ^= dataPtr[curPos];
+		hash *= 0x00000100000001B3ULL;	// FNV-1a 64-bit prime
+	}
+
+	return hash;
+}
+
+std::list<CACHE_ENTRY>::iterator DataCache::Find(UINT64 hash, const void* key, UINT32 keySize)
+{
+	std::list<CACHE_ENTRY>::iterator entIt;
+
+	for (entIt = entries.begin(); entIt != entries.end(); ++entIt)
+	{
+		if (entIt->hash != hash)
+			continue;
+		if (entIt->key.empty())
+		{
+			if (entIt->size == keySize && ! memcmp(entIt->data, key, keySize))
+				break;
+		}
+		else
+		{
+			if (entIt->key.size() == keySize && ! memcmp(&entIt->key[0], key, keySize))
+				break;
+		}
+	}
+
+	return entIt;
+}
+
+const UINT8* DataCache_Acquire(UINT64 hash, const void* key, UINT32 keySize, UINT32* retSize)
+{
+	std::list<CACHE_ENTRY>::iterator entIt;
+	const UINT8* result = NULL;
+
+	cache.Lock();
+	entIt = cache.Find(hash, key, keySize);
+	if (entIt != cache.entries.end())
+	{
+		entIt->refCount ++;
+		result = entIt->data;
+		*retSize = entIt->size;
+		cache.entries.splice(cache.entries.begin(), cache.entries, entIt);	// mark as most recently used
+	}
+	cache.Unlock();
+
+	return result;
+}
+
+const UINT8* DataCache_Insert(UINT64 hash, const void* key, UINT32 keySize, UINT8* data, UINT32 size)
+{
+	std::list<CACHE_ENTRY>::iterator entIt;
+	const UINT8* result;
+
+	if (key == NULL)
+	{
+		key = data;
+		keySize = size;
+	}
+
+	cache.Lock();
+	entIt = cache.Find(hash, key, keySize);
+	if (entIt != cache.entries.end())
+	{
+		free(data);	// another player was faster
+		entIt->refCount ++;
+		result = entIt->data;
+		cache.entries.splice(cache.entries.begin(), cache.entries, entIt);
+	}
+	else
+	{
+		cache.entries.push_front(CACHE_ENTRY());
+		CACHE_ENTRY& newEnt = cache.entries.front();
+		newEnt.hash = hash;
+		if (key != data)
+			newEnt.key.assign((const UINT8*)key, (const UINT8*)key + keySize);
+		newEnt.size = size;
+		newEnt.data = data;
+		newEnt.refCount = 1;
+		cache.totalSize += size + (UINT32)newEnt.key.size();
+		cache.Trim();
+		result = data;
+	}
+	cache.Unlock();
+
+	return result;
+}
+
+void DataCache_Release(const UINT8* data)
+{
+	std::list<CACHE_ENTRY>::iterator entIt;
+
+	if (data == NULL)
+		return;
+
+	cache.Lock();
+	for (entIt = cache.entries.begin(); entIt != cache.entries.end(); ++entIt)
+	{
+		if (entIt->data == data)
+		{
+			if (entIt->refCount > 0)
+				entIt->refCount --;
+			cache.entries.splice(cache.entries.begin(), cache.entries, entIt);
+			break;
+		}
+	}
+	cache.Trim();
+	cache.Unlock();
+
+	return;
+}
+
+void DataCache_SetLimit(UINT32 maxBytes)
+{
+	cache.Lock();
+	cache.maxSize = maxBytes;
+	cache.Trim();
+	cache.Unlock();
+
+	return;
+}
+
+UINT32 DataCache_GetSize(void)
+{
+	UINT32 size;
+
+	cache.Lock();
+	size = cache.totalSize;
+	cache.Unlock();
+
+	return size;
+}
+
+void DataCache_Purge(void)
+{
+	UINT32 oldMax;
+
+	cache.Lock();
+	oldMax = cache.maxSize;
+	cache.maxSize = 0;
+	cache.Trim();
+	cache.maxSize = oldMax;
+	cache.Unlock();
+
+	return;
+}
@@ -0,0 +1,45 @@
+#ifndef __DATACACHE_HPP__
+#define __DATACACHE_HPP__
+
+#include "../stdtype.h"
+
+// Shared Data Cache
+// -----------------
+// Process-wide cache for read-only data that multiple players can share, like decompressed PCM data blocks
+// and external sample ROMs. Entries are identified by a key (a piece of data, e.g. the compressed source data
+// or a file name). The key is looked up by its 64-bit hash first and then compared byte by byte, so that
+// hash collisions can't return the wrong data. Entries that are identified by their content use the data as key.
+// Entries are reference-counted. Unused entries are kept for reuse by later files and are freed
+// (least recently used first) as soon as the cache grows beyond its size limit.
+// All functions are thread-safe when the player library is built with threading support.
+
+#define DCACHE_HASH_INIT	0xCBF29CE484222325ULL
+
+// Calculates the FNV-1a hash of a piece of data. Start with hash = DCACHE_HASH_INIT.
+// Multiple pieces can be combined by passing the result of the previous call.
+UINT64 DataCache_Hash(const void* data, UINT32 size, UINT64 hash);
+
+// Looks up an entry and references it. Returns NULL if the cache doesn't contain it.
+// hash must be DataCache_Hash(key, keySize, DCACHE_HASH_INIT). The size of the data is returned in retSize.
+const UINT8* DataCache_Acquire(UINT64 hash, const void* key, UINT32 keySize, UINT32* retSize);
+
+// Adds an entry and references it. The cache takes ownership of the data (allocated with malloc)
+// and makes a copy of the key. key == NULL: the data is its own key (hash = hash of the data).
+// If an entry with the same key exists already, data is freed and the existing entry is returned.
+// (The lookup and the insertion are atomic, so concurrent players can't add the same entry twice.)
+const UINT8* DataCache_Insert(UINT64 hash, const void* key, UINT32 keySize, UINT8* data, UINT32 size);
+
+// Removes a reference to an entry that was returned by DataCache_Acquire/DataCache_Insert.
+void DataCache_Release(const UINT8* data);
+
+// Sets the maximum size of the cache in bytes. (default: 64 MB)
+// Entries that are in use are never freed, so the cache may exceed the limit temporarily.
+void DataCache_SetLimit(UINT32 maxBytes);
+
+// Returns the number of bytes used by all cached entries.
+UINT32 DataCache_GetSize(void);
+
+// Frees all entries that are not in use.
+void DataCache_Purge(void);
+
+#endif	// __DATACACHE_HPP__
@@ -54,6 +54,7 @@ DROPlayer::DROPlayer() :
 	dev_logger_set(&_logger, this, DROPlayer::PlayerLogCB, NULL);
 	
 	_playOpts.genOpts.pbSpeed = 0x10000;
+	_playOpts.genOpts.resmplBufLimit = 0;
 	_playOpts.v2opl3Mode = DRO_V2OPL3_DETECT;
 	
 	_lastTsMult = 0;
@@ -752,6 +753,7 @@ UINT8 DROPlayer::Start(void)
 				clDev->defInf.devDef->SetMuteMask(clDev->defInf.dataPtr, devOpts->muteOpts.chnMute[0]);
 			
 			Resmpl_SetVals(&clDev->resmpl, resmplMode, 0x100, _outSmplRate);
+			Resmpl_SetBufferLimit(&clDev->resmpl, _playOpts.genOpts.resmplBufLimit);
 			// do DualOPL2 hard panning by muting either the left or right speaker
 			if (_devPanning[curDev] & 0x02)
 				clDev->resmpl.volumeL = 0x00;
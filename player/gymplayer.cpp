@@ -48,6 +48,7 @@ GYMPlayer::GYMPlayer() :
 	dev_logger_set(&_logger, this, GYMPlayer::PlayerLogCB, NULL);
 
 	_playOpts.genOpts.pbSpeed = 0x10000;
+	_playOpts.genOpts.resmplBufLimit = 0;
 
 	_lastTsMult = 0;
 	_lastTsDiv = 0;
@@ -769,6 +770,7 @@ UINT8 GYMPlayer::Start(void)
 		{
 			UINT8 resmplMode = (devOpts != NULL) ? devOpts->resmplMode : RSMODE_LINEAR;
 			Resmpl_SetVals(&clDev->resmpl, resmplMode, _devCfgs[curDev].volume, _outSmplRate);
+			Resmpl_SetBufferLimit(&clDev->resmpl, _playOpts.genOpts.resmplBufLimit);
 			Resmpl_DevConnect(&clDev->resmpl, &clDev->defInf);
 			Resmpl_Init(&clDev->resmpl);
 		}
@@ -1,6 +1,14 @@
 #include <string.h>
 #include <vector>
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define SMPLCONV_SSE2
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__) || defined(_M_ARM64)
+#include <arm_neon.h>
+#define SMPLCONV_NEON
+#endif
+
 #include "../stdtype.h"
 #include "../common_def.h"
 #include "../utils/DataLoader.h"
@@ -67,24 +75,165 @@ static void SampleConv_toS32(void* buffer, INT32 value)
 	return;
 }
 
-static void SampleConv_toF32(void* buffer, INT32 value)
+// converts a block of stereo samples to float and applies the volume gain at the same time
+// (no limiting, so there is no integer round trip)
+static void SampleConv_toF32Blk(void* buffer, const WAVE_32BS* smpls, UINT32 count, float gainL, float gainR)
 {
-	// limiting not required here
-	float v = value / (float)0x800000;
-	memcpy(buffer,&v,sizeof(v));
+	float* dst = (float*)buffer;
+	UINT32 curSmpl = 0;
+	
+#if defined(SMPLCONV_SSE2)
+	__m128 gain = _mm_setr_ps(gainL, gainR, gainL, gainR);
+	for (; curSmpl + 4 <= count; curSmpl += 4)
+	{
+		__m128i smpl0 = _mm_loadu_si128((const __m128i*)&smpls[curSmpl + 0]);
+		__m128i smpl1 = _mm_loadu_si128((const __m128i*)&smpls[curSmpl + 2]);
+		_mm_storeu_ps(&dst[curSmpl * 2 + 0], _mm_mul_ps(_mm_cvtepi32_ps(smpl0), gain));
+		_mm_storeu_ps(&dst[curSmpl * 2 + 4], _mm_mul_ps(_mm_cvtepi32_ps(smpl1), gain));
+	}
+#elif defined(SMPLCONV_NEON)
+	const float gainArr[4] = {gainL, gainR, gainL, gainR};
+	float32x4_t gain = vld1q_f32(gainArr);
+	for (; curSmpl + 4 <= count; curSmpl += 4)
+	{
+		int32x4_t smpl0 = vld1q_s32((const int32_t*)&smpls[curSmpl + 0]);
+		int32x4_t smpl1 = vld1q_s32((const int32_t*)&smpls[curSmpl + 2]);
+		vst1q_f32(&dst[curSmpl * 2 + 0], vmulq_f32(vcvtq_f32_s32(smpl0), gain));
+		vst1q_f32(&dst[curSmpl * 2 + 4], vmulq_f32(vcvtq_f32_s32(smpl1), gain));
+	}
+#endif
+	for (; curSmpl < count; curSmpl ++)
+	{
+		dst[curSmpl * 2 + 0] = (float)smpls[curSmpl].L * gainL;
+		dst[curSmpl * 2 + 1] = (float)smpls[curSmpl].R * gainR;
+	}
+	return;
+}
+
+// The block functions convert whole blocks of stereo samples.
+// The SIMD code saturates exactly like the single-sample functions above, which also do the remaining samples.
+static void SampleConv_toU8Blk(void* buffer, const WAVE_32BS* smpls, UINT32 count)
+{
+	UINT8* dst = (UINT8*)buffer;
+	UINT32 curSmpl = 0;
+	
+#if defined(SMPLCONV_SSE2)
+	const __m128i signFlip = _mm_set1_epi8((char)0x80);
+	for (; curSmpl + 8 <= count; curSmpl += 8)
+	{
+		__m128i smpl0 = _mm_srai_epi32(_mm_loadu_si128((const __m128i*)&smpls[curSmpl + 0]), 16);
+		__m128i smpl1 = _mm_srai_epi32(_mm_loadu_si128((const __m128i*)&smpls[curSmpl + 2]), 16);
+		__m128i smpl2 = _mm_srai_epi32(_mm_loadu_si128((const __m128i*)&smpls[curSmpl + 4]), 16);
+		__m128i smpl3 = _mm_srai_epi32(_mm_loadu_si128((const __m128i*)&smpls[curSmpl + 6]), 16);
+		__m128i s8 = _mm_packs_epi16(_mm_packs_epi32(smpl0, smpl1), _mm_packs_epi32(smpl2, smpl3));
+		_mm_storeu_si128((__m128i*)&dst[curSmpl * 2], _mm_xor_si128(s8, signFlip));
+	}
+#elif defined(SMPLCONV_NEON)
+	const uint8x8_t signFlip = vdup_n_u8(0x80);
+	for (; curSmpl + 4 <= count; curSmpl += 4)
+	{
+		int32x4_t smpl0 = vld1q_s32((const int32_t*)&smpls[curSmpl + 0]);
+		int32x4_t smpl1 = vld1q_s32((const int32_t*)&smpls[curSmpl + 2]);
+		int16x8_t s16 = vcombine_s16(vqshrn_n_s32(smpl0, 16), vqshrn_n_s32(smpl1, 16));
+		vst1_u8(&dst[curSmpl * 2], veor_u8(vreinterpret_u8_s8(vqmovn_s16(s16)), signFlip));
+	}
+#endif
+	for (; curSmpl < count; curSmpl ++)
+	{
+		SampleConv_toU8(&dst[curSmpl * 2 + 0], smpls[curSmpl].L);
+		SampleConv_toU8(&dst[curSmpl * 2 + 1], smpls[curSmpl].R);
+	}
+	return;
+}
+
+static void SampleConv_toS16Blk(void* buffer, const WAVE_32BS* smpls, UINT32 count)
+{
+	UINT8* dst = (UINT8*)buffer;
+	UINT32 curSmpl = 0;
+	
+#if defined(SMPLCONV_SSE2)
+	for (; curSmpl + 4 <= count; curSmpl += 4)
+	{
+		__m128i smpl0 = _mm_srai_epi32(_mm_loadu_si128((const __m128i*)&smpls[curSmpl + 0]), 8);
+		__m128i smpl1 = _mm_srai_epi32(_mm_loadu_si128((const __m128i*)&smpls[curSmpl + 2]), 8);
+		_mm_storeu_si128((__m128i*)&dst[curSmpl * 4], _mm_packs_epi32(smpl0, smpl1));
+	}
+#elif defined(SMPLCONV_NEON)
+	for (; curSmpl + 4 <= count; curSmpl += 4)
+	{
+		int32x4_t smpl0 = vld1q_s32((const int32_t*)&smpls[curSmpl + 0]);
+		int32x4_t smpl1 = vld1q_s32((const int32_t*)&smpls[curSmpl + 2]);
+		vst1q_s16((int16_t*)&dst[curSmpl * 4], vcombine_s16(vqshrn_n_s32(smpl0, 8), vqshrn_n_s32(smpl1, 8)));
+	}
+#endif
+	for (; curSmpl < count; curSmpl ++)
+	{
+		SampleConv_toS16(&dst[curSmpl * 4 + 0], smpls[curSmpl].L);
+		SampleConv_toS16(&dst[curSmpl * 4 + 2], smpls[curSmpl].R);
+	}
+	return;
+}
+
+static void SampleConv_toS24Blk(void* buffer, const WAVE_32BS* smpls, UINT32 count)
+{
+	UINT8* dst = (UINT8*)buffer;
+	UINT32 curSmpl;
+	
+	// 3-byte samples don't map well to SIMD registers, but the loop still saves the function calls per sample
+	for (curSmpl = 0; curSmpl < count; curSmpl ++)
+	{
+		SampleConv_toS24(&dst[curSmpl * 6 + 0], smpls[curSmpl].L);
+		SampleConv_toS24(&dst[curSmpl * 6 + 3], smpls[curSmpl].R);
+	}
+	return;
+}
+
+static void SampleConv_toS32Blk(void* buffer, const WAVE_32BS* smpls, UINT32 count)
+{
+	UINT8* dst = (UINT8*)buffer;
+	UINT32 curSmpl = 0;
+	
+#if defined(SMPLCONV_SSE2)
+	// SSE2 has no 32-bit min/max, so clamp using compare + select
+	const __m128i limMax = _mm_set1_epi32(+0x7FFFFF);
+	const __m128i limMin = _mm_set1_epi32(-0x800000);
+	for (; curSmpl + 2 <= count; curSmpl += 2)
+	{
+		__m128i smpl = _mm_loadu_si128((const __m128i*)&smpls[curSmpl]);
+		__m128i mask = _mm_cmpgt_epi32(smpl, limMax);
+		smpl = _mm_or_si128(_mm_and_si128(mask, limMax), _mm_andnot_si128(mask, smpl));
+		mask = _mm_cmplt_epi32(smpl, limMin);
+		smpl = _mm_or_si128(_mm_and_si128(mask, limMin), _mm_andnot_si128(mask, smpl));
+		_mm_storeu_si128((__m128i*)&dst[curSmpl * 8], _mm_slli_epi32(smpl, 8));
+	}
+#elif defined(SMPLCONV_NEON)
+	const int32x4_t limMax = vdupq_n_s32(+0x7FFFFF);
+	const int32x4_t limMin = vdupq_n_s32(-0x800000);
+	for (; curSmpl + 2 <= count; curSmpl += 2)
+	{
+		int32x4_t smpl = vld1q_s32((const int32_t*)&smpls[curSmpl]);
+		smpl = vmaxq_s32(vminq_s32(smpl, limMax), limMin);
+		vst1q_s32((int32_t*)&dst[curSmpl * 8], vshlq_n_s32(smpl, 8));
+	}
+#endif
+	for (; curSmpl < count; curSmpl ++)
+	{
+		SampleConv_toS32(&dst[curSmpl * 8 + 0], smpls[curSmpl].L);
+		SampleConv_toS32(&dst[curSmpl * 8 + 4], smpls[curSmpl].R);
+	}
 	return;
 }
 
-static PlayerA::PLR_SMPL_PACK GetSampleConvFunc(UINT8 bits)
+static PlayerA::PLR_SMPL_PACKBLK GetSampleConvFunc(UINT8 bits)
 {
 	if (bits == 8)
-		return SampleConv_toU8;
+		return SampleConv_toU8Blk;
 	else if (bits == 16)
-		return SampleConv_toS16;
+		return SampleConv_toS16Blk;
 	else if (bits == 24)
-		return SampleConv_toS24;
+		return SampleConv_toS24Blk;
 	else if (bits == 32)
-		return SampleConv_toS32;
+		return SampleConv_toS32Blk;
 	else
 		return NULL;
 }
@@ -101,6 +250,7 @@ PlayerA::PlayerA()
 	
 	_outSmplChns = 2;
 	_outSmplBits = 16;
+	_outSmplFmt = PLR_SMPLFMT_INT;
 	_outSmplPack = GetSampleConvFunc(_outSmplBits);
 	_smplRate = 44100;
 	_outSmplSize1 = _outSmplBits / 8;
@@ -149,16 +299,25 @@ const std::vector<PlayerBase*>& PlayerA::GetRegisteredPlayers(void) const
 	return _avbPlrs;
 }
 
-UINT8 PlayerA::SetOutputSettings(UINT32 smplRate, UINT8 channels, UINT8 smplBits, UINT32 smplBufferLen)
+UINT8 PlayerA::SetOutputSettings(UINT32 smplRate, UINT8 channels, UINT8 smplBits, UINT32 smplBufferLen, UINT8 smplFmt)
 {
 	if (channels != 2)
 		return 0xF0;	// TODO: support channels = 1
-	PLR_SMPL_PACK smplPackFunc = GetSampleConvFunc(smplBits);
-	if (smplPackFunc == NULL)
+	PLR_SMPL_PACKBLK smplPackFunc = NULL;	// not used for float, Render() converts whole blocks at once
+	if (smplFmt == PLR_SMPLFMT_INT)
+	{
+		smplPackFunc = GetSampleConvFunc(smplBits);
+		if (smplPackFunc == NULL)
+			return 0xF1;	// unsupported sample format
+	}
+	else if (! (smplFmt == PLR_SMPLFMT_FLOAT && smplBits == 32))
+	{
 		return 0xF1;	// unsupported sample format
+	}
 	
 	_outSmplChns = channels;
 	_outSmplBits = smplBits;
+	_outSmplFmt = smplFmt;
 	_outSmplPack = smplPackFunc;
 	SetSampleRate(smplRate);
 	_outSmplSize1 = _outSmplBits / 8;
@@ -502,6 +661,62 @@ UINT8 PlayerA::Seek(UINT8 unit, UINT32 pos)
 // 16.16 fixed point multiplication
 #define MUL16X16_FIXED(a, b)	(INT32)(((INT64)a * b) >> 16)
 
+// applies the working volume and the channel phase inversion to a block of samples
+static void ApplySampleVolume(WAVE_32BS* smpls, UINT32 count, INT32 volume, UINT8 chnInvert)
+{
+	INT32 invL = (chnInvert & 0x01) ? -1 : 0;
+	INT32 invR = (chnInvert & 0x02) ? -1 : 0;
+	UINT32 curSmpl = 0;
+	
+#if defined(VOLCALC64) && defined(SMPLCONV_SSE2)
+	// SSE2 can only do unsigned 32x32 -> 64 bit multiplications, so the upper half of the product gets corrected
+	// for signed values afterwards. Only bits VOL_BITS..VOL_BITS+31 are kept, which makes logical shifts sufficient.
+	const __m128i vol = _mm_set1_epi32(volume);
+	const __m128i volSign = _mm_set1_epi32((volume < 0) ? -1 : 0);
+	const __m128i inv = _mm_setr_epi32(invL, invR, invL, invR);
+	const __m128i maskLo = _mm_setr_epi32(-1, 0, -1, 0);
+	for (; curSmpl + 2 <= count; curSmpl += 2)
+	{
+		__m128i smpl = _mm_loadu_si128((const __m128i*)&smpls[curSmpl]);
+		__m128i prodE = _mm_srli_epi64(_mm_mul_epu32(smpl, vol), VOL_BITS);
+		__m128i prodO = _mm_srli_epi64(_mm_mul_epu32(_mm_srli_epi64(smpl, 32), vol), VOL_BITS);
+		__m128i res = _mm_or_si128(_mm_and_si128(prodE, maskLo), _mm_slli_epi64(prodO, 32));
+		// signed product = unsigned product - ((smpl < 0 ? vol : 0) + (vol < 0 ? smpl : 0)) << 32
+		__m128i corr = _mm_add_epi32(_mm_and_si128(_mm_srai_epi32(smpl, 31), vol), _mm_and_si128(volSign, smpl));
+		res = _mm_sub_epi32(res, _mm_slli_epi32(corr, 32 - VOL_BITS));
+		res = _mm_sub_epi32(_mm_xor_si128(res, inv), inv);	// negate inverted channels
+		_mm_storeu_si128((__m128i*)&smpls[curSmpl], res);
+	}
+#elif defined(VOLCALC64) && defined(SMPLCONV_NEON)
+	const int32_t invArr[4] = {invL, invR, invL, invR};
+	const int32x4_t inv = vld1q_s32(invArr);
+	const int32x2_t vol = vdup_n_s32(volume);
+	for (; curSmpl + 2 <= count; curSmpl += 2)
+	{
+		int32x4_t smpl = vld1q_s32((const int32_t*)&smpls[curSmpl]);
+		int32x2_t res0 = vshrn_n_s64(vmull_s32(vget_low_s32(smpl), vol), VOL_BITS);
+		int32x2_t res1 = vshrn_n_s64(vmull_s32(vget_high_s32(smpl), vol), VOL_BITS);
+		int32x4_t res = vcombine_s32(res0, res1);
+		res = vsubq_s32(veorq_s32(res, inv), inv);	// negate inverted channels
+		vst1q_s32((int32_t*)&smpls[curSmpl], res);
+	}
+#endif
+	for (; curSmpl < count; curSmpl ++)
+	{
+		// Input is about 24 bits (some cores might output a bit more)
+#ifdef VOLCALC64
+		smpls[curSmpl].L = (INT32)( ((INT64)smpls[curSmpl].L * volume) >> VOL_BITS );
+		smpls[curSmpl].R = (INT32)( ((INT64)smpls[curSmpl].R * volume) >> VOL_BITS );
+#else
+		smpls[curSmpl].L = ((smpls[curSmpl].L >> VOL_PRESH) * volume) >> VOL_POSTSH;
+		smpls[curSmpl].R = ((smpls[curSmpl].R >> VOL_PRESH) * volume) >> VOL_POSTSH;
+#endif
+		smpls[curSmpl].L = (smpls[curSmpl].L ^ invL) - invL;
+		smpls[curSmpl].R = (smpls[curSmpl].R ^ invR) - invR;
+	}
+	return;
+}
+
 INT32 PlayerA::CalcSongVolume(void)
 {
 	INT32 volume = _config.masterVol;
@@ -550,7 +765,9 @@ UINT32 PlayerA::Render(UINT32 bufSize, void* data)
 	UINT32 smplCount;
 	UINT32 smplRendered;
 	UINT32 curSmpl;
-	WAVE_32BS fnlSmpl;	// final sample value
+	UINT32 segLen;
+	UINT32 segSmpl;
+	bool fading;
 	INT32 curVolume;
 	
 	smplCount = bufSize / _outSmplSizeA;
@@ -579,9 +796,12 @@ UINT32 PlayerA::Render(UINT32 bufSize, void* data)
 	smplRendered = _player->Render(smplCount, &_smplBuf[0]);
 	smplCount = smplRendered;
 	
+	// process the samples in segments of constant volume
 	curVolume = CalcCurrentVolume(basePbSmpl) >> VOL_SHIFT;
-	for (curSmpl = 0; curSmpl < smplCount; curSmpl ++, basePbSmpl ++)
+	for (curSmpl = 0; curSmpl < smplCount; curSmpl += segLen, basePbSmpl += segLen)
 	{
+		segLen = smplCount - curSmpl;
+		fading = false;
 		if (basePbSmpl >= _fadeSmplStart)
 		{
 			UINT32 fadeSmpls = basePbSmpl - _fadeSmplStart;
@@ -593,6 +813,18 @@ UINT32 PlayerA::Render(UINT32 bufSize, void* data)
 			}
 			
 			curVolume = CalcCurrentVolume(basePbSmpl) >> VOL_SHIFT;
+			if (fadeSmpls < _config.fadeSmpls)
+			{
+				// The volume changes with every sample while fading.
+				// It is applied per sample then, but the conversion still works on the whole segment.
+				fading = true;
+				if (segLen > _config.fadeSmpls - fadeSmpls)
+					segLen = _config.fadeSmpls - fadeSmpls;
+			}
+		}
+		else if (segLen > _fadeSmplStart - basePbSmpl)
+		{
+			segLen = _fadeSmplStart - basePbSmpl;
 		}
 		if (basePbSmpl >= _endSilenceStart)
 		{
@@ -607,26 +839,53 @@ UINT32 PlayerA::Render(UINT32 bufSize, void* data)
 				// stop playback at this point, but we shouldn't really do this.
 				break;
 			}
+			if (silenceSmpls < _config.endSilenceSmpls && segLen > _config.endSilenceSmpls - silenceSmpls)
+				segLen = _config.endSilenceSmpls - silenceSmpls;
+		}
+		else if (segLen > _endSilenceStart - basePbSmpl)
+		{
+			segLen = _endSilenceStart - basePbSmpl;
 		}
 		
-		// Input is about 24 bits (some cores might output a bit more)
-		fnlSmpl = _smplBuf[curSmpl];
-		
-#ifdef VOLCALC64
-		fnlSmpl.L = (INT32)( ((INT64)fnlSmpl.L * curVolume) >> VOL_BITS );
-		fnlSmpl.R = (INT32)( ((INT64)fnlSmpl.R * curVolume) >> VOL_BITS );
-#else
-		fnlSmpl.L = ((fnlSmpl.L >> VOL_PRESH) * curVolume) >> VOL_POSTSH;
-		fnlSmpl.R = ((fnlSmpl.R >> VOL_PRESH) * curVolume) >> VOL_POSTSH;
-#endif
-		
-		if (_config.chnInvert & 0x01)
-			fnlSmpl.L = -fnlSmpl.L;
-		if (_config.chnInvert & 0x02)
-			fnlSmpl.R = -fnlSmpl.R;
+		if (_outSmplFmt == PLR_SMPLFMT_FLOAT)
+		{
+			// Input is about 24 bits, float output uses 1.0 = 0x800000.
+			float gainL = 1.0f / (float)((UINT64)1 << (VOL_BITS + 23));
+			float gainR = gainL;
+			if (_config.chnInvert & 0x01)
+				gainL = -gainL;
+			if (_config.chnInvert & 0x02)
+				gainR = -gainR;
+			if (fading)
+			{
+				for (segSmpl = 0; segSmpl < segLen; segSmpl ++)
+				{
+					float vol = (float)(CalcCurrentVolume(basePbSmpl + segSmpl) >> VOL_SHIFT);
+					SampleConv_toF32Blk(&bData[(curSmpl + segSmpl) * _outSmplSizeA], &_smplBuf[curSmpl + segSmpl], 1,
+						vol * gainL, vol * gainR);
+				}
+			}
+			else
+			{
+				SampleConv_toF32Blk(&bData[curSmpl * _outSmplSizeA], &_smplBuf[curSmpl], segLen,
+					(float)curVolume * gainL, (float)curVolume * gainR);
+			}
+			continue;
+		}
 		
-		_outSmplPack(&bData[(curSmpl * 2 + 0) * _outSmplSize1], fnlSmpl.L);
-		_outSmplPack(&bData[(curSmpl * 2 + 1) * _outSmplSize1], fnlSmpl.R);
+		if (fading)
+		{
+			for (segSmpl = 0; segSmpl < segLen; segSmpl ++)
+			{
+				curVolume = CalcCurrentVolume(basePbSmpl + segSmpl) >> VOL_SHIFT;
+				ApplySampleVolume(&_smplBuf[curSmpl + segSmpl], 1, curVolume, _config.chnInvert);
+			}
+		}
+		else
+		{
+			ApplySampleVolume(&_smplBuf[curSmpl], segLen, curVolume, _config.chnInvert);
+		}
+		_outSmplPack(&bData[curSmpl * _outSmplSizeA], &_smplBuf[curSmpl], segLen);
 	}
 	
 	return curSmpl * _outSmplSizeA;
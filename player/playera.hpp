@@ -17,6 +17,9 @@
 #define PLAYTIME_WITH_FADE	0x10	// include fade out time (looping songs only)
 #define PLAYTIME_WITH_SLNC	0x20	// include silence after songs
 
+#define PLR_SMPLFMT_INT		0x00	// integer samples (8 bit: unsigned, 16/24/32 bit: signed)
+#define PLR_SMPLFMT_FLOAT	0x01	// 32-bit floating point samples, full scale is -1.0 .. +1.0, not clipped
+
 // TODO: find a proper name for this class
 class PlayerA
 {
@@ -32,6 +35,7 @@ public:
 		double pbSpeed;
 	};
 	typedef void (*PLR_SMPL_PACK)(void* buffer, INT32 value);
+	typedef void (*PLR_SMPL_PACKBLK)(void* buffer, const WAVE_32BS* smpls, UINT32 count);
 
 	PlayerA();
 	~PlayerA();
@@ -39,7 +43,7 @@ public:
 	void UnregisterAllPlayers(void);
 	const std::vector<PlayerBase*>& GetRegisteredPlayers(void) const;
 	
-	UINT8 SetOutputSettings(UINT32 smplRate, UINT8 channels, UINT8 smplBits, UINT32 smplBufferLen);
+	UINT8 SetOutputSettings(UINT32 smplRate, UINT8 channels, UINT8 smplBits, UINT32 smplBufferLen, UINT8 smplFmt = PLR_SMPLFMT_INT);
 	UINT32 GetSampleRate(void) const;
 	void SetSampleRate(UINT32 sampleRate);
 	double GetPlaybackSpeed(void) const;
@@ -93,9 +97,10 @@ private:
 	
 	UINT8 _outSmplChns;
 	UINT8 _outSmplBits;
+	UINT8 _outSmplFmt;	// see PLR_SMPLFMT_ constants
 	UINT32 _outSmplSize1;	// for 1 channel
 	UINT32 _outSmplSizeA;	// for all channels
-	PLR_SMPL_PACK _outSmplPack;
+	PLR_SMPL_PACKBLK _outSmplPack;
 	std::vector<WAVE_32BS> _smplBuf;
 	PlayerBase* _player;
 	DATA_LOADER* _dLoad;
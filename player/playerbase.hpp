@@ -90,7 +90,7 @@ struct PLR_DEV_OPTS
 {
 	UINT32 emuCore[2];	// enforce a certain sound core (0 = use default, [1] is used for linked devices)
 	UINT8 srMode;		// sample rate mode (see DEVRI_SRMODE)
-	UINT8 resmplMode;	// resampling mode (0 - high quality, 1 - low quality, 2 - LQ down, HQ up)
+	UINT8 resmplMode;	// resampling mode (0 - high quality, 1 - low quality, 2 - LQ down, HQ up, 3/4 - windowed sinc, best quality)
 	UINT32 smplRate;	// emulaiton sample rate
 	UINT32 coreOpts;
 	PLR_MUTE_OPTS muteOpts;
@@ -100,6 +100,7 @@ struct PLR_DEV_OPTS
 struct PLR_GEN_OPTS
 {
 	UINT32 pbSpeed; // playback speed (16.16 fixed point scale, 0x10000 = 100%)
+	UINT32 resmplBufLimit;	// maximum size of each resampler's sample buffer (in samples), 0 = grow as needed
 };
 
 
@@ -106,6 +106,7 @@ S98Player::S98Player() :
 	UINT8 chipID;
 
 	_playOpts.genOpts.pbSpeed = 0x10000;
+	_playOpts.genOpts.resmplBufLimit = 0;
 
 	_lastTsMult = 0;
 	_lastTsDiv = 0;
@@ -1101,6 +1102,7 @@ UINT8 S98Player::Start(void)
 		{
 			UINT8 resmplMode = (devOpts != NULL) ? devOpts->resmplMode : RSMODE_LINEAR;
 			Resmpl_SetVals(&clDev->resmpl, resmplMode, 0x100, _outSmplRate);
+			Resmpl_SetBufferLimit(&clDev->resmpl, _playOpts.genOpts.resmplBufLimit);
 			if (deviceID == DEVID_YM2203 || deviceID == DEVID_YM2608)
 			{
 				// set SSG volume
@@ -14,6 +14,7 @@
 #include "../emu/Resampler.h"
 #include "../emu/SoundDevs.h"
 #include "../emu/EmuCores.h"
+#include "../emu/dac_control.h"
 #include "../emu/cores/sn764intf.h"	// for SN76496_CFG
 #include "../emu/cores/2612intf.h"
 #include "../emu/cores/segapcm.h"		// for SEGAPCM_CFG
@@ -28,6 +29,7 @@
 #include "../emu/cores/msm5232.h"		// for MSM5232_CFG
 
 #include "dblk_compr.h"
+#include "datacache.hpp"
 #include "../utils/StrUtils.h"
 #include "helper.h"
 #include "../emu/logging.h"
@@ -147,7 +149,11 @@ VGMPlayer::VGMPlayer() :
 	_playSmpl(0),
 	_curLoop(0),
 	_playState(0x00),
-	_psTrigger(0x00)
+	_psTrigger(0x00),
+	_renderBuf(NULL),
+	_renderSmpl(0),
+	_renderPool(NULL),
+	_queueDevCmds(0)
 {
 	UINT8 retVal;
 	UINT16 optChip;
@@ -157,7 +163,17 @@ VGMPlayer::VGMPlayer() :
 	
 	_playOpts.playbackHz = 0;
 	_playOpts.hardStopOld = 0;
+	_playOpts.seekKfInterval = 0;
+	_playOpts.seekKfMemLimit = 0x1000000;	// 16 MB
+	_playOpts.renderThreads = 0;
+	_playOpts.cmdEventCache = 1;
+	_playOpts.seekSkipTime = 0;
+	_playOpts.lazyDataBlocks = 0;
 	_playOpts.genOpts.pbSpeed = 0x10000;
+	_playOpts.genOpts.resmplBufLimit = 0;
+	ClearSeekIndex();
+	_cmdEvtPos = 0;
+	memset(_cmdEvtDevs, 0x00, sizeof(_cmdEvtDevs));
 
 	_lastTsMult = 0;
 	_lastTsDiv = 0;
@@ -200,7 +216,22 @@ VGMPlayer::VGMPlayer() :
 	if (retVal)
 		_cpcUTF16 = NULL;
 	memset(&_pcmComprTbl, 0x00, sizeof(PCM_COMPR_TBL));
+	for (size_t curBank = 0; curBank < _PCM_BANK_COUNT; curBank ++)
+	{
+		_pcmBank[curBank].shared = NULL;
+		_pcmBank[curBank].sharedSize = 0;
+	}
+	_yrwRom = NULL;
+	_yrwRomSize = 0;
+	_fileSize = 0;
+	_fileLoaded = 0;
+	_tagsPending = 0;
 	_tagList[0] = NULL;
+	_tagMutex = NULL;
+#ifdef VGMPLAYER_THREADING
+	if (OSMutex_Init(&_tagMutex, 0))
+		_tagMutex = NULL;
+#endif
 	return;
 }
 
@@ -211,9 +242,13 @@ VGMPlayer::~VGMPlayer()
 	if (_playState & PLAYSTATE_PLAY)
 		Stop();
 	UnloadFile();
+	FreeRenderPool();
+	DataCache_Release(_yrwRom);
 	
 	if (_cpcUTF16 != NULL)
 		CPConv_Deinit(_cpcUTF16);
+	if (_tagMutex != NULL)
+		OSMutex_Deinit(_tagMutex);
 	
 	return;
 }
@@ -252,7 +287,21 @@ UINT8 VGMPlayer::LoadFile(DATA_LOADER *dataLoader)
 		return 0xF0;	// invalid file
 	
 	_dLoad = dataLoader;
-	DataLoader_ReadAll(_dLoad);
+	std::vector<CMD_EVENT>().swap(_cmdEvents);
+	if (DataLoader_IsAsync(_dLoad))
+	{
+		// The file is loaded in the background, so only the header is required for now.
+		// The rest is waited for when it is accessed.
+		_fileSize = DataLoader_GetTotalSize(_dLoad);
+		_fileLoaded = 0;
+		WaitForFileData(_HDR_BUF_SIZE);
+	}
+	else
+	{
+		DataLoader_ReadAll(_dLoad);
+		_fileSize = DataLoader_GetSize(_dLoad);
+		_fileLoaded = _fileSize;
+	}
 	_fileData = DataLoader_GetData(_dLoad);
 	
 	// parse main header
@@ -265,7 +314,19 @@ UINT8 VGMPlayer::LoadFile(DATA_LOADER *dataLoader)
 	GenerateDeviceConfig();
 	
 	// parse tags
-	LoadTags();
+	if (_tagMutex != NULL)
+		OSMutex_Lock(_tagMutex);
+	_tagsPending = (_fileLoaded < _fileHdr.eofOfs);
+	if (_tagsPending)
+	{
+		_tagList[0] = NULL;	// loaded by GetTags()
+	}
+	else
+	{
+		LoadTags();
+	}
+	if (_tagMutex != NULL)
+		OSMutex_Unlock(_tagMutex);
 	
 	RefreshTSRates();	// make Tick2Sample etc. work
 	
@@ -314,11 +375,11 @@ UINT8 VGMPlayer::ParseHeader(void)
 		_fileHdr.volumeGain = _hdrBuffer[0x7C] - 0x100;
 	_fileHdr.volumeGain <<= 3;	// 3.5 fixed point -> 8.8 fixed point
 	
-	if (! _fileHdr.eofOfs || _fileHdr.eofOfs > DataLoader_GetSize(_dLoad))
+	if (! _fileHdr.eofOfs || _fileHdr.eofOfs > _fileSize)
 	{
 		emu_logf(&_logger, PLRLOG_WARN, "Invalid EOF Offset 0x%06X! (should be: 0x%06X)\n",
-				_fileHdr.eofOfs, DataLoader_GetSize(_dLoad));
-		_fileHdr.eofOfs = DataLoader_GetSize(_dLoad);	// catch invalid EOF values
+				_fileHdr.eofOfs, _fileSize);
+		_fileHdr.eofOfs = _fileSize;	// catch invalid EOF values
 	}
 	_fileHdr.dataEnd = _fileHdr.eofOfs;
 	// command data ends at the GD3 offset if:
@@ -326,6 +387,7 @@ UINT8 VGMPlayer::ParseHeader(void)
 	if (_fileHdr.gd3Ofs && (_fileHdr.gd3Ofs < _fileHdr.dataEnd && _fileHdr.gd3Ofs >= _fileHdr.dataOfs))
 		_fileHdr.dataEnd = _fileHdr.gd3Ofs;
 	
+	WaitForFileData(_fileHdr.extraHdrOfs + 0x0C);
 	if (_fileHdr.extraHdrOfs && _fileHdr.extraHdrOfs < _fileHdr.eofOfs)
 	{
 		UINT32 xhLen = ReadLE32(&_fileData[_fileHdr.extraHdrOfs]);
@@ -362,6 +424,7 @@ UINT8 VGMPlayer::ParseHeader(void)
 	{
 		if (GetChipCount(0x01))        // There must be an FM clock
 		{
+			WaitForFileData(_fileHdr.dataEnd);
 			ParseFileForFMClocks();
 			_v101Fix = 1;
 		}
@@ -369,7 +432,10 @@ UINT8 VGMPlayer::ParseHeader(void)
 	
 	_opl4YRW801Req = 0x00;
 	if (GetChipCount(0x0D))	// YMF278B / OPL4
+	{
+		WaitForFileData(_fileHdr.dataEnd);
 		ParseFileForOPL4ROMRequirement();
+	}
 	
 	return 0x00;
 }
@@ -377,7 +443,10 @@ UINT8 VGMPlayer::ParseHeader(void)
 void VGMPlayer::ParseXHdr_Data32(UINT32 fileOfs, std::vector<XHDR_DATA32>& xData)
 {
 	xData.clear();
-	if (! fileOfs || fileOfs >= DataLoader_GetSize(_dLoad))
+	if (! fileOfs)
+		return;
+	WaitForFileData(fileOfs + 0x01 + 0xFF * 0x05);	// count + maximum number of entries
+	if (fileOfs >= _fileLoaded)
 		return;
 	
 	UINT32 curPos = fileOfs;
@@ -386,7 +455,7 @@ void VGMPlayer::ParseXHdr_Data32(UINT32 fileOfs, std::vector<XHDR_DATA32>& xData
 	xData.resize(_fileData[curPos]);	curPos ++;
 	for (curChip = 0; curChip < xData.size(); curChip ++, curPos += 0x05)
 	{
-		if (curPos + 0x05 > DataLoader_GetSize(_dLoad))
+		if (curPos + 0x05 > _fileLoaded)
 		{
 			xData.resize(curChip);
 			break;
@@ -403,7 +472,10 @@ void VGMPlayer::ParseXHdr_Data32(UINT32 fileOfs, std::vector<XHDR_DATA32>& xData
 void VGMPlayer::ParseXHdr_Data16(UINT32 fileOfs, std::vector<XHDR_DATA16>& xData)
 {
 	xData.clear();
-	if (! fileOfs || fileOfs >= DataLoader_GetSize(_dLoad))
+	if (! fileOfs)
+		return;
+	WaitForFileData(fileOfs + 0x01 + 0xFF * 0x04);	// count + maximum number of entries
+	if (fileOfs >= _fileLoaded)
 		return;
 	
 	UINT32 curPos = fileOfs;
@@ -412,7 +484,7 @@ void VGMPlayer::ParseXHdr_Data16(UINT32 fileOfs, std::vector<XHDR_DATA16>& xData
 	xData.resize(_fileData[curPos]);	curPos ++;
 	for (curChip = 0; curChip < xData.size(); curChip ++, curPos += 0x04)
 	{
-		if (curPos + 0x04 > DataLoader_GetSize(_dLoad))
+		if (curPos + 0x04 > _fileLoaded)
 		{
 			xData.resize(curChip);
 			break;
@@ -427,6 +499,44 @@ void VGMPlayer::ParseXHdr_Data16(UINT32 fileOfs, std::vector<XHDR_DATA16>& xData
 	return;
 }
 
+void VGMPlayer::WaitForFileData(UINT32 endOfs)
+{
+	if (endOfs > _fileSize)
+		endOfs = _fileSize;
+	if (_fileLoaded >= endOfs)
+		return;
+	
+	DataLoader_ReadUntil(_dLoad, endOfs);
+	_fileLoaded = DataLoader_GetSize(_dLoad);
+	if (_fileLoaded < endOfs && DataLoader_GetStatus(_dLoad) == DLSTAT_LOADED)
+	{
+		// loading ended early (truncated/damaged file)
+		emu_logf(&_logger, PLRLOG_WARN, "File was truncated! (size 0x%06X, expected 0x%06X)\n", _fileLoaded, _fileSize);
+		_fileSize = _fileLoaded;
+		if (_fileHdr.eofOfs > _fileSize)
+			_fileHdr.eofOfs = _fileSize;
+		if (_fileHdr.dataEnd > _fileSize)
+			_fileHdr.dataEnd = _fileSize;
+	}
+	
+	return;
+}
+
+void VGMPlayer::WaitForCmdData(void)
+{
+	// all commands are shorter than 0x10 bytes, except for data blocks
+	WaitForFileData(_filePos + 0x10);
+	if (_fileData[_filePos] == 0x67 && _filePos + 0x07 <= _fileLoaded)
+	{
+		UINT32 dblkLen = ReadLE32(&_fileData[_filePos + 0x03]) & 0x7FFFFFFF;
+		if (dblkLen > _fileHdr.dataEnd - _filePos)
+			dblkLen = _fileHdr.dataEnd - _filePos;	// prevent overflow
+		WaitForFileData(_filePos + 0x07 + dblkLen);
+	}
+	
+	return;
+}
+
 UINT8 VGMPlayer::LoadTags(void)
 {
 	size_t curTag;
@@ -504,15 +614,23 @@ UINT8 VGMPlayer::UnloadFile(void)
 	_playState = 0x00;
 	_dLoad = NULL;
 	_fileData = NULL;
+	_fileSize = 0;
+	_fileLoaded = 0;
+	if (_tagMutex != NULL)
+		OSMutex_Lock(_tagMutex);
+	_tagsPending = 0;
+	for (size_t curTag = 0; curTag < _TAG_COUNT; curTag ++)
+		_tagData[curTag] = std::string();
+	_tagList[0] = NULL;
+	if (_tagMutex != NULL)
+		OSMutex_Unlock(_tagMutex);
 	_fileHdr.fileVer = 0xFFFFFFFF;
 	_fileHdr.dataOfs = 0x00;
 	_opl4YRW801Req = 0x00;
 	_devNames.clear();
 	_devices.clear();
 	_devCfgs.clear();
-	for (size_t curTag = 0; curTag < _TAG_COUNT; curTag ++)
-		_tagData[curTag] = std::string();
-	_tagList[0] = NULL;
+	std::vector<CMD_EVENT>().swap(_cmdEvents);
 	
 	return 0x00;
 }
@@ -524,6 +642,25 @@ const VGM_HEADER* VGMPlayer::GetFileHeader(void) const
 
 const char* const* VGMPlayer::GetTags(void)
 {
+	if (_tagMutex != NULL)
+		OSMutex_Lock(_tagMutex);
+	if (_tagsPending)
+	{
+		// Note: _fileLoaded isn't touched here, as this may be called while the playback thread loads data.
+		// ReadUntil waits for the loader thread. The tag data is only parsed when it is complete.
+		DataLoader_ReadUntil(_dLoad, _fileHdr.eofOfs);
+		if (DataLoader_GetSize(_dLoad) >= _fileHdr.eofOfs)
+		{
+			LoadTags();
+			_tagsPending = 0;
+		}
+		else if (DataLoader_GetStatus(_dLoad) == DLSTAT_LOADED)
+		{
+			_tagsPending = 0;	// file was truncated, there are no tags
+		}
+	}
+	if (_tagMutex != NULL)
+		OSMutex_Unlock(_tagMutex);
 	return _tagList;
 }
 
@@ -747,12 +884,15 @@ UINT8 VGMPlayer::SetDeviceOptions(UINT32 id, const PLR_DEV_OPTS& devOpts)
 	if (optID == (size_t)-1)
 		return 0x80;	// bad device ID
 	
+	UINT8 kfChange = (_devOpts[optID].coreOpts != devOpts.coreOpts);	// keyframes were rendered with the old options
 	_devOpts[optID] = devOpts;
 	
 	size_t devID = _optDevMap[optID];
 	if (devID < _devices.size())
 	{
 		DEV_INFO* devInf = &_devices[devID].base.defInf;
+		if (kfChange)
+			ClearSeekIndex();
 		RefreshDevOptions(_devices[devID], _devOpts[optID]);
 		RefreshMuting(_devices[devID], _devOpts[optID].muteOpts);
 		RefreshPanning(_devices[devID], _devOpts[optID].panOpts);
@@ -796,7 +936,19 @@ UINT8 VGMPlayer::GetDeviceMuting(UINT32 id, PLR_MUTE_OPTS& muteOpts) const
 
 UINT8 VGMPlayer::SetPlayerOptions(const VGM_PLAY_OPTIONS& playOpts)
 {
+	UINT8 kfChange = (_playOpts.seekKfInterval != playOpts.seekKfInterval ||
+					_playOpts.seekKfMemLimit != playOpts.seekKfMemLimit ||
+					_playOpts.seekSkipTime != playOpts.seekSkipTime ||	// keyframes stored while seeking depend on it
+					_playOpts.playbackHz != playOpts.playbackHz ||	// the keyframes' device states were rendered
+					_playOpts.hardStopOld != playOpts.hardStopOld ||	// with the old timing/command handling
+					_playOpts.genOpts.pbSpeed != playOpts.genOpts.pbSpeed);
+	if (_playOpts.renderThreads != playOpts.renderThreads)
+		FreeRenderPool();	// recreated with the new thread count by the next Render() call
+	if (_playOpts.cmdEventCache != playOpts.cmdEventCache)
+		std::vector<CMD_EVENT>().swap(_cmdEvents);	// rebuilt by the next Start() call
 	_playOpts = playOpts;
+	if (kfChange)
+		ClearSeekIndex();
 	RefreshTSRates();	// refresh, in case _playOpts.playbackHz changed
 	return 0x00;
 }
@@ -823,7 +975,12 @@ double VGMPlayer::GetPlaybackSpeed(void) const
 
 UINT8 VGMPlayer::SetPlaybackSpeed(double speed)
 {
-	_playOpts.genOpts.pbSpeed = (UINT32)(0x10000 * speed);
+	UINT32 pbSpeed = (UINT32)(0x10000 * speed);
+	if (_playOpts.genOpts.pbSpeed != pbSpeed)
+	{
+		_playOpts.genOpts.pbSpeed = pbSpeed;
+		ClearSeekIndex();	// keyframes were rendered with the old speed
+	}
 	RefreshTSRates();
 	return 0x00;
 }
@@ -960,10 +1117,24 @@ const std::vector<VGMPlayer::DACSTRM_DEV>& VGMPlayer::GetStreamDevInfo(void) con
 
 UINT8 VGMPlayer::Start(void)
 {
+	UINT8 chipType;
+	UINT8 chipID;
+	
 	InitDevices();
+	if (_cmdEvents.empty() && _fileLoaded >= _fileHdr.dataEnd)	// requires the whole command data
+		BuildCmdEvents();
+	for (chipType = 0; chipType < _CHIP_COUNT; chipType ++)
+	{
+		for (chipID = 0; chipID < 2; chipID ++)
+		{
+			size_t devID = _vdDevMap[chipType][chipID];
+			_cmdEvtDevs[(chipType << 1) | chipID] = (devID == (size_t)-1) ? NULL : &_devices[devID];
+		}
+	}
 	
 	_playState |= PLAYSTATE_PLAY;
 	Reset();
+	ClearSeekIndex();
 	if (_eventCbFunc != NULL)
 		_eventCbFunc(this, _eventCbParam, PLREVT_START, NULL);
 	
@@ -976,6 +1147,7 @@ UINT8 VGMPlayer::Stop(void)
 	size_t curBank;
 	
 	_playState &= ~PLAYSTATE_PLAY;
+	ClearSeekIndex();
 	
 	for (curDev = 0; curDev < _dacStreams.size(); curDev ++)
 	{
@@ -985,12 +1157,7 @@ UINT8 VGMPlayer::Stop(void)
 	_dacStreams.clear();
 	
 	for (curBank = 0x00; curBank < _PCM_BANK_COUNT; curBank ++)
-	{
-		PCM_BANK* pcmBnk = &_pcmBank[curBank];
-		pcmBnk->bankOfs.clear();
-		pcmBnk->bankSize.clear();
-		pcmBnk->data.clear();
-	}
+		ClearPCMBank(_pcmBank[curBank]);
 	free(_pcmComprTbl.values.d8);	_pcmComprTbl.values.d8 = NULL;
 	
 	for (curDev = 0; curDev < _devices.size(); curDev ++)
@@ -1034,12 +1201,7 @@ UINT8 VGMPlayer::Reset(void)
 	
 	// TODO (optimization): don't reset _pcmBank and instead skip data that was already loaded
 	for (curBank = 0x00; curBank < _PCM_BANK_COUNT; curBank++)
-	{
-		PCM_BANK* pcmBnk = &_pcmBank[curBank];
-		pcmBnk->bankOfs.clear();
-		pcmBnk->bankSize.clear();
-		pcmBnk->data.clear();
-	}
+		ClearPCMBank(_pcmBank[curBank]);
 	free(_pcmComprTbl.values.d8);	_pcmComprTbl.values.d8 = NULL;
 	memset(&_pcmComprTbl, 0x00, sizeof(PCM_COMPR_TBL));
 	
@@ -1651,6 +1813,8 @@ void VGMPlayer::InitDevices(void)
 			devInf->devDef = NULL;
 			continue;
 		}
+		if (chipDev.romWrite != NULL)	// optional: use ROM data from the file without copying it
+			SndEmu_GetDeviceFunc(devInf->devDef, RWF_MEMORY | RWF_WRITE, DEVRW_BLOCK_ALIAS, 0, (void**)&chipDev.romAlias);
 		sdCfg.deviceID = _devices.size();
 		
 		std::string devName = SndEmu_GetDevName(chipType, 0x00, devCfg);	// use short name for now
@@ -1715,6 +1879,7 @@ void VGMPlayer::InitDevices(void)
 			UINT8 resmplMode = (devOpts != NULL) ? devOpts->resmplMode : RSMODE_LINEAR;
 			
 			Resmpl_SetVals(&clDev->resmpl, resmplMode, chipVol, _outSmplRate);
+			Resmpl_SetBufferLimit(&clDev->resmpl, _playOpts.genOpts.resmplBufLimit);
 			Resmpl_DevConnect(&clDev->resmpl, &clDev->defInf);
 			Resmpl_Init(&clDev->resmpl);
 		}
@@ -1787,9 +1952,212 @@ VGMPlayer::CHIP_DEVICE* VGMPlayer::GetDevicePtr(UINT8 chipType, UINT8 chipID)
 	size_t devID = _vdDevMap[chipType][chipID];
 	if (devID == (size_t)-1)
 		return NULL;
+	// bring the device up to the current position before it receives any commands
+	// (not required in parallel mode, where commands are queued)
+	if (! _queueDevCmds)
+		RenderDevice(&_devices[devID], _renderSmpl);
 	return &_devices[devID];
 }
 
+void VGMPlayer::RenderDevice(CHIP_DEVICE* cDev, UINT32 endSmpl)
+{
+	if (_renderBuf == NULL)
+	{
+		// while seeking, the device is advanced to the time of the current command instead
+		if ((_playState & PLAYSTATE_SEEK) && _playOpts.seekSkipTime)
+			SkipDevice(cDev, Tick2Sample(_fileTick));
+		return;
+	}
+	
+	RenderDeviceBuf(cDev, endSmpl, _renderBuf);
+	return;
+}
+
+void VGMPlayer::RenderDeviceBuf(CHIP_DEVICE* cDev, UINT32 endSmpl, WAVE_32BS* buffer)
+{
+	size_t devID = cDev - &_devices[0];
+	DEV_CMD_QUEUE* cmdQueue = (devID < _devCmdQueues.size()) ? &_devCmdQueues[devID] : NULL;
+	
+	// send all queued commands up to endSmpl, each one at the position where it was issued
+	while(1)
+	{
+		const DEV_CMD* cmd = NULL;
+		UINT32 smplPos = endSmpl;
+		
+		if (cmdQueue != NULL && cmdQueue->pos < cmdQueue->cmds.size() &&
+			cmdQueue->cmds[cmdQueue->pos].smplPos <= endSmpl)
+		{
+			cmd = &cmdQueue->cmds[cmdQueue->pos];
+			smplPos = cmd->smplPos;
+		}
+		if (cDev->renderSmpl < smplPos)
+		{
+			UINT8 disable = (cDev->optID != (size_t)-1) ? _devOpts[cDev->optID].muteOpts.disable : 0x00;
+			VGM_BASEDEV* clDev;
+			for (clDev = &cDev->base; clDev != NULL; clDev = clDev->linkDev, disable >>= 1)
+			{
+				if (clDev->defInf.dataPtr != NULL && ! (disable & 0x01))
+					Resmpl_Execute(&clDev->resmpl, smplPos - cDev->renderSmpl, &buffer[cDev->renderSmpl]);
+			}
+			cDev->renderSmpl = smplPos;
+		}
+		if (cmd == NULL)
+			break;
+		SendDevCmd(cDev, *cmd);
+		cmdQueue->pos ++;
+	}
+	if (cmdQueue != NULL && cmdQueue->pos >= cmdQueue->cmds.size())
+	{
+		cmdQueue->cmds.clear();
+		cmdQueue->pos = 0;
+	}
+	
+	return;
+}
+
+void VGMPlayer::RenderAllDevices(UINT32 endSmpl)
+{
+	size_t curDev;
+	
+	for (curDev = 0; curDev < _devices.size(); curDev ++)
+		RenderDevice(&_devices[curDev], endSmpl);
+	
+	return;
+}
+
+void VGMPlayer::RenderDevicesParallel(UINT32 endSmpl)
+{
+#ifdef VGMPLAYER_THREADING
+	size_t taskCnt;
+	size_t curTask;
+	size_t curDev;
+	UINT32 curSmpl;
+	
+	// Devices that use the same core are rendered by the same task,
+	// because some cores keep scratch buffers in static variables.
+	if (_renderTasks.size() < _devices.size())
+		_renderTasks.resize(_devices.size());
+	taskCnt = 0;
+	for (curDev = 0; curDev < _devices.size(); curDev ++)
+	{
+		const CHIP_DEVICE& cDev = _devices[curDev];
+		if (cDev.renderSmpl >= endSmpl && _devCmdQueues[curDev].cmds.empty())
+			continue;
+		
+		for (curTask = 0; curTask < taskCnt; curTask ++)
+		{
+			const CHIP_DEVICE& taskDev = _devices[_renderTasks[curTask].devIDs[0]];
+			if (taskDev.base.defInf.devDef == cDev.base.defInf.devDef)
+				break;
+		}
+		RENDER_TASK& rTask = _renderTasks[curTask];
+		if (curTask == taskCnt)
+		{
+			rTask.player = this;
+			rTask.devIDs.clear();
+			rTask.startSmpl = cDev.renderSmpl;
+			rTask.endSmpl = endSmpl;
+			taskCnt ++;
+		}
+		else if (rTask.startSmpl > cDev.renderSmpl)
+		{
+			rTask.startSmpl = cDev.renderSmpl;
+		}
+		rTask.devIDs.push_back(curDev);
+	}
+	if (taskCnt <= 1 || ! endSmpl)
+		return;	// nothing to parallelize - the remaining work is done by RenderAllDevices()
+	
+	// render each task into a private buffer
+	for (curTask = 0; curTask < taskCnt; curTask ++)
+	{
+		RENDER_TASK& rTask = _renderTasks[curTask];
+		if (rTask.buffer.size() < endSmpl)
+			rTask.buffer.resize(endSmpl);
+		if (rTask.startSmpl < endSmpl)
+			memset(&rTask.buffer[rTask.startSmpl], 0x00, (endSmpl - rTask.startSmpl) * sizeof(WAVE_32BS));
+		if (ThreadPool_Submit(_renderPool, &VGMPlayer::RenderTaskFunc, &rTask))
+			RenderTaskFunc(&rTask);	// unable to queue - render on this thread
+	}
+	ThreadPool_Wait(_renderPool);
+	
+	// mix the results in a fixed order, so that the output doesn't depend on thread timing
+	for (curTask = 0; curTask < taskCnt; curTask ++)
+	{
+		const RENDER_TASK& rTask = _renderTasks[curTask];
+		for (curSmpl = rTask.startSmpl; curSmpl < endSmpl; curSmpl ++)
+		{
+			_renderBuf[curSmpl].L += rTask.buffer[curSmpl].L;
+			_renderBuf[curSmpl].R += rTask.buffer[curSmpl].R;
+		}
+	}
+#endif
+	
+	return;
+}
+
+/*static*/ void VGMPlayer::RenderTaskFunc(void* param)
+{
+	RENDER_TASK* rTask = (RENDER_TASK*)param;
+	VGMPlayer* player = rTask->player;
+	size_t curDev;
+	
+	for (curDev = 0; curDev < rTask->devIDs.size(); curDev ++)
+		player->RenderDeviceBuf(&player->_devices[rTask->devIDs[curDev]], rTask->endSmpl, &rTask->buffer[0]);
+	
+	return;
+}
+
+void VGMPlayer::FreeRenderPool(void)
+{
+#ifdef VGMPLAYER_THREADING
+	if (_renderPool != NULL)
+	{
+		ThreadPool_Deinit(_renderPool);
+		_renderPool = NULL;
+	}
+#endif
+	_renderTasks.clear();
+	
+	return;
+}
+
+void VGMPlayer::QueueDevCmd(CHIP_DEVICE* cDev, UINT8 type, UINT16 ofs, UINT16 data)
+{
+	DEV_CMD cmd;
+	
+	cmd.smplPos = _renderSmpl;
+	cmd.type = type;
+	cmd.ofs = ofs;
+	cmd.data = data;
+	_devCmdQueues[cDev - &_devices[0]].cmds.push_back(cmd);
+	
+	return;
+}
+
+void VGMPlayer::SendDevCmd(CHIP_DEVICE* cDev, const DEV_CMD& cmd)
+{
+	void* dataPtr = cDev->base.defInf.dataPtr;
+	
+	switch(cmd.type)
+	{
+	case DEVRW_A8D8:
+		cDev->write8(dataPtr, (UINT8)cmd.ofs, (UINT8)cmd.data);
+		break;
+	case DEVRW_A16D8:
+		cDev->writeM8(dataPtr, cmd.ofs, (UINT8)cmd.data);
+		break;
+	case DEVRW_A8D16:
+		cDev->writeD16(dataPtr, (UINT8)cmd.ofs, cmd.data);
+		break;
+	case DEVRW_A16D16:
+		cDev->writeM16(dataPtr, cmd.ofs, cmd.data);
+		break;
+	}
+	
+	return;
+}
+
 void VGMPlayer::ParseFileForOPL4ROMRequirement(void)
 {
 	UINT32 filePos = _fileHdr.dataOfs;
@@ -1900,7 +2268,13 @@ void VGMPlayer::LoadOPL4ROM(CHIP_DEVICE* chipDev)
 		return;
 	emu_logf(&_logger, PLRLOG_DEBUG, "OPL4 requires external sample ROM %s.\n", romFile);
 	
-	if (_yrwRom.empty())
+	// The ROM is shared by all players and cached by its file name, so that it is read only once per process.
+	// (A file with this name is always a dump of the same ROM.)
+	UINT32 nameLen = (UINT32)strlen(romFile);
+	UINT64 nameHash = DataCache_Hash(romFile, nameLen, DCACHE_HASH_INIT);
+	if (_yrwRom == NULL)
+		_yrwRom = DataCache_Acquire(nameHash, romFile, nameLen, &_yrwRomSize);
+	if (_yrwRom == NULL)
 	{
 		if (_fileReqCbFunc == NULL)
 		{
@@ -1918,18 +2292,123 @@ void VGMPlayer::LoadOPL4ROM(CHIP_DEVICE* chipDev)
 		UINT32 yrwSize = DataLoader_GetSize(romDLoad);
 		const UINT8* yrwData = DataLoader_GetData(romDLoad);
 		if (yrwSize > 0 && yrwData != NULL)
-			_yrwRom.assign(yrwData, yrwData + yrwSize);
+		{
+			UINT8* romCopy = (UINT8*)malloc(yrwSize);
+			if (romCopy != NULL)
+			{
+				memcpy(romCopy, yrwData, yrwSize);
+				_yrwRom = DataCache_Insert(nameHash, romFile, nameLen, romCopy, yrwSize);
+				_yrwRomSize = yrwSize;
+			}
+		}
 		DataLoader_Deinit(romDLoad);
 	}
-	if (_yrwRom.empty())
+	if (_yrwRom == NULL)
 	{
 		emu_logf(&_logger, PLRLOG_WARN, "Couldn't load %s.\n", romFile);
 		return;
 	}
 	
+	DEVFUNC_ALIAS_BLOCK romAlias = NULL;
+	SndEmu_GetDeviceFunc(chipDev->base.defInf.devDef, RWF_MEMORY | RWF_WRITE, DEVRW_BLOCK_ALIAS, 0x524F, (void**)&romAlias);
+	if (romAlias != NULL)
+	{
+		romAlias(chipDev->base.defInf.dataPtr, _yrwRomSize, _yrwRom);
+		return;
+	}
 	if (chipDev->romSize != NULL)
-		chipDev->romSize(chipDev->base.defInf.dataPtr, (UINT32)_yrwRom.size());
-	chipDev->romWrite(chipDev->base.defInf.dataPtr, 0x00, (UINT32)_yrwRom.size(), &_yrwRom[0]);
+		chipDev->romSize(chipDev->base.defInf.dataPtr, _yrwRomSize);
+	chipDev->romWrite(chipDev->base.defInf.dataPtr, 0x00, _yrwRomSize, _yrwRom);
+	
+	return;
+}
+
+/*static*/ const UINT8* VGMPlayer::GetPCMBankData(const PCM_BANK& pcmBnk)
+{
+	if (pcmBnk.shared != NULL)
+		return pcmBnk.shared;
+	return pcmBnk.data.empty() ? NULL : &pcmBnk.data[0];
+}
+
+/*static*/ UINT32 VGMPlayer::GetPCMBankSize(const PCM_BANK& pcmBnk)
+{
+	if (pcmBnk.shared != NULL)
+		return pcmBnk.sharedSize;
+	return (UINT32)pcmBnk.data.size();
+}
+
+// make a private copy of shared bank data, so that it can be modified
+/*static*/ void VGMPlayer::UnsharePCMBank(PCM_BANK& pcmBnk)
+{
+	if (pcmBnk.shared == NULL)
+		return;
+	
+	pcmBnk.data.assign(pcmBnk.shared, pcmBnk.shared + pcmBnk.sharedSize);
+	DataCache_Release(pcmBnk.shared);
+	pcmBnk.shared = NULL;
+	pcmBnk.sharedSize = 0;
+	
+	return;
+}
+
+/*static*/ void VGMPlayer::ClearPCMBank(PCM_BANK& pcmBnk)
+{
+	DataCache_Release(pcmBnk.shared);
+	pcmBnk.shared = NULL;
+	pcmBnk.sharedSize = 0;
+	pcmBnk.bankOfs.clear();
+	pcmBnk.bankSize.clear();
+	pcmBnk.pending.clear();
+	pcmBnk.data.clear();
+	
+	return;
+}
+
+void VGMPlayer::SkipDevice(CHIP_DEVICE* cDev, UINT32 smplPos)
+{
+	UINT8 disable;
+	VGM_BASEDEV* clDev;
+	
+	if (smplPos <= cDev->skipSmpl)
+		return;
+	
+	disable = (cDev->optID != (size_t)-1) ? _devOpts[cDev->optID].muteOpts.disable : 0x00;
+	for (clDev = &cDev->base; clDev != NULL; clDev = clDev->linkDev, disable >>= 1)
+	{
+		const RESMPL_STATE* rsmpl = &clDev->resmpl;
+		UINT64 smplStart;
+		UINT64 smplEnd;
+		
+		if (clDev->defInf.dataPtr == NULL || (disable & 0x01) || ! rsmpl->smpRateDst)
+			continue;
+		// convert the playback sample positions to the device's sample rate
+		smplStart = (UINT64)cDev->skipSmpl * rsmpl->smpRateSrc / rsmpl->smpRateDst;
+		smplEnd = (UINT64)smplPos * rsmpl->smpRateSrc / rsmpl->smpRateDst;
+		if (smplEnd > smplStart)
+			SndEmu_Skip(&clDev->defInf, (UINT32)(smplEnd - smplStart));
+	}
+	cDev->skipSmpl = smplPos;
+	
+	return;
+}
+
+void VGMPlayer::SkipAllDevices(UINT32 smplPos)
+{
+	size_t curDev;
+	
+	for (curDev = 0; curDev < _devices.size(); curDev ++)
+		SkipDevice(&_devices[curDev], smplPos);
+	
+	return;
+}
+
+void VGMPlayer::BeginDeviceSkip(void)
+{
+	size_t curDev;
+	
+	// the devices were rendered up to the current playback position
+	for (curDev = 0; curDev < _devices.size(); curDev ++)
+		_devices[curDev].skipSmpl = _playSmpl;
 	
 	return;
 }
@@ -1940,7 +2419,7 @@ UINT8 VGMPlayer::Seek(UINT8 unit, UINT32 pos)
 	{
 	case PLAYPOS_FILEOFS:
 		_playState |= PLAYSTATE_SEEK;
-		if (pos < _filePos)
+		if (pos < _filePos && SeekToKeyframe(PLAYPOS_FILEOFS, pos))
 			Reset();
 		return SeekToFilePos(pos);
 	case PLAYPOS_SAMPLE:
@@ -1948,7 +2427,7 @@ UINT8 VGMPlayer::Seek(UINT8 unit, UINT32 pos)
 		// fall through
 	case PLAYPOS_TICK:
 		_playState |= PLAYSTATE_SEEK;
-		if (pos < _playTick)
+		if (SeekToKeyframe(PLAYPOS_TICK, pos) && pos < _playTick)
 			Reset();
 		return SeekToTick(pos);
 	case PLAYPOS_COMMAND:
@@ -1960,9 +2439,16 @@ UINT8 VGMPlayer::Seek(UINT8 unit, UINT32 pos)
 UINT8 VGMPlayer::SeekToTick(UINT32 tick)
 {
 	_playState |= PLAYSTATE_SEEK;
+	if (_playOpts.seekSkipTime)
+		BeginDeviceSkip();
 	if (tick > _playTick)
+	{
 		ParseFile(tick - _playTick);
-	_playSmpl = Tick2Sample(_playTick);
+		_playSmpl = Tick2Sample(_playTick);
+	}
+	// else: keep the sample position, e.g. the one restored from a keyframe
+	if (_playOpts.seekSkipTime)
+		SkipAllDevices(_playSmpl);
 	_playState &= ~PLAYSTATE_SEEK;
 	return 0x00;
 }
@@ -1970,8 +2456,12 @@ UINT8 VGMPlayer::SeekToTick(UINT32 tick)
 UINT8 VGMPlayer::SeekToFilePos(UINT32 pos)
 {
 	_playState |= PLAYSTATE_SEEK;
+	if (_playOpts.seekSkipTime)
+		BeginDeviceSkip();
 	while(_filePos < _fileHdr.dataEnd && _filePos <= pos && ! (_playState & PLAYSTATE_END))
 	{
+		if (_fileLoaded < _fileHdr.dataEnd)
+			WaitForCmdData();
 		UINT8 curCmd = _fileData[_filePos];
 		COMMAND_FUNC func = _CMD_INFO[curCmd].func;
 		(this->*func)();
@@ -1979,6 +2469,8 @@ UINT8 VGMPlayer::SeekToFilePos(UINT32 pos)
 	}
 	_playTick = _fileTick;
 	_playSmpl = Tick2Sample(_playTick);
+	if (_playOpts.seekSkipTime)
+		SkipAllDevices(_playSmpl);
 	
 	if (_filePos >= _fileHdr.dataEnd)
 	{
@@ -2001,37 +2493,61 @@ UINT32 VGMPlayer::Render(UINT32 smplCnt, WAVE_32BS* data)
 	INT32 smplStep;	// might be negative due to rounding errors in Tick2Sample
 	size_t curDev;
 	
+	// Devices are rendered lazily: A device is only rendered up to the current position when it receives
+	// a command (see GetDevicePtr) and at the end of the buffer, so that each device is split only at its own writes.
+	// This doesn't change the output, because the resamplers give the same results for any block split.
+	// (Resmpl_Exec_LinearDown must stay that way - the old block-relative version would change the output here.)
+	_renderBuf = data;
+	for (curDev = 0; curDev < _devices.size(); curDev ++)
+		_devices[curDev].renderSmpl = 0;
+#ifdef VGMPLAYER_THREADING
+	// In parallel mode, register writes are queued while parsing and the devices are rendered
+	// on the worker threads at the end of the buffer.
+	if (_playOpts.renderThreads > 1 && _renderPool == NULL)
+	{
+		if (ThreadPool_Init(&_renderPool, _playOpts.renderThreads - 1))
+		{
+			emu_logf(&_logger, PLRLOG_WARN, "Unable to create render threads. Rendering on a single thread.\n");
+			_renderPool = NULL;
+			_playOpts.renderThreads = 0;
+		}
+	}
+	_queueDevCmds = (_renderPool != NULL && _devices.size() > 1);
+	if (_queueDevCmds && _devCmdQueues.size() < _devices.size())
+		_devCmdQueues.resize(_devices.size());
+#endif
+	
 	// Note: use do {} while(), so that "smplCnt == 0" can be used to process until reaching the next sample.
 	curSmpl = 0;
 	do
 	{
+		_renderSmpl = curSmpl;
 		smplFileTick = Sample2Tick(_playSmpl);
 		ParseFile(smplFileTick - _playTick);
 		
 		// render as many samples at once as possible (for better performance)
 		maxSmpl = Tick2Sample(_fileTick);
 		smplStep = maxSmpl - _playSmpl;
-		// When DAC streams are active, limit step size to 1, so that DAC streams and sound chip emulation are in sync.
-		if (smplStep < 1 || ! _dacStreams.empty())
+		if (smplStep < 1)
 			smplStep = 1;	// must render at least 1 sample in order to advance
 		if ((UINT32)smplStep > smplCnt - curSmpl)
 			smplStep = smplCnt - curSmpl;
-		
-		for (curDev = 0; curDev < _devices.size(); curDev ++)
+		// When DAC streams are active, end the block at the sample where the next stream command is sent,
+		// so that DAC streams and sound chip emulation are in sync.
+		for (curDev = 0; curDev < _dacStreams.size(); curDev ++)
 		{
-			CHIP_DEVICE* cDev = &_devices[curDev];
-			UINT8 disable = (cDev->optID != (size_t)-1) ? _devOpts[cDev->optID].muteOpts.disable : 0x00;
-			VGM_BASEDEV* clDev;
-			
-			for (clDev = &cDev->base; clDev != NULL; clDev = clDev->linkDev, disable >>= 1)
-			{
-				if (clDev->defInf.dataPtr != NULL && ! (disable & 0x01))
-					Resmpl_Execute(&clDev->resmpl, smplStep, &data[curSmpl]);
-			}
+			UINT32 dacStep = daccontrol_get_next_write(_dacStreams[curDev].defInf.dataPtr);
+			if (dacStep < (UINT32)smplStep)
+				smplStep = (INT32)dacStep;
 		}
+		
 		for (curDev = 0; curDev < _dacStreams.size(); curDev ++)
 		{
-			DEV_INFO* dacDInf = &_dacStreams[curDev].defInf;
+			DACSTRM_DEV* dacStrm = &_dacStreams[curDev];
+			DEV_INFO* dacDInf = &dacStrm->defInf;
+			// the stream sends its command at the end of the block, so the chip has to be rendered up to there
+			if (dacStrm->destDevID < _devices.size() && daccontrol_get_next_write(dacDInf->dataPtr) <= (UINT32)smplStep)
+				RenderDevice(&_devices[dacStrm->destDevID], curSmpl + smplStep);
 			dacDInf->devDef->Update(dacDInf->dataPtr, smplStep, NULL);
 		}
 		
@@ -2044,22 +2560,57 @@ UINT32 VGMPlayer::Render(UINT32 smplCnt, WAVE_32BS* data)
 		}
 	} while(curSmpl < smplCnt);
 	
+	if (_queueDevCmds)
+	{
+		_queueDevCmds = 0;
+		RenderDevicesParallel(curSmpl);
+	}
+	RenderAllDevices(curSmpl);
+	_renderBuf = NULL;
+	
 	return curSmpl;
 }
 
 void VGMPlayer::ParseFile(UINT32 ticks)
 {
+	UINT32 endTick;
+	
 	_playTick += ticks;
 	if (_playState & PLAYSTATE_END)
 		return;
 	
-	while(_filePos < _fileHdr.dataEnd && _fileTick <= _playTick && ! (_playState & PLAYSTATE_END))
+	endTick = _playTick;
+	do
 	{
-		UINT8 curCmd = _fileData[_filePos];
-		COMMAND_FUNC func = _CMD_INFO[curCmd].func;
-		(this->*func)();
-		_filePos += _CMD_INFO[curCmd].cmdLen;
-	}
+		// When seeking, stop at the position of the next keyframe, so that the seek index is built while parsing.
+		// When rendering, the devices can only be saved at the current sample, so all of its commands are parsed first.
+		_playTick = ((_playState & PLAYSTATE_SEEK) && _kfNextTick < endTick) ? _kfNextTick : endTick;
+		while(_filePos < _fileHdr.dataEnd && _fileTick <= _playTick && ! (_playState & PLAYSTATE_END))
+		{
+			if (! _cmdEvents.empty())
+			{
+				if (_cmdEvtPos >= _cmdEvents.size() || _cmdEvents[_cmdEvtPos].filePos != _filePos)
+					_cmdEvtPos = FindCmdEvent(_filePos);	// the file position was changed by a jump or a data block
+				if (_cmdEvtPos < _cmdEvents.size())
+				{
+					ProcessCmdEvent(_cmdEvents[_cmdEvtPos]);
+					_cmdEvtPos ++;
+					continue;
+				}
+			}
+			if (_fileLoaded < _fileHdr.dataEnd)
+				WaitForCmdData();
+			UINT8 curCmd = _fileData[_filePos];
+			COMMAND_FUNC func = _CMD_INFO[curCmd].func;
+			(this->*func)();
+			_filePos += _CMD_INFO[curCmd].cmdLen;
+		}
+		if (_filePos >= _fileHdr.dataEnd || (_playState & PLAYSTATE_END))
+			break;
+		if (_playTick >= _kfNextTick)
+			SaveKeyframe();
+	} while(_playTick < endTick);
+	_playTick = endTick;
 	
 	if (_p2612Fix & P2612FIX_ACTIVE)
 	{
@@ -2072,7 +2623,10 @@ void VGMPlayer::ParseFile(UINT32 ticks)
 		size_t devID = (optID == (size_t)-1) ? (size_t)-1 : _optDevMap[optID];
 		// refresh options, removing OPT_YM2612_LEGACY_MODE
 		if (devID < _devices.size())
+		{
+			RenderDevice(&_devices[devID], _renderSmpl);
 			RefreshDevOptions(_devices[devID], _devOpts[optID]);
+		}
 	}
 	
 	if (_filePos >= _fileHdr.dataEnd)
@@ -2089,6 +2643,338 @@ void VGMPlayer::ParseFile(UINT32 ticks)
 	return;
 }
 
+void VGMPlayer::ClearSeekIndex(void)
+{
+	_keyframes.clear();
+	_kfMemUsage = 0;
+	_kfInterval = _playOpts.seekKfInterval;
+	_kfNextTick = (UINT32)-1;
+	if (_kfInterval)
+	{
+		// the next keyframe is stored when parsing beyond the current position
+		UINT32 kfTick = (_playTick / _kfInterval + 1) * _kfInterval;
+		if (kfTick > _playTick)
+			_kfNextTick = kfTick;
+	}
+	
+	return;
+}
+
+void VGMPlayer::SaveKeyframe(void)
+{
+	size_t curDev;
+	size_t curBank;
+	size_t stateSize;
+	size_t rsmplSize;
+	size_t kfSize;
+	UINT32 devStSize;
+	UINT32 playSmpl;
+	UINT8* stPtr;
+	
+	// make the device states match the current position
+	if (_playState & PLAYSTATE_SEEK)
+	{
+		playSmpl = Tick2Sample(_playTick);
+		if (_playOpts.seekSkipTime)
+			SkipAllDevices(playSmpl);	// (RenderDevice would advance them to the next command)
+	}
+	else
+	{
+		// Render() parses the commands at the start of the sample _playSmpl, so the devices are rendered up to there.
+		playSmpl = _playSmpl;
+		RenderAllDevices(_renderSmpl);
+	}
+	stateSize = 0;
+	rsmplSize = 0;
+	for (curDev = 0; curDev < _devices.size(); curDev ++)
+	{
+		VGM_BASEDEV* clDev;
+		for (clDev = &_devices[curDev].base; clDev != NULL; clDev = clDev->linkDev)
+		{
+			if (clDev->defInf.dataPtr == NULL)
+				continue;
+			devStSize = SndEmu_GetStateSize(&clDev->defInf);
+			if (! devStSize)
+			{
+				emu_logf(&_logger, PLRLOG_DEBUG, "Seek index disabled: %s doesn't support saving its state.\n",
+					_devNames[curDev].c_str());
+				ClearSeekIndex();
+				_kfNextTick = (UINT32)-1;
+				return;
+			}
+			stateSize += devStSize;
+			rsmplSize += sizeof(UINT32) + Resmpl_GetStateSize(&clDev->resmpl);
+		}
+	}
+	for (curDev = 0; curDev < _dacStreams.size(); curDev ++)
+		stateSize += SndEmu_GetStateSize(&_dacStreams[curDev].defInf);
+	kfSize = sizeof(SEEK_KEYFRAME) + stateSize + rsmplSize + _dacStreams.size() * sizeof(DACSTRM_DEV) +
+			_PCM_BANK_COUNT * 2 * sizeof(UINT32);
+	
+	// When running out of memory, drop every 2nd keyframe and double the interval.
+	while(! _keyframes.empty() && _kfMemUsage + kfSize > _playOpts.seekKfMemLimit)
+	{
+		size_t curKf;
+		size_t dstKf = 0;
+		for (curKf = 1; curKf < _keyframes.size(); curKf += 2, dstKf ++)
+			_keyframes[dstKf] = _keyframes[curKf];
+		_keyframes.resize(dstKf);
+		_kfInterval *= 2;
+		_kfMemUsage = 0;
+		for (curKf = 0; curKf < _keyframes.size(); curKf ++)
+			_kfMemUsage += sizeof(SEEK_KEYFRAME) + _keyframes[curKf].stateData.size() + _keyframes[curKf].rsmplData.size() +
+							_keyframes[curKf].dacStreams.size() * sizeof(DACSTRM_DEV) +
+							_PCM_BANK_COUNT * 2 * sizeof(UINT32);
+	}
+	if (kfSize > _playOpts.seekKfMemLimit)
+	{
+		emu_logf(&_logger, PLRLOG_DEBUG, "Seek index disabled: keyframe size exceeds memory limit.\n");
+		_kfNextTick = (UINT32)-1;
+		return;
+	}
+	_kfNextTick = _playTick + _kfInterval;
+	if (_kfNextTick < _playTick)
+		_kfNextTick = (UINT32)-1;	// overflow
+	
+	_keyframes.push_back(SEEK_KEYFRAME());
+	SEEK_KEYFRAME& kf = _keyframes.back();
+	kf.filePos = _filePos;
+	kf.fileTick = _fileTick;
+	kf.playTick = _playTick;
+	kf.playSmpl = playSmpl;
+	kf.curLoop = _curLoop;
+	kf.lastLoopTick = _lastLoopTick;
+	kf.ym2612pcm_bnkPos = _ym2612pcm_bnkPos;
+	memcpy(kf.rf5cBank, _rf5cBank, sizeof(_rf5cBank));
+	memcpy(kf.qsWork, _qsWork, sizeof(_qsWork));
+	kf.pcmDataSize.resize(_PCM_BANK_COUNT);
+	kf.pcmBlkCount.resize(_PCM_BANK_COUNT);
+	for (curBank = 0x00; curBank < _PCM_BANK_COUNT; curBank ++)
+	{
+		kf.pcmDataSize[curBank] = GetPCMBankSize(_pcmBank[curBank]);
+		kf.pcmBlkCount[curBank] = (UINT32)_pcmBank[curBank].bankOfs.size();
+	}
+	kf.dacStreams = _dacStreams;
+	
+	kf.stateData.resize(stateSize);
+	stPtr = kf.stateData.empty() ? NULL : &kf.stateData[0];
+	for (curDev = 0; curDev < _devices.size(); curDev ++)
+	{
+		VGM_BASEDEV* clDev;
+		for (clDev = &_devices[curDev].base; clDev != NULL; clDev = clDev->linkDev)
+		{
+			if (clDev->defInf.dataPtr == NULL)
+				continue;
+			devStSize = SndEmu_GetStateSize(&clDev->defInf);
+			SndEmu_SaveState(&clDev->defInf, devStSize, stPtr);
+			stPtr += devStSize;
+		}
+	}
+	for (curDev = 0; curDev < _dacStreams.size(); curDev ++)
+	{
+		DEV_INFO* dacDInf = &_dacStreams[curDev].defInf;
+		devStSize = SndEmu_GetStateSize(dacDInf);
+		SndEmu_SaveState(dacDInf, devStSize, stPtr);
+		stPtr += devStSize;
+	}
+	// The resampler positions are saved as well, so that the output continues seamlessly.
+	kf.rsmplData.resize(rsmplSize);
+	stPtr = kf.rsmplData.empty() ? NULL : &kf.rsmplData[0];
+	for (curDev = 0; curDev < _devices.size(); curDev ++)
+	{
+		VGM_BASEDEV* clDev;
+		for (clDev = &_devices[curDev].base; clDev != NULL; clDev = clDev->linkDev)
+		{
+			if (clDev->defInf.dataPtr == NULL)
+				continue;
+			devStSize = Resmpl_GetStateSize(&clDev->resmpl);
+			memcpy(stPtr, &devStSize, sizeof(UINT32));
+			Resmpl_SaveState(&clDev->resmpl, stPtr + sizeof(UINT32));
+			stPtr += sizeof(UINT32) + devStSize;
+		}
+	}
+	_kfMemUsage += kfSize;
+	
+	return;
+}
+
+UINT8 VGMPlayer::LoadKeyframe(size_t kfID)
+{
+	const SEEK_KEYFRAME& kf = _keyframes[kfID];
+	size_t curDev;
+	size_t curBank;
+	size_t curStrm;
+	UINT32 devStSize;
+	const UINT8* stPtr;
+	const UINT8* rsPtr;
+	
+	// PCM data and DAC streams can only be rolled back, as data that wasn't parsed yet is missing.
+	if (kf.dacStreams.size() > _dacStreams.size())
+		return 0xFF;
+	for (curBank = 0x00; curBank < _PCM_BANK_COUNT; curBank ++)
+	{
+		const PCM_BANK* pcmBnk = &_pcmBank[curBank];
+		if (kf.pcmDataSize[curBank] > GetPCMBankSize(*pcmBnk) || kf.pcmBlkCount[curBank] > pcmBnk->bankOfs.size())
+			return 0xFF;
+	}
+	
+	stPtr = kf.stateData.empty() ? NULL : &kf.stateData[0];
+	for (curDev = 0; curDev < _devices.size(); curDev ++)
+	{
+		VGM_BASEDEV* clDev;
+		for (clDev = &_devices[curDev].base; clDev != NULL; clDev = clDev->linkDev)
+		{
+			if (clDev->defInf.dataPtr == NULL)
+				continue;
+			devStSize = SndEmu_GetStateSize(&clDev->defInf);
+			if (SndEmu_LoadState(&clDev->defInf, devStSize, stPtr))
+			{
+				Reset();	// devices are in an undefined state now
+				return 0xFF;
+			}
+			stPtr += devStSize;
+		}
+	}
+	rsPtr = kf.rsmplData.empty() ? NULL : &kf.rsmplData[0];
+	for (curDev = 0; curDev < _devices.size(); curDev ++)
+	{
+		VGM_BASEDEV* clDev;
+		for (clDev = &_devices[curDev].base; clDev != NULL; clDev = clDev->linkDev)
+		{
+			if (clDev->defInf.dataPtr == NULL)
+				continue;
+			memcpy(&devStSize, rsPtr, sizeof(UINT32));
+			if (Resmpl_LoadState(&clDev->resmpl, devStSize, rsPtr + sizeof(UINT32)))
+			{
+				Reset();
+				return 0xFF;
+			}
+			rsPtr += sizeof(UINT32) + devStSize;
+		}
+	}
+	
+	for (curBank = 0x00; curBank < _PCM_BANK_COUNT; curBank ++)
+	{
+		PCM_BANK* pcmBnk = &_pcmBank[curBank];
+		if (! kf.pcmDataSize[curBank])
+			ClearPCMBank(*pcmBnk);
+		else if (kf.pcmDataSize[curBank] < GetPCMBankSize(*pcmBnk))
+			UnsharePCMBank(*pcmBnk);	// shared data can't be cut
+		if (pcmBnk->shared == NULL)
+			pcmBnk->data.resize(kf.pcmDataSize[curBank]);
+		while(! pcmBnk->pending.empty() && pcmBnk->pending.back().bankOfs >= kf.pcmDataSize[curBank])
+			pcmBnk->pending.pop_back();	// remove blocks that were loaded after the keyframe
+		pcmBnk->bankOfs.resize(kf.pcmBlkCount[curBank]);
+		pcmBnk->bankSize.resize(kf.pcmBlkCount[curBank]);
+	}
+	
+	// remove DAC streams that were created after the keyframe
+	for (curStrm = kf.dacStreams.size(); curStrm < _dacStreams.size(); curStrm ++)
+	{
+		DEV_INFO* devInf = &_dacStreams[curStrm].defInf;
+		devInf->devDef->Stop(devInf->dataPtr);
+	}
+	_dacStreams.resize(kf.dacStreams.size());
+	for (curStrm = 0; curStrm < 0x100; curStrm ++)
+		_dacStrmMap[curStrm] = (size_t)-1;
+	for (curStrm = 0; curStrm < _dacStreams.size(); curStrm ++)
+	{
+		DACSTRM_DEV* dacStrm = &_dacStreams[curStrm];
+		DEV_INFO defInf = dacStrm->defInf;
+		
+		*dacStrm = kf.dacStreams[curStrm];
+		dacStrm->defInf = defInf;
+		_dacStrmMap[dacStrm->streamID] = curStrm;
+		devStSize = SndEmu_GetStateSize(&defInf);
+		if (SndEmu_LoadState(&defInf, devStSize, stPtr))
+		{
+			Reset();
+			return 0xFF;
+		}
+		stPtr += devStSize;
+		if (dacStrm->bankID < _PCM_BANK_COUNT)
+		{
+			// the PCM data may have been reallocated since the keyframe was saved
+			PCM_BANK* pcmBnk = &_pcmBank[dacStrm->bankID];
+			daccontrol_refresh_data(defInf.dataPtr, GetPCMBankData(*pcmBnk), GetPCMBankSize(*pcmBnk));
+		}
+	}
+	
+	_filePos = kf.filePos;
+	_fileTick = kf.fileTick;
+	_playTick = kf.playTick;
+	_playSmpl = kf.playSmpl;
+	_curLoop = kf.curLoop;
+	_lastLoopTick = kf.lastLoopTick;
+	_playState &= ~PLAYSTATE_END;
+	_psTrigger = 0x00;
+	_ym2612pcm_bnkPos = kf.ym2612pcm_bnkPos;
+	memcpy(_rf5cBank, kf.rf5cBank, sizeof(_rf5cBank));
+	memcpy(_qsWork, kf.qsWork, sizeof(_qsWork));
+	
+	return 0x00;
+}
+
+UINT8 VGMPlayer::SeekToKeyframe(UINT8 unit, UINT32 pos)
+{
+	size_t curKf;
+	size_t kfID;
+	UINT32 curPos;
+	
+	// find the last keyframe before the seek target
+	kfID = (size_t)-1;
+	for (curKf = 0; curKf < _keyframes.size(); curKf ++)
+	{
+		const SEEK_KEYFRAME& kf = _keyframes[curKf];
+		if (unit == PLAYPOS_FILEOFS)
+		{
+			// file offsets are only unique for the first playthrough
+			if (kf.curLoop > 0 || kf.filePos > pos)
+				break;
+		}
+		else
+		{
+			if (kf.playTick > pos)
+				break;
+		}
+		kfID = curKf;
+	}
+	if (kfID == (size_t)-1)
+		return 0xFF;
+	
+	// when seeking forwards, the keyframe is only useful if it skips a part of the song
+	curPos = (unit == PLAYPOS_FILEOFS) ? _filePos : _playTick;
+	if (pos >= curPos)
+	{
+		if (unit == PLAYPOS_FILEOFS || _keyframes[kfID].playTick <= _playTick)
+			return 0xFF;
+	}
+	
+	return LoadKeyframe(kfID);
+}
+
+UINT8 VGMPlayer::BuildSeekIndex(UINT32 endTick)
+{
+	PLAYER_EVENT_CB eventCbFunc;
+	UINT32 oldSmpl;
+	
+	if (! (_playState & PLAYSTATE_PLAY) || _kfNextTick == (UINT32)-1)
+		return 0xFF;
+	if (! endTick)
+		endTick = _fileHdr.numTicks;
+	
+	// suppress end/loop events while scanning
+	eventCbFunc = _eventCbFunc;
+	_eventCbFunc = NULL;
+	oldSmpl = _playSmpl;
+	if (_kfNextTick <= endTick)
+		Seek(PLAYPOS_TICK, endTick);	// continues from the last keyframe and stores new ones on the way
+	Seek(PLAYPOS_SAMPLE, oldSmpl);
+	_eventCbFunc = eventCbFunc;
+	
+	return 0x00;
+}
+
 void VGMPlayer::ParseFileForFMClocks()
 {
 	UINT32 filePos = _fileHdr.dataOfs;
@@ -8,6 +8,8 @@
 #include "helper.h"
 #include "playerbase.hpp"
 #include "../utils/DataLoader.h"
+#include "../utils/ThreadPool.h"
+#include "../utils/OSMutex.h"
 #include "../emu/logging.h"
 #include "dblk_compr.h"
 #include <vector>
@@ -46,6 +48,12 @@ struct VGM_PLAY_OPTIONS
 	UINT32 playbackHz;	// set to 60 (NTSC) or 50 (PAL) for region-specific song speed adjustment
 						// Note: requires VGM_HEADER.recordHz to be non-zero to work.
 	UINT8 hardStopOld;	// enforce silence at end of old VGMs (<1.50), fixes Key Off events being trimmed off
+	UINT32 seekKfInterval;	// seek index: ticks between keyframes (44100 = 1 second), 0 = disable seek index
+	UINT32 seekKfMemLimit;	// seek index: memory budget in bytes, the keyframe interval is doubled when it is exceeded
+	UINT32 renderThreads;	// number of threads for rendering the sound devices, 0/1 = render everything on the calling thread
+	UINT8 cmdEventCache;	// translate the command data into a pre-decoded event list (built by Start(), kept until unloading)
+	UINT8 seekSkipTime;	// advance the sound devices while seeking, so that envelopes and sample positions match normal playback
+	UINT8 lazyDataBlocks;	// decompress compressed data blocks only when DAC streams/PCM commands access them
 };
 
 
@@ -75,7 +83,10 @@ public:
 		DEVFUNC_WRITE_BLOCK romWrite;
 		DEVFUNC_WRITE_MEMSIZE romSizeB;
 		DEVFUNC_WRITE_BLOCK romWriteB;
+		DEVFUNC_ALIAS_BLOCK romAlias;	// reference ROM data instead of copying it (may be NULL)
 		DEVLOG_CB_DATA logCbData;
+		UINT32 renderSmpl;	// number of samples rendered during the current Render() call
+		UINT32 skipSmpl;	// seeking: playback sample the device was advanced to
 	};
 	struct DACSTRM_DEV
 	{
@@ -86,6 +97,7 @@ public:
 		UINT32 freq;
 		UINT32 lastItem;
 		UINT32 maxItems;
+		size_t destDevID;	// destination chip (index for _devices array), (size_t)-1 = not set
 	};
 
 protected:
@@ -110,11 +122,23 @@ protected:
 		std::vector<UINT8> cfgData;
 	};
 	
+	struct PCM_PENDING_BLK	// compressed data block that is not fully decompressed yet
+	{
+		UINT32 bankOfs;	// start offset of the block inside the PCM bank
+		UINT32 dataLen;	// size of the decompressed data
+		UINT32 decLen;	// number of bytes that were already decompressed
+		UINT32 fileOfs;	// file offset of the compressed data (after the compression header)
+		UINT32 cmpLen;	// size of the compressed data
+		PCM_CMP_INF cmprInfo;
+	};
 	struct PCM_BANK
 	{
 		std::vector<UINT8> data;
+		const UINT8* shared;	// bank data from the shared data cache (used instead of "data", NULL = not used)
+		UINT32 sharedSize;
 		std::vector<UINT32> bankOfs;
 		std::vector<UINT32> bankSize;
+		std::vector<PCM_PENDING_BLK> pending;	// compressed blocks that are decompressed on first access (lazy mode)
 	};
 	
 	typedef void (VGMPlayer::*COMMAND_FUNC)(void);	// VGM command member function callback
@@ -133,11 +157,60 @@ protected:
 	
 	struct QSOUND_WORK
 	{
-		void (*write)(CHIP_DEVICE*, UINT8, UINT16);	// pointer to WriteQSound_A/B
+		void (VGMPlayer::*write)(CHIP_DEVICE*, UINT8, UINT16);	// pointer to WriteQSound_A/B
 		UINT16 startAddrCache[16];	// QSound register 0x01
 		UINT16 pitchCache[16];		// QSound register 0x02
 	};
 	
+	struct SEEK_KEYFRAME
+	{
+		UINT32 filePos;
+		UINT32 fileTick;
+		UINT32 playTick;
+		UINT32 playSmpl;	// the devices were rendered up to this sample
+		UINT32 curLoop;
+		UINT32 lastLoopTick;
+		UINT32 ym2612pcm_bnkPos;
+		UINT8 rf5cBank[2][2];
+		QSOUND_WORK qsWork[2];
+		std::vector<UINT32> pcmDataSize;	// size of the data of each PCM bank
+		std::vector<UINT32> pcmBlkCount;	// number of data blocks of each PCM bank
+		std::vector<DACSTRM_DEV> dacStreams;
+		std::vector<UINT8> stateData;	// device states, followed by DAC stream states
+		std::vector<UINT8> rsmplData;	// resampler states of all devices, each one preceded by its size (UINT32)
+	};
+	
+	struct CMD_EVENT	// pre-decoded VGM command
+	{
+		UINT32 filePos;	// file offset of the command
+		UINT8 type;		// CMDEVT_* constant
+		UINT8 tgtDev;	// target device: (VGM chip type << 1) | chip ID, index for _cmdEvtDevs
+		UINT8 len;		// command length in bytes
+		UINT8 port;		// YM port (CMDEVT_YM only)
+		UINT16 ofs;		// register/offset, wait: number of ticks
+		UINT16 data;
+	};
+	struct DEV_CMD	// register write, queued for rendering the device on a worker thread
+	{
+		UINT32 smplPos;	// position in the render buffer
+		UINT8 type;		// DEVRW_A8D8/A16D8/A8D16/A16D16
+		UINT16 ofs;
+		UINT16 data;
+	};
+	struct DEV_CMD_QUEUE
+	{
+		std::vector<DEV_CMD> cmds;
+		size_t pos;		// next command to be sent
+	};
+	struct RENDER_TASK
+	{
+		VGMPlayer* player;
+		std::vector<size_t> devIDs;	// devices rendered by this task, all of them use the same core
+		UINT32 startSmpl;
+		UINT32 endSmpl;
+		std::vector<WAVE_32BS> buffer;
+	};
+	
 public:
 	VGMPlayer();
 	~VGMPlayer();
@@ -186,12 +259,15 @@ public:
 	UINT8 Stop(void);
 	UINT8 Reset(void);
 	UINT8 Seek(UINT8 unit, UINT32 pos);
+	UINT8 BuildSeekIndex(UINT32 endTick);	// pre-scan the song up to endTick (0 = whole song) and store keyframes for seeking
 	UINT32 Render(UINT32 smplCnt, WAVE_32BS* data);
 	
 protected:
 	UINT8 ParseHeader(void);
 	void ParseXHdr_Data32(UINT32 fileOfs, std::vector<XHDR_DATA32>& xData);
 	void ParseXHdr_Data16(UINT32 fileOfs, std::vector<XHDR_DATA16>& xData);
+	void WaitForFileData(UINT32 endOfs);	// wait for background loading to reach endOfs
+	void WaitForCmdData(void);	// wait for the command at _filePos to be loaded completely
 	
 	UINT8 LoadTags(void);
 	std::string GetUTF8String(const UINT8* startPtr, const UINT8* endPtr);
@@ -217,12 +293,48 @@ protected:
 	
 	static void DeviceLinkCallback(void* userParam, VGM_BASEDEV* cDev, DEVLINK_INFO* dLink);
 	CHIP_DEVICE* GetDevicePtr(UINT8 chipType, UINT8 chipID);
+	void RenderDevice(CHIP_DEVICE* cDev, UINT32 endSmpl);
+	void RenderDeviceBuf(CHIP_DEVICE* cDev, UINT32 endSmpl, WAVE_32BS* buffer);
+	void RenderAllDevices(UINT32 endSmpl);
+	void RenderDevicesParallel(UINT32 endSmpl);
+	void SkipDevice(CHIP_DEVICE* cDev, UINT32 smplPos);
+	void SkipAllDevices(UINT32 smplPos);
+	void BeginDeviceSkip(void);
+	static void RenderTaskFunc(void* param);
+	void FreeRenderPool(void);
+	void QueueDevCmd(CHIP_DEVICE* cDev, UINT8 type, UINT16 ofs, UINT16 data);
+	void SendDevCmd(CHIP_DEVICE* cDev, const DEV_CMD& cmd);
+	// register write functions, they take care of queueing the command when rendering in parallel
+	void DevWrite8(CHIP_DEVICE* cDev, UINT8 ofs, UINT8 data);
+	void DevWriteM8(CHIP_DEVICE* cDev, UINT16 ofs, UINT8 data);
+	void DevWriteD16(CHIP_DEVICE* cDev, UINT8 ofs, UINT16 data);
+	void DevWriteM16(CHIP_DEVICE* cDev, UINT16 ofs, UINT16 data);
+	void SendYMCommand(CHIP_DEVICE* cDev, UINT8 port, UINT8 reg, UINT8 data);
 	void ParseFileForOPL4ROMRequirement(void);
 	void LoadOPL4ROM(CHIP_DEVICE* chipDev);
+	// PCM bank access, the data is either owned by the bank or taken from the shared data cache
+	static const UINT8* GetPCMBankData(const PCM_BANK& pcmBnk);
+	static UINT32 GetPCMBankSize(const PCM_BANK& pcmBnk);
+	static void UnsharePCMBank(PCM_BANK& pcmBnk);
+	static void ClearPCMBank(PCM_BANK& pcmBnk);
+	void DecompressPCMBlock(UINT32 outLen, UINT8* outData, UINT32 inLen, const UINT8* inData, const PCM_CMP_INF* cmprInfo);
+	// lazy decompression: make sure that a range of the PCM bank is decompressed
+	void LoadPCMBankRange(PCM_BANK& pcmBnk, UINT32 ofs, UINT32 len);
+	void DecompressPendingBlock(PCM_BANK& pcmBnk, size_t blkID, UINT32 endOfs);
+	void DecompressTablePendingBlocks(void);
 	
 	UINT8 SeekToTick(UINT32 tick);
 	UINT8 SeekToFilePos(UINT32 pos);
 	void ParseFile(UINT32 ticks);
+	
+	void BuildCmdEvents(void);
+	size_t FindCmdEvent(UINT32 filePos) const;
+	void ProcessCmdEvent(const CMD_EVENT& evt);
+	
+	void ClearSeekIndex(void);
+	void SaveKeyframe(void);
+	UINT8 LoadKeyframe(size_t kfID);
+	UINT8 SeekToKeyframe(UINT8 unit, UINT32 pos);
 
 	void ParseFileForFMClocks();
 	
@@ -263,8 +375,8 @@ protected:
 	void Cmd_RF5C_Reg(void);				// command B0/B1 - RF5C68/164 register write
 	void Cmd_Ofs4_Data12(void);				// command B2/42 - PWM/K005289 register write (4-bit offset, 12-bit data)
 	void Cmd_QSound_Reg(void);				// command C4 - QSound register write (16-bit data, 8-bit offset)
-	static void WriteQSound_A(CHIP_DEVICE* cDev, UINT8 ofs, UINT16 data);	// write by calling write8
-	static void WriteQSound_B(CHIP_DEVICE* cDev, UINT8 ofs, UINT16 data);	// write by calling writeD16
+	void WriteQSound_A(CHIP_DEVICE* cDev, UINT8 ofs, UINT16 data);	// write by calling write8
+	void WriteQSound_B(CHIP_DEVICE* cDev, UINT8 ofs, UINT16 data);	// write by calling writeD16
 	void Cmd_WSwan_Reg(void);				// command BC - WonderSwan register write (Reg8_Data8 with remapping)
 	void Cmd_NES_Reg(void);					// command B4 - NES APU register write (Reg8_Data8 with remapping)
 	void Cmd_YMW_Bank(void);				// command C3 - YMW258 bank write (Ofs8_Data16 with remapping)
@@ -279,7 +391,12 @@ protected:
 	DEV_LOGGER _logger;
 	DATA_LOADER *_dLoad;
 	const UINT8* _fileData;	// data pointer for quick access, equals _dLoad->GetFileData().data()
-	std::vector<UINT8> _yrwRom;	// cache for OPL4 sample ROM (yrw801.rom)
+	UINT32 _fileSize;	// file size (for files that are loaded in the background: the final size)
+	UINT32 _fileLoaded;	// number of bytes that are loaded already
+	UINT8 _tagsPending;	// tags are loaded on the first GetTags() call, as the file isn't loaded completely yet
+	OS_MUTEX* _tagMutex;	// guards _tagsPending/_tagList, GetTags() may be called from any thread
+	const UINT8* _yrwRom;	// OPL4 sample ROM (yrw801.rom), from the shared data cache
+	UINT32 _yrwRomSize;
 	UINT8 _shownCmdWarnings[0x100];
 	
 	enum
@@ -287,7 +404,9 @@ protected:
 		_HDR_BUF_SIZE = 0x100,
 		_OPT_DEV_COUNT = 0x30,
 		_CHIP_COUNT = 0x30,
-		_PCM_BANK_COUNT = 0x40
+		_PCM_BANK_COUNT = 0x40,
+		_PCM_DECMP_CHUNK = 0x10000,	// lazy decompression: number of bytes decompressed at once
+		_DACSTRM_STEP_MAX = 0x200	// maximum number of bytes a DAC stream reads beyond its start offset + length (step base)
 	};
 	
 	VGM_HEADER _fileHdr;
@@ -334,6 +453,12 @@ protected:
 	
 	UINT8 _playState;
 	UINT8 _psTrigger;	// used to temporarily trigger special commands
+	WAVE_32BS* _renderBuf;	// output buffer of the current Render() call, NULL when not rendering
+	UINT32 _renderSmpl;	// position in _renderBuf that is reached by the file parser
+	THREAD_POOL* _renderPool;	// worker threads for rendering devices in parallel, NULL = serial rendering
+	UINT8 _queueDevCmds;	// queue register writes instead of sending them (set while parsing in parallel mode)
+	std::vector<DEV_CMD_QUEUE> _devCmdQueues;	// one queue per device (index for _devices array)
+	std::vector<RENDER_TASK> _renderTasks;
 	//PLAYER_EVENT_CB _eventCbFunc;
 	//void* _eventCbParam;
 	//PLAYER_FILEREQ_CB _fileReqCbFunc;
@@ -371,6 +496,15 @@ protected:
 	UINT32 _ym2612pcm_bnkPos;
 	UINT8 _rf5cBank[2][2];	// [0 RF5C68 / 1 RF5C164][chipID]
 	QSOUND_WORK _qsWork[2];
+	
+	std::vector<SEEK_KEYFRAME> _keyframes;	// seek index, sorted by playTick
+	UINT32 _kfInterval;	// current keyframe interval in ticks
+	UINT32 _kfNextTick;	// tick of the next keyframe to store, (UINT32)-1 = seek index disabled
+	size_t _kfMemUsage;	// memory used by all keyframes (approximately)
+	
+	std::vector<CMD_EVENT> _cmdEvents;	// pre-decoded commands, sorted by file offset
+	size_t _cmdEvtPos;	// index of the next event in _cmdEvents
+	CHIP_DEVICE* _cmdEvtDevs[_CHIP_COUNT * 2];	// [chip type * 2 + chip ID] target devices for _cmdEvents
 
 	UINT8 _v101Fix;	// enable hack/fix for v1.00/v1.01 VGMs with FM clock
 	UINT32 _v101ym2413clock;
@@ -13,10 +13,21 @@
 #include "../emu/cores/sn764intf.h"	// for SN76496_W constants
 
 #include "dblk_compr.h"
+#include "datacache.hpp"
 #include "helper.h"
 
 #define fData	(&_fileData[_filePos])	// used by command handlers for better readability
 
+// pre-decoded command types (CMD_EVENT)
+#define CMDEVT_CALL		0x00	// call the command handler
+#define CMDEVT_WAIT		0x01	// wait "ofs" ticks
+#define CMDEVT_A8D8		0x10	// write8
+#define CMDEVT_YM		0x11	// write8 of register + data to a YM port
+#define CMDEVT_A16D8	0x12	// writeM8
+#define CMDEVT_A8D16	0x13	// writeD16
+#define CMDEVT_A16D16	0x14	// writeM16
+#define CMDEVT_MAX_COUNT	0x400000	// limit for the event list (48 MB)
+
 /*static*/ const VGMPlayer::COMMAND_INFO VGMPlayer::_CMD_INFO[0x100] =
 {
 	// {chip type, function},                         VGM command
@@ -601,6 +612,7 @@ void VGMPlayer::Cmd_EndOfData(void)
 	if (silenceStop)
 	{
 		size_t curDev;
+		RenderAllDevices(_renderSmpl);
 		for (curDev = 0; curDev < _devices.size(); curDev ++)
 		{
 			DEV_INFO* devInf = &_devices[curDev].base.defInf;
@@ -635,10 +647,46 @@ void VGMPlayer::Cmd_DelaySamplesN1(void)
 	return;
 }
 
-INLINE void SendYMCommand(VGMPlayer::CHIP_DEVICE* cDev, UINT8 port, UINT8 reg, UINT8 data)
+void VGMPlayer::SendYMCommand(CHIP_DEVICE* cDev, UINT8 port, UINT8 reg, UINT8 data)
+{
+	DevWrite8(cDev, (port << 1) | 0, reg);
+	DevWrite8(cDev, (port << 1) | 1, data);
+	return;
+}
+
+void VGMPlayer::DevWrite8(CHIP_DEVICE* cDev, UINT8 ofs, UINT8 data)
+{
+	if (_queueDevCmds)
+		QueueDevCmd(cDev, DEVRW_A8D8, ofs, data);
+	else
+		cDev->write8(cDev->base.defInf.dataPtr, ofs, data);
+	return;
+}
+
+void VGMPlayer::DevWriteM8(CHIP_DEVICE* cDev, UINT16 ofs, UINT8 data)
+{
+	if (_queueDevCmds)
+		QueueDevCmd(cDev, DEVRW_A16D8, ofs, data);
+	else
+		cDev->writeM8(cDev->base.defInf.dataPtr, ofs, data);
+	return;
+}
+
+void VGMPlayer::DevWriteD16(CHIP_DEVICE* cDev, UINT8 ofs, UINT16 data)
+{
+	if (_queueDevCmds)
+		QueueDevCmd(cDev, DEVRW_A8D16, ofs, data);
+	else
+		cDev->writeD16(cDev->base.defInf.dataPtr, ofs, data);
+	return;
+}
+
+void VGMPlayer::DevWriteM16(CHIP_DEVICE* cDev, UINT16 ofs, UINT16 data)
 {
-	cDev->write8(cDev->base.defInf.dataPtr, (port << 1) | 0, reg);
-	cDev->write8(cDev->base.defInf.dataPtr, (port << 1) | 1, data);
+	if (_queueDevCmds)
+		QueueDevCmd(cDev, DEVRW_A16D16, ofs, data);
+	else
+		cDev->writeM16(cDev->base.defInf.dataPtr, ofs, data);
 	return;
 }
 
@@ -663,6 +711,20 @@ static void WriteChipROM(VGMPlayer::CHIP_DEVICE* cDev, UINT8 memID,
 	return;
 }
 
+// When the data block contains the whole ROM, the device can use the file data directly.
+// Returns 1 if the ROM was set that way.
+static UINT8 AliasChipROM(VGMPlayer::CHIP_DEVICE* cDev, UINT8 memID,
+						  UINT32 memSize, UINT32 dataOfs, UINT32 dataLen, const UINT8* data)
+{
+	if (memID != 0 || cDev->romAlias == NULL)
+		return 0;
+	if (! memSize || dataOfs > 0 || dataLen < memSize)
+		return 0;
+	
+	cDev->romAlias(cDev->base.defInf.dataPtr, memSize, data);
+	return 1;
+}
+
 void VGMPlayer::DoRAMOfsPatches(UINT8 chipType, UINT8 chipID, UINT32& dataOfs, UINT32& dataLen)
 {
 	switch(chipType)
@@ -678,6 +740,91 @@ void VGMPlayer::DoRAMOfsPatches(UINT8 chipType, UINT8 chipID, UINT32& dataOfs, U
 	return;
 }
 
+void VGMPlayer::DecompressPCMBlock(UINT32 outLen, UINT8* outData, UINT32 inLen, const UINT8* inData, const PCM_CMP_INF* cmprInfo)
+{
+	UINT8 retVal = DecompressDataBlk(outLen, outData, inLen, inData, cmprInfo);
+	if (retVal == 0x10)
+		emu_logf(&_logger, PLRLOG_ERROR, "Error loading table-compressed data block! No table loaded!\n");
+	else if (retVal == 0x11)
+		emu_logf(&_logger, PLRLOG_ERROR, "Data block and loaded value table incompatible!\n");
+	else if (retVal == 0x80)
+		emu_logf(&_logger, PLRLOG_ERROR, "Unknown data block compression!\n");
+	
+	return;
+}
+
+void VGMPlayer::LoadPCMBankRange(PCM_BANK& pcmBnk, UINT32 ofs, UINT32 len)
+{
+	size_t curBlk;
+	
+	// go backwards, as finished blocks are removed from the list
+	for (curBlk = pcmBnk.pending.size(); curBlk > 0; curBlk --)
+	{
+		const PCM_PENDING_BLK& pBlk = pcmBnk.pending[curBlk - 1];
+		if (ofs >= pBlk.bankOfs + pBlk.dataLen || (ofs < pBlk.bankOfs && len <= pBlk.bankOfs - ofs))
+			continue;	// no overlap
+		
+		UINT32 endOfs;	// end of the requested range, relative to the block start
+		if (ofs < pBlk.bankOfs)
+			endOfs = len - (pBlk.bankOfs - ofs);
+		else
+			endOfs = (ofs - pBlk.bankOfs) + ((len < pBlk.dataLen) ? len : pBlk.dataLen);
+		if (endOfs > pBlk.dataLen)
+			endOfs = pBlk.dataLen;
+		DecompressPendingBlock(pcmBnk, curBlk - 1, endOfs);
+	}
+	
+	return;
+}
+
+void VGMPlayer::DecompressPendingBlock(PCM_BANK& pcmBnk, size_t blkID, UINT32 endOfs)
+{
+	PCM_PENDING_BLK* pBlk = &pcmBnk.pending[blkID];
+	if (endOfs <= pBlk->decLen)
+		return;
+	
+	// Decompression always continues where it stopped, as DPCM needs the previous value.
+	// Working in whole chunks keeps the position of the compressed data byte-aligned.
+	endOfs = (endOfs + _PCM_DECMP_CHUNK - 1) / _PCM_DECMP_CHUNK * _PCM_DECMP_CHUNK;
+	if (endOfs > pBlk->dataLen)
+		endOfs = pBlk->dataLen;
+	
+	PCM_CMP_INF cmprInfo = pBlk->cmprInfo;
+	UINT8 valSize = (cmprInfo.bitsDec + 7) / 8;
+	UINT32 inOfs = (UINT32)((UINT64)(pBlk->decLen / valSize) * cmprInfo.bitsCmp / 8);
+	UINT8* outData = &pcmBnk.data[pBlk->bankOfs + pBlk->decLen];
+	if (cmprInfo.comprType == 0x01 && pBlk->decLen > 0)
+		cmprInfo.baseVal = (valSize == 0x01) ? outData[-1] : ReadLE16(&outData[-2]);	// DPCM: continue with last value
+	if (inOfs < pBlk->cmpLen)
+		DecompressPCMBlock(endOfs - pBlk->decLen, outData, pBlk->cmpLen - inOfs, &_fileData[pBlk->fileOfs + inOfs], &cmprInfo);
+	
+	pBlk->decLen = endOfs;
+	if (pBlk->decLen >= pBlk->dataLen)
+		pcmBnk.pending.erase(pcmBnk.pending.begin() + blkID);
+	
+	return;
+}
+
+void VGMPlayer::DecompressTablePendingBlocks(void)
+{
+	size_t curBank;
+	size_t curBlk;
+	
+	// blocks that use the decompression table must be finished before the table is replaced
+	for (curBank = 0; curBank < _PCM_BANK_COUNT; curBank ++)
+	{
+		PCM_BANK* pcmBnk = &_pcmBank[curBank];
+		for (curBlk = pcmBnk->pending.size(); curBlk > 0; curBlk --)
+		{
+			const PCM_PENDING_BLK& pBlk = pcmBnk->pending[curBlk - 1];
+			if (pBlk.cmprInfo.comprType == 0x01 || pBlk.cmprInfo.subType == 0x02)
+				DecompressPendingBlock(*pcmBnk, curBlk - 1, pBlk.dataLen);
+		}
+	}
+	
+	return;
+}
+
 void VGMPlayer::Cmd_DataBlock(void)
 {
 	UINT8 dblkType;
@@ -705,21 +852,28 @@ void VGMPlayer::Cmd_DataBlock(void)
 		
 		if (dblkType == 0x7F)
 		{
+			DecompressTablePendingBlocks();
 			ReadPCMComprTable(dblkLen, &fData[0x00], &_pcmComprTbl);
 		}
 		else
 		{
 			PCM_BANK* pcmBnk = &_pcmBank[dblkType & 0x3F];
 			PCM_CDB_INF dbCI;
-			UINT32 oldLen = (UINT32)pcmBnk->data.size();
+			UINT32 oldLen = GetPCMBankSize(*pcmBnk);
+			UINT8 lazyDecmp = 0;
 			dataLen = dblkLen;
 			dataPtr = &fData[0x00];
 			
 			if (dblkType & 0x40)
 			{
-				ReadComprDataBlkHdr(dblkLen, dataPtr, &dbCI);
+				UINT8 retVal = ReadComprDataBlkHdr(dblkLen, dataPtr, &dbCI);
 				dbCI.cmprInfo.comprTbl = &_pcmComprTbl;
 				dataLen = dbCI.decmpLen;
+				if (_playOpts.lazyDataBlocks && ! retVal)
+				{
+					UINT8 valSize = (dbCI.cmprInfo.bitsDec + 7) / 8;
+					lazyDecmp = (valSize == 0x01 || valSize == 0x02);
+				}
 			}
 			
 			pcmBnk->bankOfs.push_back(oldLen);
@@ -727,22 +881,60 @@ void VGMPlayer::Cmd_DataBlock(void)
 			if (!dataLen)
 				return;	// don't try to access std::vector elements when there is no data
 			
+			if ((dblkType & 0x40) && ! oldLen)
+			{
+				// A bank that starts with a compressed block uses the shared data cache, so that
+				// players with the same data decompress and store it only once.
+				// The key is the compressed block, plus the decompression table if the result depends on it.
+				std::vector<UINT8> keyBuf;
+				const UINT8* key = dataPtr;
+				UINT32 keySize = dblkLen;
+				UINT32 cacheSize = 0;
+				if (dbCI.cmprInfo.comprType == 0x01 && _pcmComprTbl.values.d8 != NULL)
+				{
+					UINT32 tblSize = _pcmComprTbl.valueCount * ((_pcmComprTbl.bitsDec + 7) / 8);
+					keyBuf.reserve(dblkLen + tblSize);
+					keyBuf.assign(dataPtr, dataPtr + dblkLen);
+					keyBuf.insert(keyBuf.end(), _pcmComprTbl.values.d8, _pcmComprTbl.values.d8 + tblSize);
+					key = &keyBuf[0];
+					keySize = (UINT32)keyBuf.size();
+				}
+				UINT64 hash = DataCache_Hash(key, keySize, DCACHE_HASH_INIT);
+				pcmBnk->shared = DataCache_Acquire(hash, key, keySize, &cacheSize);
+				if (pcmBnk->shared == NULL && ! lazyDecmp)	// in lazy mode, only take data that is already decompressed
+				{
+					UINT8* decData = (UINT8*)calloc(dataLen, 1);
+					if (decData != NULL)
+					{
+						DecompressPCMBlock(dataLen, decData, dblkLen - dbCI.hdrSize, &dataPtr[dbCI.hdrSize], &dbCI.cmprInfo);
+						pcmBnk->shared = DataCache_Insert(hash, key, keySize, decData, dataLen);
+					}
+				}
+				if (pcmBnk->shared != NULL)
+				{
+					pcmBnk->sharedSize = dataLen;
+					break;
+				}
+			}
+			UnsharePCMBank(*pcmBnk);	// appending data requires a private copy
+			
 			pcmBnk->data.resize(oldLen + dataLen);
-			if (dblkType & 0x40)
+			if (lazyDecmp)
 			{
-				UINT8 retVal = DecompressDataBlk(dataLen, &pcmBnk->data[oldLen],
-					dblkLen - dbCI.hdrSize, &dataPtr[dbCI.hdrSize], &dbCI.cmprInfo);
-				if (retVal == 0x10)
-					emu_logf(&_logger, PLRLOG_ERROR, "Error loading table-compressed data block! No table loaded!\n");
-				else if (retVal == 0x11)
-					emu_logf(&_logger, PLRLOG_ERROR, "Data block and loaded value table incompatible!\n");
-				else if (retVal == 0x80)
-					emu_logf(&_logger, PLRLOG_ERROR, "Unknown data block compression!\n");
+				// just remember where the data is, it is decompressed when it is accessed for the first time
+				PCM_PENDING_BLK pBlk;
+				pBlk.bankOfs = oldLen;
+				pBlk.dataLen = dataLen;
+				pBlk.decLen = 0;
+				pBlk.fileOfs = _filePos + dbCI.hdrSize;
+				pBlk.cmpLen = dblkLen - dbCI.hdrSize;
+				pBlk.cmprInfo = dbCI.cmprInfo;
+				pcmBnk->pending.push_back(pBlk);
 			}
+			else if (dblkType & 0x40)
+				DecompressPCMBlock(dataLen, &pcmBnk->data[oldLen], dblkLen - dbCI.hdrSize, &dataPtr[dbCI.hdrSize], &dbCI.cmprInfo);
 			else
-			{
 				memcpy(&pcmBnk->data[oldLen], dataPtr, dataLen);
-			}
 			
 			// TODO: refresh DAC Stream pointers (call daccontrol_refresh_data)
 		}
@@ -755,6 +947,7 @@ void VGMPlayer::Cmd_DataBlock(void)
 		
 		if (dblkLen < 0x08)
 			return;
+		RenderDevice(cDev, _renderSmpl);	// send queued commands before changing the ROM
 		memSize = ReadLE32(&fData[0x00]);
 		dataOfs = ReadLE32(&fData[0x04]);
 		dataPtr = &fData[0x08];
@@ -771,7 +964,7 @@ void VGMPlayer::Cmd_DataBlock(void)
 			}
 			WriteChipROM(cDev, _VGM_ROM_CHIPS[dblkType & 0x3F][1], memSize, dataOfs, dataLen, &swpData[0x00]);
 		}
-		else
+		else if (! AliasChipROM(cDev, _VGM_ROM_CHIPS[dblkType & 0x3F][1], memSize, dataOfs, dataLen, dataPtr))
 		{
 			WriteChipROM(cDev, _VGM_ROM_CHIPS[dblkType & 0x3F][1], memSize, dataOfs, dataLen, dataPtr);
 		}
@@ -801,6 +994,7 @@ void VGMPlayer::Cmd_DataBlock(void)
 			dataPtr = &fData[0x04];
 		}
 		DoRAMOfsPatches(chipType, chipID, dataOfs, dataLen);
+		RenderDevice(cDev, _renderSmpl);	// send queued commands before changing the RAM
 		cDev->romWrite(cDev->base.defInf.dataPtr, dataOfs, dataLen, dataPtr);
 		break;
 	}
@@ -824,21 +1018,25 @@ void VGMPlayer::Cmd_PcmRamWrite(void)
 	UINT32 dbPos = ReadLE24(&fData[0x03]);
 	UINT32 wrtAddr = ReadLE24(&fData[0x06]);
 	UINT32 dataLen = ReadLE24(&fData[0x09]);
-	if (dbPos >= _pcmBank[dbType].data.size())
+	UINT32 bankSize = GetPCMBankSize(_pcmBank[dbType]);
+	if (dbPos >= bankSize)
 		return;
-	const UINT8* ROMData = &_pcmBank[dbType].data[dbPos];
+	const UINT8* ROMData = &GetPCMBankData(_pcmBank[dbType])[dbPos];
 	if (! dataLen)
 		dataLen += 0x01000000;
-	if (dataLen > _pcmBank[dbType].data.size() - dbPos)
+	if (dataLen > bankSize - dbPos)
 		return;	// just outright ignore writes that would go out-of-bounds
+	if (! _pcmBank[dbType].pending.empty())
+		LoadPCMBankRange(_pcmBank[dbType], dbPos, dataLen);
 	
 	if (chipType == 0x14)	// NES APU
 	{
 		//Last95Drum = dbPos / dataLen - 1;
-		//Last95Max = _pcmBank[dbType].data.size() / dataLen;
+		//Last95Max = bankSize / dataLen;
 	}
 	
 	DoRAMOfsPatches(chipType, chipID, wrtAddr, dataLen);
+	RenderDevice(cDev, _renderSmpl);	// send queued commands before changing the RAM
 	cDev->romWrite(cDev->base.defInf.dataPtr, wrtAddr, dataLen, ROMData);
 	
 	return;
@@ -851,10 +1049,12 @@ void VGMPlayer::Cmd_YM2612PCM_Delay(void)
 	
 	if (cDev == NULL || cDev->write8 == NULL)
 		return;
-	if (_ym2612pcm_bnkPos >= _pcmBank[0].data.size())
+	if (_ym2612pcm_bnkPos >= GetPCMBankSize(_pcmBank[0]))
 		return;
+	if (! _pcmBank[0].pending.empty())
+		LoadPCMBankRange(_pcmBank[0], _ym2612pcm_bnkPos, 1);
 	
-	UINT8 data = _pcmBank[0].data[_ym2612pcm_bnkPos];
+	UINT8 data = GetPCMBankData(_pcmBank[0])[_ym2612pcm_bnkPos];
 	SendYMCommand(cDev, 0x00, 0x2A, data);
 	_ym2612pcm_bnkPos ++;
 	// TODO: clip when exceeding pcmBank size
@@ -865,6 +1065,8 @@ void VGMPlayer::Cmd_YM2612PCM_Delay(void)
 void VGMPlayer::Cmd_YM2612PCM_Seek(void)
 {
 	_ym2612pcm_bnkPos = ReadLE32(&fData[0x01]);
+	if (! _pcmBank[0].pending.empty())
+		LoadPCMBankRange(_pcmBank[0], _ym2612pcm_bnkPos, _PCM_DECMP_CHUNK);
 	return;
 }
 
@@ -895,6 +1097,7 @@ void VGMPlayer::Cmd_DACCtrl_Setup(void)	// DAC Stream Control: Setup Chip
 		dacStrm.freq = 0;
 		dacStrm.lastItem = (UINT32)-1;
 		dacStrm.maxItems = 0;
+		dacStrm.destDevID = (size_t)-1;
 		
 		_dacStrmMap[dacStrm.streamID] = _dacStreams.size();
 		_dacStreams.push_back(dacStrm);
@@ -910,6 +1113,7 @@ void VGMPlayer::Cmd_DACCtrl_Setup(void)	// DAC Stream Control: Setup Chip
 	if (destChip == NULL)
 		return;
 	
+	dacStrm->destDevID = destChip - &_devices[0];
 	daccontrol_setup_chip(dacStrm->defInf.dataPtr, &destChip->base.defInf, destChip->chipType, chipCmd);
 	return;
 }
@@ -927,10 +1131,7 @@ void VGMPlayer::Cmd_DACCtrl_SetData(void)	// DAC Stream Control: Set Data Bank
 	PCM_BANK* pcmBnk = &_pcmBank[dacStrm->bankID];
 	
 	dacStrm->maxItems = (UINT32)pcmBnk->bankOfs.size();
-	if (pcmBnk->data.empty())
-		daccontrol_set_data(dacStrm->defInf.dataPtr, NULL, 0, fData[0x03], fData[0x04]);
-	else
-		daccontrol_set_data(dacStrm->defInf.dataPtr, &pcmBnk->data[0], (UINT32)pcmBnk->data.size(), fData[0x03], fData[0x04]);
+	daccontrol_set_data(dacStrm->defInf.dataPtr, GetPCMBankData(*pcmBnk), GetPCMBankSize(*pcmBnk), fData[0x03], fData[0x04]);
 	return;
 }
 
@@ -957,6 +1158,16 @@ void VGMPlayer::Cmd_DACCtrl_PlayData_Loc(void)	// DAC Stream Control: Play Data
 	UINT32 soundLen = ReadLE32(&fData[0x07]);
 	dacStrm->lastItem = (UINT32)-1;
 	dacStrm->pbMode = fData[0x06];
+	if (dacStrm->bankID < _PCM_BANK_COUNT && ! _pcmBank[dacStrm->bankID].pending.empty())
+	{
+		// The length is known only in "bytes" mode, else load everything from the start offset on.
+		if (startOfs == (UINT32)-1)
+			LoadPCMBankRange(_pcmBank[dacStrm->bankID], 0, (UINT32)-1);
+		else if ((dacStrm->pbMode & 0x0F) == DCTRL_LMODE_BYTES && soundLen < 0x80000000)
+			LoadPCMBankRange(_pcmBank[dacStrm->bankID], startOfs, soundLen + _DACSTRM_STEP_MAX);
+		else
+			LoadPCMBankRange(_pcmBank[dacStrm->bankID], startOfs, (UINT32)-1);
+	}
 	daccontrol_start(dacStrm->defInf.dataPtr, startOfs, dacStrm->pbMode, soundLen);
 	return;
 }
@@ -1001,6 +1212,8 @@ void VGMPlayer::Cmd_DACCtrl_PlayData_Blk(void)	// DAC Stream Control: Play Data
 		return;
 	UINT32 startOfs = pcmBnk->bankOfs[sndID];
 	UINT32 soundLen = pcmBnk->bankSize[sndID];
+	if (! pcmBnk->pending.empty())
+		LoadPCMBankRange(*pcmBnk, startOfs, soundLen + _DACSTRM_STEP_MAX);
 	dacStrm->pbMode = DCTRL_LMODE_BYTES |
 					((fData[0x04] & 0x10) << 0) |	// Reverse Mode
 					((fData[0x04] & 0x01) << 7);	// Looping
@@ -1016,7 +1229,7 @@ void VGMPlayer::Cmd_GGStereo(void)
 	if (cDev == NULL || cDev->write8 == NULL)
 		return;
 	
-	cDev->write8(cDev->base.defInf.dataPtr, SN76496_W_GGST, fData[0x01]);
+	DevWrite8(cDev, SN76496_W_GGST, fData[0x01]);
 	return;
 }
 
@@ -1028,7 +1241,7 @@ void VGMPlayer::Cmd_SN76489(void)
 	if (cDev == NULL || cDev->write8 == NULL)
 		return;
 	
-	cDev->write8(cDev->base.defInf.dataPtr, SN76496_W_REG, fData[0x01]);
+	DevWrite8(cDev, SN76496_W_REG, fData[0x01]);
 	return;
 }
 
@@ -1076,7 +1289,7 @@ void VGMPlayer::Cmd_MSM5205_Reg(void)
 	if (cDev == NULL || cDev->write8 == NULL)
 		return;
 
-	cDev->write8(cDev->base.defInf.dataPtr, (fData[0x01] >> 4) & 0x7, fData[0x01] & 0xF);
+	DevWrite8(cDev, (fData[0x01] >> 4) & 0x7, fData[0x01] & 0xF);
 	return;
 }
 
@@ -1088,7 +1301,7 @@ void VGMPlayer::Cmd_Ofs8_Data8(void)
 	if (cDev == NULL || cDev->write8 == NULL)
 		return;
 	
-	cDev->write8(cDev->base.defInf.dataPtr, fData[0x01] & 0x7F, fData[0x02]);
+	DevWrite8(cDev, fData[0x01] & 0x7F, fData[0x02]);
 	return;
 }
 
@@ -1101,7 +1314,7 @@ void VGMPlayer::Cmd_Ofs16_Data8(void)
 		return;
 	
 	UINT16 ofs = ReadBE16(&fData[0x01]) & 0x7FFF;
-	cDev->writeM8(cDev->base.defInf.dataPtr, ofs, fData[0x03]);
+	DevWriteM8(cDev, ofs, fData[0x03]);
 	return;
 }
 
@@ -1114,7 +1327,7 @@ void VGMPlayer::Cmd_Ofs8_Data16(void)
 		return;
 	
 	UINT16 value = ReadLE16(&fData[0x02]);
-	cDev->writeD16(cDev->base.defInf.dataPtr, fData[0x01] & 0x7F, value);
+	DevWriteD16(cDev, fData[0x01] & 0x7F, value);
 	return;
 }
 
@@ -1128,7 +1341,7 @@ void VGMPlayer::Cmd_Ofs16_Data16(void)
 	
 	UINT16 ofs = ReadBE16(&fData[0x01]) & 0x7FFF;
 	UINT16 value = ReadBE16(&fData[0x03]);
-	cDev->writeM16(cDev->base.defInf.dataPtr, ofs, value);
+	DevWriteM16(cDev, ofs, value);
 	return;
 }
 
@@ -1140,7 +1353,7 @@ void VGMPlayer::Cmd_Port_Ofs8_Data8(void)
 	if (cDev == NULL || cDev->write8 == NULL)
 		return;
 	
-	cDev->write8(cDev->base.defInf.dataPtr, fData[0x02], fData[0x03]);
+	DevWrite8(cDev, fData[0x02], fData[0x03]);
 	return;
 }
 
@@ -1165,7 +1378,7 @@ void VGMPlayer::Cmd_SegaPCM_Mem(void)
 		return;
 	
 	UINT16 memOfs = ReadLE16(&fData[0x01]) & 0x7FFF;
-	cDev->writeM8(cDev->base.defInf.dataPtr, memOfs, fData[0x03]);
+	DevWriteM8(cDev, memOfs, fData[0x03]);
 	return;
 }
 
@@ -1180,7 +1393,7 @@ void VGMPlayer::Cmd_RF5C_Mem(void)
 	UINT16 memOfs = ReadLE16(&fData[0x01]);
 	if (memOfs & 0xF000)
 		emu_logf(&_logger, PLRLOG_WARN, "RF5C mem write to out-of-window offset 0x%04X\n", memOfs);
-	cDev->writeM8(cDev->base.defInf.dataPtr, memOfs, fData[0x03]);
+	DevWriteM8(cDev, memOfs, fData[0x03]);
 	return;
 }
 
@@ -1193,7 +1406,7 @@ void VGMPlayer::Cmd_RF5C_Reg(void)
 		return;
 	
 	UINT8 ofs = fData[0x01] & 0x7F;
-	cDev->write8(cDev->base.defInf.dataPtr, ofs, fData[0x02]);
+	DevWrite8(cDev, ofs, fData[0x02]);
 	
 	// RF5C68 bank patch
 	if (ofs == 0x07 && ! (fData[0x02] & 0x40))
@@ -1215,7 +1428,7 @@ void VGMPlayer::Cmd_Ofs4_Data12(void)
 	
 	UINT8 ofs = (fData[0x01] >> 4) & 0x07;
 	UINT16 value = ReadBE16(&fData[0x01]) & 0x0FFF;
-	cDev->writeD16(cDev->base.defInf.dataPtr, ofs, value);
+	DevWriteD16(cDev, ofs, value);
 	return;
 }
 
@@ -1249,31 +1462,31 @@ void VGMPlayer::Cmd_QSound_Reg(void)
 			case 0x02:	// Pitch
 				// old HLE assumed writing a non-zero value after a zero value was Key On
 				if (! qsWork->pitchCache[chn] && data)
-					qsWork->write(cDev, (chn << 3) | 0x01, qsWork->startAddrCache[chn]);
+					(this->*qsWork->write)(cDev, (chn << 3) | 0x01, qsWork->startAddrCache[chn]);
 				qsWork->pitchCache[chn] = data;
 				break;
 			case 0x03: // Phase (old HLE also assumed this was Key On)
-				qsWork->write(cDev, (chn << 3) | 0x01, qsWork->startAddrCache[chn]);
+				(this->*qsWork->write)(cDev, (chn << 3) | 0x01, qsWork->startAddrCache[chn]);
 				break;
 			}
 		}
 	}
 	
-	qsWork->write(cDev, fData[0x03], ReadBE16(&fData[0x01]));
+	(this->*qsWork->write)(cDev, fData[0x03], ReadBE16(&fData[0x01]));
 	return;
 }
 
-/*static*/ void VGMPlayer::WriteQSound_A(CHIP_DEVICE* cDev, UINT8 ofs, UINT16 data)
+void VGMPlayer::WriteQSound_A(CHIP_DEVICE* cDev, UINT8 ofs, UINT16 data)
 {
-	cDev->writeD16(cDev->base.defInf.dataPtr, ofs, data);
+	DevWriteD16(cDev, ofs, data);
 	return;
 }
 
-/*static*/ void VGMPlayer::WriteQSound_B(CHIP_DEVICE* cDev, UINT8 ofs, UINT16 data)
+void VGMPlayer::WriteQSound_B(CHIP_DEVICE* cDev, UINT8 ofs, UINT16 data)
 {
-	cDev->write8(cDev->base.defInf.dataPtr, 0x00, (data >> 8) & 0xFF);	// Data MSB
-	cDev->write8(cDev->base.defInf.dataPtr, 0x01, (data >> 0) & 0xFF);	// Data LSB
-	cDev->write8(cDev->base.defInf.dataPtr, 0x02, ofs);	// Register
+	DevWrite8(cDev, 0x00, (data >> 8) & 0xFF);	// Data MSB
+	DevWrite8(cDev, 0x01, (data >> 0) & 0xFF);	// Data LSB
+	DevWrite8(cDev, 0x02, ofs);	// Register
 	return;
 }
 
@@ -1285,7 +1498,7 @@ void VGMPlayer::Cmd_WSwan_Reg(void)
 	if (cDev == NULL || cDev->write8 == NULL)
 		return;
 	
-	cDev->write8(cDev->base.defInf.dataPtr, 0x80 + (fData[0x01] & 0x7F), fData[0x02]);
+	DevWrite8(cDev, 0x80 + (fData[0x01] & 0x7F), fData[0x02]);
 	return;
 }
 
@@ -1305,7 +1518,7 @@ void VGMPlayer::Cmd_NES_Reg(void)
 	else if ((ofs & 0xE0) == 0x20)
 		ofs = 0x80 | (ofs & 0x1F);	// FDS register
 	
-	cDev->write8(cDev->base.defInf.dataPtr, ofs, fData[0x02]);
+	DevWrite8(cDev, ofs, fData[0x02]);
 	return;
 }
 
@@ -1322,15 +1535,15 @@ void VGMPlayer::Cmd_YMW_Bank(void)
 	if (bankmask == 0x03 && ! (fData[0x02] & 0x08))
 	{
 		// 1 MB banking (reg 0x10)
-		cDev->write8(cDev->base.defInf.dataPtr, 0x10, fData[0x02] / 0x10);
+		DevWrite8(cDev, 0x10, fData[0x02] / 0x10);
 	}
 	else
 	{
 		// 512 KB banking (regs 0x11/0x12)
 		if (bankmask & 0x02)	// low bank
-			cDev->write8(cDev->base.defInf.dataPtr, 0x11, fData[0x02] / 0x08);
+			DevWrite8(cDev, 0x11, fData[0x02] / 0x08);
 		if (bankmask & 0x01)	// high bank
-			cDev->write8(cDev->base.defInf.dataPtr, 0x12, fData[0x02] / 0x08);
+			DevWrite8(cDev, 0x12, fData[0x02] / 0x08);
 	}
 	
 	return;
@@ -1344,8 +1557,8 @@ void VGMPlayer::Cmd_SAA_Reg(void)
 	if (cDev == NULL || cDev->write8 == NULL)
 		return;
 	
-	cDev->write8(cDev->base.defInf.dataPtr, 0x01, fData[0x01] & 0x7F);	// SAA commands are at offset 1, not 0
-	cDev->write8(cDev->base.defInf.dataPtr, 0x00, fData[0x02]);
+	DevWrite8(cDev, 0x01, fData[0x01] & 0x7F);	// SAA commands are at offset 1, not 0
+	DevWrite8(cDev, 0x00, fData[0x02]);
 	return;
 }
 
@@ -1369,7 +1582,7 @@ void VGMPlayer::Cmd_OKIM6295_Reg(void)
 		}
 	}
 	
-	cDev->write8(cDev->base.defInf.dataPtr, ofs, data);
+	DevWrite8(cDev, ofs, data);
 	return;
 }
 
@@ -1383,9 +1596,12 @@ void VGMPlayer::Cmd_K007232_Reg(void)
 
 	UINT8 ofs = fData[0x01] & 0x7F;
 	if (ofs == 0x1F)	// offset 0x1F: execute chip read
+	{
+		RenderDevice(cDev, _renderSmpl);	// send queued commands first, the read has side effects
 		cDev->read8(cDev->base.defInf.dataPtr, fData[0x02]);	// the data value is the offset
+	}
 	else
-		cDev->write8(cDev->base.defInf.dataPtr, ofs, fData[0x02]);
+		DevWrite8(cDev, ofs, fData[0x02]);
 	return;
 }
 
@@ -1409,7 +1625,10 @@ void VGMPlayer::Cmd_AY_Stereo(void)
 	
 	retVal = SndEmu_GetDeviceFunc(clDev->defInf.devDef, RWF_REGISTER | RWF_WRITE, DEVRW_ALL, 0x5354, (void**)&writeStMask);
 	if (writeStMask != NULL)
+	{
+		RenderDevice(cDev, _renderSmpl);
 		writeStMask(cDev->base.defInf.dataPtr, fData[0x01] & 0x3F);
+	}
 	return;
 }
 
@@ -1423,8 +1642,253 @@ void VGMPlayer::Cmd_BSMT2000_Reg(void)
 
 	UINT8 ofs = fData[0x01] & 0x7F;
 	if (ofs == 0x7F)	// special register
-		cDev->write8(cDev->base.defInf.dataPtr, 0x10 + fData[0x02], fData[0x03]);
+		DevWrite8(cDev, 0x10 + fData[0x02], fData[0x03]);
 	else
 		WriteQSound_B(cDev, ofs, ReadBE16(&fData[0x02]));
 	return;
 }
+
+void VGMPlayer::BuildCmdEvents(void)
+{
+	UINT32 filePos;
+	
+	std::vector<CMD_EVENT>().swap(_cmdEvents);
+	_cmdEvtPos = 0;
+	if (! _playOpts.cmdEventCache || _fileData == NULL)
+		return;
+	
+	// Translate the simple register write and wait commands, so that ParseFile doesn't have to decode them
+	// each time. All other commands are stored as CMDEVT_CALL and executed by their command handlers.
+	filePos = _fileHdr.dataOfs;
+	while(filePos < _fileHdr.dataEnd)
+	{
+		const UINT8* cmdData = &_fileData[filePos];
+		const COMMAND_INFO& cmdInf = _CMD_INFO[cmdData[0x00]];
+		COMMAND_FUNC func = cmdInf.func;
+		UINT32 cmdLen = cmdInf.cmdLen;
+		UINT8 chipID = 0;
+		CMD_EVENT evt;
+		
+		if (func == &VGMPlayer::Cmd_EndOfData)
+		{
+			cmdLen = 0x01;
+		}
+		else if (func == &VGMPlayer::Cmd_DataBlock)
+		{
+			if (_fileHdr.dataEnd - filePos < 0x07)
+				break;
+			cmdLen = 0x07 + (ReadLE32(&cmdData[0x03]) & 0x7FFFFFFF);
+		}
+		if (! cmdLen || cmdLen > _fileHdr.dataEnd - filePos)
+			break;	// invalid or truncated command - the rest is left to the command handlers
+		
+		evt.filePos = filePos;
+		evt.type = CMDEVT_CALL;
+		evt.len = 0x00;
+		evt.port = 0x00;
+		evt.ofs = 0x0000;
+		evt.data = 0x0000;
+		if (func == &VGMPlayer::Cmd_DelaySamples2B)
+		{
+			evt.type = CMDEVT_WAIT;
+			evt.ofs = ReadLE16(&cmdData[0x01]);
+		}
+		else if (func == &VGMPlayer::Cmd_Delay60Hz)
+		{
+			evt.type = CMDEVT_WAIT;
+			evt.ofs = 735;
+		}
+		else if (func == &VGMPlayer::Cmd_Delay50Hz)
+		{
+			evt.type = CMDEVT_WAIT;
+			evt.ofs = 882;
+		}
+		else if (func == &VGMPlayer::Cmd_DelaySamplesN1)
+		{
+			evt.type = CMDEVT_WAIT;
+			evt.ofs = 1 + (cmdData[0x00] & 0x0F);
+		}
+		else if (func == &VGMPlayer::Cmd_GGStereo)
+		{
+			evt.type = CMDEVT_A8D8;
+			chipID = (cmdData[0x00] == 0x3F) ? 1 : 0;
+			evt.ofs = SN76496_W_GGST;
+			evt.data = cmdData[0x01];
+		}
+		else if (func == &VGMPlayer::Cmd_SN76489)
+		{
+			evt.type = CMDEVT_A8D8;
+			chipID = (cmdData[0x00] == 0x30) ? 1 : 0;
+			evt.ofs = SN76496_W_REG;
+			evt.data = cmdData[0x01];
+		}
+		else if (func == &VGMPlayer::Cmd_Reg8_Data8 || func == &VGMPlayer::Cmd_CPort_Reg8_Data8)
+		{
+			evt.type = CMDEVT_YM;
+			chipID = (cmdData[0x00] >= 0xA0) ? 1 : 0;
+			evt.port = (func == &VGMPlayer::Cmd_CPort_Reg8_Data8) ? (cmdData[0x00] & 0x01) : 0;
+			evt.ofs = cmdData[0x01];
+			evt.data = cmdData[0x02];
+		}
+		else if (func == &VGMPlayer::Cmd_Port_Reg8_Data8)
+		{
+			evt.type = CMDEVT_YM;
+			chipID = (cmdData[0x01] & 0x80) >> 7;
+			evt.port = cmdData[0x01] & 0x7F;
+			evt.ofs = cmdData[0x02];
+			evt.data = cmdData[0x03];
+		}
+		else if (func == &VGMPlayer::Cmd_DReg8_Data8)
+		{
+			evt.type = CMDEVT_YM;
+			chipID = (cmdData[0x01] & 0x80) >> 7;
+			evt.ofs = cmdData[0x01] & 0x7F;
+			evt.data = cmdData[0x02];
+		}
+		else if (func == &VGMPlayer::Cmd_MSM5205_Reg)
+		{
+			evt.type = CMDEVT_A8D8;
+			chipID = (cmdData[0x01] & 0x80) >> 7;
+			evt.ofs = (cmdData[0x01] >> 4) & 0x7;
+			evt.data = cmdData[0x01] & 0xF;
+		}
+		else if (func == &VGMPlayer::Cmd_Ofs8_Data8)
+		{
+			evt.type = CMDEVT_A8D8;
+			chipID = (cmdData[0x01] & 0x80) >> 7;
+			evt.ofs = cmdData[0x01] & 0x7F;
+			evt.data = cmdData[0x02];
+		}
+		else if (func == &VGMPlayer::Cmd_Port_Ofs8_Data8)
+		{
+			evt.type = CMDEVT_A8D8;
+			chipID = (cmdData[0x01] & 0x80) >> 7;
+			evt.ofs = cmdData[0x02];
+			evt.data = cmdData[0x03];
+		}
+		else if (func == &VGMPlayer::Cmd_Ofs16_Data8)
+		{
+			evt.type = CMDEVT_A16D8;
+			chipID = (cmdData[0x01] & 0x80) >> 7;
+			evt.ofs = ReadBE16(&cmdData[0x01]) & 0x7FFF;
+			evt.data = cmdData[0x03];
+		}
+		else if (func == &VGMPlayer::Cmd_SegaPCM_Mem)
+		{
+			evt.type = CMDEVT_A16D8;
+			chipID = (cmdData[0x02] & 0x80) >> 7;
+			evt.ofs = ReadLE16(&cmdData[0x01]) & 0x7FFF;
+			evt.data = cmdData[0x03];
+		}
+		else if (func == &VGMPlayer::Cmd_Ofs8_Data16)
+		{
+			evt.type = CMDEVT_A8D16;
+			chipID = (cmdData[0x01] & 0x80) >> 7;
+			evt.ofs = cmdData[0x01] & 0x7F;
+			evt.data = ReadLE16(&cmdData[0x02]);
+		}
+		else if (func == &VGMPlayer::Cmd_Ofs4_Data12)
+		{
+			evt.type = CMDEVT_A8D16;
+			chipID = (cmdData[0x01] & 0x80) >> 7;
+			evt.ofs = (cmdData[0x01] >> 4) & 0x07;
+			evt.data = ReadBE16(&cmdData[0x01]) & 0x0FFF;
+		}
+		else if (func == &VGMPlayer::Cmd_Ofs16_Data16)
+		{
+			evt.type = CMDEVT_A16D16;
+			chipID = (cmdData[0x01] & 0x80) >> 7;
+			evt.ofs = ReadBE16(&cmdData[0x01]) & 0x7FFF;
+			evt.data = ReadBE16(&cmdData[0x03]);
+		}
+		if (evt.type >= CMDEVT_A8D8 && cmdInf.chipType >= _CHIP_COUNT)
+			evt.type = CMDEVT_CALL;	// let the command handler deal with it
+		evt.tgtDev = (evt.type >= CMDEVT_A8D8) ? ((cmdInf.chipType << 1) | chipID) : 0x00;
+		if (evt.type != CMDEVT_CALL)
+			evt.len = (UINT8)cmdLen;
+		
+		if (_cmdEvents.size() >= CMDEVT_MAX_COUNT)
+		{
+			emu_logf(&_logger, PLRLOG_DEBUG, "Command event cache disabled: too many commands.\n");
+			std::vector<CMD_EVENT>().swap(_cmdEvents);
+			return;
+		}
+		_cmdEvents.push_back(evt);
+		filePos += cmdLen;
+	}
+	
+	return;
+}
+
+size_t VGMPlayer::FindCmdEvent(UINT32 filePos) const
+{
+	size_t posMin = 0;
+	size_t posMax = _cmdEvents.size();
+	
+	// binary search for the event at filePos
+	while(posMin < posMax)
+	{
+		size_t posMid = posMin + (posMax - posMin) / 2;
+		if (_cmdEvents[posMid].filePos < filePos)
+			posMin = posMid + 1;
+		else
+			posMax = posMid;
+	}
+	if (posMin < _cmdEvents.size() && _cmdEvents[posMin].filePos != filePos)
+		return _cmdEvents.size();	// not the start of a translated command
+	return posMin;
+}
+
+void VGMPlayer::ProcessCmdEvent(const CMD_EVENT& evt)
+{
+	CHIP_DEVICE* cDev;
+	
+	switch(evt.type)
+	{
+	case CMDEVT_CALL:
+		{
+			UINT8 curCmd = fData[0x00];
+			(this->*_CMD_INFO[curCmd].func)();
+			_filePos += _CMD_INFO[curCmd].cmdLen;
+		}
+		return;
+	case CMDEVT_WAIT:
+		_fileTick += evt.ofs;
+		_filePos += evt.len;
+		return;
+	}
+	
+	// equivalent to GetDevicePtr()
+	cDev = _cmdEvtDevs[evt.tgtDev];
+	if (cDev != NULL)
+	{
+		if (! _queueDevCmds)
+			RenderDevice(cDev, _renderSmpl);
+		switch(evt.type)
+		{
+		case CMDEVT_A8D8:
+			if (cDev->write8 != NULL)
+				DevWrite8(cDev, (UINT8)evt.ofs, (UINT8)evt.data);
+			break;
+		case CMDEVT_YM:
+			if (cDev->write8 != NULL)
+				SendYMCommand(cDev, evt.port, (UINT8)evt.ofs, (UINT8)evt.data);
+			break;
+		case CMDEVT_A16D8:
+			if (cDev->writeM8 != NULL)
+				DevWriteM8(cDev, evt.ofs, (UINT8)evt.data);
+			break;
+		case CMDEVT_A8D16:
+			if (cDev->writeD16 != NULL)
+				DevWriteD16(cDev, (UINT8)evt.ofs, evt.data);
+			break;
+		case CMDEVT_A16D16:
+			if (cDev->writeM16 != NULL)
+				DevWriteM16(cDev, evt.ofs, evt.data);
+			break;
+		}
+	}
+	_filePos += evt.len;
+	
+	return;
+}
@@ -0,0 +1,349 @@
+// PlayerA output conversion benchmark
+// -----------------------------------
+// Measures how fast PlayerA::Render applies the master volume, fading and phase inversion and converts
+// the samples to the output format. The samples come from a dummy player engine that just copies
+// pre-generated noise, so that the timing is dominated by PlayerA itself.
+// With -c, it instead checks the output against a simple per-sample reference conversion.
+//
+// Usage: playera_bench [-s seconds] [-c]
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+#include "stdtype.h"
+#include "player/playerbase.hpp"
+#include "player/playera.hpp"
+
+
+#define NOISE_SMPLS	4096	// must be a power of 2
+#define SMPL_RATE	44100
+
+// player engine that renders pre-generated noise, endlessly
+class NoiseEngine : public PlayerBase
+{
+public:
+	NoiseEngine();
+	const WAVE_32BS* GetNoise(void) const	{ return _noise; }
+
+	UINT8 CanLoadFile(DATA_LOADER *dataLoader) const	{ return 0x00; }
+	UINT8 LoadFile(DATA_LOADER *dataLoader)	{ return 0x00; }
+	UINT8 UnloadFile(void)	{ return 0x00; }
+	const char* const* GetTags(void)	{ return NULL; }
+	UINT8 GetSongInfo(PLR_SONG_INFO& songInf)	{ return 0xFF; }	// no song-specific volume gain
+	UINT8 GetSongDeviceInfo(std::vector<PLR_DEV_INFO>& devInfList) const	{ return 0xFF; }
+	UINT8 SetDeviceOptions(UINT32 id, const PLR_DEV_OPTS& devOpts)	{ return 0xFF; }
+	UINT8 GetDeviceOptions(UINT32 id, PLR_DEV_OPTS& devOpts) const	{ return 0xFF; }
+	UINT8 SetDeviceMuting(UINT32 id, const PLR_MUTE_OPTS& muteOpts)	{ return 0xFF; }
+	UINT8 GetDeviceMuting(UINT32 id, PLR_MUTE_OPTS& muteOpts) const	{ return 0xFF; }
+	UINT32 Tick2Sample(UINT32 ticks) const	{ return ticks; }
+	UINT32 Sample2Tick(UINT32 samples) const	{ return samples; }
+	double Tick2Second(UINT32 ticks) const	{ return ticks / (double)SMPL_RATE; }
+	UINT8 GetState(void) const	{ return _playState; }
+	UINT32 GetCurPos(UINT8 unit) const	{ return _curSmpl; }
+	UINT32 GetCurLoop(void) const	{ return 0; }
+	UINT32 GetTotalTicks(void) const	{ return (UINT32)-1; }
+	UINT32 GetLoopTicks(void) const	{ return 0; }
+	UINT8 Start(void)	{ _playState = PLAYSTATE_PLAY;	_curSmpl = 0;	return 0x00; }
+	UINT8 Stop(void)	{ _playState = 0x00;	return 0x00; }
+	UINT8 Reset(void)	{ _curSmpl = 0;	return 0x00; }
+	UINT8 Seek(UINT8 unit, UINT32 pos)	{ _curSmpl = pos;	return 0x00; }
+	UINT32 Render(UINT32 smplCnt, WAVE_32BS* data);
+
+private:
+	WAVE_32BS _noise[NOISE_SMPLS];
+	UINT8 _playState;
+	UINT32 _curSmpl;
+};
+
+struct OUT_FORMAT
+{
+	const char* name;
+	UINT8 bits;
+	UINT8 format;
+};
+
+static double GetTimeSec(void);
+static double BenchmarkFormat(PlayerA& player, const OUT_FORMAT& outFmt, bool fade, UINT32 outSmpls);
+static UINT32 RenderVarBlocks(PlayerA& player, UINT32 outSmpls, std::vector<UINT8>& outBuf);
+static void RefConvert(const WAVE_32BS* noise, UINT32 outSmpls, UINT8 bits, INT32 volume, UINT8 chnInvert, UINT8* outBuf);
+static int CheckFormats(PlayerA& player, const NoiseEngine* engine);
+
+static const OUT_FORMAT OUT_FORMATS[] =
+{
+	{"U8",  8,  PLR_SMPLFMT_INT},
+	{"S16", 16, PLR_SMPLFMT_INT},
+	{"S24", 24, PLR_SMPLFMT_INT},
+	{"S32", 32, PLR_SMPLFMT_INT},
+	{"F32", 32, PLR_SMPLFMT_FLOAT},
+};
+#define OUT_FMT_COUNT	(sizeof(OUT_FORMATS) / sizeof(OUT_FORMATS[0]))
+
+static const INT32 CHECK_VOLUMES[] =
+{
+	0x10000, 0x18000, 0x01234, -0x0C000, 0x7FFFF0, -0x7FFFF0,
+};
+#define CHECK_VOL_COUNT	(sizeof(CHECK_VOLUMES) / sizeof(CHECK_VOLUMES[0]))
+
+NoiseEngine::NoiseEngine() :
+	_playState(0x00),
+	_curSmpl(0)
+{
+	UINT32 seed = 0x12345678;
+	UINT32 curSmpl;
+
+	// pseudo-random samples in the range -0x1000000..0xFFFFFF, so that they also exceed the 24-bit output range
+	for (curSmpl = 0; curSmpl < NOISE_SMPLS; curSmpl ++)
+	{
+		seed = seed * 1103515245 + 12345;
+		_noise[curSmpl].L = (INT32)(seed >> 7) - 0x1000000;
+		seed = seed * 1103515245 + 12345;
+		_noise[curSmpl].R = (INT32)(seed >> 7) - 0x1000000;
+	}
+}
+
+UINT32 NoiseEngine::Render(UINT32 smplCnt, WAVE_32BS* data)
+{
+	UINT32 curSmpl;
+
+	for (curSmpl = 0; curSmpl < smplCnt; curSmpl ++)
+		data[curSmpl] = _noise[(_curSmpl + curSmpl) & (NOISE_SMPLS - 1)];
+	_curSmpl += smplCnt;
+	return smplCnt;
+}
+
+static double GetTimeSec(void)
+{
+#ifdef _WIN32
+	LARGE_INTEGER freq;
+	LARGE_INTEGER cntr;
+	QueryPerformanceFrequency(&freq);
+	QueryPerformanceCounter(&cntr);
+	return (double)cntr.QuadPart / (double)freq.QuadPart;
+#else
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1000000000.0;
+#endif
+}
+
+// returns the time for rendering outSmpls samples (in seconds)
+static double BenchmarkFormat(PlayerA& player, const OUT_FORMAT& outFmt, bool fade, UINT32 outSmpls)
+{
+	std::vector<UINT8> buffer(1024 * 2 * 4);
+	PlayerA::Config pCfg = player.GetConfiguration();
+	UINT32 bufSize;
+	UINT32 curSmpl;
+	double time;
+
+	player.SetOutputSettings(SMPL_RATE, 2, outFmt.bits, 1024, outFmt.format);
+	pCfg.masterVol = 0xC000;
+	pCfg.chnInvert = 0x00;
+	pCfg.fadeSmpls = outSmpls + 1024;	// keep fading during the whole test
+	pCfg.endSilenceSmpls = 0;
+	player.SetConfiguration(pCfg);
+	player.Start();
+	if (fade)
+		player.FadeOut();
+	bufSize = 1024 * 2 * outFmt.bits / 8;
+
+	time = GetTimeSec();
+	for (curSmpl = 0; curSmpl < outSmpls; curSmpl += 1024)
+		player.Render(bufSize, &buffer[0]);
+	time = GetTimeSec() - time;
+
+	player.Stop();
+	return time;
+}
+
+// renders outSmpls samples using varying block sizes, returns the number of samples rendered
+static UINT32 RenderVarBlocks(PlayerA& player, UINT32 outSmpls, std::vector<UINT8>& outBuf)
+{
+	UINT32 smplSize = (UINT32)(outBuf.size() / outSmpls);
+	UINT32 curSmpl;
+	UINT32 blkLen;
+
+	for (curSmpl = 0; curSmpl < outSmpls; curSmpl += blkLen)
+	{
+		blkLen = (curSmpl * 7 + 13) % 1000 + 1;
+		if (blkLen > outSmpls - curSmpl)
+			blkLen = outSmpls - curSmpl;
+		blkLen = player.Render(blkLen * smplSize, &outBuf[curSmpl * smplSize]) / smplSize;
+		if (! blkLen)
+			break;
+	}
+	return curSmpl;
+}
+
+// straightforward per-sample version of PlayerA's integer output conversion
+static void RefConvert(const WAVE_32BS* noise, UINT32 outSmpls, UINT8 bits, INT32 volume, UINT8 chnInvert, UINT8* outBuf)
+{
+	UINT32 smplSize = bits / 8;
+	UINT32 curSmpl;
+	UINT8 curChn;
+
+	for (curSmpl = 0; curSmpl < outSmpls; curSmpl ++)
+	{
+		const WAVE_32BS& inSmpl = noise[curSmpl & (NOISE_SMPLS - 1)];
+		for (curChn = 0; curChn < 2; curChn ++)
+		{
+			INT32 value = (curChn == 0) ? inSmpl.L : inSmpl.R;
+			UINT8* dst = &outBuf[(curSmpl * 2 + curChn) * smplSize];
+
+			value = (INT32)(((INT64)value * volume) >> 16);
+			if (chnInvert & (1 << curChn))
+				value = -value;
+			if (bits == 8)
+			{
+				value >>= 16;
+				value = (value < -0x80) ? -0x80 : (value > 0x7F) ? 0x7F : value;
+				dst[0] = (UINT8)(0x80 + value);
+				continue;
+			}
+			else if (bits == 16)
+			{
+				INT16 v16;
+				value >>= 8;
+				value = (value < -0x8000) ? -0x8000 : (value > 0x7FFF) ? 0x7FFF : value;
+				v16 = (INT16)value;
+				memcpy(dst, &v16, 2);
+				continue;
+			}
+
+			value = (value < -0x800000) ? -0x800000 : (value > 0x7FFFFF) ? 0x7FFFFF : value;
+			if (bits == 24)
+			{
+#if defined(VGM_LITTLE_ENDIAN)
+				dst[0] = (value >>  0) & 0xFF;
+				dst[1] = (value >>  8) & 0xFF;
+				dst[2] = (value >> 16) & 0xFF;
+#else
+				dst[0] = (value >> 16) & 0xFF;
+				dst[1] = (value >>  8) & 0xFF;
+				dst[2] = (value >>  0) & 0xFF;
+#endif
+			}
+			else
+			{
+				value *= (1 << 8);
+				memcpy(dst, &value, 4);
+			}
+		}
+	}
+
+	return;
+}
+
+// renders all integer formats with various volumes and channel inversion settings and compares the results
+// returns the number of failed tests
+static int CheckFormats(PlayerA& player, const NoiseEngine* engine)
+{
+	UINT32 outSmpls = SMPL_RATE;
+	size_t curFmt;
+	size_t curVol;
+	UINT8 chnInvert;
+	int errors = 0;
+
+	printf("Comparing PlayerA output against the reference conversion.\n");
+	for (curFmt = 0; curFmt < OUT_FMT_COUNT; curFmt ++)
+	{
+		const OUT_FORMAT& outFmt = OUT_FORMATS[curFmt];
+		UINT32 bufSize = outSmpls * 2 * outFmt.bits / 8;
+		std::vector<UINT8> outBuf(bufSize);
+		std::vector<UINT8> refBuf(bufSize);
+
+		if (outFmt.format != PLR_SMPLFMT_INT)
+			continue;	// float output isn't bit-exact by design
+		player.SetOutputSettings(SMPL_RATE, 2, outFmt.bits, 1000, outFmt.format);
+		for (curVol = 0; curVol < CHECK_VOL_COUNT; curVol ++)
+		{
+			for (chnInvert = 0x00; chnInvert < 0x04; chnInvert ++)
+			{
+				PlayerA::Config pCfg = player.GetConfiguration();
+				UINT32 smplCnt;
+				UINT32 curPos;
+
+				pCfg.masterVol = CHECK_VOLUMES[curVol];
+				pCfg.chnInvert = chnInvert;
+				pCfg.fadeSmpls = 0;
+				pCfg.endSilenceSmpls = 0;
+				player.SetConfiguration(pCfg);
+				player.Start();
+				memset(&outBuf[0], 0x00, bufSize);
+				smplCnt = RenderVarBlocks(player, outSmpls, outBuf);
+				player.Stop();
+
+				RefConvert(engine->GetNoise(), outSmpls, outFmt.bits, pCfg.masterVol, chnInvert, &refBuf[0]);
+				for (curPos = 0; curPos < bufSize; curPos ++)
+				{
+					if (outBuf[curPos] != refBuf[curPos])
+						break;
+				}
+				if (smplCnt < outSmpls || curPos < bufSize)
+				{
+					printf("%-4s volume %8X, inversion %u - FAILED at byte %u\n", outFmt.name,
+						pCfg.masterVol, chnInvert, curPos);
+					errors ++;
+				}
+			}
+		}
+		printf("%-4s done\n", outFmt.name);
+	}
+
+	return errors;
+}
+
+int main(int argc, char* argv[])
+{
+	PlayerA player;
+	NoiseEngine* engine;
+	UINT32 seconds;
+	UINT8 check;
+	int curArg;
+	size_t curFmt;
+
+	seconds = 60;
+	check = 0;
+	for (curArg = 1; curArg < argc; curArg ++)
+	{
+		if (! strcmp(argv[curArg], "-c"))
+			check = 1;
+		else if (curArg + 1 >= argc)
+			break;
+		else if (! strcmp(argv[curArg], "-s"))
+			seconds = (UINT32)strtoul(argv[++ curArg], NULL, 0);
+		else
+			break;
+	}
+	if (curArg < argc || ! seconds)
+	{
+		printf("PlayerA output conversion benchmark\n");
+		printf("Usage: %s [-s seconds] [-c]\n", argv[0]);
+		printf("    -c  compare the output against a reference conversion instead of benchmarking\n");
+		return 0;
+	}
+
+	engine = new NoiseEngine;
+	player.RegisterPlayerEngine(engine);	// PlayerA takes ownership
+	player.SetLoopCount(0);
+	player.LoadFile(NULL);	// the noise engine accepts anything
+	if (check)
+		return CheckFormats(player, engine) ? 1 : 0;
+
+	printf("Rendering %u s of audio at %u Hz per test, results in real-time multiples.\n", seconds, SMPL_RATE);
+	printf("%-6s %10s %10s\n", "Format", "Constant", "Fading");
+	for (curFmt = 0; curFmt < OUT_FMT_COUNT; curFmt ++)
+	{
+		double timeConst = BenchmarkFormat(player, OUT_FORMATS[curFmt], false, seconds * SMPL_RATE);
+		double timeFade = BenchmarkFormat(player, OUT_FORMATS[curFmt], true, seconds * SMPL_RATE);
+		printf("%-6s %9.0fx %9.0fx\n", OUT_FORMATS[curFmt].name, seconds / timeConst, seconds / timeFade);
+		fflush(stdout);
+	}
+
+	return 0;
+}
@@ -0,0 +1,302 @@
+// Resampler throughput benchmark
+// ------------------------------
+// Measures how many output samples per second each resampling mode produces for a number of typical
+// chip sample rates. The input comes from a dummy device that generates a sine wave, so that the timing
+// is dominated by the resampler itself.
+// With -c, it instead checks that the SIMD code paths produce the same output as the plain C code.
+//
+// Usage: resampler_bench [-s seconds] [-r output_rate] [-m simd_mask] [-c]
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "stdtype.h"
+#include "emu/EmuStructs.h"
+#include "emu/Resampler.h"
+
+
+typedef struct _dummy_device
+{
+	INT32 smplL;
+	INT32 stepL;
+	INT32 smplR;
+	INT32 stepR;
+} DUMMY_DEV;
+
+typedef struct _noise_device
+{
+	UINT32 seed;
+} NOISE_DEV;
+
+static double GetTimeSec(void);
+static void DummyDev_Update(void* info, UINT32 samples, DEV_SMPL** outputs);
+static void NoiseDev_Update(void* info, UINT32 samples, DEV_SMPL** outputs);
+static double BenchmarkMode(UINT8 mode, UINT32 srcRate, UINT32 dstRate, UINT32 outSmpls);
+static void RenderNoise(UINT8 mode, UINT32 srcRate, UINT32 dstRate, UINT32 outSmpls, WAVE_32BS* smplBuf);
+static int CheckSIMD(UINT32 dstRate);
+
+static const UINT32 SRC_RATES[] =
+{
+	22050,		// upsampling (e.g. OKIM6295)
+	44100,		// same rate (copy)
+	53267,		// YM2612 (7.67 MHz / 144)
+	62500,		// YM2151 (4 MHz / 64)
+	223722,		// AY8910 (1.79 MHz / 8)
+	1048576,	// GameBoy (4.19 MHz / 4)
+};
+#define SRC_RATE_COUNT	(sizeof(SRC_RATES) / sizeof(SRC_RATES[0]))
+
+static const char* const MODE_NAMES[] =
+{
+	"Linear",
+	"Nearest",
+	"LUp/NDown",
+	"Sinc",
+	"Sinc HQ",
+};
+#define MODE_COUNT	(sizeof(MODE_NAMES) / sizeof(MODE_NAMES[0]))
+
+static double GetTimeSec(void)
+{
+#ifdef _WIN32
+	LARGE_INTEGER freq;
+	LARGE_INTEGER cntr;
+	QueryPerformanceFrequency(&freq);
+	QueryPerformanceCounter(&cntr);
+	return (double)cntr.QuadPart / (double)freq.QuadPart;
+#else
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1000000000.0;
+#endif
+}
+
+// triangle waves, cheap to generate
+static void DummyDev_Update(void* info, UINT32 samples, DEV_SMPL** outputs)
+{
+	DUMMY_DEV* dev = (DUMMY_DEV*)info;
+	UINT32 curSmpl;
+
+	for (curSmpl = 0; curSmpl < samples; curSmpl ++)
+	{
+		dev->smplL += dev->stepL;
+		if (dev->smplL > 0x4000 || dev->smplL < -0x4000)
+			dev->stepL = -dev->stepL;
+		dev->smplR += dev->stepR;
+		if (dev->smplR > 0x4000 || dev->smplR < -0x4000)
+			dev->stepR = -dev->stepR;
+		outputs[0][curSmpl] = dev->smplL;
+		outputs[1][curSmpl] = dev->smplR;
+	}
+
+	return;
+}
+
+// pseudo-random samples in the range -0x100000..0xFFFFF
+static void NoiseDev_Update(void* info, UINT32 samples, DEV_SMPL** outputs)
+{
+	NOISE_DEV* dev = (NOISE_DEV*)info;
+	UINT32 curSmpl;
+
+	for (curSmpl = 0; curSmpl < samples; curSmpl ++)
+	{
+		dev->seed = dev->seed * 1103515245 + 12345;
+		outputs[0][curSmpl] = (DEV_SMPL)(dev->seed >> 11) - 0x100000;
+		dev->seed = dev->seed * 1103515245 + 12345;
+		outputs[1][curSmpl] = (DEV_SMPL)(dev->seed >> 11) - 0x100000;
+	}
+
+	return;
+}
+
+// returns the time for rendering outSmpls samples (in seconds)
+static double BenchmarkMode(UINT8 mode, UINT32 srcRate, UINT32 dstRate, UINT32 outSmpls)
+{
+	RESMPL_STATE resmpl;
+	DUMMY_DEV dummyDev;
+	WAVE_32BS smplBuf[1024];
+	UINT32 curSmpl;
+	double time;
+
+	dummyDev.smplL = 0;	dummyDev.stepL = 0x101;
+	dummyDev.smplR = 0;	dummyDev.stepR = 0x0C3;
+	memset(&resmpl, 0x00, sizeof(RESMPL_STATE));
+	Resmpl_SetVals(&resmpl, mode, 0x100, dstRate);
+	resmpl.smpRateSrc = srcRate;
+	resmpl.StreamUpdate = DummyDev_Update;
+	resmpl.su_DataPtr = &dummyDev;
+	Resmpl_Init(&resmpl);
+
+	// warm-up, allocates all buffers
+	memset(smplBuf, 0x00, sizeof(smplBuf));
+	Resmpl_Execute(&resmpl, 1024, smplBuf);
+
+	time = GetTimeSec();
+	for (curSmpl = 0; curSmpl < outSmpls; curSmpl += 1024)
+	{
+		memset(smplBuf, 0x00, sizeof(smplBuf));
+		Resmpl_Execute(&resmpl, 1024, smplBuf);
+	}
+	time = GetTimeSec() - time;
+
+	Resmpl_Deinit(&resmpl);
+	return time;
+}
+
+// renders outSmpls samples of pseudo-random input, using varying block sizes and different volumes per channel
+static void RenderNoise(UINT8 mode, UINT32 srcRate, UINT32 dstRate, UINT32 outSmpls, WAVE_32BS* smplBuf)
+{
+	RESMPL_STATE resmpl;
+	NOISE_DEV noiseDev;
+	UINT32 curSmpl;
+	UINT32 blkLen;
+
+	noiseDev.seed = srcRate;
+	memset(&resmpl, 0x00, sizeof(RESMPL_STATE));
+	Resmpl_SetVals(&resmpl, mode, 0x100, dstRate);
+	resmpl.volumeL = 0x1B7;
+	resmpl.volumeR = 0x05C;
+	resmpl.smpRateSrc = srcRate;
+	resmpl.StreamUpdate = NoiseDev_Update;
+	resmpl.su_DataPtr = &noiseDev;
+	Resmpl_Init(&resmpl);
+
+	memset(smplBuf, 0x00, outSmpls * sizeof(WAVE_32BS));
+	for (curSmpl = 0; curSmpl < outSmpls; curSmpl += blkLen)
+	{
+		blkLen = (curSmpl * 7 + 13) % 1000 + 1;
+		if (blkLen > outSmpls - curSmpl)
+			blkLen = outSmpls - curSmpl;
+		Resmpl_Execute(&resmpl, blkLen, &smplBuf[curSmpl]);
+	}
+
+	Resmpl_Deinit(&resmpl);
+	return;
+}
+
+// renders with the plain C code and with each supported SIMD instruction set and compares the results
+// returns the number of failed tests
+static int CheckSIMD(UINT32 dstRate)
+{
+	UINT32 outSmpls = dstRate;
+	WAVE_32BS* refBuf = (WAVE_32BS*)malloc(outSmpls * sizeof(WAVE_32BS));
+	WAVE_32BS* simdBuf = (WAVE_32BS*)malloc(outSmpls * sizeof(WAVE_32BS));
+	UINT8 simdSupport = Resmpl_GetSIMDSupport();
+	UINT8 simdMask;
+	size_t curRate;
+	size_t curMode;
+	int errors = 0;
+
+	printf("Comparing SIMD code (supported: 0x%02X) against plain C code.\n", simdSupport);
+	for (simdMask = 0x01; simdMask & 0x07; simdMask <<= 1)
+	{
+		if (! (simdSupport & simdMask))
+			continue;
+		for (curRate = 0; curRate < SRC_RATE_COUNT; curRate ++)
+		{
+			for (curMode = 0; curMode < MODE_COUNT; curMode ++)
+			{
+				INT32 maxDiff = 0;
+				INT32 maxAllowed;
+				UINT32 curSmpl;
+
+				Resmpl_SetSIMDMask(0x00);
+				RenderNoise((UINT8)curMode, SRC_RATES[curRate], dstRate, outSmpls, refBuf);
+				Resmpl_SetSIMDMask(simdMask);
+				RenderNoise((UINT8)curMode, SRC_RATES[curRate], dstRate, outSmpls, simdBuf);
+				for (curSmpl = 0; curSmpl < outSmpls; curSmpl ++)
+				{
+					INT32 diffL = abs(simdBuf[curSmpl].L - refBuf[curSmpl].L);
+					INT32 diffR = abs(simdBuf[curSmpl].R - refBuf[curSmpl].R);
+					if (maxDiff < diffL)
+						maxDiff = diffL;
+					if (maxDiff < diffR)
+						maxDiff = diffR;
+				}
+
+				// The sinc modes calculate in floating point and the SIMD code sums up in a different order.
+				// The output peaks at about 2^29 there, so allow for a few rounding errors of the 24-bit mantissa.
+				if (curMode == RSMODE_SINC || curMode == RSMODE_SINC_HQ)
+					maxAllowed = 0x400;
+				else
+					maxAllowed = 0;
+				printf("0x%02X  %-10u %-10s max. difference %d%s\n", simdMask, SRC_RATES[curRate],
+					MODE_NAMES[curMode], maxDiff, (maxDiff > maxAllowed) ? " - FAILED" : "");
+				if (maxDiff > maxAllowed)
+					errors ++;
+			}
+		}
+	}
+	Resmpl_SetSIMDMask(0xFF);
+
+	free(refBuf);
+	free(simdBuf);
+	return errors;
+}
+
+int main(int argc, char* argv[])
+{
+	UINT32 seconds;
+	UINT32 dstRate;
+	UINT8 simdMask;
+	UINT8 check;
+	int curArg;
+	size_t curRate;
+	size_t curMode;
+
+	seconds = 60;
+	dstRate = 44100;
+	simdMask = 0xFF;
+	check = 0;
+	for (curArg = 1; curArg < argc; curArg ++)
+	{
+		if (! strcmp(argv[curArg], "-c"))
+			check = 1;
+		else if (curArg + 1 >= argc)
+			break;
+		else if (! strcmp(argv[curArg], "-s"))
+			seconds = (UINT32)strtoul(argv[++ curArg], NULL, 0);
+		else if (! strcmp(argv[curArg], "-r"))
+			dstRate = (UINT32)strtoul(argv[++ curArg], NULL, 0);
+		else if (! strcmp(argv[curArg], "-m"))
+			simdMask = (UINT8)strtoul(argv[++ curArg], NULL, 0);
+		else
+			break;
+	}
+	if (curArg < argc || ! seconds || ! dstRate)
+	{
+		printf("Resampler throughput benchmark\n");
+		printf("Usage: %s [-s seconds] [-r output_rate] [-m simd_mask] [-c]\n", argv[0]);
+		printf("    -m  SIMD instruction sets to use: 0x01 = SSE2, 0x02 = AVX2, 0x04 = NEON (default: all)\n");
+		printf("    -c  compare the SIMD code against the plain C code instead of benchmarking\n");
+		return 0;
+	}
+	if (check)
+		return CheckSIMD(dstRate) ? 1 : 0;
+
+	Resmpl_SetSIMDMask(simdMask);
+	printf("Rendering %u s of audio at %u Hz per test, results in real-time multiples.\n", seconds, dstRate);
+	printf("SIMD support: 0x%02X, used: 0x%02X\n", Resmpl_GetSIMDSupport(), Resmpl_GetSIMDSupport() & simdMask);
+	printf("%-10s", "Src. Rate");
+	for (curMode = 0; curMode < MODE_COUNT; curMode ++)
+		printf(" %10s", MODE_NAMES[curMode]);
+	printf("\n");
+	for (curRate = 0; curRate < SRC_RATE_COUNT; curRate ++)
+	{
+		printf("%-10u", SRC_RATES[curRate]);
+		for (curMode = 0; curMode < MODE_COUNT; curMode ++)
+		{
+			double time = BenchmarkMode((UINT8)curMode, SRC_RATES[curRate], dstRate, seconds * dstRate);
+			printf(" %9.0fx", seconds / time);
+			fflush(stdout);
+		}
+		printf("\n");
+	}
+
+	return 0;
+}
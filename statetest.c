@@ -0,0 +1,352 @@
+// Sound core save state test
+// --------------------------
+// Runs the register write script of every core of every built-in sound device for a while, then saves
+// the state of the device (and its linked devices), renders some more, restores the state and renders
+// the same part again. Both renderings must be bit-identical.
+// Returns exit code 1 when a core fails. Cores without save state support are listed, but not counted
+// as failures.
+//
+// Usage: statetest [-d device_id] [-c core]
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "stdtype.h"
+#include "emu/EmuStructs.h"
+#include "emu/SoundEmu.h"
+#include "emu/SoundDevs.h"
+#include "player/helper.h"
+#include "core_scripts.h"
+
+
+#define SMPL_RATE		44100	// only used by cores that don't have a native sample rate
+#define SMPL_BUF_SIZE	0x400
+#define MAX_CHAIN		4		// maximum number of devices (including linked ones)
+#define PRE_TICKS		(TICK_RATE * 3 / 2)	// script ticks before saving the state
+#define CMP_TICKS		(TICK_RATE * 1)		// script ticks rendered after saving/restoring the state
+
+typedef struct _capture_buffer
+{
+	UINT32 size;	// allocated samples
+	UINT32 count;	// captured samples
+	DEV_SMPL* data[2];
+} CAPTURE_BUF;
+
+typedef struct _test_state
+{
+	UINT32 devCount;
+	VGM_BASEDEV* devs[MAX_CHAIN];
+	UINT64 smplPos[MAX_CHAIN];	// samples rendered per device
+	CAPTURE_BUF* capture;		// NULL = discard the output, else one buffer per device
+} TEST_STATE;
+
+enum
+{
+	TRES_OK = 0,
+	TRES_UNSUPPORTED,
+	TRES_START_ERR,
+	TRES_SAVE_ERR,
+	TRES_LOAD_ERR,
+	TRES_MISMATCH,
+};
+
+static void RenderTo(void* userParam, UINT64 timeNum, UINT64 timeDen);
+static void FreeCaptures(CAPTURE_BUF* captures, UINT32 count);
+static UINT8 CompareCaptures(const CAPTURE_BUF* capA, const CAPTURE_BUF* capB, UINT32 count, UINT32* retDev, UINT32* retPos);
+static UINT8 TestCore(const SCRIPT_DEF* sDef, const DEV_DEF* devDef, UINT32* retDev, UINT32* retPos);
+
+
+static DEV_SMPL smplBufL[SMPL_BUF_SIZE];
+static DEV_SMPL smplBufR[SMPL_BUF_SIZE];
+
+static void RenderTo(void* userParam, UINT64 timeNum, UINT64 timeDen)
+{
+	TEST_STATE* tState = (TEST_STATE*)userParam;
+	DEV_SMPL* smplBufs[2];
+	UINT32 curDev;
+	UINT32 smplCnt;
+	UINT64 target;
+
+	smplBufs[0] = smplBufL;
+	smplBufs[1] = smplBufR;
+	for (curDev = 0; curDev < tState->devCount; curDev ++)
+	{
+		DEV_INFO* devInf = &tState->devs[curDev]->defInf;
+		target = timeNum * devInf->sampleRate / timeDen;
+		while(tState->smplPos[curDev] < target)
+		{
+			smplCnt = (target - tState->smplPos[curDev] > SMPL_BUF_SIZE) ?
+				SMPL_BUF_SIZE : (UINT32)(target - tState->smplPos[curDev]);
+			devInf->devDef->Update(devInf->dataPtr, smplCnt, smplBufs);
+			tState->smplPos[curDev] += smplCnt;
+			if (tState->capture != NULL)
+			{
+				CAPTURE_BUF* cBuf = &tState->capture[curDev];
+				if (cBuf->count + smplCnt > cBuf->size)
+				{
+					cBuf->size = (cBuf->count + smplCnt) * 2;
+					cBuf->data[0] = (DEV_SMPL*)realloc(cBuf->data[0], cBuf->size * sizeof(DEV_SMPL));
+					cBuf->data[1] = (DEV_SMPL*)realloc(cBuf->data[1], cBuf->size * sizeof(DEV_SMPL));
+				}
+				memcpy(&cBuf->data[0][cBuf->count], smplBufL, smplCnt * sizeof(DEV_SMPL));
+				memcpy(&cBuf->data[1][cBuf->count], smplBufR, smplCnt * sizeof(DEV_SMPL));
+				cBuf->count += smplCnt;
+			}
+		}
+	}
+
+	return;
+}
+
+static void FreeCaptures(CAPTURE_BUF* captures, UINT32 count)
+{
+	UINT32 curDev;
+
+	for (curDev = 0; curDev < count; curDev ++)
+	{
+		free(captures[curDev].data[0]);
+		free(captures[curDev].data[1]);
+	}
+	memset(captures, 0x00, count * sizeof(CAPTURE_BUF));
+
+	return;
+}
+
+static UINT8 CompareCaptures(const CAPTURE_BUF* capA, const CAPTURE_BUF* capB, UINT32 count, UINT32* retDev, UINT32* retPos)
+{
+	UINT32 curDev;
+	UINT32 curSmpl;
+
+	for (curDev = 0; curDev < count; curDev ++)
+	{
+		const CAPTURE_BUF* cA = &capA[curDev];
+		const CAPTURE_BUF* cB = &capB[curDev];
+		UINT32 minCnt = (cA->count < cB->count) ? cA->count : cB->count;
+
+		*retDev = curDev;
+		for (curSmpl = 0; curSmpl < minCnt; curSmpl ++)
+		{
+			if (cA->data[0][curSmpl] != cB->data[0][curSmpl] || cA->data[1][curSmpl] != cB->data[1][curSmpl])
+			{
+				*retPos = curSmpl;
+				return 1;
+			}
+		}
+		if (cA->count != cB->count)
+		{
+			*retPos = minCnt;
+			return 1;
+		}
+	}
+
+	return 0;
+}
+
+static UINT8 TestCore(const SCRIPT_DEF* sDef, const DEV_DEF* devDef, UINT32* retDev, UINT32* retPos)
+{
+	SCRIPT_DEV sDev;
+	SCRIPT_POS sPos;
+	SCRIPT_POS savePos;
+	TEST_STATE tState;
+	UINT64 saveSmplPos[MAX_CHAIN];
+	UINT32 saveRate[MAX_CHAIN];
+	void* stateData[MAX_CHAIN];
+	UINT32 stateSize[MAX_CHAIN];
+	CAPTURE_BUF capA[MAX_CHAIN];
+	CAPTURE_BUF capB[MAX_CHAIN];
+	VGM_BASEDEV* clDev;
+	UINT32 curDev;
+	UINT8 result;
+
+	if (CoreScript_Start(sDef, devDef, DEVRI_SRMODE_NATIVE, SMPL_RATE, &sDev))
+		return TRES_START_ERR;
+
+	memset(&tState, 0x00, sizeof(TEST_STATE));
+	for (clDev = &sDev.base; clDev != NULL && tState.devCount < MAX_CHAIN; clDev = clDev->linkDev)
+		tState.devs[tState.devCount ++] = clDev;
+	memset(stateData, 0x00, sizeof(stateData));
+	memset(capA, 0x00, sizeof(capA));
+	memset(capB, 0x00, sizeof(capB));
+	result = TRES_OK;
+
+	for (curDev = 0; curDev < tState.devCount; curDev ++)
+	{
+		if (! SndEmu_GetStateSize(&tState.devs[curDev]->defInf))
+		{
+			*retDev = curDev;
+			result = TRES_UNSUPPORTED;
+			goto cleanup;
+		}
+	}
+
+	sDef->init(&sDev);
+	memset(&sPos, 0x00, sizeof(SCRIPT_POS));
+	CoreScript_Advance(sDef, &sDev, &sPos, PRE_TICKS, RenderTo, &tState);
+	RenderTo(&tState, PRE_TICKS, TICK_RATE);
+
+	savePos = sPos;
+	for (curDev = 0; curDev < tState.devCount; curDev ++)
+	{
+		saveSmplPos[curDev] = tState.smplPos[curDev];
+		saveRate[curDev] = tState.devs[curDev]->defInf.sampleRate;
+		// The size can change while running. (e.g. when the script allocates sample RAM)
+		stateSize[curDev] = SndEmu_GetStateSize(&tState.devs[curDev]->defInf);
+		stateData[curDev] = malloc(stateSize[curDev]);
+		if (SndEmu_SaveState(&tState.devs[curDev]->defInf, stateSize[curDev], stateData[curDev]))
+		{
+			*retDev = curDev;
+			result = TRES_SAVE_ERR;
+			goto cleanup;
+		}
+	}
+
+	tState.capture = capA;
+	CoreScript_Advance(sDef, &sDev, &sPos, PRE_TICKS + CMP_TICKS, RenderTo, &tState);
+	RenderTo(&tState, PRE_TICKS + CMP_TICKS, TICK_RATE);
+
+	for (curDev = 0; curDev < tState.devCount; curDev ++)
+	{
+		if (SndEmu_LoadState(&tState.devs[curDev]->defInf, stateSize[curDev], stateData[curDev]))
+		{
+			*retDev = curDev;
+			result = TRES_LOAD_ERR;
+			goto cleanup;
+		}
+		tState.smplPos[curDev] = saveSmplPos[curDev];
+		if (tState.devs[curDev]->defInf.sampleRate != saveRate[curDev])
+		{
+			// the core must report the restored sample rate
+			*retDev = curDev;
+			*retPos = 0;
+			result = TRES_MISMATCH;
+			goto cleanup;
+		}
+	}
+	sPos = savePos;
+
+	tState.capture = capB;
+	CoreScript_Advance(sDef, &sDev, &sPos, PRE_TICKS + CMP_TICKS, RenderTo, &tState);
+	RenderTo(&tState, PRE_TICKS + CMP_TICKS, TICK_RATE);
+
+	if (CompareCaptures(capA, capB, tState.devCount, retDev, retPos))
+		result = TRES_MISMATCH;
+
+cleanup:
+	for (curDev = 0; curDev < tState.devCount; curDev ++)
+		free(stateData[curDev]);
+	FreeCaptures(capA, MAX_CHAIN);
+	FreeCaptures(capB, MAX_CHAIN);
+	FreeDeviceTree(&sDev.base, 0);
+	return result;
+}
+
+int main(int argc, char* argv[])
+{
+	UINT32 devFilter;
+	const char* coreFilter;
+	UINT32 coreCnt;
+	UINT32 skipCnt;
+	UINT32 failCnt;
+	int curArg;
+	const DEV_DECL* const* curDecl;
+
+	devFilter = (UINT32)-1;
+	coreFilter = NULL;
+	for (curArg = 1; curArg < argc; curArg ++)
+	{
+		if (curArg + 1 >= argc)
+			break;
+		else if (! strcmp(argv[curArg], "-d"))
+			devFilter = (UINT32)strtoul(argv[++ curArg], NULL, 0);
+		else if (! strcmp(argv[curArg], "-c"))
+			coreFilter = argv[++ curArg];
+		else
+			break;
+	}
+	if (curArg < argc)
+	{
+		printf("Sound core save state test\n");
+		printf("Usage: %s [-d device_id] [-c core]\n", argv[0]);
+		printf("    -d  only test the device with this ID (see SoundDevs.h)\n");
+		printf("    -c  only test the core with this four-character code (e.g. MAME)\n");
+		return 0;
+	}
+
+	CoreScript_Init();
+	coreCnt = skipCnt = failCnt = 0;
+	for (curDecl = sndEmu_Devices; *curDecl != NULL; curDecl ++)
+	{
+		const DEV_DECL* devDecl = *curDecl;
+		const SCRIPT_DEF* sDef;
+		const DEV_DEF* const* curCore;
+		DEV_GEN_CFG nameCfg;
+		const char* devName;
+
+		if (devFilter != (UINT32)-1 && devDecl->deviceID != devFilter)
+			continue;
+		sDef = CoreScript_GetDef(devDecl->deviceID);
+		memset(&nameCfg, 0x00, sizeof(DEV_GEN_CFG));
+		if (sDef != NULL)
+		{
+			nameCfg.clock = sDef->clock;
+			nameCfg.flags = sDef->flags;
+		}
+		devName = devDecl->name(&nameCfg);
+		if (devName == NULL)
+			devName = "???";
+		if (devDecl->cores[0] == NULL || sDef == NULL)
+		{
+			printf("0x%02X %-12s %s\n", devDecl->deviceID, devName,
+				(devDecl->cores[0] == NULL) ? "no cores" : "no test script");
+			continue;
+		}
+
+		for (curCore = devDecl->cores; *curCore != NULL; curCore ++)
+		{
+			const DEV_DEF* devDef = *curCore;
+			char coreStr[8];
+			UINT32 errDev = 0;
+			UINT32 errPos = 0;
+			UINT8 retVal;
+
+			CoreScript_FCC2Str(devDef->coreID, coreStr);
+			if (coreFilter != NULL && strcmp(coreFilter, coreStr))
+				continue;
+
+			coreCnt ++;
+			printf("0x%02X %-12s %-5s ", devDecl->deviceID, devName, coreStr);
+			retVal = TestCore(sDef, devDef, &errDev, &errPos);
+			switch(retVal)
+			{
+			case TRES_OK:
+				printf("ok\n");
+				break;
+			case TRES_UNSUPPORTED:
+				printf("no save state support (device %u)\n", errDev);
+				skipCnt ++;
+				break;
+			case TRES_START_ERR:
+				printf("error starting device\n");
+				failCnt ++;
+				break;
+			case TRES_SAVE_ERR:
+				printf("error saving state (device %u)\n", errDev);
+				failCnt ++;
+				break;
+			case TRES_LOAD_ERR:
+				printf("error loading state (device %u)\n", errDev);
+				failCnt ++;
+				break;
+			case TRES_MISMATCH:
+				printf("MISMATCH after restoring (device %u, sample %u)\n", errDev, errPos);
+				failCnt ++;
+				break;
+			}
+			fflush(stdout);
+		}
+	}
+	CoreScript_Deinit();
+
+	printf("%u cores tested, %u without save state support, %u failed\n", coreCnt, skipCnt, failCnt);
+	return failCnt ? 1 : 0;
+}
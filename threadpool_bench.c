@@ -0,0 +1,393 @@
+// Thread pool benchmark
+// ---------------------
+// Measures the overhead of dispatching tasks to the thread pool for various numbers of worker threads:
+//	- "Submit": empty tasks queued by the controlling thread, followed by a single ThreadPool_Wait()
+//	- "Fork-Join": one empty task per thread, followed by ThreadPool_Wait(), repeated
+//	- "Spawn": a binary tree of tasks that queue their children via ThreadPool_Spawn() (work stealing)
+// With -c, it instead runs a stress test that checks that every task is executed exactly once,
+// that a worker never runs two tasks at the same time and that scratch memory isn't shared.
+//
+// Usage: threadpool_bench [-s seconds] [-t max_threads] [-c]
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "stdtype.h"
+#include "utils/ThreadPool.h"
+
+
+#define SUBMIT_TASKS	0x10000
+#define SPAWN_DEPTH		16	// 2^17 - 1 tasks per tree
+
+typedef struct _tree_node TREE_NODE;
+typedef struct _stress_tree
+{
+	THREAD_POOL* pool;
+	UINT32 nodeCount;
+	UINT32 fanOut;
+	TREE_NODE* nodes;
+	UINT32* busy;	// per worker: set while running a task
+	UINT32* taskCnt;	// per worker: number of executed tasks
+	volatile UINT32 errors;
+} STRESS_TREE;
+struct _tree_node
+{
+	STRESS_TREE* tree;
+	UINT32 index;
+	UINT32 visits;
+	UINT32 scratchSize;
+};
+
+static double GetTimeSec(void);
+static void EmptyTask(void* param);
+static void SpawnTask(THRPOOL_WORKER* worker, void* param);
+static double BenchSubmit(THREAD_POOL* pool, UINT32* retTasks, double minTime);
+static double BenchForkJoin(THREAD_POOL* pool, UINT32* retRounds, double minTime);
+static double BenchSpawn(THREAD_POOL* pool, UINT32* retTasks, double minTime);
+static void StressTask(THRPOOL_WORKER* worker, void* param);
+static void StressPlainTask(void* param);
+static UINT32 StressRun(UINT32 threads, UINT32 seed);
+static int StressTest(UINT32 maxThreads, UINT32 seconds);
+
+
+static double GetTimeSec(void)
+{
+#ifdef _WIN32
+	LARGE_INTEGER freq;
+	LARGE_INTEGER cntr;
+	QueryPerformanceFrequency(&freq);
+	QueryPerformanceCounter(&cntr);
+	return (double)cntr.QuadPart / (double)freq.QuadPart;
+#else
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1000000000.0;
+#endif
+}
+
+static void EmptyTask(void* param)
+{
+	return;
+}
+
+// param = remaining depth
+static void SpawnTask(THRPOOL_WORKER* worker, void* param)
+{
+	size_t depth = (size_t)param;
+
+	if (depth > 0)
+	{
+		// Spawning only fails when running out of memory, so just do the work directly then.
+		if (ThreadPool_Spawn(worker, &SpawnTask, (void*)(depth - 1)))
+			SpawnTask(worker, (void*)(depth - 1));
+		if (ThreadPool_Spawn(worker, &SpawnTask, (void*)(depth - 1)))
+			SpawnTask(worker, (void*)(depth - 1));
+	}
+	return;
+}
+
+// returns the time needed for running *retTasks tasks
+static double BenchSubmit(THREAD_POOL* pool, UINT32* retTasks, double minTime)
+{
+	double startTime = GetTimeSec();
+	double time;
+	UINT32 tasks = 0;
+	UINT32 curTask;
+
+	do
+	{
+		for (curTask = 0; curTask < SUBMIT_TASKS; curTask ++)
+			ThreadPool_Submit(pool, &EmptyTask, NULL);
+		ThreadPool_Wait(pool);
+		tasks += SUBMIT_TASKS;
+		time = GetTimeSec() - startTime;
+	} while(time < minTime);
+
+	*retTasks = tasks;
+	return time;
+}
+
+static double BenchForkJoin(THREAD_POOL* pool, UINT32* retRounds, double minTime)
+{
+	UINT32 taskCnt = ThreadPool_GetThreadCount(pool) + 1;
+	double startTime = GetTimeSec();
+	double time;
+	UINT32 rounds = 0;
+	UINT32 curTask;
+
+	do
+	{
+		UINT32 curRound;
+		for (curRound = 0; curRound < 0x100; curRound ++)
+		{
+			for (curTask = 0; curTask < taskCnt; curTask ++)
+				ThreadPool_Submit(pool, &EmptyTask, NULL);
+			ThreadPool_Wait(pool);
+		}
+		rounds += 0x100;
+		time = GetTimeSec() - startTime;
+	} while(time < minTime);
+
+	*retRounds = rounds;
+	return time;
+}
+
+static double BenchSpawn(THREAD_POOL* pool, UINT32* retTasks, double minTime)
+{
+	double startTime = GetTimeSec();
+	double time;
+	UINT32 tasks = 0;
+
+	do
+	{
+		ThreadPool_SubmitEx(pool, &SpawnTask, (void*)(size_t)SPAWN_DEPTH);
+		ThreadPool_Wait(pool);
+		tasks += (2 << SPAWN_DEPTH) - 1;
+		time = GetTimeSec() - startTime;
+	} while(time < minTime);
+
+	*retTasks = tasks;
+	return time;
+}
+
+static void StressTask(THRPOOL_WORKER* worker, void* param)
+{
+	TREE_NODE* node = (TREE_NODE*)param;
+	STRESS_TREE* tree = node->tree;
+	UINT32 wrkID = ThreadPool_GetWorkerID(worker);
+	UINT32* scratch;
+	UINT32 curChild;
+	UINT32 curPos;
+	UINT32 scrLen;
+
+	// No locking needed: If the pool works correctly, there are no concurrent accesses.
+	if (tree->busy[wrkID])
+		tree->errors ++;
+	tree->busy[wrkID] = 1;
+	node->visits ++;
+	tree->taskCnt[wrkID] ++;
+
+	scrLen = node->scratchSize / sizeof(UINT32);
+	scratch = (UINT32*)ThreadPool_GetScratch(worker, scrLen * sizeof(UINT32));
+	if (scratch == NULL && scrLen > 0)
+		tree->errors ++;
+	else
+	{
+		for (curPos = 0; curPos < scrLen; curPos ++)
+			scratch[curPos] = node->index ^ curPos;
+	}
+
+	for (curChild = 1; curChild <= tree->fanOut; curChild ++)
+	{
+		UINT32 childIdx = node->index * tree->fanOut + curChild;
+		if (childIdx >= tree->nodeCount)
+			break;
+		// Some children are submitted to the pool, so that several threads submit at the same time.
+		if (childIdx % 3 == 0)
+		{
+			if (ThreadPool_SubmitEx(tree->pool, &StressTask, &tree->nodes[childIdx]))
+				tree->errors ++;
+		}
+		else
+		{
+			if (ThreadPool_Spawn(worker, &StressTask, &tree->nodes[childIdx]))
+				tree->errors ++;
+		}
+	}
+
+	if (scratch != NULL)
+	{
+		for (curPos = 0; curPos < scrLen; curPos ++)
+		{
+			if (scratch[curPos] != (node->index ^ curPos))
+			{
+				tree->errors ++;
+				break;
+			}
+		}
+	}
+	tree->busy[wrkID] = 0;
+
+	return;
+}
+
+static void StressPlainTask(void* param)
+{
+	TREE_NODE* node = (TREE_NODE*)param;
+
+	node->visits ++;
+	return;
+}
+
+// returns the number of errors
+static UINT32 StressRun(UINT32 threads, UINT32 seed)
+{
+	THREAD_POOL* pool;
+	STRESS_TREE tree;
+	TREE_NODE* plainNodes;
+	UINT32 plainCount;
+	UINT32 curNode;
+	UINT32 taskSum;
+	UINT32 errors;
+
+	if (ThreadPool_Init(&pool, threads))
+	{
+		printf("ThreadPool_Init failed!\n");
+		return 1;
+	}
+	tree.pool = pool;
+	tree.nodeCount = 1000 + seed % 20000;
+	tree.fanOut = 1 + seed % 5;
+	tree.nodes = (TREE_NODE*)calloc(tree.nodeCount, sizeof(TREE_NODE));
+	tree.busy = (UINT32*)calloc(threads + 1, sizeof(UINT32));
+	tree.taskCnt = (UINT32*)calloc(threads + 1, sizeof(UINT32));
+	tree.errors = 0;
+	for (curNode = 0; curNode < tree.nodeCount; curNode ++)
+	{
+		tree.nodes[curNode].tree = &tree;
+		tree.nodes[curNode].index = curNode;
+		tree.nodes[curNode].scratchSize = (curNode * 37 + seed) % 0x1000;
+	}
+	plainCount = seed % 500;
+	plainNodes = (TREE_NODE*)calloc(plainCount ? plainCount : 1, sizeof(TREE_NODE));
+
+	// a tree of worker tasks that spawn their children, interleaved with plain tasks
+	ThreadPool_SubmitEx(pool, &StressTask, &tree.nodes[0]);
+	for (curNode = 0; curNode < plainCount; curNode ++)
+		ThreadPool_Submit(pool, &StressPlainTask, &plainNodes[curNode]);
+	ThreadPool_Wait(pool);
+
+	errors = tree.errors;
+	for (curNode = 0; curNode < tree.nodeCount; curNode ++)
+	{
+		if (tree.nodes[curNode].visits != 1)
+			errors ++;
+	}
+	for (curNode = 0; curNode < plainCount; curNode ++)
+	{
+		if (plainNodes[curNode].visits != 1)
+			errors ++;
+	}
+	taskSum = 0;
+	for (curNode = 0; curNode <= threads; curNode ++)
+		taskSum += tree.taskCnt[curNode];
+	if (taskSum != tree.nodeCount)
+		errors ++;
+
+	// tasks that are still queued when destroying the pool must be finished as well
+	if (threads > 0)
+	{
+		for (curNode = 0; curNode < plainCount; curNode ++)
+			ThreadPool_Submit(pool, &StressPlainTask, &plainNodes[curNode]);
+	}
+	ThreadPool_Deinit(pool);
+	if (threads > 0)
+	{
+		for (curNode = 0; curNode < plainCount; curNode ++)
+		{
+			if (plainNodes[curNode].visits != 2)
+				errors ++;
+		}
+	}
+
+	free(plainNodes);
+	free(tree.taskCnt);
+	free(tree.busy);
+	free(tree.nodes);
+	return errors;
+}
+
+static int StressTest(UINT32 maxThreads, UINT32 seconds)
+{
+	double startTime = GetTimeSec();
+	UINT32 runs = 0;
+	UINT32 errors = 0;
+	UINT32 seed = 1;
+
+	printf("Running thread pool stress test for %u s with up to %u threads ...\n", seconds, maxThreads);
+	do
+	{
+		UINT32 threads = runs % (maxThreads + 1);
+		UINT32 runErrors;
+
+		seed = seed * 1103515245 + 12345;
+		runErrors = StressRun(threads, (seed >> 8) & 0xFFFFFF);
+		if (runErrors)
+			printf("Run %u (%u threads, seed 0x%06X): %u errors\n", runs, threads, (seed >> 8) & 0xFFFFFF, runErrors);
+		errors += runErrors;
+		runs ++;
+	} while(GetTimeSec() - startTime < seconds);
+
+	printf("%u runs, %u errors\n", runs, errors);
+	return errors ? 1 : 0;
+}
+
+int main(int argc, char* argv[])
+{
+	UINT32 seconds;
+	UINT32 maxThreads;
+	UINT8 check;
+	int curArg;
+	UINT32 threads;
+
+	seconds = 2;
+	maxThreads = 8;
+	check = 0;
+	for (curArg = 1; curArg < argc; curArg ++)
+	{
+		if (! strcmp(argv[curArg], "-c"))
+			check = 1;
+		else if (curArg + 1 >= argc)
+			break;
+		else if (! strcmp(argv[curArg], "-s"))
+			seconds = (UINT32)strtoul(argv[++ curArg], NULL, 0);
+		else if (! strcmp(argv[curArg], "-t"))
+			maxThreads = (UINT32)strtoul(argv[++ curArg], NULL, 0);
+		else
+			break;
+	}
+	if (curArg < argc || ! seconds)
+	{
+		printf("Thread pool benchmark\n");
+		printf("Usage: %s [-s seconds] [-t max_threads] [-c]\n", argv[0]);
+		printf("    -s  minimum duration of each test (default: 2)\n");
+		printf("    -t  maximum number of worker threads (default: 8)\n");
+		printf("    -c  run a stress test instead of benchmarking\n");
+		return 0;
+	}
+	if (check)
+		return StressTest(maxThreads, seconds);
+
+	printf("Task dispatch overhead, %u s per test.\n", seconds);
+	printf("%-8s %14s %14s %14s\n", "Threads", "Submit", "Fork-Join", "Spawn");
+	for (threads = 0; threads <= maxThreads; threads = threads ? threads * 2 : 1)
+	{
+		THREAD_POOL* pool;
+		UINT32 count;
+		double time;
+
+		if (ThreadPool_Init(&pool, threads))
+		{
+			printf("ThreadPool_Init failed!\n");
+			return 1;
+		}
+		printf("%-8u", threads);
+		time = BenchSubmit(pool, &count, seconds);
+		printf(" %9.1f ns/t", time * 1000000000.0 / count);
+		fflush(stdout);
+		time = BenchForkJoin(pool, &count, seconds);
+		printf(" %9.2f us/r", time * 1000000.0 / count);
+		fflush(stdout);
+		time = BenchSpawn(pool, &count, seconds);
+		printf(" %9.1f ns/t", time * 1000000000.0 / count);
+		printf("\n");
+		ThreadPool_Deinit(pool);
+	}
+
+	return 0;
+}
@@ -3,14 +3,46 @@
 
 #include "../stdtype.h"
 #include "DataLoader.h"
+#ifdef DLOAD_ASYNC_SUPPORT
+#include "OSThread.h"
+#include "OSMutex.h"
+#include "OSSignal.h"
+
+#define ASYNC_CHUNK_SIZE	0x10000	/* number of bytes the worker reads at once */
+
+typedef struct _dload_async
+{
+	OS_THREAD *hThread;
+	OS_MUTEX *hMutex;	/* protects _bytesLoaded and _status */
+	OS_SIGNAL *hSignal;	/* set when new data is available */
+	UINT8 cancel;	/* protected by hMutex */
+	UINT8 joined;
+} DLOAD_ASYNC;
+
+static void DataLoader_AsyncThread(void *args);
+static UINT8 DataLoader_AsyncStart(DATA_LOADER *loader);
+static void DataLoader_AsyncStop(DATA_LOADER *loader);
+static void DataLoader_AsyncFree(DATA_LOADER *loader);
+static UINT32 DataLoader_AsyncWait(DATA_LOADER *loader, UINT32 fileOffset);
+#endif
+
 
 UINT8 DataLoader_Reset(DATA_LOADER *loader)
 {
-	if (loader->_status == DLSTAT_EMPTY) return 1;
+	if (DataLoader_GetStatus(loader) == DLSTAT_EMPTY) return 1;
 
 	DataLoader_CancelLoading(loader);
+#ifdef DLOAD_ASYNC_SUPPORT
+	DataLoader_AsyncFree(loader);
+#endif
 
-	if(loader->_data) {
+	if(loader->_dataMapped) {
+		loader->_callbacks->dunmap(loader->_context);
+		loader->_dataMapped = 0;
+		loader->_data = NULL;
+		loader->_bytesLoaded = 0;
+	}
+	else if(loader->_data) {
 		free(loader->_data);
 		loader->_data = NULL;
 		loader->_bytesLoaded = 0;
@@ -30,15 +62,42 @@ UINT32 DataLoader_GetTotalSize(const DATA_LOADER *loader) {
 }
 
 UINT32 DataLoader_GetSize(const DATA_LOADER *loader) {
+#ifdef DLOAD_ASYNC_SUPPORT
+	if(loader->_asyncState != NULL) {
+		DLOAD_ASYNC *async = (DLOAD_ASYNC *)loader->_asyncState;
+		UINT32 size;
+		OSMutex_Lock(async->hMutex);
+		size = loader->_bytesLoaded;
+		OSMutex_Unlock(async->hMutex);
+		return size;
+	}
+#endif
 	return loader->_bytesLoaded;
 }
 
 UINT8 DataLoader_GetStatus(const DATA_LOADER *loader) {
+#ifdef DLOAD_ASYNC_SUPPORT
+	if(loader->_asyncState != NULL) {
+		DLOAD_ASYNC *async = (DLOAD_ASYNC *)loader->_asyncState;
+		UINT8 status;
+		OSMutex_Lock(async->hMutex);
+		status = loader->_status;
+		OSMutex_Unlock(async->hMutex);
+		return status;
+	}
+#endif
 	return loader->_status;
 }
 
 UINT8 DataLoader_CancelLoading(DATA_LOADER *loader)
 {
+#ifdef DLOAD_ASYNC_SUPPORT
+	if(loader->_asyncState != NULL) {
+		/* the worker closes the file and sets the status when it quits */
+		DataLoader_AsyncStop(loader);
+		return 0x00;
+	}
+#endif
 	if(loader->_status != DLSTAT_LOADING) return 0x01;
 
 	if(loader->_callbacks->dclose(loader->_context)) return 0x01;
@@ -50,7 +109,7 @@ UINT8 DataLoader_CancelLoading(DATA_LOADER *loader)
 UINT8 DataLoader_Load(DATA_LOADER *loader)
 {
 	UINT8 ret;
-	if (loader->_status == DLSTAT_LOADING)
+	if (DataLoader_GetStatus(loader) == DLSTAT_LOADING)
 		return 0x01;
 
 	DataLoader_Reset(loader);
@@ -62,6 +121,33 @@ UINT8 DataLoader_Load(DATA_LOADER *loader)
 	loader->_status = DLSTAT_LOADING;
 	loader->_bytesTotal = loader->_callbacks->dlength(loader->_context);
 
+	if (loader->_callbacks->dmap != NULL)
+	{
+		UINT8 *mapData = loader->_callbacks->dmap(loader->_context);
+		if (mapData != NULL)
+		{
+			/* the whole data is accessible now, so the loader can be closed */
+			DataLoader_CancelLoading(loader);
+			loader->_data = mapData;
+			loader->_dataMapped = 1;
+			loader->_bytesLoaded = loader->_bytesTotal;
+			return 0x00;
+		}
+	}
+
+#ifdef DLOAD_ASYNC_SUPPORT
+	if (loader->_async && loader->_bytesTotal > 0)
+	{
+		/* on failure, fall back to reading the data in the calling thread */
+		if (! DataLoader_AsyncStart(loader))
+		{
+			if (loader->_readStopOfs > 0)
+				DataLoader_AsyncWait(loader,loader->_readStopOfs);
+			return 0x00;
+		}
+	}
+#endif
+
 	if (loader->_readStopOfs > 0)
 		DataLoader_Read(loader,loader->_readStopOfs);
 
@@ -76,6 +162,13 @@ void DataLoader_SetPreloadBytes(DATA_LOADER *loader, UINT32 byteCount)
 
 void DataLoader_ReadUntil(DATA_LOADER *loader, UINT32 fileOffset)
 {
+#ifdef DLOAD_ASYNC_SUPPORT
+	if (loader->_asyncState != NULL)
+	{
+		DataLoader_AsyncWait(loader,fileOffset);
+		return;
+	}
+#endif
 	if (fileOffset > loader->_bytesLoaded)
 		DataLoader_Read(loader, fileOffset - loader->_bytesLoaded);
 	return;
@@ -83,6 +176,13 @@ void DataLoader_ReadUntil(DATA_LOADER *loader, UINT32 fileOffset)
 
 void DataLoader_ReadAll(DATA_LOADER *loader)
 {
+#ifdef DLOAD_ASYNC_SUPPORT
+	if (loader->_asyncState != NULL)
+	{
+		DataLoader_AsyncWait(loader,loader->_bytesTotal);
+		return;
+	}
+#endif
 	while(DataLoader_Read(loader,loader->_bytesTotal - loader->_bytesLoaded) >0)
 		;
 	return;
@@ -93,6 +193,16 @@ UINT32 DataLoader_Read(DATA_LOADER *loader, UINT32 numBytes)
 	UINT32 endOfs;
 	UINT32 readBytes;
 
+#ifdef DLOAD_ASYNC_SUPPORT
+	if (loader->_asyncState != NULL)
+	{
+		UINT32 oldSize = DataLoader_GetSize(loader);
+		endOfs = oldSize + numBytes;
+		if (endOfs < oldSize)
+			endOfs = (UINT32)-1;
+		return DataLoader_AsyncWait(loader,endOfs) - oldSize;
+	}
+#endif
 	if (loader->_status != DLSTAT_LOADING)
 		return 0;
 
@@ -139,8 +249,157 @@ void DataLoader_Deinit(DATA_LOADER *dLoader)
 
 void DataLoader_Setup(DATA_LOADER *loader, const DATA_LOADER_CALLBACKS *callbacks, void *context) {
 	loader->_data = NULL;
+	loader->_dataMapped = 0;
+	loader->_async = 0;
+	loader->_asyncState = NULL;
 	loader->_status = DLSTAT_EMPTY;
 	loader->_readStopOfs = (UINT32)-1;
 	loader->_context = context;
 	loader->_callbacks = callbacks;
 }
+
+UINT8 DataLoader_SetAsync(DATA_LOADER *loader, UINT8 enable)
+{
+#ifdef DLOAD_ASYNC_SUPPORT
+	loader->_async = enable ? 1 : 0;
+	return 0x00;
+#else
+	return enable ? 0xFF : 0x00;
+#endif
+}
+
+UINT8 DataLoader_IsAsync(const DATA_LOADER *loader)
+{
+	return (loader->_asyncState != NULL);
+}
+
+#ifdef DLOAD_ASYNC_SUPPORT
+static void DataLoader_AsyncThread(void *args)
+{
+	DATA_LOADER *loader = (DATA_LOADER *)args;
+	DLOAD_ASYNC *async = (DLOAD_ASYNC *)loader->_asyncState;
+	UINT32 curPos = 0;	/* only the worker writes _bytesLoaded, so it can keep a local copy */
+	UINT32 numBytes;
+	UINT32 readBytes;
+	UINT8 isEOF;
+	UINT8 cancel;
+
+	cancel = 0;
+	while (! cancel && curPos < loader->_bytesTotal)
+	{
+		numBytes = loader->_bytesTotal - curPos;
+		if (numBytes > ASYNC_CHUNK_SIZE)
+			numBytes = ASYNC_CHUNK_SIZE;
+		readBytes = loader->_callbacks->dread(loader->_context,&loader->_data[curPos],numBytes);
+		if (! readBytes)
+			break;
+		curPos += readBytes;
+		isEOF = loader->_callbacks->deof(loader->_context);
+
+		OSMutex_Lock(async->hMutex);
+		loader->_bytesLoaded = curPos;
+		cancel = async->cancel;
+		OSMutex_Unlock(async->hMutex);
+		OSSignal_Signal(async->hSignal);
+		if (isEOF)
+			break;
+	}
+
+	loader->_callbacks->dclose(loader->_context);
+	OSMutex_Lock(async->hMutex);
+	loader->_status = DLSTAT_LOADED;
+	OSMutex_Unlock(async->hMutex);
+	OSSignal_Signal(async->hSignal);
+	return;
+}
+
+static UINT8 DataLoader_AsyncStart(DATA_LOADER *loader)
+{
+	DLOAD_ASYNC *async;
+	UINT8 retVal;
+
+	/* The buffer is allocated in full size, so that it never has to be moved. */
+	loader->_data = (UINT8 *)malloc(loader->_bytesTotal);
+	if (loader->_data == NULL)
+		return 0xFF;
+	async = (DLOAD_ASYNC *)calloc(1, sizeof(DLOAD_ASYNC));
+	if (async == NULL)
+		return 0xFF;
+
+	retVal = OSMutex_Init(&async->hMutex, 0);
+	if (retVal)
+		goto error_mutex;
+	retVal = OSSignal_Init(&async->hSignal, 0);
+	if (retVal)
+		goto error_signal;
+	async->cancel = 0;
+	async->joined = 0;
+	loader->_asyncState = async;
+	retVal = OSThread_Init(&async->hThread, &DataLoader_AsyncThread, loader);
+	if (retVal)
+		goto error_thread;
+	OSThread_SetName(async->hThread, "vgm-loader");
+	return 0x00;
+
+error_thread:
+	loader->_asyncState = NULL;
+	OSSignal_Deinit(async->hSignal);
+error_signal:
+	OSMutex_Deinit(async->hMutex);
+error_mutex:
+	free(async);
+	return 0x80;
+}
+
+static void DataLoader_AsyncStop(DATA_LOADER *loader)
+{
+	DLOAD_ASYNC *async = (DLOAD_ASYNC *)loader->_asyncState;
+
+	if (async->joined)
+		return;
+	OSMutex_Lock(async->hMutex);
+	async->cancel = 1;
+	OSMutex_Unlock(async->hMutex);
+	OSThread_Join(async->hThread);
+	async->joined = 1;
+	return;
+}
+
+static void DataLoader_AsyncFree(DATA_LOADER *loader)
+{
+	DLOAD_ASYNC *async = (DLOAD_ASYNC *)loader->_asyncState;
+
+	if (async == NULL)
+		return;
+	DataLoader_AsyncStop(loader);
+	OSThread_Deinit(async->hThread);
+	OSSignal_Deinit(async->hSignal);
+	OSMutex_Deinit(async->hMutex);
+	free(async);
+	loader->_asyncState = NULL;
+	return;
+}
+
+/* waits until the data up to fileOffset is loaded or loading has finished, returns the loaded size */
+static UINT32 DataLoader_AsyncWait(DATA_LOADER *loader, UINT32 fileOffset)
+{
+	DLOAD_ASYNC *async = (DLOAD_ASYNC *)loader->_asyncState;
+	UINT32 loadSize;
+
+	if (fileOffset > loader->_bytesTotal)
+		fileOffset = loader->_bytesTotal;
+	OSMutex_Lock(async->hMutex);
+	while (loader->_bytesLoaded < fileOffset && loader->_status == DLSTAT_LOADING)
+	{
+		OSMutex_Unlock(async->hMutex);
+		OSSignal_Wait(async->hSignal);
+		OSMutex_Lock(async->hMutex);
+	}
+	loadSize = loader->_bytesLoaded;
+	OSMutex_Unlock(async->hMutex);
+	/* pass the wakeup on, in case multiple threads are waiting */
+	OSSignal_Signal(async->hSignal);
+
+	return loadSize;
+}
+#endif
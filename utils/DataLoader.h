@@ -13,6 +13,7 @@ typedef UINT32 (*DLOADCB_READ)(void *context, UINT8 *buffer, UINT32 numBytes);
 typedef UINT8 (*DLOADCB_SEEK)(void *context, UINT32 offset, UINT8 whence);
 typedef INT32 (*DLOADCB_TELL)(void *context);
 typedef UINT32 (*DLOADCB_LENGTH)(void *context);
+typedef UINT8 *(*DLOADCB_MAP)(void *context);
 
 typedef struct _data_loader_callbacks
 {
@@ -26,6 +27,9 @@ typedef struct _data_loader_callbacks
 	DLOADCB_LENGTH dlength; /* returns the length of the data, in bytes */
 	DLOADCB_GENERIC deof;   /* determines if we've seen eof or not (return 1 for eof) */
 	DLOADCB_GEN_CALL ddeinit;   /* deinitialize loader and free context, may be NULL */
+	DLOADCB_MAP dmap;       /* optional: returns the whole data in directly accessible memory (e.g. memory-mapped file),
+	                           NULL to read it using dread instead, may be NULL */
+	DLOADCB_GEN_CALL dunmap;    /* releases the memory returned by dmap */
 } DATA_LOADER_CALLBACKS;
 
 enum
@@ -44,11 +48,16 @@ typedef struct _data_loader
 	UINT8 *_data;
 	const DATA_LOADER_CALLBACKS *_callbacks;
 	void *_context;
+	UINT8 _dataMapped;	/* _data was returned by dmap instead of being allocated */
+	UINT8 _async;	/* load the data in a background thread (see DataLoader_SetAsync) */
+	void *_asyncState;	/* background loading state, private */
 } DATA_LOADER;
 
 /* calls the dopen and dlength functions
  * by default, loads whole file into memory, use
- * DataLoader_SetPreloadBytes to change this */
+ * DataLoader_SetPreloadBytes to change this
+ * When the loader can map the data (dmap), the whole data is
+ * available right away and the status is DLSTAT_LOADED. */
 UINT8 DataLoader_Load(DATA_LOADER *loader);
 
 /* Resets the DataLoader (calls DataReader_CancelLoading, unloads data, etc */
@@ -84,6 +93,18 @@ void DataLoader_ReadUntil(DATA_LOADER *loader, UINT32 fileOffset);
 /* read all data */
 void DataLoader_ReadAll(DATA_LOADER *loader);
 
+/* enables/disables loading in a background thread, call before DataLoader_Load
+ * In asynchronous mode, DataLoader_Load returns after the preload bytes are read and
+ * the remaining data is read by a worker thread. The memory buffer is allocated once
+ * and doesn't move, so the data pointer can be used while loading.
+ * DataLoader_Read/ReadUntil/ReadAll wait for the worker instead of reading.
+ * The mode is used only when the total size is known, else the data is read normally.
+ * Returns 0xFF when compiled without threading support. */
+UINT8 DataLoader_SetAsync(DATA_LOADER *loader, UINT8 enable);
+
+/* returns 1 when the data is being loaded (or was loaded) by a background thread */
+UINT8 DataLoader_IsAsync(const DATA_LOADER *loader);
+
 /* convenience function for MemoryLoader,FileLoader, etc */
 void DataLoader_Setup(DATA_LOADER *loader, const DATA_LOADER_CALLBACKS *callbacks, void *context);
 
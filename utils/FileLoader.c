@@ -10,6 +10,17 @@
 #include <wchar.h>
 #endif
 
+#ifdef _WIN32
+#define FLOAD_MMAP	1
+#include <windows.h>
+#include <io.h>
+#elif defined(__unix__) || defined(__APPLE__)
+#define FLOAD_MMAP	1
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#endif
+
 #ifdef _MSC_VER
 #define strdup	_strdup
 #define wcsdup	_wcsdup
@@ -51,6 +62,10 @@ struct _file_loader
 	FLOAD_GENERIC Close;
 	FLOAD_TELL Tell;
 	FLOAD_GENERIC Eof;
+
+	UINT8 useMapping;	// map uncompressed files into memory instead of reading them
+	void *mapPtr;
+	size_t mapSize;
 };
 
 
@@ -61,6 +76,8 @@ static UINT8 FileLoader_dclose(void *context);
 static INT32 FileLoader_dtell(void *context);
 static UINT32 FileLoader_dlength(void *context);
 static UINT8 FileLoader_deof(void *context);
+static UINT8 *FileLoader_dmap(void *context);
+static void FileLoader_dunmap(void *context);
 
 static UINT32 FileLoader_ReadRaw(FILE_LOADER *loader, UINT8 *buffer, UINT32 numBytes);
 static UINT8 FileLoader_SeekRaw(FILE_LOADER *loader, UINT32 offset, UINT8 whence);
@@ -181,6 +198,77 @@ static UINT8 FileLoader_deof(void *context)
 	return loader->Eof(loader);
 }
 
+static UINT8 *FileLoader_dmap(void *context)
+{
+	FILE_LOADER *loader = (FILE_LOADER *)context;
+#if FLOAD_MMAP
+	void *mapPtr;
+
+	// only regular, uncompressed files can be mapped (no .gz files, pipes or devices)
+	if (! loader->useMapping || loader->modeCompr != FLMODE_CMP_RAW || ! loader->bytesTotal)
+		return NULL;
+#ifdef _WIN32
+	{
+		HANDLE hFile = (HANDLE)_get_osfhandle(_fileno(loader->hLoad.hFileRaw));
+		HANDLE hMap;
+		if (hFile == INVALID_HANDLE_VALUE || GetFileType(hFile) != FILE_TYPE_DISK)
+			return NULL;
+		// copy-on-write, so that the data can be modified like a heap buffer
+		hMap = CreateFileMappingA(hFile, NULL, PAGE_WRITECOPY, 0, 0, NULL);
+		if (hMap == NULL)
+			return NULL;
+		mapPtr = MapViewOfFile(hMap, FILE_MAP_COPY, 0, 0, loader->bytesTotal);
+		CloseHandle(hMap);	// the view keeps the mapping alive
+		if (mapPtr == NULL)
+			return NULL;
+	}
+#else
+	{
+		int fd = fileno(loader->hLoad.hFileRaw);
+		struct stat st;
+		if (fstat(fd, &st) || ! S_ISREG(st.st_mode) || (UINT32)st.st_size != loader->bytesTotal)
+			return NULL;
+		// copy-on-write, so that the data can be modified like a heap buffer
+		mapPtr = mmap(NULL, loader->bytesTotal, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+		if (mapPtr == MAP_FAILED)
+			return NULL;
+	}
+#endif
+	loader->mapPtr = mapPtr;
+	loader->mapSize = loader->bytesTotal;
+	return (UINT8 *)mapPtr;
+#else
+	(void)loader;
+	return NULL;
+#endif
+}
+
+static void FileLoader_dunmap(void *context)
+{
+	FILE_LOADER *loader = (FILE_LOADER *)context;
+#if FLOAD_MMAP
+	if (loader->mapPtr == NULL)
+		return;
+#ifdef _WIN32
+	UnmapViewOfFile(loader->mapPtr);
+#else
+	munmap(loader->mapPtr, loader->mapSize);
+#endif
+	loader->mapPtr = NULL;
+	loader->mapSize = 0;
+#else
+	(void)loader;
+#endif
+	return;
+}
+
+void FileLoader_SetMemoryMapping(DATA_LOADER *dLoader, UINT8 enable)
+{
+	FILE_LOADER *loader = (FILE_LOADER *)dLoader->_context;
+	loader->useMapping = enable;
+	return;
+}
+
 
 static UINT32 FileLoader_ReadRaw(FILE_LOADER *loader, UINT8 *buffer, UINT32 numBytes)
 {
@@ -255,6 +343,7 @@ DATA_LOADER *FileLoader_Init(const char *fileName)
 	}
 
 	fLoader->fileName = strdup(fileName);
+	fLoader->useMapping = 1;
 
 	DataLoader_Setup(dLoader,&fileLoader,fLoader);
 
@@ -279,6 +368,7 @@ DATA_LOADER *FileLoader_InitW(const wchar_t *fileName)
 
 	fLoader->fileName = NULL;	// explicitly mark as "unused"
 	fLoader->fileNameW = wcsdup(fileName);
+	fLoader->useMapping = 1;
 
 	DataLoader_Setup(dLoader,&fileLoader,fLoader);
 
@@ -308,4 +398,6 @@ const DATA_LOADER_CALLBACKS fileLoader = {
 	FileLoader_dlength,
 	FileLoader_deof,
 	FileLoader_dfree,
+	FileLoader_dmap,
+	FileLoader_dunmap,
 };
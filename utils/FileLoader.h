@@ -16,6 +16,10 @@ DATA_LOADER *FileLoader_Init(const char *fileName);
 #include <wchar.h>
 DATA_LOADER *FileLoader_InitW(const wchar_t *fileName);
 #endif
+/* Uncompressed files are memory-mapped by default, so that DataLoader_GetData() returns the
+ * mapped file without reading it. Disable this when the file might be modified during playback.
+ * Must be called before DataLoader_Load(). */
+void FileLoader_SetMemoryMapping(DATA_LOADER *loader, UINT8 enable);
 
 #define FileLoader_Load				DataLoader_Load
 #define FileLoader_Reset			DataLoader_Reset
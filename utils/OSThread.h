@@ -11,12 +11,25 @@ extern "C"
 typedef struct _os_thread OS_THREAD;
 typedef void (*OS_THR_FUNC)(void* args);
 
+// thread priority classes
+#define OSTHRD_PRIO_NORMAL	0x00	// default scheduling
+#define OSTHRD_PRIO_HIGH	0x01	// highest priority within the default scheduling class [Windows only]
+#define OSTHRD_PRIO_RT		0x02	// real-time, round-robin (POSIX: SCHED_RR, Windows: time critical)
+#define OSTHRD_PRIO_RT_FIFO	0x03	// real-time, first-in first-out (POSIX: SCHED_FIFO, Windows: same as RT)
+
 UINT8 OSThread_Init(OS_THREAD** retThread, OS_THR_FUNC threadFunc, void* args);
 void OSThread_Deinit(OS_THREAD* thr);
 void OSThread_Join(OS_THREAD* thr);
 void OSThread_Cancel(OS_THREAD* thr);
 UINT64 OSThread_GetID(const OS_THREAD* thr);
 void* OSThread_GetHandle(OS_THREAD* thr);	// return a reference to the actual handle
+// Set the priority class. When the requested class is not permitted, lower classes are tried.
+// Returns 0x00 on success, 0x01 if a lower class was applied, 0x80 if it failed.
+UINT8 OSThread_SetPriority(OS_THREAD* thr, UINT8 prioClass);
+// Restrict the thread to the CPUs set in the mask (bit 0 = CPU 0). 0 = leave unchanged
+UINT8 OSThread_SetAffinity(OS_THREAD* thr, UINT64 cpuMask);
+// Set the thread name shown by debuggers and system tools. (may be truncated to 15 characters)
+UINT8 OSThread_SetName(OS_THREAD* thr, const char* name);
 
 #ifdef __cplusplus
 }
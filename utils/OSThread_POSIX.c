@@ -1,10 +1,16 @@
 // POSIX Threads
 // -------------
 
+#if defined(__linux__) && ! defined(_GNU_SOURCE)
+#define _GNU_SOURCE	// for pthread_setaffinity_np() and pthread_setname_np()
+#endif
 #include <stdlib.h>
 #include <stddef.h>
+#include <string.h>
+#include <errno.h>
 
 #include <pthread.h>
+#include <sched.h>
 #ifdef __HAIKU__
 #include <kernel/OS.h>
 #endif
@@ -103,3 +109,83 @@ void* OSThread_GetHandle(OS_THREAD* thr)
 {
 	return &thr->id;
 }
+
+UINT8 OSThread_SetPriority(OS_THREAD* thr, UINT8 prioClass)
+{
+	struct sched_param param;
+	int policy;
+	int retVal;
+	
+	if (! thr->id)
+		return 0x80;
+	
+	memset(&param, 0x00, sizeof(struct sched_param));
+	if (prioClass == OSTHRD_PRIO_RT || prioClass == OSTHRD_PRIO_RT_FIFO)
+	{
+		int prioMin;
+		int prioMax;
+		
+		policy = (prioClass == OSTHRD_PRIO_RT_FIFO) ? SCHED_FIFO : SCHED_RR;
+		prioMin = sched_get_priority_min(policy);
+		prioMax = sched_get_priority_max(policy);
+		// Use a moderate real-time priority, so that interrupt handlers and the like can still preempt us.
+		param.sched_priority = prioMin + (prioMax - prioMin) / 4;
+		retVal = pthread_setschedparam(thr->id, policy, &param);
+		if (! retVal)
+			return 0x00;
+		if (retVal != EPERM)
+			return 0x80;
+		// not permitted (missing CAP_SYS_NICE / RLIMIT_RTPRIO) - fall back to normal scheduling
+	}
+	
+	// The default scheduling class has no per-thread priority levels, so "high" is the same as "normal".
+	memset(&param, 0x00, sizeof(struct sched_param));
+	retVal = pthread_setschedparam(thr->id, SCHED_OTHER, &param);
+	if (retVal)
+		return 0x80;
+	return (prioClass == OSTHRD_PRIO_NORMAL) ? 0x00 : 0x01;
+}
+
+UINT8 OSThread_SetAffinity(OS_THREAD* thr, UINT64 cpuMask)
+{
+#if defined(__linux__) && ! defined(__ANDROID__)
+	cpu_set_t cpuSet;
+	unsigned int curCPU;
+	int retVal;
+	
+	if (! cpuMask)
+		return 0x00;
+	if (! thr->id)
+		return 0x80;
+	
+	CPU_ZERO(&cpuSet);
+	for (curCPU = 0; curCPU < 64; curCPU ++)
+	{
+		if (cpuMask & ((UINT64)1 << curCPU))
+			CPU_SET(curCPU, &cpuSet);
+	}
+	retVal = pthread_setaffinity_np(thr->id, sizeof(cpu_set_t), &cpuSet);
+	return retVal ? 0x80 : 0x00;
+#else
+	return cpuMask ? 0x80 : 0x00;	// not supported
+#endif
+}
+
+UINT8 OSThread_SetName(OS_THREAD* thr, const char* name)
+{
+#if defined(__linux__)
+	char nameBuf[16];	// Linux allows 15 characters + terminator
+	int retVal;
+	
+	if (! thr->id)
+		return 0x80;
+	
+	strncpy(nameBuf, name, sizeof(nameBuf) - 1);
+	nameBuf[sizeof(nameBuf) - 1] = '\0';
+	retVal = pthread_setname_np(thr->id, nameBuf);
+	return retVal ? 0x80 : 0x00;
+#else
+	// macOS can only name the calling thread, other systems use varying APIs.
+	return 0x80;
+#endif
+}
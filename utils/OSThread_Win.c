@@ -91,3 +91,70 @@ void* OSThread_GetHandle(OS_THREAD* thr)
 {
 	return &thr->hThread;
 }
+
+UINT8 OSThread_SetPriority(OS_THREAD* thr, UINT8 prioClass)
+{
+	BOOL retValB;
+	
+	if (! thr->id)
+		return 0x80;
+	
+	if (prioClass == OSTHRD_PRIO_RT || prioClass == OSTHRD_PRIO_RT_FIFO)
+	{
+		retValB = SetThreadPriority(thr->hThread, THREAD_PRIORITY_TIME_CRITICAL);
+		if (retValB)
+			return 0x00;
+		// Try a lower priority, because too low priorities cause sound stuttering.
+	}
+	if (prioClass != OSTHRD_PRIO_NORMAL)
+	{
+		retValB = SetThreadPriority(thr->hThread, THREAD_PRIORITY_HIGHEST);
+		if (retValB)
+			return (prioClass == OSTHRD_PRIO_HIGH) ? 0x00 : 0x01;
+	}
+	
+	retValB = SetThreadPriority(thr->hThread, THREAD_PRIORITY_NORMAL);
+	if (! retValB)
+		return 0x80;
+	return (prioClass == OSTHRD_PRIO_NORMAL) ? 0x00 : 0x01;
+}
+
+UINT8 OSThread_SetAffinity(OS_THREAD* thr, UINT64 cpuMask)
+{
+	DWORD_PTR retVal;
+	
+	if (! cpuMask)
+		return 0x00;
+	if (! thr->id)
+		return 0x80;
+	
+	retVal = SetThreadAffinityMask(thr->hThread, (DWORD_PTR)cpuMask);
+	return retVal ? 0x00 : 0x80;
+}
+
+typedef HRESULT (WINAPI *SETTHRDESC_FUNC)(HANDLE hThread, PCWSTR lpThreadDescription);
+
+UINT8 OSThread_SetName(OS_THREAD* thr, const char* name)
+{
+	// SetThreadDescription() requires Windows 10 1607 or later, so it is loaded dynamically.
+	HMODULE hKernel32;
+	SETTHRDESC_FUNC funcSetThreadDesc;
+	WCHAR nameW[0x40];
+	HRESULT hRes;
+	
+	if (! thr->id)
+		return 0x80;
+	
+	hKernel32 = GetModuleHandleA("kernel32.dll");
+	if (hKernel32 == NULL)
+		return 0x80;
+	funcSetThreadDesc = (SETTHRDESC_FUNC)GetProcAddress(hKernel32, "SetThreadDescription");
+	if (funcSetThreadDesc == NULL)
+		return 0x80;
+	
+	if (! MultiByteToWideChar(CP_UTF8, 0, name, -1, nameW, 0x40))
+		return 0x80;
+	nameW[0x3F] = L'\0';
+	hRes = funcSetThreadDesc(thr->hThread, nameW);
+	return SUCCEEDED(hRes) ? 0x00 : 0x80;
+}
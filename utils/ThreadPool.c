@@ -0,0 +1,424 @@
+// Thread Pool
+// -----------
+// fixed number of worker threads with a task queue each
+// Workers take new tasks from the back of their own queue (LIFO, for cache locality) and
+// steal tasks from the front of the other workers' queues (FIFO) when they run out of work.
+
+#include <stdlib.h>
+#include <stddef.h>
+
+#ifdef _MSC_VER
+#include <windows.h>	// for Interlocked* functions
+#endif
+
+#include "../stdtype.h"
+#include "OSThread.h"
+#include "OSMutex.h"
+#include "OSSignal.h"
+#include "ThreadPool.h"
+
+typedef struct _thread_pool_task
+{
+	THRPOOL_FUNC func;
+	THRPOOL_WFUNC wfunc;	// used instead of func when not NULL
+	void* param;
+} THRPOOL_TASK;
+
+//typedef struct _thread_pool_worker THRPOOL_WORKER;
+struct _thread_pool_worker
+{
+	THREAD_POOL* pool;
+	UINT32 id;
+	OS_THREAD* hThread;	// NULL for the controlling thread
+	OS_MUTEX* hMutex;	// protects the task queue
+	THRPOOL_TASK* tasks;	// ring buffer, used as double-ended queue
+	UINT32 taskAlloc;	// always a power of 2
+	UINT32 taskStart;
+	UINT32 taskCount;
+	UINT32 stealPos;	// worker to steal from next
+	void* scratch;
+	size_t scratchSize;
+};
+
+//typedef struct _thread_pool THREAD_POOL;
+struct _thread_pool
+{
+	UINT32 thrCount;
+	THRPOOL_WORKER* workers;	// thrCount + 1 entries, the last one belongs to the controlling thread
+	OS_MUTEX* hMutex;	// protects the counters when there are no atomic operations
+	OS_SIGNAL* sigWork;	// set when new tasks are queued while workers are sleeping
+	OS_SIGNAL* sigDone;	// set when the last pending task was finished
+	volatile UINT32 nextQueue;	// queue that receives the next task from ThreadPool_Submit
+
+	// The counters need sequentially consistent access, so that a worker going to sleep
+	// can't miss a task that is queued at the same time.
+	volatile UINT32 queued;		// number of tasks in all queues
+	volatile UINT32 pending;	// number of tasks that are queued or running
+	volatile UINT32 idle;		// number of sleeping workers
+	volatile UINT32 quit;
+};
+
+static UINT32 Atomic_Add(THREAD_POOL* pool, volatile UINT32* var, INT32 value);
+static THRPOOL_WORKER* ThreadPool_NextQueue(THREAD_POOL* pool);
+static UINT32 Atomic_Load(THREAD_POOL* pool, volatile UINT32* var);
+static UINT8 ThreadPool_QueueTask(THRPOOL_WORKER* worker, const THRPOOL_TASK* task);
+static UINT8 Queue_Push(THRPOOL_WORKER* worker, const THRPOOL_TASK* task);
+static UINT8 Queue_Pop(THRPOOL_WORKER* worker, THRPOOL_TASK* task, UINT8 fromBack);
+static UINT8 ThreadPool_FindTask(THRPOOL_WORKER* worker, THRPOOL_TASK* task);
+static void ThreadPool_RunTask(THRPOOL_WORKER* worker, const THRPOOL_TASK* task);
+static void ThreadPool_WorkerMain(void* param);
+
+UINT8 ThreadPool_Init(THREAD_POOL** retPool, UINT32 threadCount)
+{
+	THREAD_POOL* pool;
+	UINT32 curWrk;
+	UINT8 retVal;
+
+	pool = (THREAD_POOL*)calloc(1, sizeof(THREAD_POOL));
+	if (pool == NULL)
+		return 0xFF;
+
+	retVal  = OSMutex_Init(&pool->hMutex, 0);
+	retVal |= OSSignal_Init(&pool->sigWork, 0);
+	retVal |= OSSignal_Init(&pool->sigDone, 0);
+	if (retVal)
+	{
+		ThreadPool_Deinit(pool);
+		return 0x80;
+	}
+
+	pool->workers = (THRPOOL_WORKER*)calloc(threadCount + 1, sizeof(THRPOOL_WORKER));
+	if (pool->workers == NULL)
+	{
+		ThreadPool_Deinit(pool);
+		return 0xFF;
+	}
+	pool->thrCount = threadCount;
+	// set up all queues before starting the threads, as they may steal from any of them
+	for (curWrk = 0; curWrk <= threadCount; curWrk ++)
+	{
+		THRPOOL_WORKER* wrk = &pool->workers[curWrk];
+		wrk->pool = pool;
+		wrk->id = curWrk;
+		wrk->stealPos = (curWrk + 1) % (threadCount + 1);
+		wrk->taskAlloc = 0x10;
+		wrk->tasks = (THRPOOL_TASK*)malloc(wrk->taskAlloc * sizeof(THRPOOL_TASK));
+		retVal = OSMutex_Init(&wrk->hMutex, 0);
+		if (wrk->tasks == NULL || retVal)
+		{
+			ThreadPool_Deinit(pool);
+			return 0xFF;
+		}
+	}
+
+	for (curWrk = 0; curWrk < threadCount; curWrk ++)
+	{
+		THRPOOL_WORKER* wrk = &pool->workers[curWrk];
+		retVal = OSThread_Init(&wrk->hThread, &ThreadPool_WorkerMain, wrk);
+		if (retVal)
+		{
+			wrk->hThread = NULL;
+			ThreadPool_Deinit(pool);
+			return 0x80;
+		}
+		OSThread_SetName(wrk->hThread, "vgm-pool");
+	}
+
+	*retPool = pool;
+	return 0x00;
+}
+
+void ThreadPool_Deinit(THREAD_POOL* pool)
+{
+	UINT32 curWrk;
+
+	if (pool->workers != NULL)
+	{
+		if (pool->workers[0].hThread != NULL)
+		{
+			ThreadPool_Wait(pool);
+			Atomic_Add(pool, &pool->quit, 1);
+			OSSignal_Signal(pool->sigWork);	// each worker passes the signal on when quitting
+		}
+		for (curWrk = 0; curWrk < pool->thrCount; curWrk ++)
+		{
+			THRPOOL_WORKER* wrk = &pool->workers[curWrk];
+			if (wrk->hThread != NULL)
+			{
+				OSThread_Join(wrk->hThread);
+				OSThread_Deinit(wrk->hThread);
+			}
+		}
+		// free the queues only after all threads quit, as workers access each other's queues
+		for (curWrk = 0; curWrk <= pool->thrCount; curWrk ++)
+		{
+			THRPOOL_WORKER* wrk = &pool->workers[curWrk];
+			if (wrk->hMutex != NULL)
+				OSMutex_Deinit(wrk->hMutex);
+			free(wrk->tasks);
+			free(wrk->scratch);
+		}
+		free(pool->workers);
+	}
+	if (pool->sigDone != NULL)
+		OSSignal_Deinit(pool->sigDone);
+	if (pool->sigWork != NULL)
+		OSSignal_Deinit(pool->sigWork);
+	if (pool->hMutex != NULL)
+		OSMutex_Deinit(pool->hMutex);
+	free(pool);
+
+	return;
+}
+
+UINT32 ThreadPool_GetThreadCount(const THREAD_POOL* pool)
+{
+	return pool->thrCount;
+}
+
+UINT8 ThreadPool_Submit(THREAD_POOL* pool, THRPOOL_FUNC func, void* param)
+{
+	THRPOOL_TASK task;
+
+	task.func = func;
+	task.wfunc = NULL;
+	task.param = param;
+	return ThreadPool_QueueTask(ThreadPool_NextQueue(pool), &task);
+}
+
+UINT8 ThreadPool_SubmitEx(THREAD_POOL* pool, THRPOOL_WFUNC func, void* param)
+{
+	THRPOOL_TASK task;
+
+	task.func = NULL;
+	task.wfunc = func;
+	task.param = param;
+	return ThreadPool_QueueTask(ThreadPool_NextQueue(pool), &task);
+}
+
+void ThreadPool_Wait(THREAD_POOL* pool)
+{
+	THRPOOL_WORKER* self = &pool->workers[pool->thrCount];
+	THRPOOL_TASK task;
+
+	while(1)
+	{
+		// help with the remaining tasks
+		while(ThreadPool_FindTask(self, &task))
+			ThreadPool_RunTask(self, &task);
+		if (! Atomic_Load(pool, &pool->pending))
+			break;
+		OSSignal_Wait(pool->sigDone);
+	}
+
+	return;
+}
+
+UINT8 ThreadPool_Spawn(THRPOOL_WORKER* worker, THRPOOL_WFUNC func, void* param)
+{
+	THRPOOL_TASK task;
+
+	task.func = NULL;
+	task.wfunc = func;
+	task.param = param;
+	return ThreadPool_QueueTask(worker, &task);
+}
+
+UINT32 ThreadPool_GetWorkerID(const THRPOOL_WORKER* worker)
+{
+	return worker->id;
+}
+
+void* ThreadPool_GetScratch(THRPOOL_WORKER* worker, size_t size)
+{
+	if (size > worker->scratchSize)
+	{
+		// no realloc(), as the old contents don't need to be preserved
+		free(worker->scratch);
+		worker->scratch = malloc(size);
+		worker->scratchSize = (worker->scratch != NULL) ? size : 0;
+	}
+	return worker->scratch;
+}
+
+static UINT32 Atomic_Add(THREAD_POOL* pool, volatile UINT32* var, INT32 value)
+{
+#if defined(_MSC_VER)
+	return (UINT32)InterlockedExchangeAdd((volatile LONG*)var, value) + value;
+#elif defined(__GNUC__)
+	return __atomic_add_fetch(var, (UINT32)value, __ATOMIC_SEQ_CST);
+#else
+	UINT32 result;
+	OSMutex_Lock(pool->hMutex);
+	*var += value;
+	result = *var;
+	OSMutex_Unlock(pool->hMutex);
+	return result;
+#endif
+}
+
+// distribute the tasks among the workers, stealing balances the rest
+static THRPOOL_WORKER* ThreadPool_NextQueue(THREAD_POOL* pool)
+{
+	if (! pool->thrCount)
+		return &pool->workers[0];
+	// atomic, so that multiple threads can submit tasks at the same time
+	return &pool->workers[Atomic_Add(pool, &pool->nextQueue, 1) % pool->thrCount];
+}
+
+static UINT32 Atomic_Load(THREAD_POOL* pool, volatile UINT32* var)
+{
+#if defined(_MSC_VER)
+	return (UINT32)InterlockedCompareExchange((volatile LONG*)var, 0, 0);
+#elif defined(__GNUC__)
+	return __atomic_load_n(var, __ATOMIC_SEQ_CST);
+#else
+	UINT32 result;
+	OSMutex_Lock(pool->hMutex);
+	result = *var;
+	OSMutex_Unlock(pool->hMutex);
+	return result;
+#endif
+}
+
+static UINT8 ThreadPool_QueueTask(THRPOOL_WORKER* worker, const THRPOOL_TASK* task)
+{
+	THREAD_POOL* pool = worker->pool;
+
+	// Count the task before queueing it, so that the counters never underflow.
+	Atomic_Add(pool, &pool->pending, 1);
+	Atomic_Add(pool, &pool->queued, 1);
+	if (! Queue_Push(worker, task))
+	{
+		Atomic_Add(pool, &pool->queued, -1);
+		if (! Atomic_Add(pool, &pool->pending, -1))
+			OSSignal_Signal(pool->sigDone);
+		return 0xFF;
+	}
+
+	if (Atomic_Load(pool, &pool->idle) > 0)
+		OSSignal_Signal(pool->sigWork);
+	return 0x00;
+}
+
+static UINT8 Queue_Push(THRPOOL_WORKER* worker, const THRPOOL_TASK* task)
+{
+	OSMutex_Lock(worker->hMutex);
+	if (worker->taskCount >= worker->taskAlloc)
+	{
+		// grow the ring buffer and unwrap it
+		UINT32 newAlloc = worker->taskAlloc * 2;
+		THRPOOL_TASK* newTasks = (THRPOOL_TASK*)malloc(newAlloc * sizeof(THRPOOL_TASK));
+		UINT32 curTask;
+		if (newTasks == NULL)
+		{
+			OSMutex_Unlock(worker->hMutex);
+			return 0;
+		}
+		for (curTask = 0; curTask < worker->taskCount; curTask ++)
+			newTasks[curTask] = worker->tasks[(worker->taskStart + curTask) & (worker->taskAlloc - 1)];
+		free(worker->tasks);
+		worker->tasks = newTasks;
+		worker->taskAlloc = newAlloc;
+		worker->taskStart = 0;
+	}
+	worker->tasks[(worker->taskStart + worker->taskCount) & (worker->taskAlloc - 1)] = *task;
+	worker->taskCount ++;
+	OSMutex_Unlock(worker->hMutex);
+
+	return 1;
+}
+
+static UINT8 Queue_Pop(THRPOOL_WORKER* worker, THRPOOL_TASK* task, UINT8 fromBack)
+{
+	OSMutex_Lock(worker->hMutex);
+	if (! worker->taskCount)
+	{
+		OSMutex_Unlock(worker->hMutex);
+		return 0;
+	}
+	worker->taskCount --;
+	if (fromBack)
+	{
+		*task = worker->tasks[(worker->taskStart + worker->taskCount) & (worker->taskAlloc - 1)];
+	}
+	else
+	{
+		*task = worker->tasks[worker->taskStart];
+		worker->taskStart = (worker->taskStart + 1) & (worker->taskAlloc - 1);
+	}
+	OSMutex_Unlock(worker->hMutex);
+
+	return 1;
+}
+
+static UINT8 ThreadPool_FindTask(THRPOOL_WORKER* worker, THRPOOL_TASK* task)
+{
+	THREAD_POOL* pool = worker->pool;
+	UINT32 wrkCount = pool->thrCount + 1;
+	UINT32 curWrk;
+
+	if (! Queue_Pop(worker, task, 1))
+	{
+		if (! Atomic_Load(pool, &pool->queued))
+			return 0;	// nothing to steal
+
+		for (curWrk = 0; curWrk < wrkCount; curWrk ++)
+		{
+			THRPOOL_WORKER* victim = &pool->workers[worker->stealPos];
+			if (victim != worker && Queue_Pop(victim, task, 0))
+				break;	// keep stealing from this worker next time
+			worker->stealPos = (worker->stealPos + 1) % wrkCount;
+		}
+		if (curWrk >= wrkCount)
+			return 0;
+	}
+
+	// The work signal only wakes a single thread, so pass it on while there are tasks left.
+	if (Atomic_Add(pool, &pool->queued, -1) > 0 && Atomic_Load(pool, &pool->idle) > 0)
+		OSSignal_Signal(pool->sigWork);
+	return 1;
+}
+
+static void ThreadPool_RunTask(THRPOOL_WORKER* worker, const THRPOOL_TASK* task)
+{
+	THREAD_POOL* pool = worker->pool;
+
+	if (task->wfunc != NULL)
+		task->wfunc(worker, task->param);
+	else
+		task->func(task->param);
+
+	if (! Atomic_Add(pool, &pool->pending, -1))
+		OSSignal_Signal(pool->sigDone);
+
+	return;
+}
+
+static void ThreadPool_WorkerMain(void* param)
+{
+	THRPOOL_WORKER* worker = (THRPOOL_WORKER*)param;
+	THREAD_POOL* pool = worker->pool;
+	THRPOOL_TASK task;
+
+	while(1)
+	{
+		if (ThreadPool_FindTask(worker, &task))
+		{
+			ThreadPool_RunTask(worker, &task);
+			continue;
+		}
+		if (Atomic_Load(pool, &pool->quit))
+			break;
+
+		// Announce that we're going to sleep before checking the queues for the last time.
+		// A task that is queued afterwards sees the idle worker and sets the signal.
+		Atomic_Add(pool, &pool->idle, 1);
+		if (! Atomic_Load(pool, &pool->queued) && ! Atomic_Load(pool, &pool->quit))
+			OSSignal_Wait(pool->sigWork);
+		Atomic_Add(pool, &pool->idle, -1);
+	}
+	OSSignal_Signal(pool->sigWork);	// wake up the next worker, so that it can quit as well
+
+	return;
+}
@@ -0,0 +1,45 @@
+#ifndef __THREADPOOL_H__
+#define __THREADPOOL_H__
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stddef.h>	// for size_t
+#include "../stdtype.h"
+
+typedef struct _thread_pool THREAD_POOL;
+typedef struct _thread_pool_worker THRPOOL_WORKER;
+typedef void (*THRPOOL_FUNC)(void* param);
+// task function that receives the executing worker, for sub-tasks and scratch memory
+typedef void (*THRPOOL_WFUNC)(THRPOOL_WORKER* worker, void* param);
+
+// Create a pool with a fixed number of worker threads.
+// threadCount may be 0, in which case all tasks are executed by ThreadPool_Wait().
+// Each worker has its own task queue. Idle workers steal tasks from the other queues.
+UINT8 ThreadPool_Init(THREAD_POOL** retPool, UINT32 threadCount);
+void ThreadPool_Deinit(THREAD_POOL* pool);
+UINT32 ThreadPool_GetThreadCount(const THREAD_POOL* pool);
+// Queue a task. Tasks may be executed in any order.
+// Submit can be called from multiple threads at once. Wait is meant to be called by a single controlling thread.
+UINT8 ThreadPool_Submit(THREAD_POOL* pool, THRPOOL_FUNC func, void* param);
+UINT8 ThreadPool_SubmitEx(THREAD_POOL* pool, THRPOOL_WFUNC func, void* param);
+// Wait until all submitted tasks (including sub-tasks) are finished. (fork-join barrier)
+// The calling thread helps executing queued tasks.
+void ThreadPool_Wait(THREAD_POOL* pool);
+
+// Queue a sub-task from within a running task. It is put into the worker's own queue,
+// so that it is likely to run on the same thread while the data is still in the cache.
+UINT8 ThreadPool_Spawn(THRPOOL_WORKER* worker, THRPOOL_WFUNC func, void* param);
+// Returns the index of the worker, 0 .. ThreadPool_GetThreadCount(). (the highest ID is used by ThreadPool_Wait)
+UINT32 ThreadPool_GetWorkerID(const THRPOOL_WORKER* worker);
+// Returns scratch memory of at least "size" bytes that belongs to the worker. (NULL on failure)
+// It is kept until the pool is destroyed and may be moved when a larger size is requested.
+void* ThreadPool_GetScratch(THRPOOL_WORKER* worker, size_t size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif	// __THREADPOOL_H__
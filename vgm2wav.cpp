@@ -11,9 +11,19 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <ctype.h>
+#include <vector>
+#include <string>
+#include <set>
+#include <algorithm>
 #ifdef _WIN32
 #include <io.h>
 #include <fcntl.h>
+#include <windows.h>
+#else
+#include <time.h>
+#include <sys/stat.h>
+#include <dirent.h>
 #endif
 
 #include "player/playerbase.hpp"
@@ -27,6 +37,10 @@
 #include "emu/SoundDevs.h"
 #include "emu/EmuCores.h"
 #include "emu/SoundEmu.h"
+#ifdef VGM2WAV_THREADING
+#include "utils/OSMutex.h"
+#include "utils/ThreadPool.h"
+#endif
 
 #ifdef _MSC_VER
 #define strncasecmp	_strnicmp
@@ -51,6 +65,44 @@ bit_depth = 16;
 static unsigned int
 loops = 2;
 
+/* number of files rendered in parallel (batch mode) */
+static unsigned int
+jobs = 1;
+
+/* output directory, enables batch mode */
+static const char *
+batch_dir = NULL;
+
+/* cores selected via --core, applied to all files */
+#define MAX_CORE_OVERRIDES 32
+static unsigned int
+core_count = 0;
+
+static UINT8
+core_dev[MAX_CORE_OVERRIDES];
+
+static UINT32
+core_fcc[MAX_CORE_OVERRIDES];
+
+typedef struct _batch_job {
+    std::string inPath;
+    std::string outPath;
+    double songLen;     /* in seconds */
+    double renderTime;  /* in seconds */
+    int result;
+} BATCH_JOB;
+
+static unsigned int
+batch_total = 0;
+
+static unsigned int
+batch_done = 0;
+
+#ifdef VGM2WAV_THREADING
+static OS_MUTEX *
+batch_mutex = NULL;
+#endif
+
 /* vgm-specific functions */
 static void
 FCC2STR(char *str, UINT32 fcc);
@@ -92,29 +144,51 @@ fmt_time(double ts);
 static DATA_LOADER*
 request_file_callback(void* userParam, PlayerBase* player, const char* fileName);
 
+static int
+setup_player(PlayerA &player);
+
+static int
+render_file(PlayerA &player, const char *inPath, const char *outPath, UINT8 *packed, int verbose, double *songLen);
+
+/* batch mode */
+static double
+get_time(void);
+
+static int
+add_core_override(const char *spec);
+
+static int
+is_directory(const char *path);
+
+static void
+add_input_path(const char *path, std::vector<std::string> &inputs);
+
+static int
+read_file_list(const char *listPath, std::vector<std::string> &inputs);
+
+static std::string
+make_output_path(const std::string &inPath, std::set<std::string> &usedNames);
+
+static void
+batch_lock(void);
+
+static void
+batch_unlock(void);
+
+static void
+batch_render_task(void *param);
+
+static int
+render_batch(const std::vector<std::string> &inputs);
+
 static const char *
 extensible_guid_trailer= "\x00\x00\x00\x00\x10\x00\x80\x00\x00\xAA\x00\x38\x9B\x71";
 
 int main(int argc, const char *argv[]) {
-    PlayerA player;
-    PlayerBase* plrEngine;
-
-    unsigned int totalFrames;
-    unsigned int fadeFrames;
-    unsigned int curFrames;
-    const char *const *tags;
+    std::vector<std::string> inputs;
     const char *self;
     const char *c;
     const char *s;
-    FILE *f;
-    DATA_LOADER *loader;
-    UINT8 *packed;
-    double complete;
-    double inc;
-
-    fadeFrames = 0;
-    complete = 0.0;
-    inc = 0.0;
 
     self = *argv++;
     argc--;
@@ -177,6 +251,64 @@ int main(int argc, const char *argv[]) {
             argv++;
             argc--;
         }
+        else if(str_istarts(*argv,"--core")) {
+            c = strchr(*argv,'=');
+            if(c != NULL) {
+                s = &c[1];
+            } else {
+                argv++;
+                argc--;
+                s = *argv;
+            }
+            if(s == NULL || add_core_override(s)) {
+                fprintf(stderr,"invalid core selection: %s\n",s ? s : "");
+                return 1;
+            }
+            argv++;
+            argc--;
+        }
+        else if(str_istarts(*argv,"--batch")) {
+            c = strchr(*argv,'=');
+            if(c != NULL) {
+                s = &c[1];
+            } else {
+                argv++;
+                argc--;
+                s = *argv;
+            }
+            batch_dir = s;
+            argv++;
+            argc--;
+        }
+        else if(str_istarts(*argv,"--list")) {
+            c = strchr(*argv,'=');
+            if(c != NULL) {
+                s = &c[1];
+            } else {
+                argv++;
+                argc--;
+                s = *argv;
+            }
+            if(s == NULL || read_file_list(s, inputs)) {
+                fprintf(stderr,"unable to read file list %s\n",s ? s : "");
+                return 1;
+            }
+            argv++;
+            argc--;
+        }
+        else if(str_istarts(*argv,"--jobs")) {
+            c = strchr(*argv,'=');
+            if(c != NULL) {
+                s = &c[1];
+            } else {
+                argv++;
+                argc--;
+                s = *argv;
+            }
+            jobs = scan_uint(s);
+            argv++;
+            argc--;
+        }
         else {
             break;
         }
@@ -197,35 +329,70 @@ int main(int argc, const char *argv[]) {
         default: bit_depth = 16;
     }
 
-    if(argc < 2) {
+    if(jobs == 0) {
+        jobs = 1;
+    }
+
+    if(batch_dir == NULL ? argc < 2 : (argc < 1 && inputs.empty())) {
         fprintf(stderr,"Usage: %s [options] /path/to/vgm-file /path/to/out.wav\n",self);
+        fprintf(stderr,"       %s [options] --batch /path/to/out-dir [files or directories ...]\n",self);
         fprintf(stderr,"Available options:\n");
         fprintf(stderr,"    --samplerate n - sample rate (default: %d)\n", 44100);
         fprintf(stderr,"    --bps n        - bits per sample (default: %d)\n", 16);
         fprintf(stderr,"    --fade x       - fade out length in seconds (default: %.1f)\n", 8.0);
         fprintf(stderr,"    --loops n      - numbers of loops before fade out (default: %d)\n", 2);
+        fprintf(stderr,"    --core dev=id  - emulation core for a sound device, e.g. YM2612=NUKE (can be repeated)\n");
+        fprintf(stderr,"Batch mode options:\n");
+        fprintf(stderr,"    --batch dir    - render all input files into dir, using the input file names\n");
+        fprintf(stderr,"    --list file    - read additional input files from a text file (one per line, \"-\" = stdin)\n");
+        fprintf(stderr,"    --jobs n       - number of files that are rendered in parallel (default: %d)\n", 1);
         fprintf(stderr,"Specify \"-\" as output file to write to stdout.\n");
         return 1;
     }
 
+    if(batch_dir != NULL) {
+        while(argc > 0) {
+            add_input_path(*argv, inputs);
+            argv++;
+            argc--;
+        }
+        return render_batch(inputs);
+    }
+
     /* if we were writing a library that uses libvgm, we'd want
      * to have way better clean-up of resources when we see an error
      * (free all our allocated memory, close files, etc).
      * Since this is just a CLI app, we can just quit and let
      * the OS handle everything. */
+    {
+        PlayerA player;
+        UINT8 *packed;
+        int retVal;
+
+        /* we'll want to make sure to pack our audio samples
+         * into little-endian, interleaved format.
+         * If we only supported 16-bit samples this could be
+         * malloc(sizeof(INT16) * 2 * BUFFER_LEN) - but in
+         * this case we're using INT32 to ensure we can pack
+         * 16 and 24-bit frames */
+        packed = (UINT8 *)malloc(sizeof(INT32) * 2 * BUFFER_LEN);
+        if(packed == NULL) {
+            fprintf(stderr,"out of memory\n");
+            return 1;
+        }
 
-    /* we'll want to make sure to pack our audio samples
-     * into little-endian, interleaved format.
-     * If we only supported 16-bit samples this could be
-     * malloc(sizeof(INT16) * 2 * BUFFER_LEN) - but in
-     * this case we're using INT32 to ensure we can pack
-     * 16 and 24-bit frames */
-    packed = (UINT8 *)malloc(sizeof(INT32) * 2 * BUFFER_LEN);
-    if(packed == NULL) {
-        fprintf(stderr,"out of memory\n");
-        return 1;
+        if(setup_player(player)) {
+            return 1;
+        }
+        retVal = render_file(player, argv[0], argv[1], packed, 1, NULL);
+
+        free(packed);
+        player.UnregisterAllPlayers();
+        return retVal;
     }
+}
 
+static int setup_player(PlayerA &player) {
     /* Register all player engines.
      * libvgm will automatically choose the correct one depending on the file format. */
     player.RegisterPlayerEngine(new VGMPlayer);
@@ -251,14 +418,33 @@ int main(int argc, const char *argv[]) {
         player.SetConfiguration(pCfg);
     }
 
-    if (!strcmp(argv[1], "-")) {
+    return 0;
+}
+
+/* renders a single file, returns 0 on success
+ * verbose = 1: print tags, device info and a progress bar */
+static int render_file(PlayerA &player, const char *inPath, const char *outPath, UINT8 *packed, int verbose, double *songLen) {
+    PlayerBase* plrEngine;
+    unsigned int totalFrames;
+    unsigned int curFrames;
+    unsigned int i;
+    const char *const *tags;
+    FILE *f;
+    DATA_LOADER *loader;
+    double complete;
+    double inc;
+
+    complete = 0.0;
+    inc = 0.0;
+
+    if (!strcmp(outPath, "-")) {
         f = stdout;
 #ifdef _WIN32
         _setmode(_fileno(f), _O_BINARY);	// force binary output mode
 #endif
     }
     else {
-        f = fopen(argv[1],"wb");
+        f = fopen(outPath,"wb");
     }
     if(f == NULL) {
         fprintf(stderr,"unable to open output file\n");
@@ -269,9 +455,10 @@ int main(int argc, const char *argv[]) {
      * create a FileLoader object - able to read gzip'd
      * files on-the-fly */
 
-    loader = FileLoader_Init(argv[0]);
+    loader = FileLoader_Init(inPath);
     if(loader == NULL) {
         fprintf(stderr,"failed to create FileLoader\n");
+        fclose(f);
         return 1;
     }
 
@@ -280,6 +467,7 @@ int main(int argc, const char *argv[]) {
     if(DataLoader_Load(loader)) {
         fprintf(stderr,"failed to load DataLoader\n");
         DataLoader_Deinit(loader);
+        fclose(f);
         return 1;
     }
 
@@ -287,6 +475,8 @@ int main(int argc, const char *argv[]) {
      * automatically reads the rest of the file */
     if(player.LoadFile(loader)) {
         fprintf(stderr,"failed to load file\n");
+        DataLoader_Deinit(loader);
+        fclose(f);
         return 1;
     }
     plrEngine = player.GetPlayer();
@@ -297,32 +487,33 @@ int main(int argc, const char *argv[]) {
         player.SetLoopCount(vgmplay->GetModifiedLoopCount(loops));
     }
 
-    /* example for setting cores */
-    /* TODO provide interface for user to specify cores
-     * for devices, like:
-     *   --core=ym2612=nuke ?
-     *   --ym2612=nuke ?
-     *   ???
-     */
-    /* commented-out since NUKE uses a lot of CPU */
-    // set_core(plrEngine,DEVID_YM2612,FCC_NUKE);
+    /* apply the cores selected via --core */
+    for(i=0;i<core_count;i++) {
+        set_core(plrEngine,core_dev[i],core_fcc[i]);
+    }
 
     /* let's get some tags! just printing for now.
      * if we wanted to get *really* fancy we could add
      * an "id3 " chunk or "LIST" "INFO" chunk to the
      * wave file. */
-    tags = plrEngine->GetTags();
-    while(*tags) {
-        fprintf(stderr,"%s: %s\n",tags[0],tags[1]);
-        tags += 2;
+    if(verbose) {
+        tags = plrEngine->GetTags();
+        while(*tags) {
+            fprintf(stderr,"%s: %s\n",tags[0],tags[1]);
+            tags += 2;
+        }
     }
 
     /* need to call Start before calls like Tick2Sample or
      * checking any kind of timing info, because
      * Start updates the sample rate multiplier/divisors */
+    batch_lock();
     player.Start();
+    batch_unlock();
 
-    dump_info(plrEngine);
+    if(verbose) {
+        dump_info(plrEngine);
+    }
 
     /* libvgm uses the term "Sample" but its' really a PCM frame! */
     /* In a mono configuration, 1 frame = 1 sample, in a stereo
@@ -336,13 +527,18 @@ int main(int argc, const char *argv[]) {
     if(plrEngine->GetLoopTicks() > 0) {
         totalFrames += player.GetFadeSamples();
     }
+    if(songLen != NULL) {
+        *songLen = plrEngine->Sample2Second(totalFrames);
+    }
 
-    /* Let's tell the user what we're doing */
-    fprintf(stderr,"Rendering %s to %s\n",argv[0],argv[1]);
-    fprintf(stderr,"Samplerate: %u\n",sample_rate);
-    fprintf(stderr,"BPS: %u\n",bit_depth);
-    fprintf(stderr,"Channels: 2\n");
-    fprintf(stderr,"Length: %s\n",fmt_time(plrEngine->Sample2Second(totalFrames)));
+    if(verbose) {
+        /* Let's tell the user what we're doing */
+        fprintf(stderr,"Rendering %s to %s\n",inPath,outPath);
+        fprintf(stderr,"Samplerate: %u\n",sample_rate);
+        fprintf(stderr,"BPS: %u\n",bit_depth);
+        fprintf(stderr,"Channels: 2\n");
+        fprintf(stderr,"Length: %s\n",fmt_time(plrEngine->Sample2Second(totalFrames)));
+    }
 
     write_wav_header(f,totalFrames);
 
@@ -351,8 +547,10 @@ int main(int argc, const char *argv[]) {
 
     /* we'll just print a '-' character each time we've hit the
      * next 10% of the file */
-    fprintf(stderr,"[");
-    fflush(stderr);
+    if(verbose) {
+        fprintf(stderr,"[");
+        fflush(stderr);
+    }
 
     while(totalFrames) {
 
@@ -379,33 +577,327 @@ int main(int argc, const char *argv[]) {
 
         /* if we've done the next 10% of rendering, update the progress bar */
         complete += inc;
-        if(complete >= 0.10) {
+        if(verbose && complete >= 0.10) {
             complete -= 0.10;
             fprintf(stderr,"-");
             fflush(stderr);
         }
     }
-    fprintf(stderr,"]\n");
+    if(verbose) {
+        fprintf(stderr,"]\n");
+    }
+    batch_lock();
     player.Stop();
+    batch_unlock();
     player.UnloadFile();
 
-    free(packed);
-    player.UnregisterAllPlayers();
     DataLoader_Deinit(loader);
     fclose(f);
 
     return 0;
 }
 
+static double get_time(void) {
+#ifdef _WIN32
+    LARGE_INTEGER freq;
+    LARGE_INTEGER cntr;
+    QueryPerformanceFrequency(&freq);
+    QueryPerformanceCounter(&cntr);
+    return (double)cntr.QuadPart / (double)freq.QuadPart;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1000000000.0;
+#endif
+}
+
+/* parses "device=core", e.g. "YM2612=NUKE" */
+static int add_core_override(const char *spec) {
+    const char *sep;
+    const char *devName;
+    char fccStr[5];
+    size_t nameLen;
+    size_t i;
+    unsigned int devId;
+
+    sep = strchr(spec,'=');
+    if(sep == NULL || core_count >= MAX_CORE_OVERRIDES) return 1;
+    nameLen = sep - spec;
+
+    /* core IDs are 4 characters, padded with spaces ("EMU" = "EMU ") */
+    sep++;
+    for(i=0;i<4;i++) {
+        fccStr[i] = *sep ? *sep++ : ' ';
+    }
+    fccStr[4] = '\0';
+    if(*sep) return 1;
+
+    for(devId=0;devId<0x100;devId++) {
+        devName = SndEmu_GetDevName((DEV_ID)devId, 0x00, NULL);
+        if(devName == NULL) continue;
+        if(strlen(devName) == nameLen && ! strncasecmp(devName,spec,nameLen)) {
+            core_dev[core_count] = (UINT8)devId;
+            core_fcc[core_count] = STR2FCC(fccStr);
+            core_count++;
+            return 0;
+        }
+    }
+    return 1;
+}
+
+static int is_directory(const char *path) {
+#ifdef _WIN32
+    DWORD attr = GetFileAttributesA(path);
+    return (attr != INVALID_FILE_ATTRIBUTES && (attr & FILE_ATTRIBUTE_DIRECTORY));
+#else
+    struct stat st;
+    return (stat(path,&st) == 0 && S_ISDIR(st.st_mode));
+#endif
+}
+
+/* adds a file or all files of a directory (not recursive, sorted by name) */
+static void add_input_path(const char *path, std::vector<std::string> &inputs) {
+    std::vector<std::string> dirFiles;
+    std::string dirPath;
+
+    if(! is_directory(path)) {
+        inputs.push_back(path);
+        return;
+    }
+
+    dirPath = path;
+    if(dirPath[dirPath.length() - 1] != '/' && dirPath[dirPath.length() - 1] != '\\') {
+        dirPath += '/';
+    }
+#ifdef _WIN32
+    {
+        WIN32_FIND_DATAA findData;
+        HANDLE hFind = FindFirstFileA((dirPath + "*").c_str(), &findData);
+        if(hFind == INVALID_HANDLE_VALUE) return;
+        do {
+            if(! (findData.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)) {
+                dirFiles.push_back(dirPath + findData.cFileName);
+            }
+        } while(FindNextFileA(hFind, &findData));
+        FindClose(hFind);
+    }
+#else
+    {
+        DIR *dir = opendir(path);
+        struct dirent *entry;
+        if(dir == NULL) return;
+        while((entry = readdir(dir)) != NULL) {
+            std::string filePath = dirPath + entry->d_name;
+            if(entry->d_name[0] != '.' && ! is_directory(filePath.c_str())) {
+                dirFiles.push_back(filePath);
+            }
+        }
+        closedir(dir);
+    }
+#endif
+    std::sort(dirFiles.begin(), dirFiles.end());
+    inputs.insert(inputs.end(), dirFiles.begin(), dirFiles.end());
+}
+
+/* reads input paths from a text file, one per line */
+static int read_file_list(const char *listPath, std::vector<std::string> &inputs) {
+    FILE *f;
+    char line[0x1000];
+    size_t len;
+
+    f = str_equals(listPath,"-") ? stdin : fopen(listPath,"r");
+    if(f == NULL) return 1;
+    while(fgets(line,sizeof(line),f) != NULL) {
+        len = strlen(line);
+        while(len > 0 && (line[len - 1] == '\n' || line[len - 1] == '\r')) {
+            len--;
+        }
+        line[len] = '\0';
+        if(len > 0) {
+            add_input_path(line, inputs);
+        }
+    }
+    if(f != stdin) {
+        fclose(f);
+    }
+    return 0;
+}
+
+/* output directory + input file name with the extension replaced by ".wav"
+ * Files with the same name (e.g. a/song.vgm and b/song.vgm) get a "_2", "_3", ... suffix.
+ * Names are compared case-insensitively, as the output directory may be on such a file system. */
+static std::string make_output_path(const std::string &inPath, std::set<std::string> &usedNames) {
+    std::string outPath;
+    std::string fileName;
+    std::string baseName;
+    std::string key;
+    unsigned int suffix;
+    char sfxStr[0x10];
+    size_t pos;
+    size_t i;
+
+    pos = inPath.find_last_of("/\\");
+    baseName = (pos == std::string::npos) ? inPath : inPath.substr(pos + 1);
+    pos = baseName.rfind('.');
+    if(pos != std::string::npos && pos > 0) {
+        baseName.erase(pos);
+    }
+
+    fileName = baseName;
+    for(suffix=2;;suffix++) {
+        key = fileName;
+        for(i=0;i<key.length();i++) {
+            key[i] = (char)tolower((unsigned char)key[i]);
+        }
+        if(usedNames.insert(key).second) break;
+        snprintf(sfxStr,sizeof(sfxStr),"_%u",suffix);
+        fileName = baseName + sfxStr;
+    }
+
+    outPath = batch_dir;
+    if(! outPath.empty() && outPath[outPath.length() - 1] != '/' && outPath[outPath.length() - 1] != '\\') {
+        outPath += '/';
+    }
+    return outPath + fileName + ".wav";
+}
+
+/* Serializes console output and device start/stop in batch mode.
+ * (Some sound cores initialize shared tables when a device is started.) */
+static void batch_lock(void) {
+#ifdef VGM2WAV_THREADING
+    if(batch_mutex != NULL) OSMutex_Lock(batch_mutex);
+#endif
+}
+
+static void batch_unlock(void) {
+#ifdef VGM2WAV_THREADING
+    if(batch_mutex != NULL) OSMutex_Unlock(batch_mutex);
+#endif
+}
+
+static void batch_render_task(void *param) {
+    BATCH_JOB *job = (BATCH_JOB *)param;
+    PlayerA player;
+    UINT8 *packed;
+    double startTime;
+
+    startTime = get_time();
+    packed = (UINT8 *)malloc(sizeof(INT32) * 2 * BUFFER_LEN);
+    if(packed == NULL || setup_player(player)) {
+        job->result = 1;
+    } else {
+        job->result = render_file(player, job->inPath.c_str(), job->outPath.c_str(), packed, 0, &job->songLen);
+    }
+    free(packed);
+    player.UnregisterAllPlayers();
+    job->renderTime = get_time() - startTime;
+
+    batch_lock();
+    batch_done++;
+    if(job->result) {
+        fprintf(stderr,"[%u/%u] %s: FAILED\n", batch_done, batch_total, job->inPath.c_str());
+    } else {
+        fprintf(stderr,"[%u/%u] %s -> %s: %.1f s in %.2f s (%.1fx realtime)\n", batch_done, batch_total,
+            job->inPath.c_str(), job->outPath.c_str(), job->songLen, job->renderTime,
+            job->renderTime > 0.0 ? job->songLen / job->renderTime : 0.0);
+    }
+    batch_unlock();
+}
+
+static int render_batch(const std::vector<std::string> &inputs) {
+    std::vector<BATCH_JOB> batchJobs(inputs.size());
+    std::set<std::string> usedNames;
+    double startTime;
+    double wallTime;
+    double songTime;
+    double cpuTime;
+    unsigned int failed;
+    size_t i;
+
+    batch_total = (unsigned int)inputs.size();
+    batch_done = 0;
+    for(i=0;i<inputs.size();i++) {
+        batchJobs[i].inPath = inputs[i];
+        batchJobs[i].outPath = make_output_path(inputs[i], usedNames);
+        batchJobs[i].songLen = 0.0;
+        batchJobs[i].renderTime = 0.0;
+        batchJobs[i].result = 1;
+    }
+
+#ifndef VGM2WAV_THREADING
+    if(jobs > 1) {
+        fprintf(stderr,"Compiled without threading support, rendering files one after another.\n");
+        jobs = 1;
+    }
+#endif
+    fprintf(stderr,"Rendering %u files to %s using %u thread(s)\n", batch_total, batch_dir, jobs);
+
+    startTime = get_time();
+#ifdef VGM2WAV_THREADING
+    if(jobs > 1) {
+        THREAD_POOL *pool;
+
+        if(OSMutex_Init(&batch_mutex, 0)) {
+            fprintf(stderr,"unable to create mutex\n");
+            return 1;
+        }
+        /* the main thread helps with rendering while waiting, so it needs one worker less */
+        if(ThreadPool_Init(&pool, jobs - 1)) {
+            fprintf(stderr,"unable to create worker threads\n");
+            OSMutex_Deinit(batch_mutex);
+            batch_mutex = NULL;
+            return 1;
+        }
+        for(i=0;i<batchJobs.size();i++) {
+            if(ThreadPool_Submit(pool, batch_render_task, &batchJobs[i])) {
+                /* couldn't be queued, render it on this thread instead */
+                batch_render_task(&batchJobs[i]);
+            }
+        }
+        ThreadPool_Wait(pool);
+        ThreadPool_Deinit(pool);
+        OSMutex_Deinit(batch_mutex);
+        batch_mutex = NULL;
+    } else
+#endif
+    {
+        for(i=0;i<batchJobs.size();i++) {
+            batch_render_task(&batchJobs[i]);
+        }
+    }
+    wallTime = get_time() - startTime;
+
+    failed = 0;
+    songTime = 0.0;
+    cpuTime = 0.0;
+    for(i=0;i<batchJobs.size();i++) {
+        if(batchJobs[i].result) {
+            failed++;
+            continue;
+        }
+        songTime += batchJobs[i].songLen;
+        cpuTime += batchJobs[i].renderTime;
+    }
+    fprintf(stderr,"Done: %u files, %u failed\n", batch_total, failed);
+    fprintf(stderr,"Rendered %.1f s of audio in %.2f s: %.1fx realtime (%.1fx per thread)\n",
+        songTime, wallTime, wallTime > 0.0 ? songTime / wallTime : 0.0,
+        cpuTime > 0.0 ? songTime / cpuTime : 0.0);
+
+    return failed ? 1 : 0;
+}
+
 static void set_core(PlayerBase *player, UINT8 devId, UINT32 coreId) {
     PLR_DEV_OPTS devOpts;
     UINT32 id;
-
-    /* just going to set the first instance */
-    id = PLR_DEV_ID(devId,0);
-    if(player->GetDeviceOptions(id,devOpts)) return;
-    devOpts.emuCore[0] = coreId;
-    player->SetDeviceOptions(id,devOpts);
+    UINT8 instance;
+
+    /* set both instances of dual-chip songs */
+    for(instance=0;instance<2;instance++) {
+        id = PLR_DEV_ID(devId,instance);
+        if(player->GetDeviceOptions(id,devOpts)) continue;
+        devOpts.emuCore[0] = coreId;
+        player->SetDeviceOptions(id,devOpts);
+    }
     return;
 }
 
@@ -0,0 +1,135 @@
+// VGM command parsing benchmark
+// -----------------------------
+// Measures the time VGMPlayer needs for processing the VGM command data (including the register writes
+// to the sound cores, but without rendering any audio), with and without the pre-decoded command event list.
+// The song is processed by seeking from the beginning to the end, which parses all commands without rendering.
+//
+// Usage: vgm_parse_bench [-r repeats] file1.vgm [file2.vgm ...]
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "stdtype.h"
+#include "player/vgmplayer.hpp"
+#include "utils/DataLoader.h"
+#include "utils/FileLoader.h"
+
+
+static double GetTimeSec(void);
+static double BenchmarkParsing(VGMPlayer& player, UINT8 cmdEvtCache, UINT32 repeats, double* startTime);
+
+static double GetTimeSec(void)
+{
+#ifdef _WIN32
+	LARGE_INTEGER freq;
+	LARGE_INTEGER cntr;
+	QueryPerformanceFrequency(&freq);
+	QueryPerformanceCounter(&cntr);
+	return (double)cntr.QuadPart / (double)freq.QuadPart;
+#else
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1000000000.0;
+#endif
+}
+
+// returns the average time for parsing the whole song once
+static double BenchmarkParsing(VGMPlayer& player, UINT8 cmdEvtCache, UINT32 repeats, double* startTime)
+{
+	VGM_PLAY_OPTIONS playOpts;
+	UINT32 endTick = player.GetTotalTicks();
+	UINT32 curRep;
+	double time;
+
+	player.GetPlayerOptions(playOpts);
+	playOpts.cmdEventCache = cmdEvtCache;
+	playOpts.seekKfInterval = 0;
+	player.SetPlayerOptions(playOpts);
+
+	time = GetTimeSec();
+	player.Start();	// builds the command event list
+	*startTime = GetTimeSec() - time;
+
+	player.Seek(PLAYPOS_TICK, endTick);	// warm-up
+	time = GetTimeSec();
+	for (curRep = 0; curRep < repeats; curRep ++)
+	{
+		player.Reset();
+		player.Seek(PLAYPOS_TICK, endTick);
+	}
+	time = GetTimeSec() - time;
+	player.Stop();
+
+	return time / repeats;
+}
+
+int main(int argc, char* argv[])
+{
+	int argbase;
+	UINT32 repeats;
+
+	repeats = 10;
+	argbase = 1;
+	if (argc >= 3 && ! strcmp(argv[1], "-r"))
+	{
+		repeats = (UINT32)strtoul(argv[2], NULL, 0);
+		if (! repeats)
+			repeats = 1;
+		argbase += 2;
+	}
+	if (argc <= argbase)
+	{
+		printf("VGM command parsing benchmark\n");
+		printf("Usage: %s [-r repeats] file1.vgm [file2.vgm ...]\n", argv[0]);
+		return 0;
+	}
+
+	printf("%-32s %10s %10s %10s %8s\n", "File", "Start (ms)", "Plain (ms)", "Cache (ms)", "Speedup");
+	for (; argbase < argc; argbase ++)
+	{
+		const char* fileName = argv[argbase];
+		const char* shortName;
+		DATA_LOADER* dLoad;
+		VGMPlayer player;
+		double timePlain;
+		double timeCache;
+		double startPlain;
+		double startCache;
+		UINT8 retVal;
+
+		dLoad = FileLoader_Init(fileName);
+		if (dLoad == NULL)
+			continue;
+		DataLoader_SetPreloadBytes(dLoad, 0x100);
+		retVal = DataLoader_Load(dLoad);
+		if (! retVal)
+			retVal = player.LoadFile(dLoad);
+		if (retVal)
+		{
+			DataLoader_Deinit(dLoad);
+			fprintf(stderr, "Error 0x%02X loading %s\n", retVal, fileName);
+			continue;
+		}
+		player.SetSampleRate(44100);
+
+		// Note: VGMPlayer::Stop() clears the device configuration, so the file is reloaded for each run.
+		timePlain = BenchmarkParsing(player, 0, repeats, &startPlain);
+		player.UnloadFile();
+		player.LoadFile(dLoad);
+		timeCache = BenchmarkParsing(player, 1, repeats, &startCache);
+		player.UnloadFile();
+		DataLoader_Deinit(dLoad);
+
+		shortName = strrchr(fileName, '/');
+		shortName = (shortName != NULL) ? shortName + 1 : fileName;
+		printf("%-32.32s %10.2f %10.2f %10.2f %7.2fx\n", shortName, (startCache - startPlain) * 1000.0,
+				timePlain * 1000.0, timeCache * 1000.0, timePlain / timeCache);
+	}
+
+	return 0;
+}